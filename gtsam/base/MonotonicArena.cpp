@@ -0,0 +1,167 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MonotonicArena.cpp
+ * @brief   A resettable bump allocator for short-lived, per-iteration objects
+ */
+
+#include <gtsam/base/MonotonicArena.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+// A chunk of memory with an atomic bump offset
+struct ArenaChunk {
+  std::unique_ptr<char[]> data;
+  std::size_t size;
+  std::atomic<std::size_t> used;
+
+  explicit ArenaChunk(std::size_t size)
+      : data(new char[size]), size(size), used(0) {}
+};
+
+/* ************************************************************************* */
+class MonotonicArena::Storage {
+ public:
+  explicit Storage(std::size_t chunkSize) : chunkSize_(chunkSize) {}
+
+  void* allocate(std::size_t bytes, std::size_t alignment) {
+    // Worst case padding, so that a successful bump is always aligned
+    const std::size_t padded = bytes + alignment - 1;
+    ArenaChunk* chunk = current_.load(std::memory_order_acquire);
+    while (true) {
+      if (chunk) {
+        const std::size_t offset =
+            chunk->used.fetch_add(padded, std::memory_order_relaxed);
+        if (offset + padded <= chunk->size) {
+          live_.fetch_add(1, std::memory_order_relaxed);
+          const std::uintptr_t p =
+              reinterpret_cast<std::uintptr_t>(chunk->data.get()) + offset;
+          return reinterpret_cast<void*>((p + alignment - 1) &
+                                         ~(std::uintptr_t(alignment) - 1));
+        }
+      }
+      chunk = nextChunk(chunk, padded);
+    }
+  }
+
+  void deallocate() noexcept { live_.fetch_sub(1, std::memory_order_release); }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::size_t live = live_.load(std::memory_order_acquire);
+    if (live != 0)
+      throw std::logic_error("MonotonicArena::reset: " + std::to_string(live) +
+                             " allocations are still alive");
+    for (const auto& chunk : chunks_) chunk->used.store(0);
+    currentIndex_ = 0;
+    current_.store(chunks_.empty() ? nullptr : chunks_.front().get(),
+                   std::memory_order_release);
+  }
+
+  std::size_t liveAllocations() const { return live_.load(); }
+
+  std::size_t bytesUsed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t used = 0;
+    for (size_t i = 0; i < chunks_.size() && i <= currentIndex_; ++i)
+      used += std::min(chunks_[i]->used.load(), chunks_[i]->size);
+    return used;
+  }
+
+  std::size_t capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t capacity = 0;
+    for (const auto& chunk : chunks_) capacity += chunk->size;
+    return capacity;
+  }
+
+ private:
+  // Called when `full` cannot hold `bytes` more: returns the chunk to bump
+  // into next, reusing chunks kept by reset() before allocating new ones.
+  ArenaChunk* nextChunk(ArenaChunk* full, std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ArenaChunk* current = current_.load(std::memory_order_acquire);
+    if (current != full) return current;  // another thread moved on already
+
+    // Chunks after the current one are unused since the last reset
+    size_t next = chunks_.empty() ? 0 : currentIndex_ + 1;
+    while (next < chunks_.size() && chunks_[next]->size < bytes) ++next;
+    if (next >= chunks_.size()) {
+      chunks_.emplace_back(new ArenaChunk(std::max(chunkSize_, bytes)));
+      next = chunks_.size() - 1;
+    }
+    currentIndex_ = next;
+    current_.store(chunks_[next].get(), std::memory_order_release);
+    return chunks_[next].get();
+  }
+
+  const std::size_t chunkSize_;
+  std::vector<std::unique_ptr<ArenaChunk>> chunks_;
+  size_t currentIndex_ = 0;
+  std::atomic<ArenaChunk*> current_{nullptr};
+  std::atomic<std::size_t> live_{0};
+  mutable std::mutex mutex_;  // Protects chunks_ and currentIndex_
+};
+
+/* ************************************************************************* */
+namespace {
+thread_local MonotonicArena* currentArena = nullptr;
+}
+
+/* ************************************************************************* */
+MonotonicArena::MonotonicArena(std::size_t chunkSize)
+    : storage_(std::make_shared<Storage>(chunkSize)) {}
+
+/* ************************************************************************* */
+void* MonotonicArena::allocate(std::size_t bytes, std::size_t alignment) {
+  return storage_->allocate(bytes, alignment);
+}
+
+/* ************************************************************************* */
+void MonotonicArena::deallocate(void* /*p*/, std::size_t /*bytes*/) noexcept {
+  storage_->deallocate();
+}
+
+/* ************************************************************************* */
+void MonotonicArena::reset() { storage_->reset(); }
+
+/* ************************************************************************* */
+std::size_t MonotonicArena::liveAllocations() const {
+  return storage_->liveAllocations();
+}
+
+/* ************************************************************************* */
+std::size_t MonotonicArena::bytesUsed() const { return storage_->bytesUsed(); }
+
+/* ************************************************************************* */
+std::size_t MonotonicArena::capacity() const { return storage_->capacity(); }
+
+/* ************************************************************************* */
+MonotonicArena* MonotonicArena::Current() { return currentArena; }
+
+/* ************************************************************************* */
+MonotonicArena::Scope::Scope(MonotonicArena* arena) : previous_(currentArena) {
+  currentArena = arena;
+}
+
+/* ************************************************************************* */
+MonotonicArena::Scope::~Scope() { currentArena = previous_; }
+
+}  // namespace gtsam
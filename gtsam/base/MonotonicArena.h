@@ -0,0 +1,210 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    MonotonicArena.h
+ * @brief   A resettable bump allocator for short-lived, per-iteration objects
+ */
+
+#pragma once
+
+#include <gtsam/dllexport.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace gtsam {
+
+template <typename T>
+class ArenaAllocator;
+
+/**
+ * A monotonic arena hands out memory by bumping a pointer into large chunks,
+ * and only gets the memory back all at once, in reset(). It is meant for the
+ * thousands of linear factors and conditionals that one optimizer iteration
+ * creates and throws away: allocating them from an arena replaces one malloc
+ * and one free per object with an atomic add. This only covers the factor
+ * and conditional objects themselves, see below, so it removes part of the
+ * contention on the global heap when linearization and elimination run with
+ * TBB, not all of it.
+ *
+ * The arena is opt-in through a Scope on the calling thread:
+ * ```
+ * MonotonicArena arena;
+ * for (...) {
+ *   MonotonicArena::Scope scope(arena);
+ *   auto linear = graph.linearize(values);
+ *   auto bayesNet = linear->eliminateSequential();
+ *   ...
+ *   linear.reset(); bayesNet.reset();  // release everything, then
+ *   arena.reset();                     // reuse the same chunks next time
+ * }
+ * ```
+ * While a scope is active, NonlinearFactorGraph::linearize and the dense
+ * elimination functions (EliminateQR, EliminateCholesky,
+ * EliminatePreferCholesky) allocate their factors and conditionals with
+ * allocateShared, i.e., in the arena. linearize and multifrontal elimination
+ * install the same scope on their TBB worker threads.
+ *
+ * Every object allocated in the arena keeps the arena's storage alive, so
+ * destroying the MonotonicArena before the objects is safe; reset() however
+ * throws std::logic_error if any object is still alive.
+ *
+ * Only the objects and their shared_ptr control blocks live in the arena.
+ * The dense buffers of VerticalBlockMatrix and SymmetricBlockMatrix, which
+ * are usually the larger allocations, still come from Eigen's allocator:
+ * Eigen::Matrix takes no allocator, and both classes hand out their buffer
+ * as a Matrix&, so moving it would change the interface of every factor.
+ * @ingroup base
+ */
+class GTSAM_EXPORT MonotonicArena {
+ public:
+  class Storage;  // Chunks and counters, shared with all allocated objects
+  class Scope;
+
+  /// Default size of each chunk, in bytes
+  static constexpr std::size_t kDefaultChunkSize = std::size_t(1) << 20;
+
+  /// Construct an empty arena, chunks are allocated on demand
+  explicit MonotonicArena(std::size_t chunkSize = kDefaultChunkSize);
+
+  /// Allocate bytes with the given alignment, never returns nullptr
+  void* allocate(std::size_t bytes, std::size_t alignment);
+
+  /// Release an allocation: memory is only reused after reset()
+  void deallocate(void* p, std::size_t bytes) noexcept;
+
+  /**
+   * Make all chunks available again. Throws std::logic_error if objects
+   * allocated in the arena are still alive.
+   */
+  void reset();
+
+  /// Number of allocations that have not been deallocated yet
+  std::size_t liveAllocations() const;
+
+  /// Number of bytes handed out since the last reset, including padding
+  std::size_t bytesUsed() const;
+
+  /// Total size of all chunks
+  std::size_t capacity() const;
+
+  /// The arena of the innermost active Scope on this thread, or nullptr
+  static MonotonicArena* Current();
+
+  /// The shared storage, used by ArenaAllocator
+  const std::shared_ptr<Storage>& storage() const { return storage_; }
+
+ private:
+  template <typename T>
+  friend class ArenaAllocator;
+
+  explicit MonotonicArena(const std::shared_ptr<Storage>& storage)
+      : storage_(storage) {}
+
+  std::shared_ptr<Storage> storage_;
+};
+
+/**
+ * Makes an arena the current one on this thread for the lifetime of the
+ * Scope. Scopes nest, and a Scope with a nullptr arena disables allocation
+ * in an arena, e.g., for results that have to outlive the iteration.
+ */
+class GTSAM_EXPORT MonotonicArena::Scope {
+ public:
+  explicit Scope(MonotonicArena& arena) : Scope(&arena) {}
+  explicit Scope(MonotonicArena* arena);
+  ~Scope();
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  MonotonicArena* previous_;
+};
+
+/**
+ * A standard allocator that allocates from a MonotonicArena. It holds on to
+ * the arena storage, so that it can be stored in shared_ptr control blocks.
+ * A default-constructed ArenaAllocator allocates on the heap.
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+
+  /// Allocate on the heap
+  ArenaAllocator() {}
+
+  /// Allocate in the given arena
+  explicit ArenaAllocator(const MonotonicArena& arena)
+      : storage_(arena.storage()) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : storage_(other.storage_) {}
+
+  T* allocate(std::size_t n) {
+    if (!storage_)
+      return static_cast<T*>(::operator new(
+          n * sizeof(T), std::align_val_t(alignment())));
+    return static_cast<T*>(
+        MonotonicArena(storage_).allocate(n * sizeof(T), alignment()));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (!storage_)
+      ::operator delete(p, std::align_val_t(alignment()));
+    else
+      MonotonicArena(storage_).deallocate(p, n * sizeof(T));
+  }
+
+  /// Classes with private constructors can befriend ArenaAllocator
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return storage_ == other.storage_;
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return storage_ != other.storage_;
+  }
+
+ private:
+  template <typename U>
+  friend class ArenaAllocator;
+
+  // Eigen types need at least 16 bytes
+  static constexpr std::size_t alignment() {
+    return std::max<std::size_t>(alignof(T), 16);
+  }
+
+  std::shared_ptr<MonotonicArena::Storage> storage_;
+};
+
+/**
+ * Like gtsam::make_shared, but allocates in MonotonicArena::Current() if a
+ * Scope is active on this thread, and on the heap otherwise.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> allocateShared(Args&&... args) {
+  MonotonicArena* arena = MonotonicArena::Current();
+  return std::allocate_shared<T>(
+      arena ? ArenaAllocator<T>(*arena) : ArenaAllocator<T>(),
+      std::forward<Args>(args)...);
+}
+
+}  // namespace gtsam
@@ -256,6 +256,13 @@ namespace gtsam {
       full().triangularView<Eigen::Upper>() = xpr.template triangularView<Eigen::Upper>();
     }
 
+    /// Add the active matrix of another SymmetricBlockMatrix of the same size.
+    /// Only reads the upper triangular part of `other`.
+    void updateFullMatrix(const SymmetricBlockMatrix& other) {
+      assert(rows() == other.rows());
+      full().triangularView<Eigen::Upper>() += other.full();
+    }
+
     /// Set the entire active matrix zero.
     void setZero() {
       full().triangularView<Eigen::Upper>().setZero();
@@ -0,0 +1,49 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    parallelFor.h
+ * @brief   A parallel loop over an index range, serial without TBB
+ */
+
+#pragma once
+
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+#include <cstddef>
+
+namespace gtsam {
+
+/**
+ * Call f(i) for i in [0, n), in parallel with TBB if GTSAM is built with it,
+ * and in order otherwise. Calls for different i must be independent.
+ */
+template <class FUNCTION>
+void parallelFor(size_t n, const FUNCTION& f) {
+#ifdef GTSAM_USE_TBB
+  if (n > 1) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                      [&f](const tbb::blocked_range<size_t>& range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i)
+                          f(i);
+                      });
+    return;
+  }
+#endif
+  for (size_t i = 0; i < n; ++i) f(i);
+}
+
+}  // namespace gtsam
@@ -0,0 +1,132 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testMonotonicArena.cpp
+ * @brief   Unit tests for MonotonicArena
+ */
+
+#include <gtsam/base/MonotonicArena.h>
+#include <gtsam/base/Matrix.h>
+#include <gtsam/base/Vector.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(MonotonicArena, allocate) {
+  MonotonicArena arena(256);
+  EXPECT_LONGS_EQUAL(0, arena.capacity());
+
+  // Allocations are aligned and do not overlap
+  char* p1 = static_cast<char*>(arena.allocate(10, 16));
+  char* p2 = static_cast<char*>(arena.allocate(10, 64));
+  EXPECT_LONGS_EQUAL(0, reinterpret_cast<std::uintptr_t>(p1) % 16);
+  EXPECT_LONGS_EQUAL(0, reinterpret_cast<std::uintptr_t>(p2) % 64);
+  EXPECT(p2 >= p1 + 10 || p1 >= p2 + 10);
+  EXPECT_LONGS_EQUAL(2, arena.liveAllocations());
+  EXPECT_LONGS_EQUAL(256, arena.capacity());
+
+  // A large allocation gets a chunk of its own
+  arena.allocate(1000, 16);
+  EXPECT(arena.capacity() >= 256 + 1000);
+
+  // Cannot reset while allocations are alive
+  CHECK_EXCEPTION(arena.reset(), std::logic_error);
+  arena.deallocate(p1, 10);
+  arena.deallocate(p2, 10);
+  arena.deallocate(nullptr, 1000);
+  EXPECT_LONGS_EQUAL(0, arena.liveAllocations());
+
+  // reset keeps the chunks
+  const std::size_t capacity = arena.capacity();
+  arena.reset();
+  EXPECT_LONGS_EQUAL(0, arena.bytesUsed());
+  EXPECT_LONGS_EQUAL(capacity, arena.capacity());
+  EXPECT(static_cast<char*>(arena.allocate(10, 16)) == p1);
+}
+
+/* ************************************************************************* */
+TEST(MonotonicArena, allocateShared) {
+  MonotonicArena arena;
+  EXPECT(MonotonicArena::Current() == nullptr);
+  std::shared_ptr<Matrix3> heap = allocateShared<Matrix3>(Matrix3::Identity());
+  EXPECT_LONGS_EQUAL(0, arena.liveAllocations());
+
+  std::shared_ptr<Matrix3> inArena;
+  {
+    MonotonicArena::Scope scope(arena);
+    EXPECT(MonotonicArena::Current() == &arena);
+    inArena = allocateShared<Matrix3>(Matrix3::Identity());
+    {
+      // A nullptr scope disables the arena
+      MonotonicArena::Scope none(nullptr);
+      EXPECT(MonotonicArena::Current() == nullptr);
+    }
+    EXPECT(MonotonicArena::Current() == &arena);
+  }
+  EXPECT(MonotonicArena::Current() == nullptr);
+  EXPECT(assert_equal(Matrix(*heap), Matrix(*inArena)));
+  EXPECT_LONGS_EQUAL(1, arena.liveAllocations());
+  EXPECT(arena.bytesUsed() > 0);
+
+  inArena.reset();
+  EXPECT_LONGS_EQUAL(0, arena.liveAllocations());
+  arena.reset();
+}
+
+/* ************************************************************************* */
+TEST(MonotonicArena, outlivesArena) {
+  std::shared_ptr<Vector3> v;
+  {
+    MonotonicArena arena;
+    MonotonicArena::Scope scope(arena);
+    v = allocateShared<Vector3>(1, 2, 3);
+  }
+  // The storage is kept alive by the object
+  EXPECT(assert_equal(Vector(Vector3(1, 2, 3)), Vector(*v)));
+}
+
+/* ************************************************************************* */
+TEST(MonotonicArena, threads) {
+  MonotonicArena arena(1024);
+  const size_t nrThreads = 4, nrAllocations = 1000;
+  std::vector<std::vector<std::shared_ptr<Vector4>>> results(nrThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < nrThreads; ++t)
+    threads.emplace_back([&, t]() {
+      MonotonicArena::Scope scope(arena);
+      for (size_t i = 0; i < nrAllocations; ++i)
+        results[t].push_back(allocateShared<Vector4>(Vector4::Constant(t + i)));
+    });
+  for (std::thread& thread : threads) thread.join();
+
+  EXPECT_LONGS_EQUAL(nrThreads * nrAllocations, arena.liveAllocations());
+  for (size_t t = 0; t < nrThreads; ++t)
+    for (size_t i = 0; i < nrAllocations; ++i)
+      EXPECT(assert_equal(Vector(Vector4::Constant(t + i)),
+                          Vector(*results[t][i])));
+  results.clear();
+  arena.reset();
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -19,6 +19,7 @@
 #include <gtsam/base/TestableAssertions.h>
 #include <gtsam/base/treeTraversal-inst.h>
 
+#include <atomic>
 #include <vector>
 #include <list>
 #include <memory>
@@ -31,6 +32,8 @@ struct TestNode {
   std::vector<shared_ptr> children;
   TestNode() : data(-1) {}
   TestNode(int data) : data(data) {}
+  // Used by the legacy parallel scheduler
+  int problemSize() const { return 10 * (data + 1); }
 };
 
 struct TestForest {
@@ -146,6 +149,86 @@ TEST(treeTraversal, CloneForest)
   EXPECT(assert_container_equality(preOrderModifiedExpected, preOrder2ModActual));
 }
 
+/* ************************************************************************* */
+static double testCost(const TestNode& node) { return node.data + 1.0; }
+
+/* ************************************************************************* */
+TEST(treeTraversal, EstimateCosts)
+{
+  TestForest testForest = makeTestForest();
+  const treeTraversal::ForestCosts costs =
+      treeTraversal::EstimateCosts<TestNode>(testForest.roots(), testCost);
+
+  // Breadth-first order happens to be the order of the node data
+  LONGS_EQUAL(5, costs.nodes.size());
+  LONGS_EQUAL(2, costs.nodes[0].firstChild);
+  LONGS_EQUAL(4, costs.nodes[3].firstChild);
+  const std::vector<double> expectedSubtree{13, 2, 3, 9, 5};
+  const std::vector<double> expectedCritical{10, 2, 3, 9, 5};
+  for (size_t i = 0; i < 5; ++i) {
+    DOUBLES_EQUAL(i + 1.0, costs.nodes[i].cost, 1e-9);
+    DOUBLES_EQUAL(expectedSubtree[i], costs.nodes[i].subtreeCost, 1e-9);
+    DOUBLES_EQUAL(expectedCritical[i], costs.nodes[i].criticalPath, 1e-9);
+  }
+  DOUBLES_EQUAL(15, costs.totalCost(), 1e-9);
+  DOUBLES_EQUAL(10, costs.criticalPathCost(2), 1e-9);
+}
+
+/* ************************************************************************* */
+// Visitors that may be called concurrently, and check that parents get the
+// data of their children and children are visited before their parents.
+struct ParallelPreOrderVisitor {
+  std::atomic<bool> parentsMatched{true};
+  int operator()(const TestNode::shared_ptr& node, int parentData) {
+    const int expectedParentIndex = node->data <= 1 ? -1 : node->data == 4 ? 3 : 0;
+    if (expectedParentIndex != parentData) parentsMatched = false;
+    return node->data;
+  }
+};
+
+struct ParallelPostOrderVisitor {
+  std::vector<std::atomic<bool>> visited;
+  std::atomic<bool> childrenFirst{true};
+  ParallelPostOrderVisitor() : visited(5) {}
+  void operator()(const TestNode::shared_ptr& node, int myData) {
+    for (const auto& child : node->children)
+      if (!visited[child->data]) childrenFirst = false;
+    visited[myData] = true;
+  }
+};
+
+/* ************************************************************************* */
+TEST(treeTraversal, DepthFirstParallelCostModel)
+{
+  TestForest testForest = makeTestForest();
+
+  // Spawn tasks for every subtree, serially visit every subtree, and the legacy scheduler
+  for (double minTaskCost : {0.0, 1e9, -1.0}) {
+    treeTraversal::ParallelTraversalParams params;
+    params.useCostModel = minTaskCost >= 0.0;
+    params.minTaskCost = minTaskCost;
+    ParallelPreOrderVisitor preVisitor;
+    ParallelPostOrderVisitor postVisitor;
+    treeTraversal::ParallelTraversalStatistics statistics;
+    int rootData = -1;
+    treeTraversal::DepthFirstForestParallel(testForest, rootData, preVisitor, postVisitor,
+                                            testCost, params, &statistics);
+
+    EXPECT(preVisitor.parentsMatched);
+    EXPECT(postVisitor.childrenFirst);
+    for (const auto& visited : postVisitor.visited) EXPECT(visited);
+    LONGS_EQUAL(5, statistics.nrNodes);
+    DOUBLES_EQUAL(15, statistics.totalCost, 1e-9);
+    DOUBLES_EQUAL(10, statistics.criticalPathCost, 1e-9);
+    DOUBLES_EQUAL(1.5, statistics.maxSpeedup(), 1e-9);
+    if (params.useCostModel) {
+      double visitedCost = 0.0;
+      for (double cost : statistics.costPerThread) visitedCost += cost;
+      DOUBLES_EQUAL(15, visitedCost, 1e-9);
+    }
+  }
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
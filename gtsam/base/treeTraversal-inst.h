@@ -167,6 +167,53 @@ void DepthFirstForestParallel(FOREST& forest, DATA& rootData,
 #endif
 }
 
+/** Traverse a forest depth-first in parallel, scheduling nodes with a cost model.
+ *  @param forest, rootData, visitorPre, visitorPost See DepthFirstForestParallel above.
+ *  @param cost \c cost(node) should return the estimated cost of visiting \c node, e.g., the
+ *         flops needed to eliminate it.
+ *  @param params Scheduling parameters, if \c params.useCostModel is false this is the same
+ *         as calling DepthFirstForestParallel above with \c params.problemSizeThreshold.
+ *  @param statistics If not null, filled with statistics about the scheduling decisions.
+ */
+template<class FOREST, typename DATA, typename VISITOR_PRE,
+    typename VISITOR_POST, typename COST>
+void DepthFirstForestParallel(FOREST& forest, DATA& rootData,
+    VISITOR_PRE& visitorPre, VISITOR_POST& visitorPost, const COST& cost,
+    const ParallelTraversalParams& params,
+    ParallelTraversalStatistics* statistics = nullptr) {
+  typedef typename FOREST::Node Node;
+  if (!params.useCostModel && !statistics) {
+    DepthFirstForestParallel(forest, rootData, visitorPre, visitorPost,
+                             params.problemSizeThreshold);
+    return;
+  }
+
+  const ForestCosts costs = EstimateCosts<Node>(forest.roots(), cost);
+  if (statistics) {
+    *statistics = ParallelTraversalStatistics();
+    statistics->nrNodes = costs.nodes.size();
+    statistics->totalCost = costs.totalCost();
+    statistics->criticalPathCost = costs.criticalPathCost(forest.roots().size());
+  }
+
+#ifdef GTSAM_USE_TBB
+  if (params.useCostModel) {
+    internal::CostModelScheduler<Node, DATA, VISITOR_PRE, VISITOR_POST> scheduler(
+        costs, visitorPre, visitorPost, params, statistics);
+    scheduler.run(forest.roots(), rootData);
+    return;
+  }
+  internal::CreateRootTask<Node>(forest.roots(), rootData, visitorPre,
+      visitorPost, params.problemSizeThreshold);
+#else
+  DepthFirstForest(forest, rootData, visitorPre, visitorPost);
+  if (statistics) {
+    statistics->nrSerialSubtrees = forest.roots().size();
+    statistics->costPerThread.assign(1, statistics->totalCost);
+  }
+#endif
+}
+
 /* ************************************************************************* */
 /** Traversal function for CloneForest */
 namespace {
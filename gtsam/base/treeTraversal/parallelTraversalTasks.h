@@ -17,13 +17,20 @@
 #pragma once
 
 #include <gtsam/global_includes.h>
+#include <gtsam/base/treeTraversal/scheduling.h>
+#include <gtsam/base/treeTraversal/statistics.h>
 
 #include <memory>
 
 #ifdef GTSAM_USE_TBB
+#include <tbb/task_arena.h>         // tbb::this_task_arena
 #include <tbb/task_group.h>         // tbb::task_group
 #include <tbb/scalable_allocator.h> // tbb::scalable_allocator
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 namespace gtsam {
 
   /** Internal functions used for traversing trees */
@@ -155,6 +162,193 @@ namespace gtsam {
           tg.run_and_wait(RootTask(roots, rootData, visitorPre, visitorPost, problemSizeThreshold, tg));
       }
 
+      /* ************************************************************************* */
+      // Scheduler of DepthFirstForestParallel with a cost model, see ParallelTraversalParams
+      template<typename NODE, typename DATA, typename VISITOR_PRE, typename VISITOR_POST>
+      class CostModelScheduler
+      {
+      public:
+        typedef std::shared_ptr<DATA> sharedData;
+
+        CostModelScheduler(const ForestCosts& costs, VISITOR_PRE& visitorPre,
+                           VISITOR_POST& visitorPost, const ParallelTraversalParams& params,
+                           ParallelTraversalStatistics* statistics) :
+          costs_(costs), visitorPre_(visitorPre), visitorPost_(visitorPost), params_(params),
+          statistics_(statistics), nrTasks_(0), nrInlineTasks_(0), nrSerialSubtrees_(0)
+        {
+          if (statistics_)
+            costPerThread_.resize(tbb::this_task_arena::max_concurrency(), 0.0);
+        }
+
+        // Visit the trees rooted at the given nodes, whose cost indices start at firstIndex
+        template<typename CHILDREN>
+        void run(const CHILDREN& roots, DATA& rootData)
+        {
+          {
+            tbb::task_group tg;
+            visitChildren(roots, 0, rootData, tg);
+            tg.wait();
+          }
+          if (statistics_) {
+            statistics_->nrTasks = nrTasks_;
+            statistics_->nrInlineTasks = nrInlineTasks_;
+            statistics_->nrSerialSubtrees = nrSerialSubtrees_;
+            statistics_->costPerThread = costPerThread_;
+          }
+        }
+
+      private:
+        // A child to visit, with its data and its index in costs_
+        struct Item {
+          const std::shared_ptr<NODE>* node;
+          sharedData data;
+          size_t index;
+        };
+
+        // Task that visits a subtree, spawning tasks for its children
+        class Task
+        {
+        public:
+          CostModelScheduler& scheduler;
+          Item item;
+          tbb::task_group& tg;
+          mutable bool isPostOrderPhase;
+
+          Task(CostModelScheduler& scheduler, const Item& item, tbb::task_group& tg) :
+            scheduler(scheduler), item(item), tg(tg), isPostOrderPhase(false) {}
+
+          void operator()() const
+          {
+            const std::shared_ptr<NODE>& node = *item.node;
+            if (!isPostOrderPhase && !node->children.empty())
+            {
+              tbb::task_group ctg;
+              scheduler.visitChildren(node->children,
+                                      scheduler.costs_.nodes[item.index].firstChild, *item.data, ctg);
+              ctg.wait();
+
+              // Allocate post-order task as a continuation
+              isPostOrderPhase = true;
+              tg.run(*this);
+            }
+            else
+            {
+              scheduler.visitPost(node, *item.data, item.index);
+            }
+          }
+        };
+
+        // Task that visits a batch of cheap subtrees serially
+        class SerialTask
+        {
+        public:
+          CostModelScheduler& scheduler;
+          std::vector<Item> items;
+
+          SerialTask(CostModelScheduler& scheduler, std::vector<Item>&& items) :
+            scheduler(scheduler), items(std::move(items)) {}
+
+          void operator()() const
+          {
+            for (const Item& item : items)
+              scheduler.processNodeRecursively(*item.node, *item.data, item.index);
+          }
+        };
+
+        // Run the pre-order visitor on all children in their natural order, then
+        // schedule them by cost
+        template<typename CHILDREN>
+        void visitChildren(const CHILDREN& children, size_t firstIndex, DATA& parentData,
+                           tbb::task_group& tg)
+        {
+          // Important: run all pre-order visitors before spawning any task, so
+          // that if a visitor throws, no task is left running.
+          std::vector<Item> items;
+          items.reserve(children.size());
+          for (size_t i = 0; i < children.size(); ++i)
+            items.push_back({&children[i], std::allocate_shared<DATA>(
+                tbb::scalable_allocator<DATA>(), visitorPre_(children[i], parentData)),
+                firstIndex + i});
+
+          if (params_.prioritizeCriticalPath)
+            std::stable_sort(items.begin(), items.end(), [this](const Item& a, const Item& b) {
+              return costs_.nodes[a.index].criticalPath > costs_.nodes[b.index].criticalPath;
+            });
+
+          // Spawn expensive children in their own tasks, and batch cheap ones
+          std::vector<Item> batch;
+          double batchCost = 0.0;
+          const Item* inlineItem = nullptr;
+          for (const Item& item : items)
+          {
+            const double subtreeCost = costs_.nodes[item.index].subtreeCost;
+            if (subtreeCost < params_.minTaskCost)
+            {
+              ++nrSerialSubtrees_;
+              batch.push_back(item);
+              batchCost += subtreeCost;
+              if (batchCost >= params_.minTaskCost) {
+                spawnSerial(std::move(batch), tg);
+                batch.clear();
+                batchCost = 0.0;
+              }
+            }
+            else if (params_.prioritizeCriticalPath && !inlineItem)
+            {
+              inlineItem = &item;  // Visited below, in this task
+            }
+            else
+            {
+              ++nrTasks_;
+              tg.run(Task(*this, item, tg));
+            }
+          }
+          if (!batch.empty()) spawnSerial(std::move(batch), tg);
+
+          // Continue down the critical path in this task
+          if (inlineItem) {
+            ++nrInlineTasks_;
+            Task(*this, *inlineItem, tg)();
+          }
+        }
+
+        void spawnSerial(std::vector<Item>&& batch, tbb::task_group& tg)
+        {
+          ++nrTasks_;
+          tg.run(SerialTask(*this, std::move(batch)));
+        }
+
+        void processNodeRecursively(const std::shared_ptr<NODE>& node, DATA& myData,
+                                    size_t index)
+        {
+          const size_t firstChild = costs_.nodes[index].firstChild;
+          for (size_t i = 0; i < node->children.size(); ++i)
+          {
+            DATA childData = visitorPre_(node->children[i], myData);
+            processNodeRecursively(node->children[i], childData, firstChild + i);
+          }
+          visitPost(node, myData, index);
+        }
+
+        void visitPost(const std::shared_ptr<NODE>& node, DATA& myData, size_t index)
+        {
+          (void) visitorPost_(node, myData);
+          if (statistics_) {
+            const int thread = tbb::this_task_arena::current_thread_index();
+            if (thread >= 0 && size_t(thread) < costPerThread_.size())
+              costPerThread_[thread] += costs_.nodes[index].cost;
+          }
+        }
+
+        const ForestCosts& costs_;
+        VISITOR_PRE& visitorPre_;
+        VISITOR_POST& visitorPost_;
+        const ParallelTraversalParams& params_;
+        ParallelTraversalStatistics* statistics_;
+        std::atomic<size_t> nrTasks_, nrInlineTasks_, nrSerialSubtrees_;
+        std::vector<double> costPerThread_;  // Each entry is only written by its own thread
+      };
+
     }
 
   }
@@ -0,0 +1,119 @@
+/* ----------------------------------------------------------------------------
+
+* GTSAM Copyright 2010, Georgia Tech Research Corporation,
+* Atlanta, Georgia 30332-0415
+* All Rights Reserved
+* Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+* See LICENSE for the license information
+
+* -------------------------------------------------------------------------- */
+
+/**
+* @file    scheduling.h
+* @brief   Parameters and cost estimates for the cost-model scheduler of
+*          DepthFirstForestParallel
+*/
+#pragma once
+
+#include <gtsam/global_includes.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace gtsam {
+
+  namespace treeTraversal {
+
+    /* ************************************************************************* */
+    /**
+     * Parameters of DepthFirstForestParallel.
+     *
+     * With the cost model, every node gets an estimated cost, e.g. the flops of
+     * eliminating a clique. Subtrees cheaper than \c minTaskCost are traversed
+     * serially in one task, and children are scheduled by the cost of their
+     * critical path, i.e. the most expensive path from the child to a leaf.
+     */
+    struct ParallelTraversalParams {
+      /// Use the cost model. If false, the children of every node with
+      /// problemSize() >= problemSizeThreshold are traversed in their own tasks.
+      bool useCostModel = true;
+
+      /// Threshold on node problem size, used if useCostModel is false
+      int problemSizeThreshold = 10;
+
+      /// Subtrees with a smaller estimated cost are traversed serially in a
+      /// single task. Cheap siblings are batched into tasks of at least this cost.
+      double minTaskCost = 1000.0;
+
+      /// Visit the child with the most expensive critical path in the current
+      /// task, and spawn its siblings in order of decreasing critical path so
+      /// that idle threads steal the most expensive work first.
+      bool prioritizeCriticalPath = true;
+    };
+
+    /* ************************************************************************* */
+    /// Estimated costs of the nodes of a forest, in breadth-first order
+    struct ForestCosts {
+      struct Node {
+        size_t firstChild;    ///< Index of the first child, children are contiguous
+        double cost;          ///< Estimated cost of the node itself
+        double subtreeCost;   ///< Estimated cost of the subtree rooted at the node
+        double criticalPath;  ///< Estimated cost of the most expensive path to a leaf
+      };
+      std::vector<Node> nodes;  ///< Roots come first, at indices 0..nrRoots-1
+
+      /// Total estimated cost of the forest
+      double totalCost() const {
+        double total = 0.0;
+        for (const Node& node : nodes) total += node.cost;
+        return total;
+      }
+
+      /// Estimated cost of the most expensive root-to-leaf path
+      double criticalPathCost(size_t nrRoots) const {
+        double longest = 0.0;
+        for (size_t i = 0; i < nrRoots; ++i)
+          longest = std::max(longest, nodes[i].criticalPath);
+        return longest;
+      }
+    };
+
+    /* ************************************************************************* */
+    /// Estimate the cost of every node of a forest with \c cost(node), and
+    /// accumulate subtree and critical path costs.
+    template<class NODE, class ROOTS, class COST>
+    ForestCosts EstimateCosts(const ROOTS& roots, const COST& cost)
+    {
+      ForestCosts costs;
+      std::vector<const NODE*> order;
+      order.reserve(roots.size());
+      for (const auto& root : roots) order.push_back(root.get());
+
+      // Number the nodes breadth-first, so the children of a node are contiguous
+      costs.nodes.reserve(order.size());
+      for (size_t i = 0; i < order.size(); ++i) {
+        const NODE* node = order[i];
+        const double nodeCost = cost(*node);
+        costs.nodes.push_back({order.size(), nodeCost, nodeCost, nodeCost});
+        for (const auto& child : node->children) order.push_back(child.get());
+      }
+
+      // Accumulate from the leaves up
+      for (size_t i = order.size(); i-- > 0;) {
+        ForestCosts::Node& node = costs.nodes[i];
+        double longestChild = 0.0;
+        for (size_t c = 0; c < order[i]->children.size(); ++c) {
+          const ForestCosts::Node& child = costs.nodes[node.firstChild + c];
+          node.subtreeCost += child.subtreeCost;
+          longestChild = std::max(longestChild, child.criticalPath);
+        }
+        node.criticalPath += longestChild;
+      }
+      return costs;
+    }
+
+  }
+
+}
@@ -20,7 +20,9 @@
 #include <gtsam/global_includes.h>
 #include <gtsam/base/FastMap.h>
 
+#include <algorithm>
 #include <ostream>
+#include <vector>
 
 namespace gtsam {
 
@@ -52,6 +54,52 @@ namespace gtsam {
       }
     };
 
+    /* ************************************************************************* */
+    /// Scheduling decisions of DepthFirstForestParallel with the cost model, see
+    /// ParallelTraversalParams. Costs are in the units of the cost estimate.
+    struct ParallelTraversalStatistics
+    {
+      size_t nrNodes = 0;           ///< Number of nodes visited
+      size_t nrTasks = 0;           ///< Number of tasks spawned
+      size_t nrInlineTasks = 0;     ///< Number of critical-path children visited in the parent's task
+      size_t nrSerialSubtrees = 0;  ///< Number of subtrees below minTaskCost, visited serially
+      double totalCost = 0.0;       ///< Estimated cost of all nodes
+      double criticalPathCost = 0.0;  ///< Estimated cost of the most expensive root-to-leaf path
+      std::vector<double> costPerThread;  ///< Estimated cost of the nodes visited by each thread
+
+      /// Upper bound on the speedup of the traversal, from the critical path
+      double maxSpeedup() const
+      {
+        return criticalPathCost > 0.0 ? totalCost / criticalPathCost : 1.0;
+      }
+
+      /// Number of threads that visited at least one node
+      size_t nrThreadsUsed() const
+      {
+        return std::count_if(costPerThread.begin(), costPerThread.end(),
+                             [](double cost) { return cost > 0.0; });
+      }
+
+      /// Average load of the threads used, relative to the busiest one
+      double utilization() const
+      {
+        const double busiest = costPerThread.empty() ? 0.0 :
+            *std::max_element(costPerThread.begin(), costPerThread.end());
+        return busiest > 0.0 ? totalCost / (busiest * nrThreadsUsed()) : 1.0;
+      }
+
+      void print(std::ostream& outStream) const
+      {
+        outStream << "nodes: " << nrNodes << ", tasks: " << nrTasks
+                  << ", inline tasks: " << nrInlineTasks
+                  << ", serial subtrees: " << nrSerialSubtrees << "\n"
+                  << "total cost: " << totalCost << ", critical path: " << criticalPathCost
+                  << ", max speedup: " << maxSpeedup() << "\n"
+                  << "threads used: " << nrThreadsUsed() << ", utilization: "
+                  << utilization() << "\n";
+      }
+    };
+
     /* ************************************************************************* */
     namespace internal {
       template<class NODE>
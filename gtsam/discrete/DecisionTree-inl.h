@@ -24,12 +24,16 @@
 #include <algorithm>
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <optional>
 #include <cassert>
@@ -45,6 +49,12 @@ namespace gtsam {
   int DecisionTree<L, Y>::Node::nrNodes = 0;
 #endif
 
+  /****************************************************************************/
+  // Unique table, defined below
+  /****************************************************************************/
+  template <typename L, typename Y>
+  class UniqueNodes;
+
   /****************************************************************************/
   // Leaf
   /****************************************************************************/
@@ -65,6 +75,14 @@ namespace gtsam {
     Leaf(const Y& constant, size_t nrAssignments = 1)
         : constant_(constant), nrAssignments_(nrAssignments) {}
 
+    /// Create a leaf, or share an identical one in table, see UniqueNodes
+    static NodePtr Unique(
+        const Y& constant, size_t nrAssignments = 1,
+        UniqueNodes<L, Y>* table = UniqueNodes<L, Y>::Current()) {
+      if (table) return table->leaf(constant, nrAssignments);
+      return std::make_shared<const Leaf>(constant, nrAssignments);
+    }
+
     /// Return the constant
     const Y& constant() const {
       return constant_;
@@ -112,43 +130,10 @@ namespace gtsam {
       return constant_;
     }
 
-    /** apply unary operator */
-    NodePtr apply(const Unary& op) const override {
-      NodePtr f(new Leaf(op(constant_), nrAssignments_));
-      return f;
-    }
-
     /// Apply unary operator with assignment
     NodePtr apply(const UnaryAssignment& op,
                   const Assignment<L>& assignment) const override {
-      NodePtr f(new Leaf(op(assignment, constant_), nrAssignments_));
-      return f;
-    }
-
-    // Apply binary operator "h = f op g" on Leaf node
-    // Note op is not assumed commutative so we need to keep track of order
-    // Simply calls apply on argument to call correct virtual method:
-    // fL.apply_f_op_g(gL) -> gL.apply_g_op_fL(fL) (below)
-    // fL.apply_f_op_g(gC) -> gC.apply_g_op_fL(fL) (Choice)
-    NodePtr apply_f_op_g(const Node& g, const Binary& op) const override {
-      return g.apply_g_op_fL(*this, op);
-    }
-
-    // Applying binary operator to two leaves results in a leaf
-    NodePtr apply_g_op_fL(const Leaf& fL, const Binary& op) const override {
-      // fL op gL
-      NodePtr h(new Leaf(op(fL.constant_, constant_), nrAssignments_));
-      return h;
-    }
-
-    // If second argument is a Choice node, call it's apply with leaf as second
-    NodePtr apply_g_op_fC(const Choice& fC, const Binary& op) const override {
-      return fC.apply_fC_op_gL(*this, op);  // operand order back to normal
-    }
-
-    /** choose a branch, create new memory ! */
-    NodePtr choose(const L& label, size_t index) const override {
-      return NodePtr(new Leaf(constant(), nrAssignments()));
+      return Unique(op(assignment, constant_), nrAssignments_);
     }
 
     bool isLeaf() const override { return true; }
@@ -200,7 +185,10 @@ namespace gtsam {
     }
 
     /// If all branches of a choice node f are the same, just return a branch.
-    static NodePtr Unique(const ChoicePtr& f) {
+    /// Otherwise return f, or an identical node in table, see UniqueNodes.
+    static NodePtr Unique(
+        const ChoicePtr& f,
+        UniqueNodes<L, Y>* table = UniqueNodes<L, Y>::Current()) {
 #ifndef GTSAM_DT_NO_PRUNING
       if (f->allSame_) {
         assert(f->branches().size() > 0);
@@ -212,13 +200,12 @@ namespace gtsam {
           nrAssignments +=
               std::dynamic_pointer_cast<const Leaf>(branch)->nrAssignments();
         }
-        NodePtr newLeaf(
-            new Leaf(std::dynamic_pointer_cast<const Leaf>(f0)->constant(),
-                     nrAssignments));
-        return newLeaf;
+        return Leaf::Unique(
+            std::dynamic_pointer_cast<const Leaf>(f0)->constant(),
+            nrAssignments, table);
       } else
 #endif
-        return f;
+        return table ? table->choice(f) : f;
     }
 
     bool isLeaf() const override { return false; }
@@ -229,34 +216,6 @@ namespace gtsam {
       branches_.reserve(count);
     }
 
-    /// Construct from applying binary op to two Choice nodes.
-    Choice(const Choice& f, const Choice& g, const Binary& op) :
-      allSame_(true) {
-      // Choose what to do based on label
-      if (f.label() > g.label()) {
-        // f higher than g
-        label_ = f.label();
-        size_t count = f.nrChoices();
-        branches_.reserve(count);
-        for (size_t i = 0; i < count; i++)
-          push_back(f.branches_[i]->apply_f_op_g(g, op));
-      } else if (g.label() > f.label()) {
-        // f lower than g
-        label_ = g.label();
-        size_t count = g.nrChoices();
-        branches_.reserve(count);
-        for (size_t i = 0; i < count; i++)
-          push_back(g.branches_[i]->apply_g_op_fC(f, op));
-      } else {
-        // f same level as g
-        label_ = f.label();
-        size_t count = f.nrChoices();
-        branches_.reserve(count);
-        for (size_t i = 0; i < count; i++)
-          push_back(f.branches_[i]->apply_f_op_g(*g.branches_[i], op));
-      }
-    }
-
     /// Return the label of this choice node.
     const L& label() const {
       return label_;
@@ -274,7 +233,8 @@ namespace gtsam {
     void push_back(const NodePtr& node) {
       // allSame_ is restricted to leaf nodes in a decision tree
       if (allSame_ && !branches_.empty()) {
-        allSame_ = node->sameLeaf(*branches_.back());
+        allSame_ = node->isLeaf() && (node == branches_.back() ||
+                                      node->sameLeaf(*branches_.back()));
       }
       branches_.push_back(node);
     }
@@ -324,6 +284,7 @@ namespace gtsam {
 
     /// equality
     bool equals(const Node& q, const CompareFunc& compare) const override {
+      if (this == &q) return true;  // shared subtree
       const Choice* other = dynamic_cast<const Choice*>(&q);
       if (!other) return false;
       if (this->label_ != other->label_) return false;
@@ -350,15 +311,6 @@ namespace gtsam {
       return (*child)(x);
     }
 
-    /// Construct from applying unary op to a Choice node.
-    Choice(const L& label, const Choice& f, const Unary& op) :
-      label_(label), allSame_(true) {
-      branches_.reserve(f.branches_.size());  // reserve space
-      for (const NodePtr& branch : f.branches_) {
-        push_back(branch->apply(op));
-      }
-    }
-
     /**
      * @brief Constructor which accepts a UnaryAssignment op and the
      * corresponding assignment.
@@ -388,12 +340,6 @@ namespace gtsam {
       }
     }
 
-    /// apply unary operator.
-    NodePtr apply(const Unary& op) const override {
-      auto r = std::make_shared<Choice>(label_, *this, op);
-      return Unique(r);
-    }
-
     /// Apply unary operator with assignment
     NodePtr apply(const UnaryAssignment& op,
                   const Assignment<L>& assignment) const override {
@@ -401,49 +347,6 @@ namespace gtsam {
       return Unique(r);
     }
 
-    // Apply binary operator "h = f op g" on Choice node
-    // Note op is not assumed commutative so we need to keep track of order
-    // Simply calls apply on argument to call correct virtual method:
-    // fC.apply_f_op_g(gL) -> gL.apply_g_op_fC(fC) -> (Leaf)
-    // fC.apply_f_op_g(gC) -> gC.apply_g_op_fC(fC) -> (below)
-    NodePtr apply_f_op_g(const Node& g, const Binary& op) const override {
-      return g.apply_g_op_fC(*this, op);
-    }
-
-    // If second argument of binary op is Leaf node, recurse on branches
-    NodePtr apply_g_op_fL(const Leaf& fL, const Binary& op) const override {
-      auto h = std::make_shared<Choice>(label(), nrChoices());
-      for (auto&& branch : branches_)
-        h->push_back(fL.apply_f_op_g(*branch, op));
-      return Unique(h);
-    }
-
-    // If second argument of binary op is Choice, call constructor
-    NodePtr apply_g_op_fC(const Choice& fC, const Binary& op) const override {
-      auto h = std::make_shared<Choice>(fC, *this, op);
-      return Unique(h);
-    }
-
-    // If second argument of binary op is Leaf
-    template<typename OP>
-    NodePtr apply_fC_op_gL(const Leaf& gL, OP op) const {
-      auto h = std::make_shared<Choice>(label(), nrChoices());
-      for (auto&& branch : branches_)
-        h->push_back(branch->apply_f_op_g(gL, op));
-      return Unique(h);
-    }
-
-    /** choose a branch, recursively */
-    NodePtr choose(const L& label, size_t index) const override {
-      if (label_ == label) return branches_[index];  // choose branch
-
-      // second case, not label of interest, just recurse
-      auto r = std::make_shared<Choice>(label_, branches_.size());
-      for (auto&& branch : branches_)
-        r->push_back(branch->choose(label, index));
-      return Unique(r);
-    }
-
    private:
     using Base = DecisionTree<L, Y>::Node;
 
@@ -460,6 +363,408 @@ namespace gtsam {
 #endif
   };  // Choice
 
+  /****************************************************************************/
+  // UniqueNodes
+  /****************************************************************************/
+  /// Whether std::hash is enabled for T
+  template <typename T, typename = void>
+  struct IsHashable : std::false_type {};
+
+  template <typename T>
+  struct IsHashable<
+      T, std::void_t<decltype(std::hash<T>()(std::declval<const T&>()))>>
+      : std::true_type {};
+
+  /**
+   * Unique table as in algebraic decision diagrams: while a UniqueNodes scope
+   * is open on this thread, every node is created through the table, which
+   * returns an existing node if an identical one was created before, so the
+   * result of an operation shares identical subtrees rather than copying them.
+   *
+   * Choice nodes are identical if they have the same label and the very same
+   * branches. Leaves are identical if they have the same value and number of
+   * assignments; they are only shared when Y can be hashed with std::hash.
+   * Because branches are compared by pointer, sharing the leaves is what lets
+   * whole subtrees be shared.
+   *
+   * The table lives as long as the outermost scope, i.e., one top-level
+   * operation such as apply, choose or construction from a table of values:
+   * it stays small, needs no locking, and only holds on to nodes while the
+   * operation runs.
+   */
+  template <typename L, typename Y>
+  class UniqueNodes {
+    using NodePtr = typename DecisionTree<L, Y>::NodePtr;
+    using Leaf = typename DecisionTree<L, Y>::Leaf;
+    using Choice = typename DecisionTree<L, Y>::Choice;
+
+    /**
+     * Open-addressing hash set of nodes, keeping the nodes alive. Sharing has
+     * a cost for every node created, so a table that finds hardly any
+     * identical nodes once it has grown a bit switches itself off.
+     */
+    template <class NODE>
+    class Table {
+      std::vector<std::pair<size_t, std::shared_ptr<const NODE>>> slots_;
+      size_t size_ = 0, hits_ = 0;
+      bool active_ = true;
+
+     public:
+      /// Whether the table still looks for identical nodes
+      bool active() const { return active_; }
+
+      /// Stop looking for identical nodes, and release the ones held
+      void deactivate() {
+        active_ = false;
+        slots_.clear();
+        slots_.shrink_to_fit();
+      }
+
+      /// Return the node equal to the one \c make would create, or create it
+      template <class EQUAL, class MAKE>
+      std::shared_ptr<const NODE> insert(size_t hash, const EQUAL& equal,
+                                         const MAKE& make) {
+        if (2 * (size_ + 1) > slots_.size()) {
+          // Fewer than one in eight nodes shared so far: stop looking
+          if (size_ >= 32 && hits_ < size_ / 8) {
+            deactivate();
+            return make();
+          }
+          grow();
+        }
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+          auto& slot = slots_[i];
+          if (!slot.second) {
+            slot.first = hash;
+            slot.second = make();
+            ++size_;
+            return slot.second;
+          }
+          if (slot.first == hash && equal(*slot.second)) {
+            ++hits_;
+            return slot.second;
+          }
+        }
+      }
+
+     private:
+      void grow() {
+        std::vector<std::pair<size_t, std::shared_ptr<const NODE>>> old(
+            std::max<size_t>(16, 2 * slots_.size()));
+        old.swap(slots_);
+        const size_t mask = slots_.size() - 1;
+        for (auto& slot : old) {
+          if (!slot.second) continue;
+          size_t i = slot.first & mask;
+          while (slots_[i].second) i = (i + 1) & mask;
+          slots_[i] = std::move(slot);
+        }
+      }
+    };
+
+    Table<Leaf> leaves_;
+    Table<Choice> choices_;
+    bool outermost_;
+
+    static UniqueNodes*& current() {
+      static thread_local UniqueNodes* current = nullptr;
+      return current;
+    }
+
+    /// Mix the bits of a hash, as std::hash is the identity for integers
+    static size_t Mix(size_t h) {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    /// Hash a leaf value, cheaply by its bits if it is a double
+    static size_t HashValue(const Y& y) {
+      if constexpr (std::is_same<Y, double>::value) {
+        uint64_t bits;
+        std::memcpy(&bits, &y, sizeof(bits));
+        return bits;
+      } else {
+        return std::hash<Y>()(y);
+      }
+    }
+
+   public:
+    /// Open a scope, or join the one already open on this thread
+    UniqueNodes() : outermost_(current() == nullptr) {
+      if (outermost_) current() = this;
+    }
+
+    ~UniqueNodes() {
+      if (outermost_) current() = nullptr;
+    }
+
+    UniqueNodes(const UniqueNodes&) = delete;
+    UniqueNodes& operator=(const UniqueNodes&) = delete;
+
+    /// The table of the scope open on this thread, or null
+    static UniqueNodes* Current() { return current(); }
+
+    /// Create a leaf, or return an identical one
+    NodePtr leaf(const Y& constant, size_t nrAssignments) {
+      if constexpr (IsHashable<Y>::value) {
+        if (!leaves_.active())
+          return std::make_shared<const Leaf>(constant, nrAssignments);
+        const size_t hash = Mix(HashValue(constant) * 31 + nrAssignments);
+        return leaves_.insert(
+            hash,
+            [&](const Leaf& leaf) {
+              return leaf.nrAssignments() == nrAssignments &&
+                     leaf.constant() == constant;
+            },
+            [&] {
+              return std::make_shared<const Leaf>(constant, nrAssignments);
+            });
+      }
+      return std::make_shared<const Leaf>(constant, nrAssignments);
+    }
+
+    /// Return node, or an identical choice node
+    NodePtr choice(const std::shared_ptr<const Choice>& node) {
+      if (!choices_.active()) return node;
+      size_t hash = node->nrChoices();
+      for (const NodePtr& branch : node->branches())
+        hash = hash * 31 + reinterpret_cast<size_t>(branch.get());
+      NodePtr unique = choices_.insert(
+          Mix(hash),
+          [&](const Choice& other) {
+            return other.label() == node->label() &&
+                   other.branches() == node->branches();
+          },
+          [&] { return node; });
+      // Sharing leaves only pays off if it lets choice nodes be shared
+      if (!choices_.active() && leaves_.active()) leaves_.deactivate();
+      return unique;
+    }
+  };
+
+  /****************************************************************************/
+  // Memoized operations
+  /****************************************************************************/
+  /*
+   * The functors below cache their results only for nodes that can be reached
+   * along more than one path, i.e., nodes at or below a branch with more than
+   * one owner: in a tree without sharing, the cache would never be hit and
+   * would only slow down the operation. The root is not checked, as it is
+   * reached only once however many trees own it, and it is owned by more than
+   * one as soon as a tree is copied, or is a branch chosen from another.
+   */
+
+  /**
+   * Results of an operation for a node, or a pair of nodes, in a flat table.
+   * Like the unique table, it switches itself off if it is hardly ever hit.
+   */
+  template <typename L, typename Y>
+  class NodeCache {
+    using NodePtr = typename DecisionTree<L, Y>::NodePtr;
+    using Node = typename DecisionTree<L, Y>::Node;
+
+    struct Slot {
+      const Node* f = nullptr;
+      const Node* g = nullptr;
+      NodePtr h;
+    };
+    std::vector<Slot> slots_;
+    size_t size_ = 0, hits_ = 0;
+    bool active_ = true;
+
+    size_t index(const Node* f, const Node* g) const {
+      size_t hash = reinterpret_cast<size_t>(f) * 0x9e3779b97f4a7c15ULL ^
+                    reinterpret_cast<size_t>(g) * 0xc2b2ae3d27d4eb4fULL;
+      return (hash ^ (hash >> 29)) & (slots_.size() - 1);
+    }
+
+   public:
+    /// Return the cached result for (f, g), or null
+    const NodePtr* find(const Node* f, const Node* g = nullptr) {
+      if (slots_.empty()) return nullptr;
+      const size_t mask = slots_.size() - 1;
+      for (size_t i = index(f, g);; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (!slot.f) return nullptr;
+        if (slot.f == f && slot.g == g) {
+          ++hits_;
+          return &slot.h;
+        }
+      }
+    }
+
+    /// Cache the result h for (f, g), which is not in the cache yet
+    void insert(const Node* f, const Node* g, const NodePtr& h) {
+      if (!active_) return;
+      if (2 * (size_ + 1) > slots_.size()) {
+        if (size_ >= 32 && hits_ < size_ / 8) {
+          active_ = false;
+          slots_.clear();
+          slots_.shrink_to_fit();
+          return;
+        }
+        std::vector<Slot> old(std::max<size_t>(16, 2 * slots_.size()));
+        old.swap(slots_);
+        for (Slot& slot : old)
+          if (slot.f) place(std::move(slot));
+      }
+      place(Slot{f, g, h});
+      ++size_;
+    }
+
+   private:
+    void place(Slot&& slot) {
+      const size_t mask = slots_.size() - 1;
+      size_t i = index(slot.f, slot.g);
+      while (slots_[i].f) i = (i + 1) & mask;
+      slots_[i] = std::move(slot);
+    }
+  };
+
+  /**
+   * Functor applying a unary operator to every leaf. Shared subtrees are only
+   * visited once: results are cached by node for the duration of one apply.
+   */
+  template <typename L, typename Y>
+  struct ApplyUnary {
+    using NodePtr = typename DecisionTree<L, Y>::NodePtr;
+    using Node = typename DecisionTree<L, Y>::Node;
+    using Leaf = typename DecisionTree<L, Y>::Leaf;
+    using Choice = typename DecisionTree<L, Y>::Choice;
+    using Unary = typename DecisionTree<L, Y>::Unary;
+
+    explicit ApplyUnary(const Unary& op) : op(op) {}
+    const Unary& op;  ///< unary operator
+    UniqueNodes<L, Y>* table = UniqueNodes<L, Y>::Current();  ///< or null
+    NodeCache<L, Y> cache;  ///< results so far
+
+    /// Apply op to f, where shared says whether f can be reached twice
+    NodePtr operator()(const NodePtr& f, bool shared = false) {
+      if (f->isLeaf()) {
+        const auto& leaf = static_cast<const Leaf&>(*f);
+        return Leaf::Unique(op(leaf.constant()), leaf.nrAssignments(), table);
+      }
+      if (shared) {
+        if (const NodePtr* cached = cache.find(f.get())) return *cached;
+      }
+
+      const auto& choice = static_cast<const Choice&>(*f);
+      auto r = std::make_shared<Choice>(choice.label(), choice.nrChoices());
+      for (const NodePtr& branch : choice.branches())
+        r->push_back((*this)(branch, shared || branch.use_count() > 1));
+      NodePtr h = Choice::Unique(r, table);
+      if (shared) cache.insert(f.get(), nullptr, h);
+      return h;
+    }
+  };
+
+  /**
+   * Functor applying a binary operator "h = f op g", which is not assumed to
+   * be commutative. The result is cached for every pair of nodes visited, so
+   * the work is proportional to the number of distinct pairs of nodes rather
+   * than the number of paths, which is what sharing subtrees pays off for.
+   */
+  template <typename L, typename Y>
+  struct ApplyBinary {
+    using NodePtr = typename DecisionTree<L, Y>::NodePtr;
+    using Node = typename DecisionTree<L, Y>::Node;
+    using Leaf = typename DecisionTree<L, Y>::Leaf;
+    using Choice = typename DecisionTree<L, Y>::Choice;
+    using Binary = typename DecisionTree<L, Y>::Binary;
+
+    explicit ApplyBinary(const Binary& op) : op(op) {}
+    const Binary& op;  ///< binary operator
+    UniqueNodes<L, Y>* table = UniqueNodes<L, Y>::Current();  ///< or null
+    NodeCache<L, Y> cache;  ///< results so far
+
+    /// Apply op to f and g, where fShared and gShared say whether f and g
+    /// can be reached twice
+    NodePtr operator()(const NodePtr& f, const NodePtr& g,
+                       bool fShared = false, bool gShared = false) {
+      // Two leaves: the leaf keeps the number of assignments of g
+      const bool fLeaf = f->isLeaf(), gLeaf = g->isLeaf();
+      if (fLeaf && gLeaf) {
+        const auto& fL = static_cast<const Leaf&>(*f);
+        const auto& gL = static_cast<const Leaf&>(*g);
+        return Leaf::Unique(op(fL.constant(), gL.constant()),
+                            gL.nrAssignments(), table);
+      }
+
+      // The pair can only be reached twice if f or g can
+      const bool memoize = fShared || gShared;
+      if (memoize) {
+        if (const NodePtr* cached = cache.find(f.get(), g.get())) return *cached;
+      }
+
+      // Split on the highest label, recursing on the branches of f, of g, or
+      // of both if they split on the same label
+      const Choice* fC = fLeaf ? nullptr : static_cast<const Choice*>(f.get());
+      const Choice* gC = gLeaf ? nullptr : static_cast<const Choice*>(g.get());
+      std::shared_ptr<Choice> h;
+      if (fC && (!gC || fC->label() > gC->label())) {
+        h = std::make_shared<Choice>(fC->label(), fC->nrChoices());
+        for (const NodePtr& branch : fC->branches())
+          h->push_back((*this)(branch, g, fShared || branch.use_count() > 1,
+                               gShared));
+      } else if (gC && (!fC || gC->label() > fC->label())) {
+        h = std::make_shared<Choice>(gC->label(), gC->nrChoices());
+        for (const NodePtr& branch : gC->branches())
+          h->push_back((*this)(f, branch, fShared,
+                               gShared || branch.use_count() > 1));
+      } else {
+        h = std::make_shared<Choice>(fC->label(), fC->nrChoices());
+        for (size_t i = 0; i < fC->nrChoices(); i++) {
+          const NodePtr& fi = fC->branches()[i];
+          const NodePtr& gi = gC->branches()[i];
+          h->push_back((*this)(fi, gi, fShared || fi.use_count() > 1,
+                               gShared || gi.use_count() > 1));
+        }
+      }
+      NodePtr result = Choice::Unique(h, table);
+      if (memoize) cache.insert(f.get(), g.get(), result);
+      return result;
+    }
+  };
+
+  /**
+   * Functor restricting a tree to label == index, with results cached by node
+   * so shared subtrees are restricted only once.
+   */
+  template <typename L, typename Y>
+  struct ChooseBranch {
+    using NodePtr = typename DecisionTree<L, Y>::NodePtr;
+    using Node = typename DecisionTree<L, Y>::Node;
+    using Choice = typename DecisionTree<L, Y>::Choice;
+
+    ChooseBranch(const L& label, size_t index) : label(label), index(index) {}
+    const L& label;  ///< label to restrict
+    size_t index;    ///< value of the label
+    UniqueNodes<L, Y>* table = UniqueNodes<L, Y>::Current();  ///< or null
+    NodeCache<L, Y> cache;  ///< results so far
+
+    /// Restrict f, where shared says whether f can be reached twice
+    NodePtr operator()(const NodePtr& f, bool shared = false) {
+      if (f->isLeaf()) return f;
+      const auto& choice = static_cast<const Choice&>(*f);
+      if (choice.label() == label) return choice.branches()[index];
+      // Labels decrease towards the leaves, so label does not occur below
+      if (choice.label() < label) return f;
+
+      if (shared) {
+        if (const NodePtr* cached = cache.find(f.get())) return *cached;
+      }
+      auto r = std::make_shared<Choice>(choice.label(), choice.nrChoices());
+      for (const NodePtr& branch : choice.branches())
+        r->push_back((*this)(branch, shared || branch.use_count() > 1));
+      NodePtr h = Choice::Unique(r, table);
+      if (shared) cache.insert(f.get(), nullptr, h);
+      return h;
+    }
+  };
+
   /****************************************************************************/
   // DecisionTree
   /****************************************************************************/
@@ -475,16 +780,15 @@ namespace gtsam {
   /****************************************************************************/
   template<typename L, typename Y>
   DecisionTree<L, Y>::DecisionTree(const Y& y)  {
-    root_ = NodePtr(new Leaf(y));
+    root_ = Leaf::Unique(y);
   }
 
   /****************************************************************************/
   template <typename L, typename Y>
   DecisionTree<L, Y>::DecisionTree(const L& label, const Y& y1, const Y& y2) {
     auto a = std::make_shared<Choice>(label, 2);
-    NodePtr l1(new Leaf(y1)), l2(new Leaf(y2));
-    a->push_back(l1);
-    a->push_back(l2);
+    a->push_back(Leaf::Unique(y1));
+    a->push_back(Leaf::Unique(y2));
     root_ = Choice::Unique(a);
   }
 
@@ -495,9 +799,8 @@ namespace gtsam {
     if (labelC.second != 2) throw std::invalid_argument(
         "DecisionTree: binary constructor called with non-binary label");
     auto a = std::make_shared<Choice>(labelC.first, 2);
-    NodePtr l1(new Leaf(y1)), l2(new Leaf(y2));
-    a->push_back(l1);
-    a->push_back(l2);
+    a->push_back(Leaf::Unique(y1));
+    a->push_back(Leaf::Unique(y2));
     root_ = Choice::Unique(a);
   }
 
@@ -567,6 +870,7 @@ namespace gtsam {
   template <typename Iterator>
   typename DecisionTree<L, Y>::NodePtr DecisionTree<L, Y>::compose(
       Iterator begin, Iterator end, const L& label) const {
+    UniqueNodes<L, Y> scope;
     // find highest label among branches
     std::optional<L> highestLabel;
     size_t nrChoices = 0;
@@ -634,6 +938,7 @@ namespace gtsam {
   template<typename It, typename ValueIt>
   typename DecisionTree<L, Y>::NodePtr DecisionTree<L, Y>::create(
       It begin, It end, ValueIt beginY, ValueIt endY) const {
+    UniqueNodes<L, Y> scope;
     // get crucial counts
     size_t nrChoices = begin->second;
     size_t size = endY - beginY;
@@ -651,7 +956,7 @@ namespace gtsam {
       }
       auto choice = std::make_shared<Choice>(begin->first, endY - beginY);
       for (ValueIt y = beginY; y != endY; y++)
-        choice->push_back(NodePtr(new Leaf(*y)));
+        choice->push_back(Leaf::Unique(*y));
       return Choice::Unique(choice);
     }
 
@@ -674,6 +979,7 @@ namespace gtsam {
       const typename DecisionTree<M, X>::NodePtr& f,
       std::function<L(const M&)> L_of_M,
       std::function<Y(const X&)> Y_of_X) const {
+    UniqueNodes<L, Y> scope;
     using LY = DecisionTree<L, Y>;
 
     // Ugliness below because apparently we can't have templated virtual
@@ -681,7 +987,7 @@ namespace gtsam {
     // If leaf, apply unary conversion "op" and create a unique leaf.
     using MXLeaf = typename DecisionTree<M, X>::Leaf;
     if (auto leaf = std::dynamic_pointer_cast<const MXLeaf>(f)) {
-      return NodePtr(new Leaf(Y_of_X(leaf->constant()), leaf->nrAssignments()));
+      return Leaf::Unique(Y_of_X(leaf->constant()), leaf->nrAssignments());
     }
 
     // Check if Choice
@@ -904,7 +1210,9 @@ namespace gtsam {
       throw std::runtime_error(
           "DecisionTree::apply(unary op) undefined for empty tree.");
     }
-    return DecisionTree(root_->apply(op));
+    UniqueNodes<L, Y> scope;
+    ApplyUnary<L, Y> applyUnary(op);
+    return DecisionTree(applyUnary(root_));
   }
 
   /// Apply unary operator with assignment
@@ -916,6 +1224,7 @@ namespace gtsam {
       throw std::runtime_error(
           "DecisionTree::apply(unary op) undefined for empty tree.");
     }
+    UniqueNodes<L, Y> scope;
     Assignment<L> assignment;
     return DecisionTree(root_->apply(op, assignment));
   }
@@ -929,11 +1238,19 @@ namespace gtsam {
       throw std::runtime_error(
           "DecisionTree::apply(binary op) undefined for empty trees.");
     }
-    // apply the operaton on the root of both diagrams
-    NodePtr h = root_->apply_f_op_g(*g.root_, op);
-    // create a new class with the resulting root "h"
-    DecisionTree result(h);
-    return result;
+    // apply the operation on the root of both diagrams
+    UniqueNodes<L, Y> scope;
+    ApplyBinary<L, Y> applyBinary(op);
+    return DecisionTree(applyBinary(root_, g.root_));
+  }
+
+  /****************************************************************************/
+  template <typename L, typename Y>
+  DecisionTree<L, Y> DecisionTree<L, Y>::choose(const L& label,
+                                                size_t index) const {
+    UniqueNodes<L, Y> scope;
+    ChooseBranch<L, Y> chooseBranch(label, index);
+    return DecisionTree(chooseBranch(root_));
   }
 
   /****************************************************************************/
@@ -57,6 +57,10 @@ namespace gtsam {
    * 
    * More examples can be found in testDecisionTree.cpp
    *
+   * Nodes are immutable and hash-consed as in algebraic decision diagrams:
+   * identical subtrees are shared, and apply/choose visit each shared subtree
+   * only once, see UniqueNodes in DecisionTree-inl.h.
+   *
    * @ingroup discrete
    */
   template<typename L, typename Y>
@@ -123,13 +127,8 @@ namespace gtsam {
       virtual bool equals(const Node& other, const CompareFunc& compare =
                                                  &DefaultCompare) const = 0;
       virtual const Y& operator()(const Assignment<L>& x) const = 0;
-      virtual Ptr apply(const Unary& op) const = 0;
       virtual Ptr apply(const UnaryAssignment& op,
                         const Assignment<L>& assignment) const = 0;
-      virtual Ptr apply_f_op_g(const Node&, const Binary&) const = 0;
-      virtual Ptr apply_g_op_fL(const Leaf&, const Binary&) const = 0;
-      virtual Ptr apply_g_op_fC(const Choice&, const Binary&) const = 0;
-      virtual Ptr choose(const L& label, size_t index) const = 0;
       virtual bool isLeaf() const = 0;
 
      private:
@@ -377,7 +376,8 @@ namespace gtsam {
     /** Retrieve all unique labels as a set. */
     std::set<L> labels() const;
 
-    /** apply Unary operation "op" to f */
+    /** apply Unary operation "op" to f, which is called once per distinct
+     * leaf of a shared subtree, so it should not have side effects */
     DecisionTree apply(const Unary& op) const;
 
     /**
@@ -390,15 +390,12 @@ namespace gtsam {
      */
     DecisionTree apply(const UnaryAssignment& op) const;
 
-    /** apply binary operation "op" to f and g */
+    /** apply binary operation "op" to f and g, memoized on pairs of nodes */
     DecisionTree apply(const DecisionTree& g, const Binary& op) const;
 
     /** create a new function where value(label)==index
      * It's like "restrict" in Darwiche09book pg329, 330? */
-    DecisionTree choose(const L& label, size_t index) const {
-      NodePtr newRoot = root_->choose(label, index);
-      return DecisionTree(newRoot);
-    }
+    DecisionTree choose(const L& label, size_t index) const;
 
     /** combine subtrees on key with binary operation "op" */
     DecisionTree combine(const L& label, size_t cardinality,
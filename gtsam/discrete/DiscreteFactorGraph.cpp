@@ -22,9 +22,12 @@
 #include <gtsam/discrete/DiscreteFactorGraph.h>
 #include <gtsam/discrete/DiscreteJunctionTree.h>
 #include <gtsam/discrete/DiscreteLookupDAG.h>
+#include <gtsam/discrete/TableFactor.h>
 #include <gtsam/inference/EliminateableFactorGraph-inst.h>
 #include <gtsam/inference/FactorGraph-inst.h>
 
+#include <optional>
+
 using std::vector;
 using std::string;
 using std::map;
@@ -110,11 +113,146 @@ namespace gtsam {
 //      }
 //  }
 
+  /* ************************************************************************ */
+  namespace {
+
+  /// Cliques whose product table is larger are always eliminated as trees.
+  constexpr size_t kMaxDenseSize = size_t(1) << 22;
+
+  /// Smallest estimated ratio of tree leaves to table entries in the product
+  /// for which a clique is eliminated as a dense table: below it, the tree
+  /// is small enough to beat the strided loops despite its cost per node.
+  constexpr double kMinDenseFill = 1.0 / 32;
+
+  /// The product of a clique's factors as a dense table.
+  struct DenseProduct {
+    /// Layout of the table: the separator keys in decreasing order, which is
+    /// the fast order to build trees in, then the frontal keys in reverse, so
+    /// the frontals are reduced as trailing axes in the order of the Ordering.
+    DiscreteKeys layout;
+    /// Layout of the separator: the separator keys in decreasing order.
+    DiscreteKeys separatorLayout;
+    /// Separator keys in increasing order, as DecisionTreeFactor::sum has them.
+    DiscreteKeys separator;
+    std::vector<double> table;
+  };
+
+  /**
+   * Multiply the factors into a dense table, normalized by its maximum as in
+   * the tree path, if the product is (close to) dense. The fill is estimated
+   * as the product of the factors' ratios of leaves (or nonzeros) to table
+   * entries, i.e., assuming their zeros and repeated values are independent.
+   */
+  std::optional<DenseProduct> MultiplyDense(const DiscreteFactorGraph& factors,
+                                            const Ordering& frontalKeys) {
+    // Other factors, e.g., constraints, are converted to trees as in the tree
+    // path, which also gives us their cardinalities.
+    std::vector<DiscreteFactor::shared_ptr> tables;
+    std::map<Key, size_t> cardinalities;
+    double fill = 1.0;
+    for (auto&& factor : factors) {
+      if (!factor) continue;
+      DiscreteFactor::shared_ptr table = factor;
+      double nrValues;
+      if (auto tree = std::dynamic_pointer_cast<DecisionTreeFactor>(factor)) {
+        nrValues = tree->nrLeaves();
+      } else if (auto sparse = std::dynamic_pointer_cast<TableFactor>(factor)) {
+        nrValues = sparse->nrNonZeros();
+      } else {
+        auto converted = std::make_shared<DecisionTreeFactor>(
+            factor->toDecisionTreeFactor());
+        nrValues = converted->nrLeaves();
+        table = converted;
+      }
+      double size = 1.0;
+      for (auto&& [key, cardinality] : table->cardinalities()) {
+        cardinalities.emplace(key, cardinality);
+        size *= cardinality;
+      }
+      fill *= nrValues / size;
+      tables.push_back(table);
+    }
+
+    double size = 1.0;
+    for (auto&& [key, cardinality] : cardinalities) size *= cardinality;
+    if (size > kMaxDenseSize || fill < kMinDenseFill) return {};
+
+    DenseProduct product;
+    for (auto it = cardinalities.rbegin(); it != cardinalities.rend(); ++it) {
+      if (std::find(frontalKeys.begin(), frontalKeys.end(), it->first) ==
+          frontalKeys.end())
+        product.separatorLayout.push_back(*it);
+    }
+    product.separator.assign(product.separatorLayout.rbegin(),
+                             product.separatorLayout.rend());
+    product.layout = product.separatorLayout;
+    for (auto it = frontalKeys.rbegin(); it != frontalKeys.rend(); ++it)
+      product.layout.emplace_back(*it, cardinalities.at(*it));
+
+    gttic(product);
+    product.table.assign(static_cast<size_t>(size), 1.0);
+    for (auto&& table : tables)
+      TableFactor::MultiplyDense(product.table, product.layout, *table);
+    gttoc(product);
+
+    // Normalize the product to prevent underflow.
+    const double normalization =
+        *std::max_element(product.table.begin(), product.table.end());
+    for (double& value : product.table)
+      value = DecisionTreeFactor::safe_div(value, normalization);
+    return product;
+  }
+
+  /// Sum or max out the frontal keys, the trailing axes of the product.
+  std::vector<double> ReduceFrontals(const DenseProduct& product,
+                                     size_t nrFrontals, bool max) {
+    std::vector<double> table = product.table;
+    for (size_t i = 0; i < nrFrontals; ++i) {
+      const size_t cardinality =
+          product.layout[product.layout.size() - 1 - i].second;
+      table = max ? TableFactor::MaxDense(table, cardinality)
+                  : TableFactor::SumDense(table, cardinality);
+    }
+    return table;
+  }
+
+  /// Keys for a conditional with the frontal keys really in front.
+  DiscreteKeys ConditionalKeys(const DenseProduct& product,
+                               size_t nrFrontals) {
+    DiscreteKeys orderedKeys;
+    orderedKeys.assign(product.layout.rbegin(),
+                       product.layout.rbegin() + nrFrontals);
+    orderedKeys.insert(orderedKeys.end(), product.separator.begin(),
+                       product.separator.end());
+    return orderedKeys;
+  }
+
+  }  // namespace
+
   /* ************************************************************************ */
   // Alternate eliminate function for MPE
   std::pair<DiscreteConditional::shared_ptr, DecisionTreeFactor::shared_ptr>  //
   EliminateForMPE(const DiscreteFactorGraph& factors,
                   const Ordering& frontalKeys) {
+    // Cliques with a (close to) dense product are eliminated as tables.
+    if (auto product = MultiplyDense(factors, frontalKeys)) {
+      const size_t nrFrontals = frontalKeys.size();
+      gttic(max);
+      auto max = std::make_shared<DecisionTreeFactor>(
+          product->separator,
+          TableFactor::DenseToTree(ReduceFrontals(*product, nrFrontals, true),
+                                   product->separatorLayout));
+      gttoc(max);
+
+      gttic(lookup);
+      auto lookup = std::make_shared<DiscreteLookupTable>(
+          nrFrontals, ConditionalKeys(*product, nrFrontals),
+          TableFactor::DenseToTree(product->table, product->layout));
+      gttoc(lookup);
+
+      return {std::dynamic_pointer_cast<DiscreteConditional>(lookup), max};
+    }
+
     // PRODUCT: multiply all factors
     gttic(product);
     DecisionTreeFactor product;
@@ -204,6 +342,30 @@ namespace gtsam {
   std::pair<DiscreteConditional::shared_ptr, DecisionTreeFactor::shared_ptr>  //
   EliminateDiscrete(const DiscreteFactorGraph& factors,
                     const Ordering& frontalKeys) {
+    // Cliques with a (close to) dense product are eliminated as tables.
+    if (auto product = MultiplyDense(factors, frontalKeys)) {
+      const size_t nrFrontals = frontalKeys.size();
+      gttic(sum);
+      std::vector<double> sum = ReduceFrontals(*product, nrFrontals, false);
+      gttoc(sum);
+
+      // Divide the product by the sum, broadcast over the frontal block.
+      gttic(divide);
+      const size_t block = product->table.size() / sum.size();
+      for (size_t i = 0; i < product->table.size(); ++i)
+        product->table[i] =
+            DecisionTreeFactor::safe_div(product->table[i], sum[i / block]);
+      auto conditional = std::make_shared<DiscreteConditional>(
+          nrFrontals, ConditionalKeys(*product, nrFrontals),
+          TableFactor::DenseToTree(product->table, product->layout));
+      gttoc(divide);
+
+      return {conditional,
+              std::make_shared<DecisionTreeFactor>(
+                  product->separator,
+                  TableFactor::DenseToTree(sum, product->separatorLayout))};
+    }
+
     // PRODUCT: multiply all factors
     gttic(product);
     DecisionTreeFactor product;
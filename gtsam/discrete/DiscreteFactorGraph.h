@@ -42,6 +42,11 @@ class DiscreteJunctionTree;
 /**
  * @brief Main elimination function for DiscreteFactorGraph.
  *
+ * Cliques whose product is (close to) dense, judging by the number of leaves
+ * of the factors, are multiplied and summed as contiguous tables with the
+ * strided kernels in TableFactor; others as decision trees. Both give the
+ * same conditional and separator factor.
+ *
  * @param factors The factor graph to eliminate.
  * @param frontalKeys An ordering for which variables to eliminate.
  * @return A pair of the resulting conditional and the separator factor.
@@ -22,7 +22,10 @@
 #include <gtsam/discrete/TableFactor.h>
 #include <gtsam/hybrid/HybridValues.h>
 
+#include <algorithm>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -175,13 +178,7 @@ DecisionTreeFactor TableFactor::operator*(const DecisionTreeFactor& f) const {
 
 /* ************************************************************************ */
 DecisionTreeFactor TableFactor::toDecisionTreeFactor() const {
-  DiscreteKeys dkeys = discreteKeys();
-  std::vector<double> table;
-  for (auto i = 0; i < sparse_table_.size(); i++) {
-    table.push_back(sparse_table_.coeff(i));
-  }
-  DecisionTreeFactor f(dkeys, table);
-  return f;
+  return DenseToTree(dense(), discreteKeys());
 }
 
 /* ************************************************************************ */
@@ -293,6 +290,85 @@ TableFactor TableFactor::apply(UnaryAssignment op) const {
   return TableFactor(discreteKeys(), sparse_table);
 }
 
+/* ************************************************************************ */
+namespace {
+
+/// Row-major strides of a table over the given keys, first key slowest.
+std::vector<uint64_t> RowMajorStrides(const DiscreteKeys& dkeys) {
+  std::vector<uint64_t> strides(dkeys.size());
+  uint64_t stride = 1;
+  for (size_t i = dkeys.size(); i-- > 0;) {
+    strides[i] = stride;
+    stride *= dkeys[i].second;
+  }
+  return strides;
+}
+
+/**
+ * Maps the index of an entry in a sparse table to a code over some of its
+ * keys: each key's value is decoded with its stride and cardinality in the
+ * table and re-encoded with its stride in the code. All strides are
+ * precomputed, so no map is accessed per entry.
+ */
+class IndexMap {
+  std::vector<uint64_t> strides_, cardinalities_, codeStrides_;
+
+ public:
+  IndexMap(std::vector<uint64_t> strides, const DiscreteKeys& dkeys,
+           std::vector<uint64_t> codeStrides)
+      : strides_(std::move(strides)), codeStrides_(std::move(codeStrides)) {
+    for (const DiscreteKey& dkey : dkeys) cardinalities_.push_back(dkey.second);
+  }
+
+  uint64_t operator()(uint64_t index) const {
+    uint64_t code = 0;
+    for (size_t i = 0; i < strides_.size(); ++i)
+      code += (index / strides_[i]) % cardinalities_[i] * codeStrides_[i];
+    return code;
+  }
+};
+
+/// A nonzero of a sparse table, keyed on the code of the join keys.
+struct JoinEntry {
+  uint64_t code;   ///< Code of the assignment to the join keys
+  uint64_t index;  ///< Contribution to the index in the output table
+  double value;
+};
+
+/// Stream of the nonzeros of a table, in the order of their index.
+std::vector<JoinEntry> JoinStream(const Eigen::SparseVector<double>& table,
+                                  const IndexMap& code, const IndexMap& index) {
+  std::vector<JoinEntry> entries;
+  entries.reserve(table.nonZeros());
+  for (TableFactor::SparseIt it(table); it; ++it)
+    entries.push_back({code(it.index()), index(it.index()), it.value()});
+  return entries;
+}
+
+/// Sparse vector of the given size from (index, value) pairs.
+Eigen::SparseVector<double> ToSparse(
+    uint64_t size, std::vector<std::pair<uint64_t, double>>& entries) {
+  if (!std::is_sorted(entries.begin(), entries.end()))
+    std::sort(entries.begin(), entries.end());
+  Eigen::SparseVector<double> table(size);
+  table.reserve(entries.size());
+  for (const auto& [index, value] : entries) table.insertBack(index) = value;
+  table.data().squeeze();
+  return table;
+}
+
+}  // namespace
+
+/* ************************************************************************ */
+std::vector<uint64_t> TableFactor::strides(const DiscreteKeys& dkeys) const {
+  std::vector<uint64_t> result;
+  for (const DiscreteKey& dkey : dkeys) {
+    auto it = denominators_.find(dkey.first);
+    result.push_back(it == denominators_.end() ? 0 : it->second);
+  }
+  return result;
+}
+
 /* ************************************************************************ */
 TableFactor TableFactor::apply(const TableFactor& f, Binary op) const {
   if (keys_.empty() && sparse_table_.nonZeros() == 0)
@@ -303,28 +379,58 @@ TableFactor TableFactor::apply(const TableFactor& f, Binary op) const {
   DiscreteKeys contract_dkeys = contractDkeys(f);
   DiscreteKeys f_free_dkeys = f.freeDkeys(*this);
   DiscreteKeys union_dkeys = unionDkeys(f);
-  // 2. Create hash table for input factor f
-  unordered_map<uint64_t, AssignValList> map_f =
-      f.createMap(contract_dkeys, f_free_dkeys);
-  // 3. Initialize multiplied factor.
+  // 2. Stream the nonzeros of both factors with the code of their contract
+  // assignment. This factor contributes all its keys to the output index, f
+  // its free keys.
+  const std::vector<uint64_t> union_strides = RowMajorStrides(union_dkeys);
+  auto outputStrides = [&](const DiscreteKeys& dkeys) {
+    std::vector<uint64_t> result;
+    for (const DiscreteKey& dkey : dkeys)
+      result.push_back(union_strides[std::lower_bound(union_dkeys.begin(),
+                                                      union_dkeys.end(), dkey) -
+                                     union_dkeys.begin()]);
+    return result;
+  };
+  const std::vector<uint64_t> contract_strides =
+      RowMajorStrides(contract_dkeys);
+  const DiscreteKeys this_dkeys = discreteKeys();
+  std::vector<JoinEntry> entries = JoinStream(
+      sparse_table_,
+      IndexMap(strides(contract_dkeys), contract_dkeys, contract_strides),
+      IndexMap(strides(this_dkeys), this_dkeys, outputStrides(this_dkeys)));
+  std::vector<JoinEntry> f_entries = JoinStream(
+      f.sparse_table_,
+      IndexMap(f.strides(contract_dkeys), contract_dkeys, contract_strides),
+      IndexMap(f.strides(f_free_dkeys), f_free_dkeys,
+               outputStrides(f_free_dkeys)));
+  // 3. Join: sort the smaller stream on the contract code, and look up the
+  // matching run for every entry of the larger one, in index order, so the
+  // product mostly comes out sorted.
+  const bool this_smaller = entries.size() < f_entries.size();
+  std::vector<JoinEntry>& lookup = this_smaller ? entries : f_entries;
+  const std::vector<JoinEntry>& scan = this_smaller ? f_entries : entries;
+  auto byCode = [](const JoinEntry& a, const JoinEntry& b) {
+    return a.code < b.code;
+  };
+  if (!std::is_sorted(lookup.begin(), lookup.end(), byCode))
+    std::stable_sort(lookup.begin(), lookup.end(), byCode);
+  std::vector<std::pair<uint64_t, double>> product;
+  product.reserve(scan.size());
+  auto first = lookup.cend(), last = lookup.cend();
+  for (size_t i = 0; i < scan.size(); ++i) {
+    const JoinEntry& entry = scan[i];
+    if (i == 0 || entry.code != scan[i - 1].code)
+      std::tie(first, last) =
+          std::equal_range(lookup.cbegin(), lookup.cend(), entry, byCode);
+    for (auto it = first; it != last; ++it)
+      product.emplace_back(entry.index + it->index,
+                           this_smaller ? op(it->value, entry.value)
+                                        : op(entry.value, it->value));
+  }
+  // 4. Create union keys and return.
   uint64_t card = 1;
   for (auto u_dkey : union_dkeys) card *= u_dkey.second;
-  Eigen::SparseVector<double> mult_sparse_table(card);
-  mult_sparse_table.reserve(card);
-  // 3. Multiply.
-  for (SparseIt it(sparse_table_); it; ++it) {
-    uint64_t contract_unique = uniqueRep(contract_dkeys, it.index());
-    if (map_f.find(contract_unique) == map_f.end()) continue;
-    for (auto assignVal : map_f[contract_unique]) {
-      uint64_t union_idx = unionRep(union_dkeys, assignVal.first, it.index());
-      mult_sparse_table.insert(union_idx) = op(it.value(), assignVal.second);
-    }
-  }
-  // 4. Free unused memory.
-  mult_sparse_table.pruned();
-  mult_sparse_table.data().squeeze();
-  // 5. Create union keys and return.
-  return TableFactor(union_dkeys, mult_sparse_table);
+  return TableFactor(union_dkeys, ToSparse(card, product));
 }
 
 /* ************************************************************************ */
@@ -438,24 +544,10 @@ TableFactor::shared_ptr TableFactor::combine(size_t nrFrontals,
   }
   // Find remaining keys.
   DiscreteKeys remain_dkeys;
-  uint64_t card = 1;
   for (auto i = nrFrontals; i < keys_.size(); i++) {
     remain_dkeys.push_back(discreteKey(i));
-    card *= cardinality(keys_[i]);
-  }
-  // Create combined table.
-  Eigen::SparseVector<double> combined_table(card);
-  combined_table.reserve(sparse_table_.nonZeros());
-  // Populate combined table.
-  for (SparseIt it(sparse_table_); it; ++it) {
-    uint64_t idx = uniqueRep(remain_dkeys, it.index());
-    double new_val = op(combined_table.coeff(idx), it.value());
-    combined_table.coeffRef(idx) = new_val;
   }
-  // Free unused memory.
-  combined_table.pruned();
-  combined_table.data().squeeze();
-  return std::make_shared<TableFactor>(remain_dkeys, combined_table);
+  return combine(remain_dkeys, op);
 }
 
 /* ************************************************************************ */
@@ -470,27 +562,60 @@ TableFactor::shared_ptr TableFactor::combine(const Ordering& frontalKeys,
   }
   // Find remaining keys.
   DiscreteKeys remain_dkeys;
-  uint64_t card = 1;
   for (Key key : keys_) {
     if (std::find(frontalKeys.begin(), frontalKeys.end(), key) ==
         frontalKeys.end()) {
       remain_dkeys.emplace_back(key, cardinality(key));
-      card *= cardinality(key);
     }
   }
-  // Create combined table.
-  Eigen::SparseVector<double> combined_table(card);
-  combined_table.reserve(sparse_table_.nonZeros());
-  // Populate combined table.
-  for (SparseIt it(sparse_table_); it; ++it) {
-    uint64_t idx = uniqueRep(remain_dkeys, it.index());
-    double new_val = op(combined_table.coeff(idx), it.value());
-    combined_table.coeffRef(idx) = new_val;
+  return combine(remain_dkeys, op);
+}
+
+/* ************************************************************************ */
+TableFactor::shared_ptr TableFactor::combine(const DiscreteKeys& remain_dkeys,
+                                             Binary op) const {
+  const IndexMap remain(strides(remain_dkeys), remain_dkeys,
+                        RowMajorStrides(remain_dkeys));
+  uint64_t card = 1;
+  for (const DiscreteKey& dkey : remain_dkeys) card *= dkey.second;
+  std::vector<std::pair<uint64_t, double>> combined;
+
+  if (card <= static_cast<uint64_t>(sparse_table_.nonZeros())) {
+    // Small result: combine into a dense table, in the order of the nonzeros.
+    std::vector<double> values(card, 0.0);
+    std::vector<bool> touched(card, false);
+    for (SparseIt it(sparse_table_); it; ++it) {
+      const uint64_t idx = remain(it.index());
+      values[idx] = op(values[idx], it.value());
+      touched[idx] = true;
+    }
+    for (uint64_t idx = 0; idx < card; ++idx)
+      if (touched[idx]) combined.emplace_back(idx, values[idx]);
+    return std::make_shared<TableFactor>(remain_dkeys,
+                                         ToSparse(card, combined));
+  }
+
+  // Otherwise sort the index of every nonzero in the combined table, so the
+  // values to combine are adjacent and in the order of the original table.
+  std::vector<std::pair<uint64_t, double>> entries;
+  entries.reserve(sparse_table_.nonZeros());
+  for (SparseIt it(sparse_table_); it; ++it)
+    entries.emplace_back(remain(it.index()), it.value());
+  auto byIndex = [](const std::pair<uint64_t, double>& a,
+                    const std::pair<uint64_t, double>& b) {
+    return a.first < b.first;
+  };
+  if (!std::is_sorted(entries.begin(), entries.end(), byIndex))
+    std::stable_sort(entries.begin(), entries.end(), byIndex);
+  // Combine the runs with equal index.
+  for (size_t i = 0; i < entries.size();) {
+    const uint64_t idx = entries[i].first;
+    double value = op(0.0, entries[i].second);
+    for (++i; i < entries.size() && entries[i].first == idx; ++i)
+      value = op(value, entries[i].second);
+    combined.emplace_back(idx, value);
   }
-  // Free unused memory.
-  combined_table.pruned();
-  combined_table.data().squeeze();
-  return std::make_shared<TableFactor>(remain_dkeys, combined_table);
+  return std::make_shared<TableFactor>(remain_dkeys, ToSparse(card, combined));
 }
 
 /* ************************************************************************ */
@@ -616,5 +741,227 @@ TableFactor TableFactor::prune(size_t maxNrAssignments) const {
   return TableFactor(this->discreteKeys(), pruned_vec);
 }
 
+/* ************************************************************************ */
+namespace {
+
+/// Row-major strides of a dense table with the given cardinalities.
+std::vector<size_t> DenseStrides(const std::vector<size_t>& cardinalities) {
+  std::vector<size_t> strides(cardinalities.size());
+  size_t stride = 1;
+  for (size_t a = cardinalities.size(); a-- > 0;) {
+    strides[a] = stride;
+    stride *= cardinalities[a];
+  }
+  return strides;
+}
+
+/**
+ * Visit all entries of a dense table with the given cardinalities, calling
+ * op(i, j) with the index i of the entry and its index j in another table,
+ * whose strides along the same axes are `other` (0 to broadcast an axis).
+ * The last axis is the inner loop, so op is inlined into a strided loop.
+ */
+template <typename OP>
+void ForEachEntry(const std::vector<size_t>& cardinalities,
+                  const std::vector<size_t>& other, OP&& op) {
+  const size_t n = cardinalities.size();
+  if (n == 0) {
+    op(0, 0);
+    return;
+  }
+  const size_t c = cardinalities[n - 1], s = other[n - 1];
+  std::vector<size_t> index(n - 1, 0);
+  size_t i = 0, j = 0;
+  while (true) {
+    for (size_t k = 0; k < c; ++k) op(i + k, j + k * s);
+    i += c;
+    // Advance the odometer over the outer axes.
+    size_t a = n - 1;
+    for (; a > 0; --a) {
+      j += other[a - 1];
+      if (++index[a - 1] < cardinalities[a - 1]) break;
+      j -= other[a - 1] * cardinalities[a - 1];
+      index[a - 1] = 0;
+    }
+    if (a == 0) return;
+  }
+}
+
+/**
+ * Multiplies a dense table by a decision tree: each leaf scales the block of
+ * entries that agree with the choices on its path, so collapsed subtrees cost
+ * one strided loop instead of a visit per assignment.
+ */
+class TreeMultiplier {
+  using ADT = AlgebraicDecisionTree<Key>;
+
+  std::vector<double>& table_;
+  std::map<Key, size_t> axes_;  ///< Axis of each key in the table
+  std::vector<size_t> cardinalities_, strides_;
+  std::vector<bool> fixed_;  ///< Axes chosen on the path to the current node
+
+  // Multiply the entries agreeing with fixed_ by y, looping over the free
+  // axes before `end`, after which the block of entries is contiguous.
+  void scale(size_t a, size_t end, size_t offset, double y) {
+    if (a == end) {
+      const size_t n = (end == 0) ? table_.size() : strides_[end - 1];
+      for (size_t k = 0; k < n; ++k) table_[offset + k] *= y;
+    } else if (fixed_[a]) {
+      scale(a + 1, end, offset, y);
+    } else {
+      for (size_t v = 0; v < cardinalities_[a]; ++v)
+        scale(a + 1, end, offset + v * strides_[a], y);
+    }
+  }
+
+ public:
+  TreeMultiplier(std::vector<double>& table, const DiscreteKeys& dkeys)
+      : table_(table), fixed_(dkeys.size(), false) {
+    for (size_t a = 0; a < dkeys.size(); ++a) {
+      axes_.emplace(dkeys[a].first, a);
+      cardinalities_.push_back(dkeys[a].second);
+    }
+    strides_ = DenseStrides(cardinalities_);
+  }
+
+  void operator()(const ADT::NodePtr& node, size_t offset) {
+    if (node->isLeaf()) {
+      auto leaf = std::static_pointer_cast<const ADT::Leaf>(node);
+      // Everything after the last fixed axis is one contiguous block.
+      size_t end = fixed_.size();
+      while (end > 0 && !fixed_[end - 1]) --end;
+      scale(0, end, offset, leaf->constant());
+      return;
+    }
+    auto choice = std::static_pointer_cast<const ADT::Choice>(node);
+    auto it = axes_.find(choice->label());
+    if (it == axes_.end())
+      throw std::invalid_argument(
+          "TableFactor::MultiplyDense: factor key not in the table");
+    const size_t a = it->second;
+    fixed_[a] = true;
+    for (size_t v = 0; v < choice->nrChoices(); ++v)
+      (*this)(choice->branches()[v], offset + v * strides_[a]);
+    fixed_[a] = false;
+  }
+};
+
+/**
+ * Build the tree of a dense table whose keys are in decreasing order, the
+ * order of labels in a tree: every block of the table is a subtree, so the
+ * nodes are made directly instead of composing trees as DecisionTree::create.
+ */
+AlgebraicDecisionTree<Key>::NodePtr BuildTree(const DiscreteKeys& dkeys,
+                                              size_t level,
+                                              const double* values,
+                                              size_t size) {
+  using ADT = AlgebraicDecisionTree<Key>;
+  if (level == dkeys.size()) return ADT::Leaf::Unique(*values);
+  const size_t cardinality = dkeys[level].second, block = size / cardinality;
+  auto choice = std::make_shared<ADT::Choice>(dkeys[level].first, cardinality);
+  for (size_t v = 0; v < cardinality; ++v)
+    choice->push_back(BuildTree(dkeys, level + 1, values + v * block, block));
+  return ADT::Choice::Unique(choice);
+}
+
+}  // namespace
+
+/* ************************************************************************ */
+std::vector<double> TableFactor::dense() const {
+  std::vector<double> table(sparse_table_.size(), 0.0);
+  for (SparseIt it(sparse_table_); it; ++it) table[it.index()] = it.value();
+  return table;
+}
+
+/* ************************************************************************ */
+void TableFactor::MultiplyDense(std::vector<double>& table,
+                                const DiscreteKeys& dkeys,
+                                const DiscreteFactor& f) {
+  if (auto tree = dynamic_cast<const DecisionTreeFactor*>(&f)) {
+    TreeMultiplier(table, dkeys)(tree->root_, 0);
+  } else if (auto tf = dynamic_cast<const TableFactor*>(&f)) {
+    // Strides of the table factor along the axes of the dense table.
+    std::vector<size_t> cardinalities, strides;
+    size_t found = 0;
+    for (const DiscreteKey& dkey : dkeys) {
+      cardinalities.push_back(dkey.second);
+      auto it = tf->denominators_.find(dkey.first);
+      strides.push_back(it == tf->denominators_.end() ? 0 : it->second);
+      if (it != tf->denominators_.end()) ++found;
+    }
+    if (found != tf->size())
+      throw std::invalid_argument(
+          "TableFactor::MultiplyDense: factor key not in the table");
+    const std::vector<double> values = tf->dense();
+    ForEachEntry(cardinalities, strides,
+                 [&](size_t i, size_t j) { table[i] *= values[j]; });
+  } else {
+    MultiplyDense(table, dkeys, f.toDecisionTreeFactor());
+  }
+}
+
+/* ************************************************************************ */
+std::vector<double> TableFactor::SumDense(const std::vector<double>& table,
+                                          size_t cardinality) {
+  std::vector<double> result(table.size() / cardinality);
+  for (size_t i = 0, k = 0; i < result.size(); ++i) {
+    double sum = table[k++];
+    for (size_t v = 1; v < cardinality; ++v) sum += table[k++];
+    result[i] = sum;
+  }
+  return result;
+}
+
+/* ************************************************************************ */
+std::vector<double> TableFactor::MaxDense(const std::vector<double>& table,
+                                          size_t cardinality) {
+  std::vector<double> result(table.size() / cardinality);
+  for (size_t i = 0, k = 0; i < result.size(); ++i) {
+    double max = table[k++];
+    for (size_t v = 1; v < cardinality; ++v) max = std::max(max, table[k++]);
+    result[i] = max;
+  }
+  return result;
+}
+
+/* ************************************************************************ */
+DecisionTreeFactor TableFactor::DenseToTree(const std::vector<double>& table,
+                                            const DiscreteKeys& dkeys) {
+  auto decreasing = [](const DiscreteKey& a, const DiscreteKey& b) {
+    return a.first > b.first;
+  };
+  size_t size = 1;
+  for (const DiscreteKey& dkey : dkeys) size *= dkey.second;
+  if (table.size() != size)
+    throw std::invalid_argument("TableFactor::DenseToTree: table size " +
+                                std::to_string(table.size()) + ", expected " +
+                                std::to_string(size));
+
+  UniqueNodes<Key, double> scope;
+  AlgebraicDecisionTree<Key> tree;
+  if (std::is_sorted(dkeys.begin(), dkeys.end(), decreasing)) {
+    tree.root_ = BuildTree(dkeys, 0, table.data(), table.size());
+    return DecisionTreeFactor(dkeys, tree);
+  }
+
+  // Transpose to decreasing key order, gathering from the original layout.
+  DiscreteKeys sorted = dkeys;
+  std::sort(sorted.begin(), sorted.end(), decreasing);
+  std::vector<size_t> cardinalities;
+  for (const DiscreteKey& dkey : dkeys) cardinalities.push_back(dkey.second);
+  const std::vector<size_t> strides = DenseStrides(cardinalities);
+  std::vector<size_t> sortedCardinalities, sortedStrides;
+  for (const DiscreteKey& dkey : sorted) {
+    const size_t a = std::find(dkeys.begin(), dkeys.end(), dkey) - dkeys.begin();
+    sortedCardinalities.push_back(dkey.second);
+    sortedStrides.push_back(strides[a]);
+  }
+  std::vector<double> transposed(table.size());
+  ForEachEntry(sortedCardinalities, sortedStrides,
+               [&](size_t i, size_t j) { transposed[i] = table[j]; });
+  tree.root_ = BuildTree(sorted, 0, transposed.data(), transposed.size());
+  return DecisionTreeFactor(dkeys, tree);
+}
+
 /* ************************************************************************ */
 }  // namespace gtsam
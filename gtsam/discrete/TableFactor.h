@@ -324,6 +324,53 @@ class GTSAM_EXPORT TableFactor : public DiscreteFactor {
    */
   TableFactor prune(size_t maxNrAssignments) const;
 
+  /// @}
+  /// @name Dense tables
+  /// @{
+
+  /*
+   * A dense table over DiscreteKeys is a std::vector<double> in row-major
+   * order with the first key the most significant, as in the constructor
+   * from doubles. The functions below work on contiguous dense tables with
+   * strided loops, and are used by EliminateDiscrete for cliques whose
+   * product is (close to) dense.
+   */
+
+  /// Number of nonzero values stored in the sparse table.
+  size_t nrNonZeros() const { return sparse_table_.nonZeros(); }
+
+  /// Dense table of this factor over discreteKeys(), zeros included.
+  std::vector<double> dense() const;
+
+  /**
+   * Multiply a dense table over `dkeys` by the factor `f`, in place. The keys
+   * of `f` must be among `dkeys`, and `f` is broadcast over the other keys.
+   * DecisionTreeFactors are multiplied in leaf-sized blocks, TableFactors
+   * through their dense table, other factors via toDecisionTreeFactor().
+   */
+  static void MultiplyDense(std::vector<double>& table,
+                            const DiscreteKeys& dkeys, const DiscreteFactor& f);
+
+  /**
+   * Sum out the last key, with cardinality `cardinality`, of a dense table.
+   * Values are added in increasing order of the key, as in
+   * DecisionTreeFactor::sum, so both give the same result.
+   */
+  static std::vector<double> SumDense(const std::vector<double>& table,
+                                      size_t cardinality);
+
+  /// Maximize out the last key, with cardinality `cardinality`, of a table.
+  static std::vector<double> MaxDense(const std::vector<double>& table,
+                                      size_t cardinality);
+
+  /**
+   * Convert a dense table over `dkeys` to a DecisionTreeFactor with keys
+   * `dkeys`. The table is transposed to decreasing key order first, if
+   * needed, as the tree is fastest to build in that order.
+   */
+  static DecisionTreeFactor DenseToTree(const std::vector<double>& table,
+                                        const DiscreteKeys& dkeys);
+
   /// @}
   /// @name Wrapper support
   /// @{
@@ -359,6 +406,13 @@ class GTSAM_EXPORT TableFactor : public DiscreteFactor {
   double error(const HybridValues& values) const override;
 
   /// @}
+
+ private:
+  /// Strides of the given keys in the index of sparse_table_, 0 if absent.
+  std::vector<uint64_t> strides(const DiscreteKeys& dkeys) const;
+
+  /// Combine the values with the same assignment to `remain_dkeys` with op.
+  shared_ptr combine(const DiscreteKeys& remain_dkeys, Binary op) const;
 };
 
 // traits
@@ -410,6 +410,34 @@ TEST(DecisionTree, NrAssignments) {
   EXPECT_LONGS_EQUAL(2, choice11->nrAssignments());
 }
 
+/* ************************************************************************** */
+// Test that identical subtrees are shared, and only visited once by apply.
+TEST(DecisionTree, SharedSubtrees) {
+  const std::pair<string, size_t> A("A", 2), B("B", 2), C("C", 2);
+  DT tree({C, B, A}, "1 2 3 4 1 2 3 4");
+
+  // Both branches of C are the same function of B and A, hence the same node
+  auto root = std::dynamic_pointer_cast<const DT::Choice>(tree.root_);
+  CHECK(root);
+  EXPECT(root->branches()[0] == root->branches()[1]);
+
+  size_t count = 0;
+  auto twice = [&](const int& x) {
+    count += 1;
+    return 2 * x;
+  };
+  DT doubled = tree.apply(twice);
+  EXPECT(assert_equal(DT({C, B, A}, "2 4 6 8 2 4 6 8"), doubled));
+  EXPECT_LONGS_EQUAL(4, count);
+
+  // The result of a binary operation shares identical subtrees as well
+  DT sum = tree.apply(doubled, &Ring::add);
+  EXPECT(assert_equal(DT({C, B, A}, "3 6 9 12 3 6 9 12"), sum));
+  auto sumRoot = std::dynamic_pointer_cast<const DT::Choice>(sum.root_);
+  CHECK(sumRoot);
+  EXPECT(sumRoot->branches()[0] == sumRoot->branches()[1]);
+}
+
 /* ************************************************************************** */
 // Test visit.
 TEST(DecisionTree, visit) {
@@ -19,6 +19,7 @@
 #include <gtsam/discrete/DiscreteFactorGraph.h>
 #include <gtsam/discrete/DiscreteEliminationTree.h>
 #include <gtsam/discrete/DiscreteBayesTree.h>
+#include <gtsam/discrete/TableFactor.h>
 #include <gtsam/inference/BayesNet.h>
 
 #include <CppUnitLite/TestHarness.h>
@@ -170,6 +171,51 @@ TEST(DiscreteFactorGraph, test) {
   }
 }
 
+/* ************************************************************************* */
+// Dense cliques are eliminated as tables, check against the tree operations.
+TEST(DiscreteFactorGraph, EliminateDense) {
+  DiscreteKey A(0, 2), B(1, 3), C(2, 2), D(3, 2);
+  DiscreteFactorGraph graph;
+  graph.add(A & B, "1 2 3  4 5 6");
+  graph.add(B & C & D, "1 2 3 4  5 6 7 8  9 10 11 12");
+  graph.emplace_shared<TableFactor>(C & A, "3 1 1 3");
+  graph.add(D, "2 3");
+
+  // Frontals not first in key order, separator {B, D}
+  const Ordering frontalKeys{2, 0};
+  DecisionTreeFactor product = graph.product();
+  product = product / *product.max(product.size());
+  DecisionTreeFactor::shared_ptr sum = product.sum(frontalKeys);
+  DecisionTreeFactor::shared_ptr max = product.max(frontalKeys);
+  Ordering orderedKeys{2, 0, 1, 3};
+  DiscreteConditional expected(product, *sum, orderedKeys);
+
+  const auto [conditional, factor] = EliminateDiscrete(graph, frontalKeys);
+  EXPECT(assert_equal(expected, *conditional));
+  EXPECT(assert_equal(*sum, *factor));
+  EXPECT(orderedKeys == conditional->keys());
+  EXPECT(sum->keys() == factor->keys());
+
+  const auto [lookup, maxFactor] = EliminateForMPE(graph, frontalKeys);
+  EXPECT(assert_equal(*max, *maxFactor));
+  DiscreteValues parents{{1, 2}, {3, 1}};
+  DiscreteValues mpe = parents;
+  double best = 0;
+  for (size_t c : {0, 1}) {
+    for (size_t a : {0, 1}) {
+      DiscreteValues values = parents;
+      values[2] = c;
+      values[0] = a;
+      if (product(values) > best) {
+        best = product(values);
+        mpe = values;
+      }
+    }
+  }
+  EXPECT_DOUBLES_EQUAL(best, (*maxFactor)(parents), 1e-9);
+  EXPECT_DOUBLES_EQUAL(best, (*lookup)(mpe), 1e-9);
+}
+
 /* ************************************************************************* */
 TEST_UNSAFE(DiscreteFactorGraph, testMaxProduct) {
   // Declare a bunch of keys
@@ -253,6 +253,80 @@ TEST(TableFactor, sum_max) {
   TableFactor::shared_ptr actual22 = f2.sum(1);
 }
 
+/* ************************************************************************* */
+// Check products, quotients and marginals of sparse tables against trees,
+// with shared keys in different positions in both factors.
+TEST(TableFactor, SparseJoin) {
+  DiscreteKey A(0, 3), B(1, 2), C(2, 4), D(3, 2);
+  const DiscreteKeys keys1{A, B, C}, keys2{B, C, D}, keys3{C, A};
+  const vector<double> values1 = {0, 1, 2, 0, 3, 0, 0, 4, 5, 6, 0, 7,
+                                  0, 8, 9, 0, 1, 0, 2, 0, 3, 0, 4, 5},
+                       values2 = {1, 0, 2, 3, 0, 0, 4, 5,
+                                  6, 7, 0, 8, 9, 0, 0, 2},
+                       values3 = {1, 2, 0, 0, 3, 4, 5, 0, 6, 7, 0, 8};
+  const TableFactor f1(keys1, values1), f2(keys2, values2),
+      f3(keys3, values3);
+  const DecisionTreeFactor t1(keys1, values1), t2(keys2, values2),
+      t3(keys3, values3);
+
+  // The smaller factor is looked up, check both sides keep their operands.
+  EXPECT(assert_equal(t1 * t2, (f1 * f2).toDecisionTreeFactor()));
+  EXPECT(assert_equal(t2 * t1, (f2 * f1).toDecisionTreeFactor()));
+  EXPECT(assert_equal(t1 * t3, (f1 * f3).toDecisionTreeFactor()));
+  EXPECT(assert_equal(t1 / t3, (f1 / f3).toDecisionTreeFactor()));
+  EXPECT(assert_equal(t3 / t1, (f3 / f1).toDecisionTreeFactor()));
+
+  // Marginals, both into a dense and a sparse result.
+  const TableFactor product = f1 * f2;
+  const DecisionTreeFactor tree = t1 * t2;
+  EXPECT(assert_equal(*tree.sum(Ordering{A.first}),
+                      product.sum(Ordering{A.first})->toDecisionTreeFactor()));
+  EXPECT(assert_equal(*tree.max(Ordering{B.first, D.first}),
+                      product.max(Ordering{B.first, D.first})
+                          ->toDecisionTreeFactor()));
+  EXPECT(assert_equal(*tree.sum(2), product.sum(2)->toDecisionTreeFactor()));
+
+  // Fewer nonzeros than values in the marginal.
+  const vector<double> values4 = {0, 0, 2, 0, 0, 0, 0, 4, 0, 0, 0, 0,
+                                  0, 0, 0, 0, 1, 0, 0, 0, 3, 0, 0, 0};
+  const TableFactor f4(keys1, values4);
+  const DecisionTreeFactor t4(keys1, values4);
+  EXPECT(assert_equal(*t4.sum(Ordering{A.first}),
+                      f4.sum(Ordering{A.first})->toDecisionTreeFactor()));
+  EXPECT(assert_equal(*t4.max(1), f4.max(1)->toDecisionTreeFactor()));
+}
+
+/* ************************************************************************* */
+// Check the strided kernels on dense tables.
+TEST(TableFactor, DenseTables) {
+  DiscreteKey v0(0, 3), v1(1, 2);
+  TableFactor f(v0 & v1, "1 2  3 4  5 6");
+  EXPECT(f.dense() == vector<double>({1, 2, 3, 4, 5, 6}));
+
+  // Multiply into a table with the keys in the other order, then broadcast a
+  // DecisionTreeFactor on v1 over v0.
+  const DiscreteKeys layout = v1 & v0;
+  vector<double> table(6, 1.0);
+  TableFactor::MultiplyDense(table, layout, f);
+  EXPECT(table == vector<double>({1, 3, 5, 2, 4, 6}));
+  TableFactor::MultiplyDense(table, layout, DecisionTreeFactor(v1, "1 10"));
+  EXPECT(table == vector<double>({1, 3, 5, 20, 40, 60}));
+
+  // Reduce the last key, v0.
+  EXPECT(TableFactor::SumDense(table, 3) == vector<double>({9, 120}));
+  EXPECT(TableFactor::MaxDense(table, 3) == vector<double>({5, 60}));
+
+  // Trees are the same for either key order.
+  DecisionTreeFactor expected(layout, table);
+  EXPECT(assert_equal(expected, TableFactor::DenseToTree(table, layout)));
+  EXPECT(assert_equal(DecisionTreeFactor(v0 & v1, "1 20 3 40 5 60"),
+                      TableFactor::DenseToTree({1, 20, 3, 40, 5, 60}, v0 & v1)));
+  EXPECT(assert_equal(f.toDecisionTreeFactor(),
+                      DecisionTreeFactor(v0 & v1, "1 2 3 4 5 6")));
+  CHECK_EXCEPTION(TableFactor::DenseToTree({1, 2}, layout),
+                  std::invalid_argument);
+}
+
 /* ************************************************************************* */
 // Check enumerate yields the correct list of assignment/value pairs.
 TEST(TableFactor, enumerate) {
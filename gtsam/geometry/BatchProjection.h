@@ -0,0 +1,355 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file   BatchProjection.h
+ * @brief  Project a point into many pinhole cameras at once, with Jacobians
+ */
+
+#pragma once
+
+#include <gtsam/geometry/Cal3DS2.h>
+#include <gtsam/geometry/Cal3Bundler.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/geometry/PinholeCamera.h>
+
+#include <algorithm>
+
+namespace gtsam {
+
+namespace internal {
+
+/// Number of cameras processed together. The arrays have a fixed size, so
+/// they live on the stack and Eigen unrolls and vectorizes every expression.
+static const int kBatchLanes = 8;
+
+/// One value per camera in a batch
+using Lanes = Eigen::Array<double, kBatchLanes, 1>;
+
+/// N values per camera in a batch, one row per camera
+template <int N>
+using LaneArrays = Eigen::Array<double, kBatchLanes, N>;
+
+/// Poses of the cameras in a batch, one row per camera: the rotation matrix in
+/// column-major order, followed by the translation
+using PoseArrays = LaneArrays<12>;
+
+/**
+ * Normalized coordinates of a point in a batch of posed cameras, and their
+ * derivatives with respect to the point, as structures of arrays. Same math as
+ * PinholeBase::project2, but every step is one Eigen array expression across
+ * the cameras of the batch.
+ */
+struct BatchPinholeBase {
+  Lanes u, v;  ///< Normalized coordinates
+  Lanes d;     ///< Inverse depth
+  /// Derivative with respect to the point, row-major 2x3 per camera
+  LaneArrays<6> Dpoint;
+
+  /// Returns false if the point is not in front of every camera
+  bool project(const PoseArrays& poses, const Point3& pw, bool derivatives) {
+    // q = R' * (pw - t), where R(r, c) is column 3 * c + r
+    const Lanes dx = pw.x() - poses.col(9);
+    const Lanes dy = pw.y() - poses.col(10);
+    const Lanes dz = pw.z() - poses.col(11);
+    const Lanes qz =
+        poses.col(6) * dx + poses.col(7) * dy + poses.col(8) * dz;
+    if ((qz <= 0.0).any()) return false;
+    d = qz.inverse();
+    u = (poses.col(0) * dx + poses.col(1) * dy + poses.col(2) * dz) * d;
+    v = (poses.col(3) * dx + poses.col(4) * dy + poses.col(5) * dz) * d;
+
+    if (derivatives) {
+      // See PinholeBase::Dpoint, with Rt(i, j) = R(j, i) in column 3 * i + j
+      for (int j = 0; j < 3; j++) {
+        Dpoint.col(j) = d * (poses.col(j) - u * poses.col(6 + j));
+        Dpoint.col(3 + j) = d * (poses.col(3 + j) - v * poses.col(6 + j));
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Batched uncalibrate for the calibrations of a batch of cameras, stored as
+ * structures of arrays with one row per camera. Specializations provide
+ *  - dimension, the number of calibration parameters,
+ *  - Set(K, &arrays, i), which stores the calibration of camera i, and
+ *  - Uncalibrate(arrays, x, y, &u, &v, Dp, Dcal), with the same math as
+ *    CALIBRATION::uncalibrate. Dp has the 2x2 and Dcal the 2xdimension
+ *    derivatives of every camera in row-major order, and may be null.
+ */
+template <class CALIBRATION>
+struct BatchCalibration;
+
+template <>
+struct BatchCalibration<Cal3_S2> {
+  static const int dimension = 5;
+  using Arrays = internal::LaneArrays<dimension>;
+
+  static void Set(const Cal3_S2& K, Arrays* arrays, size_t i) {
+    arrays->row(i) = K.vector().transpose();
+  }
+
+  static void Uncalibrate(const Arrays& K, const internal::Lanes& x,
+                          const internal::Lanes& y, internal::Lanes* u,
+                          internal::Lanes* v,
+                          internal::LaneArrays<4>* Dp,
+                          internal::LaneArrays<10>* Dcal) {
+    const auto fx = K.col(0), fy = K.col(1), s = K.col(2);
+    *u = fx * x + s * y + K.col(3);
+    *v = fy * y + K.col(4);
+    if (Dp) {
+      *Dp << fx, s, internal::Lanes::Zero(), fy;
+    }
+    if (Dcal) {
+      const internal::Lanes zero = internal::Lanes::Zero(),
+                           one = internal::Lanes::Ones();
+      *Dcal << x, zero, y, one, zero, zero, y, zero, zero, one;
+    }
+  }
+};
+
+template <>
+struct BatchCalibration<Cal3Bundler> {
+  static const int dimension = 3;
+  /// f, k1, k2, u0, v0
+  using Arrays = internal::LaneArrays<5>;
+
+  static void Set(const Cal3Bundler& K, Arrays* arrays, size_t i) {
+    arrays->row(i) << K.fx(), K.k1(), K.k2(), K.px(), K.py();
+  }
+
+  static void Uncalibrate(const Arrays& K, const internal::Lanes& x,
+                          const internal::Lanes& y, internal::Lanes* u,
+                          internal::Lanes* v,
+                          internal::LaneArrays<4>* Dp,
+                          internal::LaneArrays<6>* Dcal) {
+    const auto f = K.col(0), k1 = K.col(1), k2 = K.col(2);
+    const internal::Lanes r = x * x + y * y;
+    const internal::Lanes g = 1.0 + (k1 + k2 * r) * r;
+    const internal::Lanes gx = g * x, gy = g * y;
+    *u = K.col(3) + f * gx;
+    *v = K.col(4) + f * gy;
+    if (Dcal) {
+      const internal::Lanes frx = f * r * x, fry = f * r * y;
+      *Dcal << gx, frx, r * frx, gy, fry, r * fry;
+    }
+    if (Dp) {
+      const internal::Lanes a = 2.0 * (k1 + 2.0 * k2 * r);
+      const internal::Lanes faxy = f * a * x * y;
+      *Dp << f * (g + a * x * x), faxy, faxy, f * (g + a * y * y);
+    }
+  }
+};
+
+template <>
+struct BatchCalibration<Cal3DS2> {
+  static const int dimension = 9;
+  using Arrays = internal::LaneArrays<dimension>;
+
+  static void Set(const Cal3DS2& K, Arrays* arrays, size_t i) {
+    arrays->row(i) = K.vector().transpose();
+  }
+
+  static void Uncalibrate(const Arrays& K, const internal::Lanes& x,
+                          const internal::Lanes& y, internal::Lanes* u,
+                          internal::Lanes* v,
+                          internal::LaneArrays<4>* Dp,
+                          internal::LaneArrays<18>* Dcal) {
+    const auto fx = K.col(0), fy = K.col(1), s = K.col(2);
+    const auto k1 = K.col(5), k2 = K.col(6), p1 = K.col(7), p2 = K.col(8);
+    const internal::Lanes xy = x * y, xx = x * x, yy = y * y;
+    const internal::Lanes rr = xx + yy, r4 = rr * rr;
+    const internal::Lanes g = 1.0 + k1 * rr + k2 * r4;
+    const internal::Lanes pnx = g * x + 2.0 * p1 * xy + p2 * (rr + 2.0 * xx);
+    const internal::Lanes pny = g * y + 2.0 * p2 * xy + p1 * (rr + 2.0 * yy);
+    *u = fx * pnx + s * pny + K.col(3);
+    *v = fy * pny + K.col(4);
+
+    if (Dcal) {
+      // [DR1, DK * DR2], see D2dcalibration in Cal3DS2_Base.cpp
+      const internal::Lanes zero = internal::Lanes::Zero(),
+                           one = internal::Lanes::Ones();
+      const internal::Lanes a0 = x * rr, a1 = x * r4, a2 = 2.0 * xy,
+                           a3 = rr + 2.0 * xx;
+      const internal::Lanes b0 = y * rr, b1 = y * r4, b2 = rr + 2.0 * yy,
+                           b3 = 2.0 * xy;
+      *Dcal << pnx, zero, pny, one, zero,                   //
+          fx * a0 + s * b0, fx * a1 + s * b1, fx * a2 + s * b2,
+          fx * a3 + s * b3,                                 //
+          zero, pny, zero, zero, one,                       //
+          fy * b0, fy * b1, fy * b2, fy * b3;
+    }
+    if (Dp) {
+      // DK * DR, see D2dintrinsic in Cal3DS2_Base.cpp
+      const internal::Lanes dgdx = 2.0 * x * (k1 + 2.0 * k2 * rr);
+      const internal::Lanes dgdy = 2.0 * y * (k1 + 2.0 * k2 * rr);
+      const internal::Lanes DR00 = g + x * dgdx + 2.0 * p1 * y + 6.0 * p2 * x;
+      const internal::Lanes DR01 = x * dgdy + 2.0 * p1 * x + 2.0 * p2 * y;
+      const internal::Lanes DR10 = y * dgdx + 2.0 * p2 * y + 2.0 * p1 * x;
+      const internal::Lanes DR11 = g + y * dgdy + 2.0 * p2 * x + 6.0 * p1 * y;
+      *Dp << fx * DR00 + s * DR10, fx * DR01 + s * DR11, fy * DR10, fy * DR11;
+    }
+  }
+};
+
+/**
+ * Projects a Point3 into a set of cameras at once, with the derivatives
+ * CameraSet::project2 needs. The cameras are processed in batches of
+ * internal::kBatchLanes: the poses and calibrations of a batch are gathered
+ * into fixed-size structures of arrays, one row per camera, and all further
+ * steps are Eigen array expressions across the cameras of the batch.
+ *
+ * Project2 returns false when the batch can not be used, either for other
+ * camera types or when the point is behind a camera. CameraSet then falls
+ * back on projecting into the cameras one by one, which throws the
+ * CheiralityException as before.
+ */
+template <class CAMERA>
+struct BatchProjection {
+  template <class CAMERAS, class ZVECTOR, class FBLOCKS>
+  static bool Project2(const CAMERAS&, const Point3&, ZVECTOR*, FBLOCKS*,
+                       Matrix*) {
+    return false;
+  }
+};
+
+namespace internal {
+
+/// Batch projection for pinhole cameras on Pose3, with Jacobians with respect
+/// to the pose only, or also with respect to the calibration
+template <class CALIBRATION, bool WITH_CALIBRATION>
+struct BatchPinholeProjection {
+  using Calibration = BatchCalibration<CALIBRATION>;
+  static const int DimK = Calibration::dimension;
+
+  /// Below this number of cameras, projecting one by one is as fast
+  static const size_t kMinCameras = 4;
+
+  using DcalArrays = LaneArrays<2 * DimK>;
+
+  /// Copy the derivatives of lane j with respect to the calibration into Fi
+  template <class MATRIX>
+  static void SetDcal(const DcalArrays&, int, MATRIX*, std::false_type) {}
+  template <class MATRIX>
+  static void SetDcal(const DcalArrays& Dcal, int j, MATRIX* Fi,
+                      std::true_type) {
+    Fi->template block<1, DimK>(0, 6) =
+        Dcal.row(j).template head<DimK>().matrix();
+    Fi->template block<1, DimK>(1, 6) =
+        Dcal.row(j).template tail<DimK>().matrix();
+  }
+
+  template <class CAMERAS, class ZVECTOR, class FBLOCKS>
+  static bool Project2(const CAMERAS& cameras, const Point3& pw, ZVECTOR* z,
+                       FBLOCKS* Fs, Matrix* E) {
+    const size_t m = cameras.size();
+    if (m < kMinCameras) return false;
+
+    z->resize(m);
+    if (Fs) Fs->resize(m);
+    if (E) E->resize(2 * m, 3);
+
+    PoseArrays poses;
+    typename Calibration::Arrays K;
+    BatchPinholeBase pn;
+    Lanes u, v;
+    LaneArrays<4> Dp;
+    DcalArrays Dcal;
+    for (size_t first = 0; first < m; first += kBatchLanes) {
+      const int n = static_cast<int>(std::min<size_t>(kBatchLanes, m - first));
+
+      // Gather poses and calibrations into structures of arrays. The lanes
+      // past the last camera repeat it, so they never fail the cheirality test.
+      for (int j = 0; j < kBatchLanes; j++) {
+        const auto& camera = cameras[first + std::min(j, n - 1)];
+        const Pose3& pose = camera.pose();
+        const Matrix3& R = pose.rotation().matrix();
+        poses.row(j).template head<9>() =
+            Eigen::Map<const Eigen::Matrix<double, 1, 9>>(R.data());
+        poses.row(j).template tail<3>() = pose.translation().transpose();
+        Calibration::Set(camera.calibration(), &K, j);
+      }
+
+      if (!pn.project(poses, pw, Fs || E)) {
+        z->clear();
+        return false;
+      }
+      Calibration::Uncalibrate(K, pn.u, pn.v, &u, &v,
+                               (Fs || E) ? &Dp : nullptr,
+                               (Fs && WITH_CALIBRATION) ? &Dcal : nullptr);
+      for (int j = 0; j < n; j++) (*z)[first + j] << u(j), v(j);
+
+      if (Fs) {
+        // Dp * Dpose, with the rows of Dpose from PinholeBase::Dpose
+        const Lanes uv = pn.u * pn.v;
+        LaneArrays<6> Dpose0, Dpose1;
+        Dpose0 << uv, -1.0 - pn.u * pn.u, pn.v, -pn.d, Lanes::Zero(),
+            pn.d * pn.u;
+        Dpose1 << 1.0 + pn.v * pn.v, -uv, -pn.u, Lanes::Zero(), -pn.d,
+            pn.d * pn.v;
+        const LaneArrays<6> F0 =
+            Dpose0.colwise() * Dp.col(0) + Dpose1.colwise() * Dp.col(1);
+        const LaneArrays<6> F1 =
+            Dpose0.colwise() * Dp.col(2) + Dpose1.colwise() * Dp.col(3);
+        for (int j = 0; j < n; j++) {
+          auto& Fi = (*Fs)[first + j];
+          Fi.template block<1, 6>(0, 0) = F0.row(j).matrix();
+          Fi.template block<1, 6>(1, 0) = F1.row(j).matrix();
+          SetDcal(Dcal, j, &Fi,
+                  std::integral_constant<bool, WITH_CALIBRATION>());
+        }
+      }
+
+      if (E) {
+        // Dp * Dpoint
+        const auto& Dpoint = pn.Dpoint;
+        const LaneArrays<3> E0 =
+            Dpoint.template leftCols<3>().colwise() * Dp.col(0) +
+            Dpoint.template rightCols<3>().colwise() * Dp.col(1);
+        const LaneArrays<3> E1 =
+            Dpoint.template leftCols<3>().colwise() * Dp.col(2) +
+            Dpoint.template rightCols<3>().colwise() * Dp.col(3);
+        for (int j = 0; j < n; j++) {
+          E->row(2 * (first + j)) = E0.row(j).matrix();
+          E->row(2 * (first + j) + 1) = E1.row(j).matrix();
+        }
+      }
+    }
+    return true;
+  }
+};
+
+}  // namespace internal
+
+template <>
+struct BatchProjection<PinholePose<Cal3_S2>>
+    : internal::BatchPinholeProjection<Cal3_S2, false> {};
+template <>
+struct BatchProjection<PinholePose<Cal3Bundler>>
+    : internal::BatchPinholeProjection<Cal3Bundler, false> {};
+template <>
+struct BatchProjection<PinholePose<Cal3DS2>>
+    : internal::BatchPinholeProjection<Cal3DS2, false> {};
+template <>
+struct BatchProjection<PinholeCamera<Cal3_S2>>
+    : internal::BatchPinholeProjection<Cal3_S2, true> {};
+template <>
+struct BatchProjection<PinholeCamera<Cal3Bundler>>
+    : internal::BatchPinholeProjection<Cal3Bundler, true> {};
+template <>
+struct BatchProjection<PinholeCamera<Cal3DS2>>
+    : internal::BatchPinholeProjection<Cal3DS2, true> {};
+
+}  // namespace gtsam
@@ -21,6 +21,7 @@
 #include <gtsam/base/FastMap.h>
 #include <gtsam/base/SymmetricBlockMatrix.h>
 #include <gtsam/base/Testable.h>
+#include <gtsam/geometry/BatchProjection.h>
 #include <gtsam/geometry/CalibratedCamera.h>  // for Cheirality exception
 #include <gtsam/geometry/Point3.h>
 #include <gtsam/inference/Key.h>
@@ -57,7 +58,8 @@ class CameraSet : public std::vector<CAMERA, Eigen::aligned_allocator<CAMERA>> {
     // Project and fill error vector
     Vector b(ZDim * m);
     for (size_t i = 0, row = 0; i < m; i++, row += ZDim) {
-      Vector bi = traits<Z>::Local(measured[i], predicted[i]);
+      typename traits<Z>::TangentVector bi =
+          traits<Z>::Local(measured[i], predicted[i]);
       if (ZDim == 3 && std::isnan(bi(1))) {  // if it is a stereo point and the
                                              // right pixel is missing (nan)
         bi(1) = 0;
@@ -110,9 +112,12 @@ class CameraSet : public std::vector<CAMERA, Eigen::aligned_allocator<CAMERA>> {
                    Matrix* E = nullptr) const {
     static const int N = FixedDimension<POINT>::value;
 
+    // Project into all cameras at once where possible, see BatchProjection
+    ZVector z;
+    if (batchProject2(point, &z, Fs, E)) return z;
+
     // Allocate result
     size_t m = this->size();
-    ZVector z;
     z.reserve(m);
 
     // Allocate derivatives
@@ -131,6 +136,18 @@ class CameraSet : public std::vector<CAMERA, Eigen::aligned_allocator<CAMERA>> {
     return z;
   }
 
+  /// Batched projection of a Point3, returns false if not available
+  bool batchProject2(const Point3& point, ZVector* z, FBlocks* Fs,
+                     Matrix* E) const {
+    return BatchProjection<CAMERA>::Project2(*this, point, z, Fs, E);
+  }
+
+  /// Other points are always projected one camera at a time
+  template <class POINT>
+  bool batchProject2(const POINT&, ZVector*, FBlocks*, Matrix*) const {
+    return false;
+  }
+
   /** An overload of the project2 function to accept
    * full matrices and vectors and pass it to the pointer
    * version of the function.
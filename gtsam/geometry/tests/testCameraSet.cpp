@@ -245,6 +245,82 @@ TEST(CameraSet, Stereo) {
   EXPECT(assert_equal(actualE, E));
 }
 
+/* ************************************************************************* */
+// Compare the batched projection with projecting into each camera
+#include <gtsam/geometry/Cal3DS2.h>
+template <class CAL>
+static PinholePose<CAL> makeCamera(const Pose3& pose, const CAL& K,
+                                   PinholePose<CAL>*) {
+  return PinholePose<CAL>(pose, std::make_shared<CAL>(K));
+}
+
+template <class CAL>
+static PinholeCamera<CAL> makeCamera(const Pose3& pose, const CAL& K,
+                                     PinholeCamera<CAL>*) {
+  return PinholeCamera<CAL>(pose, K);
+}
+
+template <class CAMERA, class CAL>
+static void checkBatchProjection(const CAL& K, TestResult& result_,
+                                 const string& name_) {
+  CameraSet<CAMERA> set;
+  for (size_t i = 0; i < 6; i++) {
+    const Pose3 pose(Rot3::Ypr(0.1 * i, -0.2, 0.05 * i),
+                     Point3(0.3 * i, -0.1 * i, -5.0));
+    set.push_back(makeCamera(pose, K, static_cast<CAMERA*>(nullptr)));
+  }
+  const Point3 p(0.5, -0.3, 1.0);
+
+  typename CameraSet<CAMERA>::FBlocks Fs;
+  Matrix E;
+  const Point2Vector z = set.project2(p, Fs, E);
+  LONGS_EQUAL(6, z.size());
+  LONGS_EQUAL(6, Fs.size());
+  for (size_t i = 0; i < 6; i++) {
+    typename CameraSet<CAMERA>::MatrixZD Fi;
+    Matrix23 Ei;
+    EXPECT(assert_equal(set[i].project2(p, Fi, Ei), z[i], 1e-9));
+    EXPECT(assert_equal(Fi, Fs[i], 1e-9));
+    EXPECT(assert_equal(Ei, Matrix(E.block<2, 3>(2 * i, 0)), 1e-9));
+  }
+
+  // The batch was used, and not the fallback
+  Point2Vector zb;
+  EXPECT(BatchProjection<CAMERA>::Project2(set, p, &zb, &Fs, &E));
+
+  // Without derivatives
+  const Point2Vector z2 = set.project2(p);
+  for (size_t i = 0; i < 6; i++) EXPECT(assert_equal(z[i], z2[i]));
+}
+
+TEST(CameraSet, BatchProjection) {
+  const Cal3_S2 K(500, 480, 0.1, 320, 240);
+  const Cal3Bundler bundler(500, 1e-2, -1e-3, 320, 240);
+  const Cal3DS2 ds2(500, 480, 0.1, 320, 240, 1e-2, -1e-3, 1e-3, -2e-3);
+  checkBatchProjection<PinholePose<Cal3_S2>>(K, result_, name_);
+  checkBatchProjection<PinholePose<Cal3Bundler>>(bundler, result_, name_);
+  checkBatchProjection<PinholePose<Cal3DS2>>(ds2, result_, name_);
+  checkBatchProjection<PinholeCamera<Cal3_S2>>(K, result_, name_);
+  checkBatchProjection<PinholeCamera<Cal3Bundler>>(bundler, result_, name_);
+  checkBatchProjection<PinholeCamera<Cal3DS2>>(ds2, result_, name_);
+}
+
+/* ************************************************************************* */
+TEST(CameraSet, BatchProjectionCheirality) {
+  // A point behind one of the cameras is projected camera by camera
+  typedef PinholePose<Cal3_S2> Camera;
+  CameraSet<Camera> set;
+  for (size_t i = 0; i < 5; i++)
+    set.emplace_back(Pose3(Rot3(), Point3(i, 0, 0)),
+                     std::make_shared<Cal3_S2>());
+  set.emplace_back(Pose3(Rot3(), Point3(0, 0, 2)), std::make_shared<Cal3_S2>());
+#ifdef GTSAM_THROW_CHEIRALITY_EXCEPTION
+  CHECK_EXCEPTION(set.project2(Point3(0, 0, 1)), CheiralityException);
+#else
+  EXPECT_LONGS_EQUAL(6, set.project2(Point3(0, 0, 1)).size());
+#endif
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
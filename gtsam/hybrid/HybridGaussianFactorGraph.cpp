@@ -18,7 +18,9 @@
  * @date   Mar 11, 2022
  */
 
+#include <gtsam/base/parallelFor.h>
 #include <gtsam/base/utilities.h>
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
 #include <gtsam/discrete/Assignment.h>
 #include <gtsam/discrete/DiscreteEliminationTree.h>
 #include <gtsam/discrete/DiscreteFactorGraph.h>
@@ -45,6 +47,7 @@
 #include <iterator>
 #include <memory>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -197,12 +200,20 @@ GaussianFactorGraphTree removeEmpty(const GaussianFactorGraphTree &sum) {
   return GaussianFactorGraphTree(sum, emptyGaussian);
 }
 
+/* ************************************************************************ */
+/// Parameters of pruning the modes during elimination.
+struct Pruning {
+  size_t maxNrLeaves;
+  DecisionTreeFactor::shared_ptr discretePrior;
+};
+
 /* ************************************************************************ */
 static std::pair<HybridConditional::shared_ptr, std::shared_ptr<Factor>>
 hybridElimination(const HybridGaussianFactorGraph &factors,
                   const Ordering &frontalKeys,
                   const KeyVector &continuousSeparator,
-                  const std::set<DiscreteKey> &discreteSeparatorSet) {
+                  const std::set<DiscreteKey> &discreteSeparatorSet,
+                  const Pruning *pruning) {
   // NOTE: since we use the special JunctionTree,
   // only possibility is continuous conditioned on discrete.
   DiscreteKeys discreteSeparator(discreteSeparatorSet.begin(),
@@ -231,8 +242,68 @@ hybridElimination(const HybridGaussianFactorGraph &factors,
     return result;
   };
 
-  // Perform elimination!
-  DecisionTree<Key, Result> eliminationResults(factorGraphTree, eliminate);
+  // Perform elimination! The leaves are independent Gaussian eliminations,
+  // so we eliminate them in parallel and then look up the results by leaf.
+  std::vector<const GaussianFactorGraph *> graphs;
+  std::unordered_map<const GaussianFactorGraph *, size_t> leafIndex;
+  factorGraphTree.visit([&](const GaussianFactorGraph &graph) {
+    if (leafIndex.emplace(&graph, graphs.size()).second)
+      graphs.push_back(&graph);
+  });
+  std::vector<Result> results(graphs.size());
+  parallelFor(graphs.size(),
+              [&](size_t i) { results[i] = eliminate(*graphs[i]); });
+
+  // Integrate the probability mass in the last continuous conditional using
+  // the unnormalized probability q(μ;m) = exp(-error(μ;m)) at the mean.
+  //   discrete_probability = exp(-error(μ;m)) * sqrt(det(2π Σ_m))
+  auto probability = [&](const Result &pair) -> double {
+    static const VectorValues kEmpty;
+    // If the factor is not null, it has no keys, just contains the residual.
+    // When pruning during elimination, modes without elimination result were
+    // pruned, in this or an earlier clique.
+    const auto &factor = pair.second;
+    // TODO(dellaert): not loving this.
+    if (!factor) return pruning ? 0.0 : 1.0;
+    return exp(-factor->error(kEmpty)) / pair.first->normalizationConstant();
+  };
+
+  // Look up the elimination result of each leaf, by index.
+  DecisionTree<Key, double> indices(
+      factorGraphTree, [&](const GaussianFactorGraph &graph) {
+        return static_cast<double>(leafIndex.at(&graph));
+      });
+
+  // Beam over the modes: once all continuous keys are eliminated, keep only
+  // the maxNrLeaves assignments with the highest probability times the
+  // discrete prior, if given. Pruned assignments get an empty leaf, like the
+  // ones pruned before, so they have zero probability. Cliques with a
+  // continuous separator are not pruned: evidence on their separator is still
+  // ahead, so new modes would be ranked on the prior alone.
+  if (pruning && continuousSeparator.empty()) {
+    AlgebraicDecisionTree<Key> mass(
+        DecisionTree<Key, double>(indices, [&](double index) {
+          return probability(results[static_cast<size_t>(index)]);
+        }));
+    if (const auto &prior = pruning->discretePrior) {
+      // Marginalize the prior to the keys of the separator.
+      Ordering others;
+      for (Key key : prior->keys())
+        if (!discreteSeparatorSet.count({key, prior->cardinality(key)}))
+          others.push_back(key);
+      mass = mass * (others.empty() ? *prior : *prior->sum(others));
+    }
+    const DecisionTreeFactor kept =
+        DecisionTreeFactor(discreteSeparator, mass).prune(pruning->maxNrLeaves);
+    indices = indices.apply(kept, [](const double &index, const double &p) {
+      return p > 0.0 ? index : -1.0;
+    });
+  }
+
+  DecisionTree<Key, Result> eliminationResults(indices, [&](double index) {
+    return index < 0.0 ? Result{nullptr, nullptr}
+                       : results[static_cast<size_t>(index)];
+  });
 
   // Separate out decision tree into conditionals and remaining factors.
   const auto [conditionals, newFactors] = unzip(eliminationResults);
@@ -244,18 +315,6 @@ hybridElimination(const HybridGaussianFactorGraph &factors,
   if (continuousSeparator.empty()) {
     // If there are no more continuous parents, then we create a
     // DiscreteFactor here, with the error for each discrete choice.
-
-    // Integrate the probability mass in the last continuous conditional using
-    // the unnormalized probability q(μ;m) = exp(-error(μ;m)) at the mean.
-    //   discrete_probability = exp(-error(μ;m)) * sqrt(det(2π Σ_m))
-    auto probability = [&](const Result &pair) -> double {
-      static const VectorValues kEmpty;
-      // If the factor is not null, it has no keys, just contains the residual.
-      const auto &factor = pair.second;
-      if (!factor) return 1.0;  // TODO(dellaert): not loving this.
-      return exp(-factor->error(kEmpty)) / pair.first->normalizationConstant();
-    };
-
     DecisionTree<Key, double> probabilities(eliminationResults, probability);
 
     return {
@@ -265,7 +324,8 @@ hybridElimination(const HybridGaussianFactorGraph &factors,
     // Otherwise, we create a resulting GaussianMixtureFactor on the separator,
     // taking care to correct for conditional constant.
 
-    // Correct for the normalization constant used up by the conditional
+    // Correct for the normalization constant used up by the conditional.
+    // Leaves of the tree can share a result, so correct each result once.
     auto correct = [&](const Result &pair) {
       const auto &factor = pair.second;
       if (!factor) return;
@@ -273,7 +333,7 @@ hybridElimination(const HybridGaussianFactorGraph &factors,
       if (!hf) throw std::runtime_error("Expected HessianFactor!");
       hf->constantTerm() += 2.0 * pair.first->logNormalizationConstant();
     };
-    eliminationResults.visit(correct);
+    for (const Result &result : results) correct(result);
 
     const auto mixtureFactor = std::make_shared<GaussianMixtureFactor>(
         continuousSeparator, discreteSeparator, newFactors);
@@ -297,9 +357,10 @@ hybridElimination(const HybridGaussianFactorGraph &factors,
  * eliminate a discrete variable (as specified in the ordering), the result will
  * be INCORRECT and there will be NO error raised.
  */
-std::pair<HybridConditional::shared_ptr, std::shared_ptr<Factor>>  //
-EliminateHybrid(const HybridGaussianFactorGraph &factors,
-                const Ordering &frontalKeys) {
+static std::pair<HybridConditional::shared_ptr, std::shared_ptr<Factor>>
+eliminateHybrid(const HybridGaussianFactorGraph &factors,
+                const Ordering &frontalKeys,
+                const Pruning *pruning) {
   // NOTE: Because we are in the Conditional Gaussian regime there are only
   // a few cases:
   // 1. continuous variable, make a Gaussian Mixture if there are hybrid
@@ -405,10 +466,26 @@ EliminateHybrid(const HybridGaussianFactorGraph &factors,
     }
 
     return hybridElimination(factors, frontalKeys, continuousSeparator,
-                             discreteSeparator);
+                             discreteSeparator, pruning);
   }
 }
 
+/* ************************************************************************ */
+std::pair<HybridConditional::shared_ptr, std::shared_ptr<Factor>>  //
+EliminateHybrid(const HybridGaussianFactorGraph &factors,
+                const Ordering &frontalKeys) {
+  return eliminateHybrid(factors, frontalKeys, nullptr);
+}
+
+/* ************************************************************************ */
+std::pair<HybridConditional::shared_ptr, std::shared_ptr<Factor>>  //
+EliminateHybridPruned(const HybridGaussianFactorGraph &factors,
+                      const Ordering &frontalKeys, size_t maxNrLeaves,
+                      const DecisionTreeFactor::shared_ptr &discretePrior) {
+  const Pruning pruning{maxNrLeaves, discretePrior};
+  return eliminateHybrid(factors, frontalKeys, &pruning);
+}
+
 /* ************************************************************************ */
 AlgebraicDecisionTree<Key> HybridGaussianFactorGraph::error(
     const VectorValues &continuousValues) const {
@@ -440,6 +517,24 @@ AlgebraicDecisionTree<Key> HybridGaussianFactorGraph::error(
   return error_tree;
 }
 
+/* ************************************************************************ */
+DecisionTreeFactor::shared_ptr HybridGaussianFactorGraph::discretePrior()
+    const {
+  DecisionTreeFactor::shared_ptr prior;
+  for (auto &&factor : factors_) {
+    DiscreteFactor::shared_ptr discrete;
+    if (auto hc = std::dynamic_pointer_cast<HybridConditional>(factor)) {
+      discrete = hc->asDiscrete();
+    } else {
+      discrete = std::dynamic_pointer_cast<DiscreteFactor>(factor);
+    }
+    if (!discrete) continue;
+    const DecisionTreeFactor dtf = discrete->toDecisionTreeFactor();
+    prior = std::make_shared<DecisionTreeFactor>(prior ? *prior * dtf : dtf);
+  }
+  return prior;
+}
+
 /* ************************************************************************ */
 double HybridGaussianFactorGraph::probPrime(const HybridValues &values) const {
   double error = this->error(values);
@@ -56,6 +56,36 @@ GTSAM_EXPORT
 std::pair<std::shared_ptr<HybridConditional>, std::shared_ptr<Factor>>
 EliminateHybrid(const HybridGaussianFactorGraph& factors, const Ordering& keys);
 
+/**
+ * @brief Elimination function that prunes the modes during elimination.
+ *
+ * Like EliminateHybrid, but once the last continuous keys of a branch are
+ * eliminated, it keeps only the \c maxNrLeaves discrete assignments with the
+ * highest probability times the optional discrete prior, i.e., a beam search
+ * over the modes. The other assignments get no conditional and zero
+ * probability, so the modes carried to the next update are bounded before
+ * the discrete keys are eliminated, rather than after.
+ *
+ * Cliques that still have a continuous separator are not pruned, as modes
+ * whose evidence is still to come cannot be ranked yet. Discrete factors are
+ * eliminated after the continuous keys, so pass the ones already known, e.g.,
+ * the discrete posterior of the previous time step, as prior. To use with
+ * eliminate or ISAM, bind the arguments in a lambda.
+ *
+ * @param factors The factor graph to eliminate.
+ * @param keys The elimination ordering.
+ * @param maxNrLeaves The maximum number of modes to keep.
+ * @param discretePrior Optional prior on the discrete keys to rank the modes.
+ * @return The conditional on the ordering keys and the remaining factors.
+ * @ingroup hybrid
+ */
+GTSAM_EXPORT
+std::pair<std::shared_ptr<HybridConditional>, std::shared_ptr<Factor>>
+EliminateHybridPruned(const HybridGaussianFactorGraph& factors,
+                      const Ordering& keys, size_t maxNrLeaves,
+                      const std::shared_ptr<DecisionTreeFactor>& discretePrior =
+                          nullptr);
+
 /**
  * @brief Return a Colamd constrained ordering where the discrete keys are
  * eliminated after the continuous keys.
@@ -193,6 +223,14 @@ class GTSAM_EXPORT HybridGaussianFactorGraph
    */
   GaussianFactorGraphTree assembleGraphTree() const;
 
+  /**
+   * @brief Product of the discrete factors and of the discrete conditionals in
+   * the graph, e.g., to rank the modes in EliminateHybridPruned.
+   *
+   * @return The product, or nullptr if there are no discrete factors.
+   */
+  std::shared_ptr<DecisionTreeFactor> discretePrior() const;
+
   /// @}
 };
 
@@ -32,7 +32,8 @@ namespace gtsam {
 // template class ISAM<HybridBayesTree>;
 
 /* ************************************************************************* */
-HybridGaussianISAM::HybridGaussianISAM() {}
+HybridGaussianISAM::HybridGaussianISAM(bool pruneDuringElimination)
+    : pruneDuringElimination_(pruneDuringElimination) {}
 
 /* ************************************************************************* */
 HybridGaussianISAM::HybridGaussianISAM(const HybridBayesTree& bayesTree)
@@ -100,9 +101,24 @@ void HybridGaussianISAM::updateInternal(
     elimination_ordering = GetOrdering(factors, newFactors);
   }
 
-  // eliminate all factors (top, added, orphans) into a new Bayes tree
-  HybridBayesTree::shared_ptr bayesTree =
-      factors.eliminateMultifrontal(elimination_ordering, function, std::cref(index));
+  // eliminate all factors (top, added, orphans) into a new Bayes tree, if
+  // asked pruning the modes in every clique. The discrete conditionals of the
+  // removed top rank the modes in the beam.
+  HybridBayesTree::shared_ptr bayesTree;
+  if (maxNrLeaves && pruneDuringElimination_) {
+    const size_t cap = *maxNrLeaves;
+    const auto prior = factors.discretePrior();
+    bayesTree = factors.eliminateMultifrontal(
+        elimination_ordering,
+        [cap, prior](const HybridGaussianFactorGraph& factors,
+                     const Ordering& keys) {
+          return EliminateHybridPruned(factors, keys, cap, prior);
+        },
+        std::cref(index));
+  } else {
+    bayesTree = factors.eliminateMultifrontal(elimination_ordering, function,
+                                              std::cref(index));
+  }
 
   if (maxNrLeaves) {
     bayesTree->prune(*maxNrLeaves);
@@ -39,11 +39,22 @@ class GTSAM_EXPORT HybridGaussianISAM : public ISAM<HybridBayesTree> {
   typedef HybridGaussianISAM This;
   typedef std::shared_ptr<This> shared_ptr;
 
+ private:
+  /// Whether updates with maxNrLeaves also prune during elimination.
+  bool pruneDuringElimination_ = false;
+
+ public:
   /// @name Standard Constructors
   /// @{
 
-  /** Create an empty Bayes Tree */
-  HybridGaussianISAM();
+  /**
+   * Create an empty Bayes Tree.
+   *
+   * @param pruneDuringElimination If true, updates with maxNrLeaves eliminate
+   * with EliminateHybridPruned, bounding the modes in every clique rather than
+   * only after elimination.
+   */
+  explicit HybridGaussianISAM(bool pruneDuringElimination = false);
 
   /** Copy constructor */
   HybridGaussianISAM(const HybridBayesTree& bayesTree);
@@ -67,7 +78,8 @@ class GTSAM_EXPORT HybridGaussianISAM : public ISAM<HybridBayesTree> {
    * @param newFactors Factor graph of new factors to add and eliminate.
    * @param maxNrLeaves The maximum number of leaves to keep after pruning.
    * @param ordering Custom elimination ordering.
-   * @param function Elimination function.
+   * @param function Elimination function. Not used when pruning during
+   * elimination, which eliminates with EliminateHybridPruned.
    */
   void update(const HybridGaussianFactorGraph& newFactors,
               const std::optional<size_t>& maxNrLeaves = {},
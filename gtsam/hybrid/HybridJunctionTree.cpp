@@ -112,6 +112,7 @@ struct HybridConstructorTraversalData {
     const FastVector<SymbolicConditional::shared_ptr>& childConditionals =
         data.childSymbolicConditionals;
     jt_node->problemSize_ = (int)(conditional->size() * symbolicFactors.size());
+    jt_node->separatorSize_ = (int)conditional->nrParents();
 
     // Merge our children if they are in our clique - if our conditional has
     // exactly one fewer parent than our child's conditional.
@@ -19,10 +19,35 @@
 #include <gtsam/hybrid/HybridSmoother.h>
 
 #include <algorithm>
+#include <chrono>
 #include <unordered_set>
 
 namespace gtsam {
 
+/* ************************************************************************* */
+/// Largest number of non-pruned components of a mixture in the Bayes net.
+static size_t MaxNrModes(const HybridBayesNet &bayesNet) {
+  size_t maxNrModes = 0;
+  for (auto &&conditional : bayesNet) {
+    auto mixture = conditional ? conditional->asMixture() : nullptr;
+    if (!mixture) continue;
+    size_t nrModes = 0;
+    mixture->conditionals().visit(
+        [&](const GaussianConditional::shared_ptr &gc) {
+          if (gc) ++nrModes;
+        });
+    maxNrModes = std::max(maxNrModes, nrModes);
+  }
+  return maxNrModes;
+}
+
+/// Seconds elapsed since start.
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
 /* ************************************************************************* */
 Ordering HybridSmoother::getOrdering(
     const HybridGaussianFactorGraph &newFactors) {
@@ -71,11 +96,27 @@ void HybridSmoother::update(HybridGaussianFactorGraph graph,
   std::tie(graph, hybridBayesNet_) =
       addConditionals(graph, hybridBayesNet_, ordering);
 
-  // Eliminate.
-  HybridBayesNet::shared_ptr bayesNetFragment =
-      graph.eliminateSequential(ordering);
+  // Eliminate, if asked pruning the modes in every clique. The discrete
+  // posterior of the previous steps ranks the modes in the beam.
+  auto start = std::chrono::steady_clock::now();
+  HybridBayesNet::shared_ptr bayesNetFragment;
+  if (maxNrLeaves && pruneDuringElimination_) {
+    const size_t cap = *maxNrLeaves;
+    const auto prior = graph.discretePrior();
+    bayesNetFragment = graph.eliminateSequential(
+        ordering, [cap, prior](const HybridGaussianFactorGraph &factors,
+                               const Ordering &keys) {
+          return EliminateHybridPruned(factors, keys, cap, prior);
+        });
+  } else {
+    bayesNetFragment = graph.eliminateSequential(ordering);
+  }
+  statistics_ = Statistics();
+  statistics_.eliminationTime = SecondsSince(start);
+  statistics_.maxNrModes = MaxNrModes(*bayesNetFragment);
 
   /// Prune
+  start = std::chrono::steady_clock::now();
   if (maxNrLeaves) {
     // `pruneBayesNet` sets the leaves with 0 in discreteFactor to nullptr in
     // all the conditionals with the same keys in bayesNetFragment.
@@ -84,6 +125,8 @@ void HybridSmoother::update(HybridGaussianFactorGraph graph,
     // Set the bayes net fragment to the pruned version
     bayesNetFragment = std::make_shared<HybridBayesNet>(prunedBayesNetFragment);
   }
+  statistics_.pruningTime = SecondsSince(start);
+  statistics_.nrModes = MaxNrModes(*bayesNetFragment);
 
   // Add the partial bayes net to the posterior bayes net.
   hybridBayesNet_.add(*bayesNetFragment);
@@ -25,11 +25,34 @@
 namespace gtsam {
 
 class GTSAM_EXPORT HybridSmoother {
+ public:
+  /// Timing and mode counts of the last update.
+  struct Statistics {
+    double eliminationTime = 0.0;  ///< Wall time of elimination, in seconds
+    double pruningTime = 0.0;      ///< Wall time of pruning, in seconds
+    /// Largest number of modes of a conditional in the eliminated fragment
+    size_t maxNrModes = 0;
+    /// Largest number of modes of a conditional after pruning
+    size_t nrModes = 0;
+  };
+
  private:
   HybridBayesNet hybridBayesNet_;
   HybridGaussianFactorGraph remainingFactorGraph_;
+  bool pruneDuringElimination_;
+  Statistics statistics_;
 
  public:
+  /**
+   * @brief Construct a new Hybrid Smoother.
+   *
+   * @param pruneDuringElimination If true, updates with maxNrLeaves eliminate
+   * with EliminateHybridPruned, so the number of modes stays bounded during
+   * elimination instead of only after it.
+   */
+  explicit HybridSmoother(bool pruneDuringElimination = false)
+      : pruneDuringElimination_(pruneDuringElimination) {}
+
   /**
    * Given new factors, perform an incremental update.
    * The relevant densities in the `hybridBayesNet` will be added to the input
@@ -39,9 +62,10 @@ class GTSAM_EXPORT HybridSmoother {
    * discrete factor on all discrete keys, plus all discrete factors in the
    * original graph.
    *
-   * \note If maxComponents is given, we look at the discrete factor resulting
+   * \note If maxNrLeaves is given, we look at the discrete factor resulting
    * from this elimination, and prune it and the Gaussian components
-   * corresponding to the pruned choices.
+   * corresponding to the pruned choices. If the smoother prunes during
+   * elimination, the modes are also capped to maxNrLeaves in every clique.
    *
    * @param graph The new factors, should be linear only
    * @param maxNrLeaves The maximum number of leaves in the new discrete factor,
@@ -73,6 +97,9 @@ class GTSAM_EXPORT HybridSmoother {
 
   /// Return the Bayes Net posterior.
   const HybridBayesNet& hybridBayesNet() const;
+
+  /// Return the timing and mode counts of the last update.
+  const Statistics& statistics() const { return statistics_; }
 };
 
 }  // namespace gtsam
@@ -140,6 +140,64 @@ TEST(HybridEstimation, IncrementalSmoother) {
   EXPECT(assert_equal(expected_continuous, result));
 }
 
+/****************************************************************************/
+// Test the incremental smoother when pruning during elimination.
+TEST(HybridEstimation, IncrementalSmootherPruneDuringElimination) {
+  size_t K = 15;
+  std::vector<double> measurements = {0, 1, 2, 2, 2, 2,  3,  4,  5,  6, 6,
+                                      7, 8, 9, 9, 9, 10, 11, 11, 11, 11};
+  // Ground truth discrete seq
+  std::vector<size_t> discrete_seq = {1, 1, 0, 0, 0, 1, 1, 1, 1, 0,
+                                      1, 1, 1, 0, 0, 1, 1, 0, 0, 0};
+  Switching switching(K, 1.0, 0.1, measurements, "1/1 1/1");
+  HybridSmoother smoother(true);
+  HybridNonlinearFactorGraph graph;
+  Values initial;
+
+  // Add the X(0) prior
+  graph.push_back(switching.nonlinearFactorGraph.at(0));
+  initial.insert(X(0), switching.linearizationPoint.at<double>(X(0)));
+
+  const size_t maxNrLeaves = 3;
+  for (size_t k = 1; k < K; k++) {
+    // Motion Model
+    graph.push_back(switching.nonlinearFactorGraph.at(k));
+    // Measurement
+    graph.push_back(switching.nonlinearFactorGraph.at(k + K - 1));
+
+    initial.insert(X(k), switching.linearizationPoint.at<double>(X(k)));
+
+    HybridGaussianFactorGraph linearized = *graph.linearize(initial);
+    Ordering ordering = smoother.getOrdering(linearized);
+
+    smoother.update(linearized, maxNrLeaves, ordering);
+    graph.resize(0);
+
+    // The modes are bounded during elimination, not only after it.
+    const auto& statistics = smoother.statistics();
+    EXPECT(statistics.maxNrModes <= 2 * maxNrLeaves);
+    EXPECT(statistics.nrModes <= maxNrLeaves);
+    EXPECT(statistics.eliminationTime >= 0.0);
+    EXPECT(statistics.pruningTime >= 0.0);
+  }
+
+  HybridValues delta = smoother.hybridBayesNet().optimize();
+
+  Values result = initial.retract(delta.continuous());
+
+  DiscreteValues expected_discrete;
+  for (size_t k = 0; k < K - 1; k++) {
+    expected_discrete[M(k)] = discrete_seq[k];
+  }
+  EXPECT(assert_equal(expected_discrete, delta.discrete()));
+
+  Values expected_continuous;
+  for (size_t k = 0; k < K; k++) {
+    expected_continuous.insert(X(k), measurements[k]);
+  }
+  EXPECT(assert_equal(expected_continuous, result));
+}
+
 /****************************************************************************/
 // Test approximate inference with an additional pruning step.
 TEST(HybridEstimation, ISAM) {
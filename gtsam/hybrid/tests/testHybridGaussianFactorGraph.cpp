@@ -551,6 +551,44 @@ TEST(HybridGaussianFactorGraph, Conditionals) {
   EXPECT(assert_equal(expected_discrete, result.discrete()));
 }
 
+/* ************************************************************************* */
+// Test pruning the modes during elimination.
+TEST(HybridGaussianFactorGraph, EliminateHybridPruned) {
+  Switching switching(4);
+  const HybridGaussianFactorGraph& hfg = switching.linearizedFactorGraph;
+  const Ordering ordering{X(0), X(1), X(2), X(3), M(0), M(1), M(2)};
+
+  // The discrete factors are eliminated last, so pass them to rank the modes.
+  auto prior = std::make_shared<DecisionTreeFactor>();
+  for (auto&& factor : hfg) {
+    if (auto df = std::dynamic_pointer_cast<DecisionTreeFactor>(factor))
+      *prior = *prior * *df;
+  }
+
+  const size_t maxNrLeaves = 3;
+  auto pruned = hfg.eliminateSequential(
+      ordering, [&](const HybridGaussianFactorGraph& factors,
+                    const Ordering& keys) {
+        return EliminateHybridPruned(factors, keys, maxNrLeaves, prior);
+      });
+
+  // Only the mixture on the last continuous key is pruned.
+  auto countModes = [](const HybridConditional& conditional) {
+    size_t nrModes = 0;
+    conditional.asMixture()->conditionals().visit(
+        [&](const GaussianConditional::shared_ptr& gc) {
+          if (gc) ++nrModes;
+        });
+    return nrModes;
+  };
+  EXPECT_LONGS_EQUAL(8, countModes(*pruned->at(2)));
+  EXPECT_LONGS_EQUAL(maxNrLeaves, countModes(*pruned->at(3)));
+
+  // The most probable modes are kept.
+  auto full = hfg.eliminateSequential(ordering);
+  EXPECT(assert_equal(full->optimize(), pruned->optimize()));
+}
+
 /* ****************************************************************************/
 // Test hybrid gaussian factor graph error and unnormalized probabilities
 TEST(HybridGaussianFactorGraph, ErrorAndProbPrime) {
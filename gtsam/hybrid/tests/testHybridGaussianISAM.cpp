@@ -356,6 +356,51 @@ TEST(HybridGaussianElimination, Incremental_approximate) {
       5, incrementalHybrid[X(4)]->conditional()->asMixture()->nrComponents());
 }
 
+/* ****************************************************************************/
+// Test approximate inference with pruning during elimination.
+TEST(HybridGaussianElimination, Incremental_pruneDuringElimination) {
+  Switching switching(5);
+  HybridGaussianISAM exact, incrementalHybrid(true);
+  HybridGaussianFactorGraph graph1;
+
+  /***** Run Round 1 *****/
+  for (size_t i = 1; i < 4; i++) {
+    graph1.push_back(switching.linearizedFactorGraph.at(i));
+  }
+  graph1.push_back(switching.linearizedFactorGraph.at(0));
+  for (size_t i = 5; i <= 7; i++) {
+    graph1.push_back(switching.linearizedFactorGraph.at(i));
+  }
+
+  size_t maxComponents = 5;
+  exact.update(graph1);
+  incrementalHybrid.update(graph1, maxComponents);
+
+  // No mixture keeps more than maxComponents modes.
+  EXPECT_LONGS_EQUAL(4, incrementalHybrid.size());
+  for (size_t k = 0; k < 4; k++) {
+    auto mixture = incrementalHybrid[X(k)]->conditional()->asMixture();
+    EXPECT(mixture->nrComponents() <= maxComponents);
+  }
+
+  /***** Run Round 2 *****/
+  HybridGaussianFactorGraph graph2;
+  graph2.push_back(switching.linearizedFactorGraph.at(4));
+  graph2.push_back(switching.linearizedFactorGraph.at(8));
+
+  exact.update(graph2);
+  incrementalHybrid.update(graph2, maxComponents);
+
+  CHECK_EQUAL(5, incrementalHybrid.size());
+  for (size_t k = 0; k < 5; k++) {
+    auto mixture = incrementalHybrid[X(k)]->conditional()->asMixture();
+    EXPECT(mixture->nrComponents() <= maxComponents);
+  }
+
+  // The beam keeps the most probable modes, so the MAP estimate is unchanged.
+  EXPECT(assert_equal(exact.optimize(), incrementalHybrid.optimize()));
+}
+
 /* ************************************************************************/
 // A GTSAM-only test for running inference on a single-legged robot.
 // The leg links are represented by the chain X-Y-Z-W, where X is the base and
@@ -12,13 +12,13 @@
 #include <gtsam/inference/ClusterTree.h>
 #include <gtsam/inference/BayesTree.h>
 #include <gtsam/inference/Ordering.h>
+#include <gtsam/base/MonotonicArena.h>
 #include <gtsam/base/timing.h>
 #include <gtsam/base/treeTraversal-inst.h>
 
-#ifdef GTSAM_USE_TBB
-#include <mutex>
-#endif
 #include <queue>
+#include <utility>
+#include <vector>
 
 namespace gtsam {
 
@@ -147,6 +147,10 @@ ClusterTree<GRAPH>& ClusterTree<GRAPH>::operator=(const This& other) {
 // Elimination traversal data - stores a pointer to the parent data and collects
 // the factors resulting from elimination of the children.  Also sets up BayesTree
 // cliques with parent and child pointers.
+// Every child gets a preassigned slot in its parent's childFactors and in the
+// children of its parent's clique, so the parallel traversal needs no locks:
+// slots are handed out by the parent's pre-order loop, which runs in a single
+// task, and each slot is only written by the child that owns it.
 template<class CLUSTERTREE>
 struct EliminationData {
   // Typedefs
@@ -158,35 +162,22 @@ struct EliminationData {
 
   EliminationData* const parentData;
   size_t myIndexInParent;
+  size_t nrChildrenAssigned;  ///< Number of child slots handed out so far
   FastVector<sharedFactor> childFactors;
   std::shared_ptr<BTNode> bayesTreeNode;
-#ifdef GTSAM_USE_TBB
-  std::shared_ptr<std::mutex> writeLock;
-#endif
 
   EliminationData(EliminationData* _parentData, size_t nChildren) :
-      parentData(_parentData), bayesTreeNode(std::make_shared<BTNode>())
-#ifdef GTSAM_USE_TBB
-      , writeLock(std::make_shared<std::mutex>())
-#endif
-    {
-    if (parentData) {
-#ifdef GTSAM_USE_TBB
-      parentData->writeLock->lock();
-#endif
-      myIndexInParent = parentData->childFactors.size();
-      parentData->childFactors.push_back(sharedFactor());
-#ifdef GTSAM_USE_TBB
-      parentData->writeLock->unlock();
-#endif
-    } else {
-      myIndexInParent = 0;
-    }
-    // Set up BayesTree parent and child pointers
+      parentData(_parentData), myIndexInParent(0), nrChildrenAssigned(0),
+      childFactors(nChildren), bayesTreeNode(std::make_shared<BTNode>()) {
+    bayesTreeNode->children.resize(nChildren);
     if (parentData) {
+      // Take the next slot of the parent
+      myIndexInParent = parentData->nrChildrenAssigned++;
+      assert(myIndexInParent < parentData->childFactors.size());
+      // Set up BayesTree parent and child pointers
       if (parentData->parentData) // If our parent is not the dummy node
         bayesTreeNode->parent_ = parentData->bayesTreeNode;
-      parentData->bayesTreeNode->children.push_back(bayesTreeNode);
+      parentData->bayesTreeNode->children[myIndexInParent] = bayesTreeNode;
     }
   }
 
@@ -204,27 +195,30 @@ struct EliminationData {
   // resulting conditional to the BayesTree, and add the remaining factor to the parent.
   class EliminationPostOrderVisitor {
     const typename CLUSTERTREE::Eliminate& eliminationFunction_;
-    typename CLUSTERTREE::BayesTreeType::Nodes& nodesIndex_;
+    MonotonicArena* arena_;  // Arena of the eliminating thread, if any
 
   public:
     // Construct functor
     EliminationPostOrderVisitor(
-        const typename CLUSTERTREE::Eliminate& eliminationFunction,
-        typename CLUSTERTREE::BayesTreeType::Nodes& nodesIndex) :
-        eliminationFunction_(eliminationFunction), nodesIndex_(nodesIndex) {
+        const typename CLUSTERTREE::Eliminate& eliminationFunction) :
+        eliminationFunction_(eliminationFunction), arena_(MonotonicArena::Current()) {
     }
 
     // Function that does the HEAVY lifting
     void operator()(const typename CLUSTERTREE::sharedNode& node, EliminationData& myData) {
       assert(node);
 
+      // Elimination results go in the same arena on all TBB threads
+      MonotonicArena::Scope scope(arena_);
+
       // Gather factors
       FactorGraphType gatheredFactors;
       gatheredFactors.reserve(node->factors.size() + node->nrChildren());
       gatheredFactors.push_back(node->factors);
       gatheredFactors.push_back(myData.childFactors);
 
-      // Check for Bayes tree orphan subtrees, and add them to our children
+      // Check for Bayes tree orphan subtrees, and add them to our children. They
+      // come after the slots of the eliminated children.
       // TODO(frank): should this really happen here?
       for (const sharedFactor& factor: node->factors) {
         auto asSubtree = dynamic_cast<const BayesTreeOrphanWrapper<BTNode>*>(factor.get());
@@ -242,28 +236,42 @@ struct EliminationData {
       // remaining factor
       myData.bayesTreeNode->setEliminationResult(eliminationResult);
 
-      // Fill nodes index - we do this here instead of calling insertRoot at the end to avoid
-      // putting orphan subtrees in the index - they'll already be in the index of the ISAM2
-      // object they're added to.
-      for (const Key& j : myData.bayesTreeNode->conditional()->frontals()) {
-#ifdef GTSAM_USE_TBB
-        nodesIndex_.insert({j, myData.bayesTreeNode});
-#else
-        nodesIndex_.emplace(j, myData.bayesTreeNode);
-#endif
-      }
-      // Store remaining factor in parent's gathered factors
-      if (!eliminationResult.second->empty()) {
-#ifdef GTSAM_USE_TBB
-        myData.parentData->writeLock->lock();
-#endif
+      // Store remaining factor in our slot of the parent's gathered factors
+      if (!eliminationResult.second->empty())
         myData.parentData->childFactors[myData.myIndexInParent] = eliminationResult.second;
-#ifdef GTSAM_USE_TBB
-        myData.parentData->writeLock->unlock();
-#endif
-      }
     }
   };
+
+  // Fill the nodes index of the eliminated Bayes tree in one pass after elimination.
+  // Walks the cluster tree and the Bayes tree side by side so that only cliques
+  // created by the elimination are indexed: orphan subtrees, stored after the
+  // child slots, are already in the index of the ISAM2 object they're added to.
+  static void FillNodesIndex(const CLUSTERTREE& clusterTree, const EliminationData& rootsData,
+                             typename CLUSTERTREE::BayesTreeType::Nodes& nodesIndex) {
+    gttic(FillNodesIndex);
+    typedef std::pair<const typename CLUSTERTREE::Cluster*, const BTNode*> NodePair;
+    std::vector<NodePair> stack;
+    std::vector<std::pair<Key, std::shared_ptr<BTNode>>> entries;
+    const auto& roots = clusterTree.roots();
+    for (size_t i = 0; i < roots.size(); ++i) {
+      const auto& clique = rootsData.bayesTreeNode->children[i];
+      for (const Key& j : clique->conditional()->frontals()) entries.emplace_back(j, clique);
+      stack.emplace_back(roots[i].get(), clique.get());
+    }
+    while (!stack.empty()) {
+      const NodePair nodes = stack.back();
+      stack.pop_back();
+      for (size_t i = 0; i < nodes.first->children.size(); ++i) {
+        const auto& clique = nodes.second->children[i];
+        for (const Key& j : clique->conditional()->frontals()) entries.emplace_back(j, clique);
+        stack.emplace_back(nodes.first->children[i].get(), clique.get());
+      }
+    }
+#ifdef GTSAM_USE_TBB
+    nodesIndex.rehash(entries.size());
+#endif
+    nodesIndex.insert(entries.begin(), entries.end());
+  }
 };
 
 /* ************************************************************************* */
@@ -283,6 +291,15 @@ EliminatableClusterTree<BAYESTREE, GRAPH>& EliminatableClusterTree<BAYESTREE, GR
 template <class BAYESTREE, class GRAPH>
 std::pair<std::shared_ptr<BAYESTREE>, std::shared_ptr<GRAPH> >
 EliminatableClusterTree<BAYESTREE, GRAPH>::eliminate(const Eliminate& function) const {
+  return eliminate(function, treeTraversal::ParallelTraversalParams());
+}
+
+/* ************************************************************************* */
+template <class BAYESTREE, class GRAPH>
+std::pair<std::shared_ptr<BAYESTREE>, std::shared_ptr<GRAPH> >
+EliminatableClusterTree<BAYESTREE, GRAPH>::eliminate(
+    const Eliminate& function, const treeTraversal::ParallelTraversalParams& params,
+    treeTraversal::ParallelTraversalStatistics* statistics) const {
   gttic(ClusterTree_eliminate);
   // Do elimination (depth-first traversal).  The rootsContainer stores a 'dummy' BayesTree node
   // that contains all of the roots as its children.  rootsContainer also stores the remaining
@@ -292,13 +309,18 @@ EliminatableClusterTree<BAYESTREE, GRAPH>::eliminate(const Eliminate& function)
   typedef EliminationData<This> Data;
   Data rootsContainer(0, this->nrRoots());
 
-  typename Data::EliminationPostOrderVisitor visitorPost(function, result->nodes_);
+  typename Data::EliminationPostOrderVisitor visitorPost(function);
   {
     TbbOpenMPMixedScope threadLimiter;  // Limits OpenMP threads since we're mixing TBB and OpenMP
+    auto cost = [](const typename This::Node& cluster) { return cluster.eliminationCost(); };
     treeTraversal::DepthFirstForestParallel(*this, rootsContainer, Data::EliminationPreOrderVisitor,
-                                            visitorPost, 10);
+                                            visitorPost, cost, params, statistics);
   }
 
+  // Fill nodes index - we do this here instead of calling insertRoot to avoid putting orphan
+  // subtrees in the index.
+  Data::FillNodesIndex(*this, rootsContainer, result->nodes_);
+
   // Create BayesTree from roots stored in the dummy BayesTree node.
   result->roots_.insert(result->roots_.end(), rootsContainer.bayesTreeNode->children.begin(),
                         rootsContainer.bayesTreeNode->children.end());
@@ -11,6 +11,8 @@
 
 #include <gtsam/base/Testable.h>
 #include <gtsam/base/FastVector.h>
+#include <gtsam/base/treeTraversal/scheduling.h>
+#include <gtsam/base/treeTraversal/statistics.h>
 #include <gtsam/inference/Ordering.h>
 
 namespace gtsam {
@@ -44,7 +46,9 @@ class ClusterTree {
 
     int problemSize_;
 
-    Cluster() : problemSize_(0) {}
+    int separatorSize_;  ///< Number of separator keys, used to estimate elimination cost
+
+    Cluster() : problemSize_(0), separatorSize_(0) {}
 
     virtual ~Cluster() {}
 
@@ -55,7 +59,7 @@ class ClusterTree {
     /// Construct from factors associated with a single key
     template <class CONTAINER>
     Cluster(Key key, const CONTAINER& factorsToAdd)
-        : problemSize_(0) {
+        : problemSize_(0), separatorSize_(0) {
       addFactors(key, factorsToAdd);
     }
 
@@ -89,6 +93,17 @@ class ClusterTree {
       return problemSize_;
     }
 
+    int separatorSize() const {
+      return separatorSize_;
+    }
+
+    /// Estimated cost of eliminating this cluster, for scheduling parallel
+    /// elimination: the flops of a dense partial factorization, in units of keys.
+    double eliminationCost() const {
+      const double f = double(nrFrontals()), n = f + separatorSize_;
+      return f * n * n + double(nrFactors());
+    }
+
     /// print this node
     virtual void print(const std::string& s = "",
                        const KeyFormatter& keyFormatter = DefaultKeyFormatter) const;
@@ -224,6 +239,17 @@ class EliminatableClusterTree : public ClusterTree<GRAPH> {
   std::pair<std::shared_ptr<BayesTreeType>, std::shared_ptr<FactorGraphType> > eliminate(
       const Eliminate& function) const;
 
+  /** Eliminate the factors to a Bayes tree and remaining factor graph, with the given
+   * parallel scheduling parameters. Cluster costs are estimated by Cluster::eliminationCost.
+   * @param function The function to use to eliminate
+   * @param params Parameters of the parallel traversal, see treeTraversal::ParallelTraversalParams
+   * @param statistics If not null, filled with the scheduling decisions of the traversal
+   * @return The Bayes tree and factor graph resulting from elimination
+   */
+  std::pair<std::shared_ptr<BayesTreeType>, std::shared_ptr<FactorGraphType> > eliminate(
+      const Eliminate& function, const treeTraversal::ParallelTraversalParams& params,
+      treeTraversal::ParallelTraversalStatistics* statistics = nullptr) const;
+
   /// @}
 
   /// @name Advanced Interface
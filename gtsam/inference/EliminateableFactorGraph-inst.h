@@ -125,17 +125,32 @@ namespace gtsam {
     EliminateableFactorGraph<FACTORGRAPH>::eliminateMultifrontal(
     const Ordering& ordering, const Eliminate& function,
     OptionalVariableIndex variableIndex) const
+  {
+    return eliminateMultifrontal(ordering, function, variableIndex,
+                                 treeTraversal::ParallelTraversalParams());
+  }
+
+  /* ************************************************************************* */
+  template<class FACTORGRAPH>
+  std::shared_ptr<typename EliminateableFactorGraph<FACTORGRAPH>::BayesTreeType>
+    EliminateableFactorGraph<FACTORGRAPH>::eliminateMultifrontal(
+    const Ordering& ordering, const Eliminate& function,
+    OptionalVariableIndex variableIndex,
+    const treeTraversal::ParallelTraversalParams& parallelParams,
+    treeTraversal::ParallelTraversalStatistics* statistics) const
   {
     if(!variableIndex) {
       // If no VariableIndex provided, compute one and call this function again
       VariableIndex computedVariableIndex(asDerived());
-      return eliminateMultifrontal(ordering, function, std::cref(computedVariableIndex));
+      return eliminateMultifrontal(ordering, function, std::cref(computedVariableIndex),
+                                   parallelParams, statistics);
     } else {
       gttic(eliminateMultifrontal);
       // Do elimination with given ordering
       EliminationTreeType etree(asDerived(), (*variableIndex).get(), ordering);
       JunctionTreeType junctionTree(etree);
-      const auto [bayesTree, factorGraph] = junctionTree.eliminate(function);
+      const auto [bayesTree, factorGraph] =
+          junctionTree.eliminate(function, parallelParams, statistics);
       // If any factors are remaining, the ordering was incomplete
       if(!factorGraph->empty()) {
         throw InconsistentEliminationRequested(factorGraph->keys());
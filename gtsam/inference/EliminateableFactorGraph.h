@@ -25,6 +25,8 @@
 
 #include <gtsam/inference/Ordering.h>
 #include <gtsam/inference/VariableIndex.h>
+#include <gtsam/base/treeTraversal/scheduling.h>
+#include <gtsam/base/treeTraversal/statistics.h>
 
 namespace gtsam {
   /// Traits class for eliminateable factor graphs, specifies the types that result from
@@ -173,6 +175,26 @@ namespace gtsam {
       const Eliminate& function = EliminationTraitsType::DefaultEliminate,
       OptionalVariableIndex variableIndex = {}) const;
 
+    /** Do multifrontal elimination of all variables in \c ordering, with the given parameters of
+     *  the parallel elimination, see treeTraversal::ParallelTraversalParams. If \c statistics is not
+     *  null it is filled with the scheduling decisions, e.g. to check core utilization.
+     *
+     *  <b> Example - Spawn tasks for smaller subtrees, and print the scheduling statistics:
+     *  \code
+     *  treeTraversal::ParallelTraversalParams parallelParams;
+     *  parallelParams.minTaskCost = 100;
+     *  treeTraversal::ParallelTraversalStatistics statistics;
+     *  auto result = graph.eliminateMultifrontal(myOrdering, EliminateCholesky, {},
+     *                                            parallelParams, &statistics);
+     *  statistics.print(std::cout);
+     *  \endcode
+     *  */
+    std::shared_ptr<BayesTreeType> eliminateMultifrontal(
+      const Ordering& ordering, const Eliminate& function,
+      OptionalVariableIndex variableIndex,
+      const treeTraversal::ParallelTraversalParams& parallelParams,
+      treeTraversal::ParallelTraversalStatistics* statistics = nullptr) const;
+
     /** Do sequential elimination of some variables, in \c ordering provided, to produce a Bayes net
      *  and a remaining factor graph.  This computes the factorization \f$ p(X) = p(A|B) p(B) \f$,
      *  where \f$ A = \f$ \c variables, \f$ X \f$ is all the variables in the factor graph, and \f$
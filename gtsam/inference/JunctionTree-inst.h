@@ -94,6 +94,7 @@ struct ConstructorTraversalData {
     const FastVector<SymbolicConditional::shared_ptr>& childConditionals =
         myData.childSymbolicConditionals;
     node->problemSize_ = (int) (myConditional->size() * symbolicFactors.size());
+    node->separatorSize_ = (int) myConditional->nrParents();
 
     // Merge our children if they are in our clique - if our conditional has
     // exactly one fewer parent than our child's conditional.
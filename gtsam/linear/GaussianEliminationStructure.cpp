@@ -0,0 +1,115 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    GaussianEliminationStructure.cpp
+ * @brief   Cached symbolic multifrontal elimination for graphs with fixed sparsity
+ */
+
+#include <gtsam/linear/GaussianEliminationStructure.h>
+#include <gtsam/linear/GaussianEliminationTree.h>
+#include <gtsam/inference/VariableIndex.h>
+#include <gtsam/inference/inferenceExceptions.h>
+#include <gtsam/base/timing.h>
+
+#include <stdexcept>
+#include <unordered_map>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+GaussianEliminationStructure::GaussianEliminationStructure(
+    const GaussianFactorGraph& graph, const Ordering& ordering)
+    : ordering_(ordering) {
+  gttic(GaussianEliminationStructure);
+
+  // Remember the keys of every factor, and where it lives in the graph
+  factorKeys_.resize(graph.size());
+  std::unordered_map<const GaussianFactor*, size_t> factorIndex;
+  for (size_t i = 0; i < graph.size(); ++i) {
+    if (graph[i]) {
+      factorKeys_[i] = graph[i]->keys();
+      factorIndex.emplace(graph[i].get(), i);
+    }
+  }
+
+  // Build the junction tree once
+  const VariableIndex variableIndex(graph);
+  const GaussianEliminationTree etree(graph, variableIndex, ordering);
+  junctionTree_ = std::make_shared<GaussianJunctionTree>(etree);
+  if (!junctionTree_->remainingFactors().empty()) {
+    GaussianFactorGraph remaining;
+    remaining.push_back(junctionTree_->remainingFactors().begin(),
+                        junctionTree_->remainingFactors().end());
+    throw InconsistentEliminationRequested(remaining.keys());
+  }
+
+  // Record the factor indices of each cluster, and drop the factors themselves
+  std::vector<sharedCluster> stack(junctionTree_->roots().begin(),
+                                   junctionTree_->roots().end());
+  while (!stack.empty()) {
+    sharedCluster cluster = stack.back();
+    stack.pop_back();
+    FastVector<size_t> indices;
+    indices.reserve(cluster->factors.size());
+    for (const auto& factor : cluster->factors)
+      indices.push_back(factorIndex.at(factor.get()));
+    for (auto& factor : cluster->factors) factor.reset();
+    clusters_.push_back(cluster);
+    clusterFactors_.push_back(std::move(indices));
+    stack.insert(stack.end(), cluster->children.begin(),
+                 cluster->children.end());
+  }
+}
+
+/* ************************************************************************* */
+bool GaussianEliminationStructure::matches(const GaussianFactorGraph& graph,
+                                           const Ordering& ordering) const {
+  if (graph.size() != factorKeys_.size() || ordering != ordering_)
+    return false;
+  for (size_t i = 0; i < graph.size(); ++i) {
+    if (graph[i]) {
+      if (graph[i]->keys() != factorKeys_[i]) return false;
+    } else if (!factorKeys_[i].empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+GaussianBayesTree::shared_ptr GaussianEliminationStructure::eliminate(
+    const GaussianFactorGraph& graph,
+    const GaussianFactorGraph::Eliminate& function) const {
+  gttic(GaussianEliminationStructure_eliminate);
+  if (graph.size() != factorKeys_.size())
+    throw std::invalid_argument(
+        "GaussianEliminationStructure::eliminate: graph does not match the "
+        "cached structure");
+
+  // Re-fill the clusters with the factors of the new graph
+  for (size_t c = 0; c < clusters_.size(); ++c) {
+    auto& factors = clusters_[c]->factors;
+    const auto& indices = clusterFactors_[c];
+    for (size_t k = 0; k < indices.size(); ++k) factors[k] = graph[indices[k]];
+  }
+
+  GaussianBayesTree::shared_ptr bayesTree =
+      junctionTree_->eliminate(function).first;
+
+  // Release the factors so they do not outlive the graph
+  for (const auto& cluster : clusters_)
+    for (auto& factor : cluster->factors) factor.reset();
+
+  return bayesTree;
+}
+
+}  // namespace gtsam
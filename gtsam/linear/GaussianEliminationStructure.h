@@ -0,0 +1,88 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    GaussianEliminationStructure.h
+ * @brief   Cached symbolic multifrontal elimination for graphs with fixed sparsity
+ */
+
+#pragma once
+
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/GaussianJunctionTree.h>
+#include <gtsam/inference/Ordering.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * The symbolic part of multifrontal elimination of a GaussianFactorGraph: the
+ * junction tree built for a given ordering, together with the index of every
+ * factor in the cluster it was assigned to.
+ *
+ * Nonlinear optimizers re-linearize the same nonlinear graph every iteration,
+ * so the linear graphs they eliminate all have the same factor keys in the same
+ * order. Building the VariableIndex, elimination tree and junction tree is then
+ * only needed once: later graphs are eliminated by re-filling the clusters of
+ * the cached junction tree with the new factors.
+ *
+ * Example:
+ * \code
+ * GaussianEliminationStructure structure(*graph.linearize(x0), ordering);
+ * for (...) {
+ *   auto linear = graph.linearize(x);
+ *   if (!structure.matches(*linear, ordering)) { ... rebuild ... }
+ *   VectorValues delta = structure.eliminate(*linear, EliminateCholesky)->optimize();
+ * }
+ * \endcode
+ */
+class GTSAM_EXPORT GaussianEliminationStructure {
+ public:
+  typedef std::shared_ptr<GaussianEliminationStructure> shared_ptr;
+  typedef GaussianJunctionTree::sharedCluster sharedCluster;
+
+  /**
+   * Build the symbolic structure of eliminating \c graph with \c ordering.
+   * Throws InconsistentEliminationRequested if the ordering does not cover all
+   * variables of the graph.
+   */
+  GaussianEliminationStructure(const GaussianFactorGraph& graph,
+                               const Ordering& ordering);
+
+  /// Whether \c graph has the same factor layout as the graph this structure
+  /// was built from, and \c ordering is the same ordering.
+  bool matches(const GaussianFactorGraph& graph, const Ordering& ordering) const;
+
+  /**
+   * Eliminate a graph with the same structure, see matches(), into a Bayes tree.
+   * Throws std::invalid_argument if the number of factors differs.
+   */
+  GaussianBayesTree::shared_ptr eliminate(
+      const GaussianFactorGraph& graph,
+      const GaussianFactorGraph::Eliminate& function) const;
+
+  /// The elimination ordering
+  const Ordering& ordering() const { return ordering_; }
+
+  /// Number of clusters in the cached junction tree
+  size_t nrClusters() const { return clusters_.size(); }
+
+ private:
+  Ordering ordering_;
+  std::vector<KeyVector> factorKeys_;  ///< Keys of each factor, empty if null
+  std::shared_ptr<GaussianJunctionTree> junctionTree_;
+  std::vector<sharedCluster> clusters_;  ///< All clusters, in pre-order
+  std::vector<FastVector<size_t>> clusterFactors_;  ///< Factor indices, per cluster
+};
+
+}  // namespace gtsam
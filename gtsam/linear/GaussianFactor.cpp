@@ -20,6 +20,7 @@
 
 #include <gtsam/hybrid/HybridValues.h>
 #include <gtsam/linear/GaussianFactor.h>
+#include <gtsam/linear/PackedVectorValues.h>
 #include <gtsam/linear/VectorValues.h>
 
 namespace gtsam {
@@ -38,4 +39,13 @@ VectorValues GaussianFactor::hessianDiagonal() const {
   return d;
 }
 
+void GaussianFactor::multiplyHessianAdd(double alpha,
+                                        const PackedVectorValues& x,
+                                        PackedVectorValues& y) const {
+  VectorValues xValues, yValues;
+  for (Key key : keys_) xValues.emplace(key, x.at(key));
+  multiplyHessianAdd(alpha, xValues, yValues);
+  for (const auto& [key, value] : yValues) y.at(key) += value;
+}
+
 }  // namespace gtsam
@@ -28,6 +28,7 @@ namespace gtsam {
 
   // Forward declarations
   class VectorValues;
+  class PackedVectorValues;
   class Scatter;
   class SymmetricBlockMatrix;
 
@@ -157,6 +158,14 @@ namespace gtsam {
     /// y += alpha * A'*A*x
     virtual void multiplyHessianAdd(double alpha, const VectorValues& x, VectorValues& y) const = 0;
 
+    /**
+     * y += alpha * A'*A*x, with x and y packed in one buffer each. The default
+     * copies the variables of this factor into VectorValues, JacobianFactor
+     * and HessianFactor work on the buffers directly.
+     */
+    virtual void multiplyHessianAdd(double alpha, const PackedVectorValues& x,
+                                    PackedVectorValues& y) const;
+
     /// A'*b for Jacobian, eta for Hessian
     virtual VectorValues gradientAtZero() const = 0;
 
@@ -23,6 +23,7 @@
 #include <gtsam/linear/GaussianEliminationTree.h>
 #include <gtsam/linear/GaussianJunctionTree.h>
 #include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/PackedVectorValues.h>
 #include <gtsam/inference/FactorGraph-inst.h>
 #include <gtsam/inference/EliminateableFactorGraph-inst.h>
 #include <gtsam/base/debug.h>
@@ -410,6 +411,7 @@ namespace gtsam {
   Errors GaussianFactorGraph::operator*(const VectorValues& x) const {
     Errors e;
     for (const GaussianFactor::shared_ptr& factor: *this) {
+      if (!factor) continue;
       JacobianFactor::shared_ptr Ai = convertToJacobianFactorPtr(factor);
       e.push_back((*Ai) * x);
     }
@@ -423,6 +425,13 @@ namespace gtsam {
      f->multiplyHessianAdd(alpha, x, y);
   }
 
+  /* ************************************************************************* */
+  void GaussianFactorGraph::multiplyHessianAdd(double alpha,
+      const PackedVectorValues& x, PackedVectorValues& y) const {
+    for (const GaussianFactor::shared_ptr& f: *this)
+      if (f) f->multiplyHessianAdd(alpha, x, y);
+  }
+
   /* ************************************************************************* */
   void GaussianFactorGraph::multiplyInPlace(const VectorValues& x, Errors& e) const {
     multiplyInPlace(x, e.begin());
@@ -383,6 +383,10 @@ namespace gtsam {
     void multiplyHessianAdd(double alpha, const VectorValues& x,
         VectorValues& y) const;
 
+    /** y += alpha*A'A*x, on packed vectors that have all variables of the graph */
+    void multiplyHessianAdd(double alpha, const PackedVectorValues& x,
+        PackedVectorValues& y) const;
+
     ///** In-place version e <- A*x that overwrites e. */
     void multiplyInPlace(const VectorValues& x, Errors& e) const;
 
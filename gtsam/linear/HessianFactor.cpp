@@ -22,9 +22,11 @@
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/JacobianFactor.h>
 #include <gtsam/linear/linearExceptions.h>
+#include <gtsam/linear/PackedVectorValues.h>
 #include <gtsam/base/cholesky.h>
 #include <gtsam/base/debug.h>
 #include <gtsam/base/FastMap.h>
+#include <gtsam/base/MonotonicArena.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/ThreadsafeException.h>
 #include <gtsam/base/timing.h>
@@ -418,6 +420,29 @@ void HessianFactor::multiplyHessianAdd(double alpha, const VectorValues& x,
   }
 }
 
+/* ************************************************************************* */
+void HessianFactor::multiplyHessianAdd(double alpha,
+    const PackedVectorValues& x, PackedVectorValues& yvalues) const {
+  // Same as above, but x and y are views into the packed buffers
+  vector<Vector> y;
+  y.reserve(size());
+  for (const_iterator it = begin(); it != end(); it++)
+    y.push_back(Vector::Zero(getDim(it)));
+
+  for (DenseIndex j = 0; j < (DenseIndex) size(); ++j) {
+    const auto xj = x.at(keys_[j]);
+    DenseIndex i = 0;
+    for (; i < j; ++i)
+      y[i] += info_.aboveDiagonalBlock(i, j) * xj;
+    y[i] += info_.diagonalBlock(j) * xj;
+    for (i = j + 1; i < (DenseIndex) size(); ++i)
+      y[i] += info_.aboveDiagonalBlock(j, i).transpose() * xj;
+  }
+
+  for (DenseIndex i = 0; i < (DenseIndex) size(); ++i)
+    yvalues.at(keys_[i]) += alpha * y[i];
+}
+
 /* ************************************************************************* */
 VectorValues HessianFactor::gradientAtZero() const {
   VectorValues g;
@@ -469,7 +494,7 @@ std::shared_ptr<GaussianConditional> HessianFactor::eliminateCholesky(const Orde
 
     // TODO(frank): pre-allocate GaussianConditional and write into it
     const VerticalBlockMatrix Ab = info_.split(nFrontals);
-    conditional = std::make_shared<GaussianConditional>(keys_, nFrontals, Ab);
+    conditional = allocateShared<GaussianConditional>(keys_, nFrontals, Ab);
 
     // Erase the eliminated keys in this factor
     keys_.erase(begin(), begin() + nFrontals);
@@ -521,7 +546,7 @@ EliminateCholesky(const GaussianFactorGraph& factors, const Ordering& keys) {
   HessianFactor::shared_ptr jointFactor;
   try {
     Scatter scatter(factors, keys);
-    jointFactor = std::make_shared<HessianFactor>(factors, scatter);
+    jointFactor = allocateShared<HessianFactor>(factors, scatter);
   } catch (std::invalid_argument&) {
     throw InvalidDenseElimination(
         "EliminateCholesky was called with a request to eliminate variables that are not\n"
@@ -332,6 +332,10 @@ namespace gtsam {
     /** y += alpha * A'*A*x */
     void multiplyHessianAdd(double alpha, const VectorValues& x, VectorValues& y) const override;
 
+    /** y += alpha * A'*A*x, on packed vectors */
+    void multiplyHessianAdd(double alpha, const PackedVectorValues& x,
+                            PackedVectorValues& y) const override;
+
     /// eta for Hessian
     VectorValues gradientAtZero() const override;
 
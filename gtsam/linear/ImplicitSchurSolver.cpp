@@ -0,0 +1,492 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ImplicitSchurSolver.cpp
+ * @brief   Matrix-free preconditioned conjugate gradient on the Schur
+ *          complement of a set of eliminated variables
+ */
+
+#include <gtsam/linear/ImplicitSchurSolver.h>
+#include <gtsam/base/parallelFor.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/inference/VariableIndex.h>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+void ImplicitSchurSolverParameters::print(ostream &os) const {
+  Base::print(os);
+  os << "ImplicitSchurSolverParameters:" << endl
+     << "preconditioner: " << preconditionerTranslator(preconditioner) << endl
+     << "eliminated keys: "
+     << (eliminatedKeys.empty() ? string("automatic")
+                                : to_string(eliminatedKeys.size()))
+     << endl;
+}
+
+/* ************************************************************************* */
+void ImplicitSchurSolverParameters::print(const std::string &s) const {
+  std::cout << s << std::endl;
+  std::ostringstream os;
+  print(os);
+  std::cout << os.str() << std::endl;
+}
+
+/* ************************************************************************* */
+ImplicitSchurSolverParameters::PreconditionerType
+ImplicitSchurSolverParameters::preconditionerTranslator(const std::string &s) {
+  if (s == "BLOCK_JACOBI") return BLOCK_JACOBI;
+  if (s == "SCHUR_JACOBI") return SCHUR_JACOBI;
+  throw invalid_argument(
+      "ImplicitSchurSolverParameters: unknown preconditioner " + s);
+}
+
+/* ************************************************************************* */
+std::string ImplicitSchurSolverParameters::preconditionerTranslator(
+    PreconditionerType type) {
+  switch (type) {
+    case BLOCK_JACOBI:
+      return "BLOCK_JACOBI";
+    case SCHUR_JACOBI:
+      return "SCHUR_JACOBI";
+  }
+  return "UNDEFINED";
+}
+
+/* ************************************************************************* */
+namespace {
+
+/// Unconstrained Jacobian factor, or null for any other factor
+const JacobianFactor *asJacobian(const GaussianFactor::shared_ptr &factor) {
+  const auto jacobian = dynamic_cast<const JacobianFactor *>(factor.get());
+  return (jacobian && !jacobian->isConstrained()) ? jacobian : nullptr;
+}
+
+/// The rows of a JacobianBlock that multiply one reduced variable
+struct ColumnBlock {
+  size_t variable;  ///< Index of the reduced variable
+  size_t row;       ///< First row in the block
+  Matrix F;         ///< Whitened Jacobian
+};
+
+/**
+ * Whitened Jacobian factors on one eliminated variable, stacked, or a single
+ * Jacobian factor on reduced variables only, in which case E has no columns.
+ */
+struct JacobianBlock {
+  Key eliminated = 0;
+  std::vector<ColumnBlock> columns;
+  Matrix E;  ///< Jacobian of the eliminated variable
+  Matrix P;  ///< inv(E'E)
+  Vector b;
+  mutable Vector e;  ///< Workspace for Q * F * x, with Q = I - E * P * E'
+
+  /// e = Q * e, which projects out the eliminated variable
+  void project(Vector &e) const {
+    if (E.cols() > 0) e.noalias() -= E * (P * (E.transpose() * e));
+  }
+
+  /// e = Q * F * x
+  void multiply(const Vector &x, const std::vector<size_t> &offsets) const {
+    e.setZero(b.size());
+    for (const ColumnBlock &c : columns)
+      e.segment(c.row, c.F.rows()).noalias() +=
+          c.F * x.segment(offsets[c.variable], c.F.cols());
+    project(e);
+  }
+};
+
+/// Any other factor on reduced variables only, multiplied through VectorValues
+struct OtherFactor {
+  GaussianFactor::shared_ptr factor;
+  std::vector<size_t> variables;
+  mutable VectorValues x, y;
+  std::vector<Vector *> xs, ys;  ///< The entries of x and y, in key order
+};
+
+/// A reduced variable appears in a column of a block, or in another factor
+typedef std::pair<size_t, size_t> Term;
+
+/**
+ * The Schur complement system, with the interface that
+ * preconditionedConjugateGradient expects.
+ */
+class ImplicitSchurSystem {
+ public:
+  ImplicitSchurSystem(const GaussianFactorGraph &gfg, const KeySet &eliminated,
+                      ImplicitSchurSolverParameters::PreconditionerType type);
+
+  /// Not copyable, the other factors point into their own VectorValues
+  ImplicitSchurSystem(const ImplicitSchurSystem &) = delete;
+  ImplicitSchurSystem &operator=(const ImplicitSchurSystem &) = delete;
+
+  size_t dim() const { return offsets_.back(); }
+
+  /// Stack the reduced variables of values into one vector, zero if missing
+  Vector vector(const VectorValues &values) const;
+
+  /// The solution for all variables, given the reduced variables x
+  VectorValues solution(const Vector &x) const;
+
+  void residual(const Vector &x, Vector &r) const {
+    multiply(x, r);
+    r = b_ - r;
+  }
+
+  /// y = S * x
+  void multiply(const Vector &x, Vector &y) const {
+    parallelFor(blocks_.size(),
+                [&](size_t i) { blocks_[i].multiply(x, offsets_); });
+    parallelFor(others_.size(), [&](size_t i) {
+      const OtherFactor &other = others_[i];
+      for (size_t k = 0; k < other.variables.size(); k++) {
+        *other.xs[k] = x.segment(offsets_[other.variables[k]],
+                                 other.xs[k]->size());
+        other.ys[k]->setZero();
+      }
+      other.factor->multiplyHessianAdd(1.0, other.x, other.y);
+    });
+    gather(y);
+  }
+
+  void leftPrecondition(const Vector &x, Vector &y) const {
+    y = x;
+    parallelFor(keys_.size(), [&](size_t j) {
+      auto yj = y.segment(offsets_[j], L_[j].rows());
+      L_[j].triangularView<Eigen::Lower>().solveInPlace(yj);
+    });
+  }
+
+  void rightPrecondition(const Vector &x, Vector &y) const {
+    y = x;
+    parallelFor(keys_.size(), [&](size_t j) {
+      auto yj = y.segment(offsets_[j], L_[j].rows());
+      L_[j].transpose().triangularView<Eigen::Upper>().solveInPlace(yj);
+    });
+  }
+
+  void scal(const double alpha, Vector &x) const { x *= alpha; }
+  double dot(const Vector &x, const Vector &y) const { return x.dot(y); }
+  void axpy(const double alpha, const Vector &x, Vector &y) const {
+    y += alpha * x;
+  }
+
+ private:
+  std::vector<Key> keys_;        ///< Reduced variables
+  std::vector<size_t> offsets_;  ///< Offsets of the reduced variables, and dim
+  std::vector<JacobianBlock> blocks_;
+  std::vector<OtherFactor> others_;
+  std::vector<std::vector<Term>> blockTerms_, otherTerms_;  ///< Per variable
+  std::vector<Matrix> L_;  ///< Cholesky factors of the preconditioner blocks
+  Vector b_;               ///< Right-hand side of the reduced system
+
+  /// y = sum of F' * e over all blocks, plus the y of the other factors
+  void gather(Vector &y) const {
+    y.resize(dim());
+    parallelFor(keys_.size(), [&](size_t j) {
+      auto yj = y.segment(offsets_[j], offsets_[j + 1] - offsets_[j]);
+      yj.setZero();
+      for (const Term &term : blockTerms_[j]) {
+        const JacobianBlock &block = blocks_[term.first];
+        const ColumnBlock &c = block.columns[term.second];
+        yj.noalias() += c.F.transpose() * block.e.segment(c.row, c.F.rows());
+      }
+      for (const Term &term : otherTerms_[j])
+        yj += *others_[term.first].ys[term.second];
+    });
+  }
+
+  /// Stack Jacobian factors, which may share one eliminated variable
+  static JacobianBlock stack(const std::vector<const JacobianFactor *> &factors,
+                             Key eliminated,
+                             const FastMap<Key, size_t> &indices);
+  void buildPreconditioner(
+      ImplicitSchurSolverParameters::PreconditionerType type);
+};
+
+/* ************************************************************************* */
+// Variables that only appear in unconstrained Jacobian factors, taken in order
+// of increasing dimension as long as they share no factor with a variable
+// taken before.
+KeySet chooseEliminatedKeys(const GaussianFactorGraph &gfg,
+                            const VariableIndex &variableIndex) {
+  std::vector<std::pair<size_t, Key>> candidates;
+  for (const auto &[key, factors] : variableIndex) {
+    bool onlyJacobians = true;
+    size_t dim = 0;
+    for (size_t i : factors) {
+      if (!asJacobian(gfg[i])) {
+        onlyJacobians = false;
+        break;
+      }
+      dim = gfg[i]->getDim(gfg[i]->find(key));
+    }
+    if (onlyJacobians) candidates.emplace_back(dim, key);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  KeySet eliminated, blocked;
+  for (const auto &[dim, key] : candidates) {
+    if (blocked.count(key)) continue;
+    eliminated.insert(key);
+    for (size_t i : variableIndex[key])
+      blocked.insert(gfg[i]->begin(), gfg[i]->end());
+  }
+  return eliminated;
+}
+
+/* ************************************************************************* */
+ImplicitSchurSystem::ImplicitSchurSystem(
+    const GaussianFactorGraph &gfg, const KeySet &eliminated,
+    ImplicitSchurSolverParameters::PreconditionerType type) {
+  const VariableIndex variableIndex(gfg);
+
+  // Lay out the reduced variables in one vector, in key order
+  FastMap<Key, size_t> indices;
+  offsets_.push_back(0);
+  for (const auto &[key, factors] : variableIndex) {
+    if (eliminated.count(key)) continue;
+    const auto &factor = gfg[factors.front()];
+    indices.emplace(key, keys_.size());
+    keys_.push_back(key);
+    offsets_.push_back(offsets_.back() + factor->getDim(factor->find(key)));
+  }
+  blockTerms_.resize(keys_.size());
+  otherTerms_.resize(keys_.size());
+
+  // One block per eliminated variable
+  for (Key key : eliminated) {
+    if (variableIndex.find(key) == variableIndex.end()) continue;
+    std::vector<const JacobianFactor *> factors;
+    for (size_t i : variableIndex[key]) {
+      const JacobianFactor *jacobian = asJacobian(gfg[i]);
+      if (!jacobian)
+        throw invalid_argument(
+            "ImplicitSchurSolver: eliminated variables may only appear in "
+            "unconstrained Jacobian factors");
+      if (std::count_if(jacobian->begin(), jacobian->end(), [&](Key k) {
+            return eliminated.count(k) > 0;
+          }) > 1)
+        throw invalid_argument(
+            "ImplicitSchurSolver: a factor involves two eliminated variables");
+      factors.push_back(jacobian);
+    }
+
+    JacobianBlock block = stack(factors, key, indices);
+    Eigen::LLT<Matrix> llt(block.E.transpose() * block.E);
+    if (llt.info() != Eigen::Success)
+      throw IndeterminantLinearSystemException(key);
+    block.P = llt.solve(Matrix::Identity(block.E.cols(), block.E.cols()));
+    blocks_.push_back(std::move(block));
+  }
+
+  // All other factors only involve reduced variables
+  for (const auto &factor : gfg) {
+    if (!factor || factor->empty() ||
+        std::any_of(factor->begin(), factor->end(),
+                    [&](Key k) { return eliminated.count(k) > 0; }))
+      continue;
+    if (const JacobianFactor *jacobian = asJacobian(factor)) {
+      blocks_.push_back(stack({jacobian}, 0, indices));
+    } else if (dynamic_cast<const JacobianFactor *>(factor.get())) {
+      throw invalid_argument(
+          "ImplicitSchurSolver: constrained noise models are not supported");
+    } else {
+      others_.emplace_back();
+      OtherFactor &other = others_.back();
+      other.factor = factor;
+      for (auto it = factor->begin(); it != factor->end(); ++it) {
+        const size_t j = indices.at(*it);
+        const Vector zero = Vector::Zero(factor->getDim(it));
+        otherTerms_[j].emplace_back(others_.size() - 1, other.variables.size());
+        other.variables.push_back(j);
+        other.x.insert(*it, zero);
+        other.y.insert(*it, zero);
+      }
+    }
+  }
+
+  // Point into x and y only once others_ is complete: growing it copies the
+  // entries, and VectorValues allocates new storage when copied.
+  for (OtherFactor &other : others_) {
+    for (Key key : *other.factor) {
+      other.xs.push_back(&other.x.at(key));
+      other.ys.push_back(&other.y.at(key));
+    }
+  }
+
+  for (size_t i = 0; i < blocks_.size(); i++)
+    for (size_t k = 0; k < blocks_[i].columns.size(); k++)
+      blockTerms_[blocks_[i].columns[k].variable].emplace_back(i, k);
+
+  // Right-hand side F' * Q * b, and -gradientAtZero for the other factors
+  parallelFor(blocks_.size(), [&](size_t i) {
+    const JacobianBlock &block = blocks_[i];
+    block.e = block.b;
+    block.project(block.e);
+  });
+  parallelFor(others_.size(), [&](size_t i) {
+    const OtherFactor &other = others_[i];
+    const VectorValues g = other.factor->gradientAtZero();
+    for (size_t k = 0; k < other.variables.size(); k++)
+      *other.ys[k] = -g.at(other.factor->keys()[k]);
+  });
+  gather(b_);
+
+  buildPreconditioner(type);
+}
+
+/* ************************************************************************* */
+JacobianBlock ImplicitSchurSystem::stack(
+    const std::vector<const JacobianFactor *> &factors, Key eliminated,
+    const FastMap<Key, size_t> &indices) {
+  size_t rows = 0;
+  for (const JacobianFactor *factor : factors) rows += factor->rows();
+
+  JacobianBlock block;
+  block.eliminated = eliminated;
+  block.b.resize(rows);
+  size_t row = 0;
+  for (const JacobianFactor *factor : factors) {
+    const auto [A, b] = factor->jacobian();
+    block.b.segment(row, b.size()) = b;
+    size_t column = 0;
+    for (auto it = factor->begin(); it != factor->end(); ++it) {
+      const size_t dim = factor->getDim(it);
+      auto index = indices.find(*it);
+      if (index != indices.end()) {
+        block.columns.push_back(
+            {index->second, row, A.block(0, column, b.size(), dim)});
+      } else {
+        if (block.E.size() == 0) block.E = Matrix::Zero(rows, dim);
+        block.E.middleRows(row, b.size()) = A.middleCols(column, dim);
+      }
+      column += dim;
+    }
+    row += b.size();
+  }
+  return block;
+}
+
+/* ************************************************************************* */
+void ImplicitSchurSystem::buildPreconditioner(
+    ImplicitSchurSolverParameters::PreconditionerType type) {
+  // Diagonal blocks of the Hessian, or of the Schur complement
+  std::vector<Matrix> D(keys_.size());
+  for (size_t j = 0; j < keys_.size(); j++) {
+    const size_t dim = offsets_[j + 1] - offsets_[j];
+    D[j] = Matrix::Zero(dim, dim);
+  }
+  for (const auto &other : others_) {
+    const std::map<Key, Matrix> diagonal = other.factor->hessianBlockDiagonal();
+    for (size_t k = 0; k < other.variables.size(); k++)
+      D[other.variables[k]] += diagonal.at(other.factor->keys()[k]);
+  }
+  parallelFor(keys_.size(), [&](size_t j) {
+    Matrix &Dj = D[j];
+    for (const Term &term : blockTerms_[j]) {
+      const JacobianBlock &block = blocks_[term.first];
+      const ColumnBlock &c = block.columns[term.second];
+      Dj.noalias() += c.F.transpose() * c.F;
+    }
+    if (type != ImplicitSchurSolverParameters::SCHUR_JACOBI) return;
+    // Subtract F' * E * P * E' * F, summed over the columns of a block that
+    // belong to the same variable
+    for (size_t t = 0; t < blockTerms_[j].size();) {
+      const size_t i = blockTerms_[j][t].first;
+      const JacobianBlock &block = blocks_[i];
+      Matrix FtE = Matrix::Zero(Dj.rows(), block.E.cols());
+      for (; t < blockTerms_[j].size() && blockTerms_[j][t].first == i; ++t) {
+        const ColumnBlock &c = block.columns[blockTerms_[j][t].second];
+        FtE.noalias() +=
+            c.F.transpose() * block.E.middleRows(c.row, c.F.rows());
+      }
+      if (block.E.cols() > 0)
+        Dj.noalias() -= FtE * block.P * FtE.transpose();
+    }
+  });
+
+  L_.resize(keys_.size());
+  for (size_t j = 0; j < keys_.size(); j++) {
+    Eigen::LLT<Matrix> llt(D[j]);
+    if (llt.info() != Eigen::Success)
+      throw IndeterminantLinearSystemException(keys_[j]);
+    L_[j] = llt.matrixL();
+  }
+}
+
+/* ************************************************************************* */
+Vector ImplicitSchurSystem::vector(const VectorValues &values) const {
+  Vector x = Vector::Zero(dim());
+  for (size_t j = 0; j < keys_.size(); j++) {
+    auto it = values.find(keys_[j]);
+    if (it != values.end() &&
+        size_t(it->second.size()) == offsets_[j + 1] - offsets_[j])
+      x.segment(offsets_[j], it->second.size()) = it->second;
+  }
+  return x;
+}
+
+/* ************************************************************************* */
+VectorValues ImplicitSchurSystem::solution(const Vector &x) const {
+  VectorValues result;
+  for (size_t j = 0; j < keys_.size(); j++)
+    result.insert(keys_[j],
+                  x.segment(offsets_[j], offsets_[j + 1] - offsets_[j]));
+
+  // Back-substitute the eliminated variables, P * E' * (b - F * x)
+  std::vector<Vector> eliminated(blocks_.size());
+  parallelFor(blocks_.size(), [&](size_t i) {
+    const JacobianBlock &block = blocks_[i];
+    if (block.E.cols() == 0) return;
+    Vector r = block.b;
+    for (const ColumnBlock &c : block.columns)
+      r.segment(c.row, c.F.rows()).noalias() -=
+          c.F * x.segment(offsets_[c.variable], c.F.cols());
+    eliminated[i] = block.P * (block.E.transpose() * r);
+  });
+  for (size_t i = 0; i < blocks_.size(); i++)
+    if (blocks_[i].E.cols() > 0)
+      result.insert(blocks_[i].eliminated, eliminated[i]);
+  return result;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+VectorValues ImplicitSchurSolver::optimize(const GaussianFactorGraph &gfg,
+                                           const KeyInfo &,
+                                           const std::map<Key, Vector> &,
+                                           const VectorValues &initial) {
+  const KeySet eliminated =
+      parameters_.eliminatedKeys.empty()
+          ? chooseEliminatedKeys(gfg, VariableIndex(gfg))
+          : parameters_.eliminatedKeys;
+  const ImplicitSchurSystem system(gfg, eliminated, parameters_.preconditioner);
+
+  Vector x = system.vector(initial);
+  if (system.dim() > 0)
+    x = preconditionedConjugateGradient(system, x, parameters_);
+  return system.solution(x);
+}
+
+}  // namespace gtsam
@@ -0,0 +1,115 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ImplicitSchurSolver.h
+ * @brief   Matrix-free preconditioned conjugate gradient on the Schur
+ *          complement of a set of eliminated variables, e.g. the landmarks in
+ *          bundle adjustment
+ */
+
+#pragma once
+
+#include <gtsam/inference/Key.h>
+#include <gtsam/linear/ConjugateGradientSolver.h>
+
+#include <string>
+
+namespace gtsam {
+
+/**
+ * Parameters for ImplicitSchurSolver
+ */
+struct GTSAM_EXPORT ImplicitSchurSolverParameters
+    : public ConjugateGradientParameters {
+  typedef ConjugateGradientParameters Base;
+  typedef std::shared_ptr<ImplicitSchurSolverParameters> shared_ptr;
+
+  /// Block diagonal preconditioners for the reduced system
+  enum PreconditionerType {
+    BLOCK_JACOBI,  ///< Diagonal blocks of the Hessian of the reduced variables
+    SCHUR_JACOBI   ///< Diagonal blocks of the Schur complement
+  };
+
+  /// The preconditioner (default: SCHUR_JACOBI)
+  PreconditionerType preconditioner = SCHUR_JACOBI;
+
+  /// The variables to eliminate, or empty to let the solver choose them
+  KeySet eliminatedKeys;
+
+  ImplicitSchurSolverParameters() {}
+
+  void print(std::ostream &os) const override;
+
+  // needed for python wrapper
+  void print(const std::string &s) const;
+
+  void setPreconditioner(const std::string &s) {
+    preconditioner = preconditionerTranslator(s);
+  }
+  std::string getPreconditioner() const {
+    return preconditionerTranslator(preconditioner);
+  }
+  void setEliminatedKeys(const KeySet &keys) { eliminatedKeys = keys; }
+
+  static PreconditionerType preconditionerTranslator(const std::string &s);
+  static std::string preconditionerTranslator(PreconditionerType type);
+};
+
+/**
+ * Solves a Gaussian factor graph with preconditioned conjugate gradient on the
+ * Schur complement S of a set of eliminated variables, without forming S.
+ *
+ * The Jacobian factors on each eliminated variable are stacked into one block
+ * [F E | b], where E is the Jacobian of the eliminated variable. A product
+ * S * x is then F' * (I - E * inv(E'E) * E') * F * x for every block, plus
+ * A'A * x for the factors on the reduced variables only, which may be of any
+ * type, e.g. the RegularImplicitSchurFactors of smart factors. Blocks are
+ * processed in parallel, and the reduced variables are stored in one
+ * contiguous vector, so memory grows with the number of Jacobian entries and
+ * not with the number of nonzeros of S. After the reduced system is solved,
+ * the eliminated variables are recovered block by block.
+ *
+ * Factors on an eliminated variable must be Jacobian factors, and may not
+ * involve a second eliminated variable. If no eliminated variables are given,
+ * the solver picks a maximal independent set of the variables that only appear
+ * in Jacobian factors, preferring variables of small dimension. In bundle
+ * adjustment, these are the landmarks.
+ */
+class GTSAM_EXPORT ImplicitSchurSolver : public IterativeSolver {
+ public:
+  typedef IterativeSolver Base;
+  typedef std::shared_ptr<ImplicitSchurSolver> shared_ptr;
+
+ protected:
+  ImplicitSchurSolverParameters parameters_;
+
+ public:
+  explicit ImplicitSchurSolver(const ImplicitSchurSolverParameters &p)
+      : parameters_(p) {}
+  ~ImplicitSchurSolver() override {}
+
+  using IterativeSolver::optimize;
+
+  /**
+   * Solve the graph, starting from the reduced variables in initial.
+   * @throw std::invalid_argument if an eliminated variable appears in a factor
+   * that is not a Jacobian factor, or with another eliminated variable.
+   * @throw IndeterminantLinearSystemException if an eliminated variable, or a
+   * block of the preconditioner, is not fully constrained.
+   */
+  VectorValues optimize(const GaussianFactorGraph &gfg,
+                        const KeyInfo &keyInfo,
+                        const std::map<Key, Vector> &lambda,
+                        const VectorValues &initial) override;
+};
+
+}  // namespace gtsam
@@ -22,6 +22,7 @@
 #include <gtsam/linear/JacobianFactor.h>
 #include <gtsam/linear/Scatter.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/PackedVectorValues.h>
 #include <gtsam/linear/VectorValues.h>
 #include <gtsam/inference/VariableSlots.h>
 #include <gtsam/inference/Ordering.h>
@@ -29,6 +30,7 @@
 #include <gtsam/base/timing.h>
 #include <gtsam/base/Matrix.h>
 #include <gtsam/base/FastMap.h>
+#include <gtsam/base/MonotonicArena.h>
 #include <gtsam/base/cholesky.h>
 
 #include <cmath>
@@ -641,6 +643,26 @@ void JacobianFactor::multiplyHessianAdd(double alpha, const VectorValues& x,
   transposeMultiplyAdd(alpha, Ax, y);
 }
 
+/* ************************************************************************* */
+void JacobianFactor::multiplyHessianAdd(double alpha,
+    const PackedVectorValues& x, PackedVectorValues& y) const {
+  if (empty())
+    return;
+  Vector Ax = Vector::Zero(Ab_.rows());
+  for (size_t pos = 0; pos < size(); ++pos)
+    Ax.noalias() += Ab_(pos) * x.at(keys_[pos]);
+
+  // Whiten twice, as we are dividing by the variance
+  if (model_) {
+    model_->whitenInPlace(Ax);
+    model_->whitenInPlace(Ax);
+  }
+  Ax *= alpha;
+
+  for (size_t pos = 0; pos < size(); ++pos)
+    y.at(keys_[pos]).noalias() += Ab_(pos).transpose() * Ax;
+}
+
 /* ************************************************************************* */
 /** Raw memory access version of multiplyHessianAdd y += alpha * A'*A*x
  * Note: this is not assuming a fixed dimension for the variables,
@@ -781,7 +803,7 @@ std::pair<GaussianConditional::shared_ptr, JacobianFactor::shared_ptr> Eliminate
   // Combine and sort variable blocks in elimination order
   JacobianFactor::shared_ptr jointFactor;
   try {
-    jointFactor = std::make_shared<JacobianFactor>(factors, keys);
+    jointFactor = allocateShared<JacobianFactor>(factors, keys);
   } catch (std::invalid_argument&) {
     throw InvalidDenseElimination(
         "EliminateQR was called with a request to eliminate variables that are not\n"
@@ -844,7 +866,7 @@ GaussianConditional::shared_ptr JacobianFactor::splitConditional(size_t nrFronta
   conditionalNoiseModel =
       noiseModel::Diagonal::Sigmas(model_->sigmas().segment(Ab_.rowStart(), Ab_.rows()));
   GaussianConditional::shared_ptr conditional =
-      std::make_shared<GaussianConditional>(Base::keys_, nrFrontals, Ab_, conditionalNoiseModel);
+      allocateShared<GaussianConditional>(Base::keys_, nrFrontals, Ab_, conditionalNoiseModel);
 
   const DenseIndex maxRemainingRows =
       std::min(Ab_.cols(), originalRowEnd) - Ab_.rowStart() - frontalDim;
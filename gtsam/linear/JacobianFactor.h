@@ -331,6 +331,10 @@ namespace gtsam {
     void multiplyHessianAdd(double alpha, const VectorValues& x,
                             VectorValues& y) const override;
 
+    /** y += alpha * A'*A*x, on packed vectors */
+    void multiplyHessianAdd(double alpha, const PackedVectorValues& x,
+                            PackedVectorValues& y) const override;
+
     /**
      * Raw memory access version of multiplyHessianAdd y += alpha * A'*A*x
      * Requires the vector accumulatedDims to tell the dimension of
@@ -414,6 +418,8 @@ namespace gtsam {
 
     // be very selective on who can access these private methods:
     template<typename T> friend class ExpressionFactor;
+    template<int ZDim, class... ValueTypes> friend class FixedSizeNoiseModelFactorN;
+    template<typename T> friend class ArenaAllocator;
 
 #ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
     /** Serialization function */
@@ -61,12 +61,13 @@ VectorValues PCGSolver::optimize(const GaussianFactorGraph &gfg,
   /* build preconditioner */
   preconditioner_->build(gfg, keyInfo, lambda);
 
-  /* apply pcg */
+  /* apply pcg, on vectors packed in the order of keyInfo */
   GaussianFactorGraphSystem system(gfg, *preconditioner_, keyInfo, lambda);
-  Vector x0 = initial.vector(keyInfo.ordering());
-  const Vector sol = preconditionedConjugateGradient(system, x0, parameters_);
+  const PackedVectorValues x0(system.layout_, initial);
+  const PackedVectorValues sol =
+      preconditionedConjugateGradient(system, x0, parameters_);
 
-  return buildVectorValues(sol, keyInfo);
+  return sol.vectorValues();
 }
 
 /*****************************************************************************/
@@ -74,7 +75,63 @@ GaussianFactorGraphSystem::GaussianFactorGraphSystem(
     const GaussianFactorGraph &gfg, const Preconditioner &preconditioner,
     const KeyInfo &keyInfo, const std::map<Key, Vector> &lambda) :
     gfg_(gfg), preconditioner_(preconditioner), keyInfo_(keyInfo), lambda_(
-        lambda) {
+        lambda), layout_(std::make_shared<PackedVectorValues::Layout>(keyInfo)) {
+}
+
+/*****************************************************************************/
+void GaussianFactorGraphSystem::residual(const PackedVectorValues &x,
+    PackedVectorValues &r) const {
+  /* implement b-Ax */
+  getb(r);
+  PackedVectorValues Ax(layout_);
+  multiply(x, Ax);
+  r -= Ax;
+}
+
+/*****************************************************************************/
+void GaussianFactorGraphSystem::multiply(const PackedVectorValues &x,
+    PackedVectorValues& AtAx) const {
+  /* implement A^T*(A*x), without any VectorValues */
+  if (AtAx.layout() == layout_)
+    AtAx.setZero();
+  else
+    AtAx = PackedVectorValues(layout_);
+  gfg_.multiplyHessianAdd(1.0, x, AtAx);
+}
+
+/*****************************************************************************/
+void GaussianFactorGraphSystem::getb(PackedVectorValues &b) const {
+  /* compute rhs, -gradientAtZero is the whitened A^T * b */
+  b = PackedVectorValues(layout_, gfg_.gradientAtZero());
+  b *= -1.0;
+}
+
+/*****************************************************************************/
+void GaussianFactorGraphSystem::leftPrecondition(const PackedVectorValues &x,
+    PackedVectorValues &y) const {
+  if (y.layout() != layout_) y = PackedVectorValues(layout_);
+  preconditioner_.solve(x.vector(), y.vector());
+}
+
+/*****************************************************************************/
+void GaussianFactorGraphSystem::rightPrecondition(const PackedVectorValues &x,
+    PackedVectorValues &y) const {
+  if (y.layout() != layout_) y = PackedVectorValues(layout_);
+  preconditioner_.transposeSolve(x.vector(), y.vector());
+}
+
+/*****************************************************************************/
+void GaussianFactorGraphSystem::scal(const double alpha,
+    PackedVectorValues &x) const {
+  x *= alpha;
+}
+double GaussianFactorGraphSystem::dot(const PackedVectorValues &x,
+    const PackedVectorValues &y) const {
+  return x.dot(y);
+}
+void GaussianFactorGraphSystem::axpy(const double alpha,
+    const PackedVectorValues &x, PackedVectorValues &y) const {
+  y.axpy(alpha, x);
 }
 
 /*****************************************************************************/
@@ -92,30 +149,19 @@ void GaussianFactorGraphSystem::residual(const Vector &x, Vector &r) const {
 
 /*****************************************************************************/
 void GaussianFactorGraphSystem::multiply(const Vector &x, Vector& AtAx) const {
-  /* implement A^T*(A*x), assume x and AtAx are pre-allocated */
-
-  // Build a VectorValues for Vector x
-  VectorValues vvX = buildVectorValues(x, keyInfo_);
-
-  // VectorValues form of A'Ax for multiplyHessianAdd
-  VectorValues vvAtAx = keyInfo_.x0(); // crucial for performance
-
-  // vvAtAx += 1.0 * A'Ax for each factor
-  gfg_.multiplyHessianAdd(1.0, vvX, vvAtAx);
-
-  // Make the result as Vector form
-  AtAx = vvAtAx.vector(keyInfo_.ordering());
+  /* implement A^T*(A*x) on the packed buffers */
+  PackedVectorValues packedAtAx(layout_);
+  multiply(PackedVectorValues(layout_, x), packedAtAx);
+  AtAx = packedAtAx.vector();
 }
 
 /*****************************************************************************/
 void GaussianFactorGraphSystem::getb(Vector &b) const {
   /* compute rhs, assume b pre-allocated */
 
-  // Get whitened r.h.s (A^T * b) from each factor in the form of VectorValues
-  VectorValues vvb = gfg_.gradientAtZero();
-
-  // Make the result as Vector form
-  b = -vvb.vector(keyInfo_.ordering());
+  PackedVectorValues packedb;
+  getb(packedb);
+  b = packedb.vector();
 }
 
 /**********************************************************************************/
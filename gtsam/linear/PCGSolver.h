@@ -20,6 +20,7 @@
 #pragma once
 
 #include <gtsam/linear/ConjugateGradientSolver.h>
+#include <gtsam/linear/PackedVectorValues.h>
 #include <string>
 
 namespace gtsam {
@@ -84,7 +85,10 @@ public:
 };
 
 /**
- * System class needed for calling preconditionedConjugateGradient
+ * System class needed for calling preconditionedConjugateGradient. It works
+ * on PackedVectorValues laid out as in the KeyInfo, so that the vector
+ * operations of PCG never look up a key. The Vector versions take and return
+ * the same buffers.
  */
 class GTSAM_EXPORT GaussianFactorGraphSystem {
 public:
@@ -97,6 +101,17 @@ public:
   const Preconditioner &preconditioner_;
   const KeyInfo &keyInfo_;
   const std::map<Key, Vector> &lambda_;
+  PackedVectorValues::SharedLayout layout_;  ///< Layout of keyInfo_
+
+  void residual(const PackedVectorValues &x, PackedVectorValues &r) const;
+  void multiply(const PackedVectorValues &x, PackedVectorValues& y) const;
+  void leftPrecondition(const PackedVectorValues &x, PackedVectorValues &y) const;
+  void rightPrecondition(const PackedVectorValues &x, PackedVectorValues &y) const;
+  void scal(const double alpha, PackedVectorValues &x) const;
+  double dot(const PackedVectorValues &x, const PackedVectorValues &y) const;
+  void axpy(const double alpha, const PackedVectorValues &x, PackedVectorValues &y) const;
+
+  void getb(PackedVectorValues &b) const;
 
   void residual(const Vector &x, Vector &r) const;
   void multiply(const Vector &x, Vector& y) const;
@@ -0,0 +1,160 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    PackedVectorValues.cpp
+ * @brief   Vector-valued variables stored in one contiguous buffer
+ */
+
+#include <gtsam/linear/PackedVectorValues.h>
+#include <gtsam/linear/IterativeSolver.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace gtsam {
+
+/* ************************************************************************* */
+PackedVectorValues::Layout::Layout(const Scatter& scatter) {
+  offsets_.push_back(0);
+  for (const SlotEntry& entry : scatter) {
+    slots_.emplace(entry.key, keys_.size());
+    keys_.push_back(entry.key);
+    offsets_.push_back(offsets_.back() + entry.dimension);
+  }
+}
+
+/* ************************************************************************* */
+PackedVectorValues::Layout::Layout(const KeyInfo& keyInfo) {
+  offsets_.push_back(0);
+  for (Key key : keyInfo.ordering()) {
+    const KeyInfoEntry& entry = keyInfo.at(key);
+    if (entry.start != offsets_.back())
+      throw invalid_argument(
+          "PackedVectorValues::Layout: KeyInfo offsets are not contiguous");
+    slots_.emplace(key, keys_.size());
+    keys_.push_back(key);
+    offsets_.push_back(offsets_.back() + entry.dim);
+  }
+}
+
+/* ************************************************************************* */
+size_t PackedVectorValues::Layout::slot(Key key) const {
+  auto it = slots_.find(key);
+  if (it == slots_.end())
+    throw out_of_range("PackedVectorValues: key " + DefaultKeyFormatter(key) +
+                       " is not in the layout");
+  return it->second;
+}
+
+/* ************************************************************************* */
+PackedVectorValues::PackedVectorValues(const SharedLayout& layout)
+    : layout_(layout), values_(Vector::Zero(layout->dim())) {}
+
+/* ************************************************************************* */
+PackedVectorValues::PackedVectorValues(const SharedLayout& layout,
+                                       const Vector& values)
+    : layout_(layout), values_(values) {
+  if (size_t(values.size()) != layout->dim())
+    throw invalid_argument(
+        "PackedVectorValues: vector dimension does not match the layout");
+}
+
+/* ************************************************************************* */
+PackedVectorValues::PackedVectorValues(const SharedLayout& layout,
+                                       const VectorValues& values)
+    : PackedVectorValues(layout) {
+  for (size_t i = 0; i < layout->size(); i++) {
+    auto it = values.find(layout->key(i));
+    if (it != values.end())
+      values_.segment(layout->offset(i), layout->dim(i)) = it->second;
+  }
+}
+
+/* ************************************************************************* */
+VectorValues PackedVectorValues::vectorValues() const {
+  VectorValues result;
+  if (!layout_) return result;
+  for (size_t i = 0; i < layout_->size(); i++)
+    result.emplace(layout_->key(i),
+                   values_.segment(layout_->offset(i), layout_->dim(i)));
+  return result;
+}
+
+/* ************************************************************************* */
+void PackedVectorValues::checkLayout(const PackedVectorValues& other) const {
+  if (layout_ == other.layout_) return;
+  bool same = layout_ && other.layout_ &&
+              layout_->size() == other.layout_->size() &&
+              dim() == other.dim();
+  for (size_t i = 0; same && i < layout_->size(); i++)
+    same = layout_->key(i) == other.layout_->key(i) &&
+           layout_->dim(i) == other.layout_->dim(i);
+  if (!same)
+    throw invalid_argument("PackedVectorValues: layouts do not match");
+}
+
+/* ************************************************************************* */
+double PackedVectorValues::dot(const PackedVectorValues& other) const {
+  checkLayout(other);
+  return values_.dot(other.values_);
+}
+
+/* ************************************************************************* */
+void PackedVectorValues::axpy(double alpha, const PackedVectorValues& x) {
+  checkLayout(x);
+  values_.noalias() += alpha * x.values_;
+}
+
+/* ************************************************************************* */
+PackedVectorValues& PackedVectorValues::operator+=(
+    const PackedVectorValues& other) {
+  checkLayout(other);
+  values_ += other.values_;
+  return *this;
+}
+
+/* ************************************************************************* */
+PackedVectorValues& PackedVectorValues::operator-=(
+    const PackedVectorValues& other) {
+  checkLayout(other);
+  values_ -= other.values_;
+  return *this;
+}
+
+/* ************************************************************************* */
+void PackedVectorValues::print(const string& str,
+                               const KeyFormatter& formatter) const {
+  cout << str << ": " << (layout_ ? layout_->size() : 0) << " elements\n";
+  if (!layout_) return;
+  for (size_t i = 0; i < layout_->size(); i++)
+    cout << "  " << formatter(layout_->key(i)) << ": "
+         << values_.segment(layout_->offset(i), layout_->dim(i)).transpose()
+         << "\n";
+  cout.flush();
+}
+
+/* ************************************************************************* */
+bool PackedVectorValues::equals(const PackedVectorValues& x,
+                                double tol) const {
+  if (!layout_ || !x.layout_) return !layout_ && !x.layout_;
+  try {
+    checkLayout(x);
+  } catch (const invalid_argument&) {
+    return false;
+  }
+  return equal_with_abs_tol(values_, x.values_, tol);
+}
+
+}  // namespace gtsam
@@ -0,0 +1,178 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    PackedVectorValues.h
+ * @brief   Vector-valued variables stored in one contiguous buffer
+ */
+
+#pragma once
+
+#include <gtsam/base/FastMap.h>
+#include <gtsam/base/Testable.h>
+#include <gtsam/base/Vector.h>
+#include <gtsam/linear/Scatter.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+class KeyInfo;
+class VectorValues;
+
+/**
+ * PackedVectorValues stores the same variables as VectorValues, but in one
+ * aligned Eigen vector instead of one heap-allocated Vector per key. Which
+ * variable lives where is described by a Layout, which is shared between all
+ * vectors of the same problem, e.g. all the vectors of a conjugate gradient
+ * solve.
+ *
+ * Element-wise and reduction operations (axpy, dot, scaling) act on the
+ * whole buffer at once and are vectorized by Eigen, without looking up any
+ * key. Access by key, which factors need in multiplyHessianAdd, is one lookup
+ * in the layout and returns a view into the buffer.
+ * @ingroup linear
+ */
+class GTSAM_EXPORT PackedVectorValues {
+ public:
+  /// Keys, dimensions and offsets of the variables in the buffer
+  class GTSAM_EXPORT Layout {
+   public:
+    /// Variables in the order of a Scatter, e.g. Scatter(gfg, ordering)
+    explicit Layout(const Scatter& scatter);
+
+    /// Variables in the order and at the offsets of a KeyInfo
+    explicit Layout(const KeyInfo& keyInfo);
+
+    /// Number of variables
+    size_t size() const { return keys_.size(); }
+
+    /// Total dimension of all variables
+    size_t dim() const { return offsets_.back(); }
+
+    /// Key, offset and dimension of the variable in slot i
+    Key key(size_t i) const { return keys_[i]; }
+    size_t offset(size_t i) const { return offsets_[i]; }
+    size_t dim(size_t i) const { return offsets_[i + 1] - offsets_[i]; }
+
+    /// The slot of a key, throws std::out_of_range if it is not in the layout
+    size_t slot(Key key) const;
+
+    /// Whether the layout has a variable with this key
+    bool exists(Key key) const { return slots_.count(key) > 0; }
+
+   private:
+    std::vector<Key> keys_;
+    std::vector<size_t> offsets_;  ///< One more than keys_, the last is dim()
+    FastMap<Key, size_t> slots_;
+  };
+
+  typedef std::shared_ptr<const Layout> SharedLayout;
+
+ private:
+  SharedLayout layout_;
+  Vector values_;
+
+ public:
+  /// @name Standard Constructors
+  /// @{
+
+  /// Empty vector, without a layout
+  PackedVectorValues() {}
+
+  /// Zero vector with the given layout
+  explicit PackedVectorValues(const SharedLayout& layout);
+
+  /// Wrap a vector that is laid out as in layout
+  PackedVectorValues(const SharedLayout& layout, const Vector& values);
+
+  /// Copy the variables in layout from values, missing variables are zero
+  PackedVectorValues(const SharedLayout& layout, const VectorValues& values);
+
+  /// Zero vector with the same layout as other
+  static PackedVectorValues Zero(const PackedVectorValues& other) {
+    return PackedVectorValues(other.layout_);
+  }
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  const SharedLayout& layout() const { return layout_; }
+
+  /// Total dimension
+  size_t dim() const { return values_.size(); }
+
+  /// The contiguous buffer
+  const Vector& vector() const { return values_; }
+  Vector& vector() { return values_; }
+
+  /// View on the variable with this key
+  Eigen::VectorBlock<const Vector> at(Key key) const {
+    const size_t i = layout_->slot(key);
+    return values_.segment(layout_->offset(i), layout_->dim(i));
+  }
+  Eigen::VectorBlock<Vector> at(Key key) {
+    const size_t i = layout_->slot(key);
+    return values_.segment(layout_->offset(i), layout_->dim(i));
+  }
+
+  /// Whether a variable with this key is in the layout
+  bool exists(Key key) const { return layout_ && layout_->exists(key); }
+
+  /// Convert to VectorValues, with one Vector per key
+  VectorValues vectorValues() const;
+
+  void setZero() { values_.setZero(); }
+
+  /// @}
+  /// @name Vector Space Operations, on the whole buffer
+  /// @{
+
+  /// Dot product with a vector of the same layout
+  double dot(const PackedVectorValues& other) const;
+
+  double squaredNorm() const { return values_.squaredNorm(); }
+  double norm() const { return values_.norm(); }
+
+  /// this += alpha * x
+  void axpy(double alpha, const PackedVectorValues& x);
+
+  PackedVectorValues& operator+=(const PackedVectorValues& other);
+  PackedVectorValues& operator-=(const PackedVectorValues& other);
+  PackedVectorValues& operator*=(double alpha) {
+    values_ *= alpha;
+    return *this;
+  }
+
+  /// @}
+  /// @name Testable
+  /// @{
+
+  void print(const std::string& str = "PackedVectorValues",
+             const KeyFormatter& formatter = DefaultKeyFormatter) const;
+
+  bool equals(const PackedVectorValues& x, double tol = 1e-9) const;
+
+  /// @}
+
+ private:
+  /// Throw std::invalid_argument unless other has the same layout
+  void checkLayout(const PackedVectorValues& other) const;
+};
+
+/// traits
+template <>
+struct traits<PackedVectorValues> : public Testable<PackedVectorValues> {};
+
+}  // namespace gtsam
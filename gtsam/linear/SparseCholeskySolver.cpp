@@ -0,0 +1,299 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SparseCholeskySolver.cpp
+ * @brief   Block-supernodal sparse Cholesky with a reusable symbolic analysis
+ */
+
+#include <gtsam/linear/SparseCholeskySolver.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/base/timing.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+SparseCholeskySolver::SparseCholeskySolver(const GaussianFactorGraph& graph,
+                                           const Ordering& ordering)
+    : ordering_(ordering) {
+  gttic(SparseCholeskySolver_analyze);
+  const size_t n = ordering.size();
+  std::unordered_map<Key, size_t> position;
+  for (size_t j = 0; j < n; ++j) position.emplace(ordering[j], j);
+  if (position.size() != n)
+    throw std::invalid_argument(
+        "SparseCholeskySolver: the ordering contains duplicate keys");
+
+  // Variable dimensions, and the lower-triangular block adjacency of A'A
+  dims_.assign(n, 0);
+  std::vector<std::vector<size_t>> adjacent(n);
+  std::vector<std::vector<size_t>> factorPositions(graph.size());
+  factorKeys_.resize(graph.size());
+  for (size_t f = 0; f < graph.size(); ++f) {
+    if (!graph[f]) continue;
+    factorKeys_[f] = graph[f]->keys();
+    std::vector<size_t>& positions = factorPositions[f];
+    for (auto it = graph[f]->begin(); it != graph[f]->end(); ++it) {
+      auto p = position.find(*it);
+      if (p == position.end())
+        throw std::invalid_argument(
+            "SparseCholeskySolver: the ordering does not contain all keys");
+      dims_[p->second] = graph[f]->getDim(it);
+      positions.push_back(p->second);
+    }
+    for (size_t a : positions)
+      for (size_t b : positions)
+        if (a > b) adjacent[b].push_back(a);
+  }
+  for (size_t j = 0; j < n; ++j)
+    if (dims_[j] == 0)
+      throw std::invalid_argument(
+          "SparseCholeskySolver: the ordering contains keys not in the graph");
+
+  colOffsets_.resize(n);
+  for (size_t j = 0, offset = 0; j < n; offset += dims_[j++])
+    colOffsets_[j] = offset;
+
+  // Block structure of L: the rows of column j are its neighbors after j,
+  // merged with the rows of its children in the elimination tree
+  std::vector<std::vector<size_t>> structure(n), children(n);
+  for (size_t j = 0; j < n; ++j) {
+    std::vector<size_t>& rows = structure[j];
+    rows = std::move(adjacent[j]);
+    for (size_t child : children[j])
+      for (size_t r : structure[child])
+        if (r != j) rows.push_back(r);
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    if (!rows.empty()) children[rows.front()].push_back(j);
+  }
+
+  // Variable j joins the supernode of j-1 if the column of j-1 is that of j,
+  // with j on top
+  supernodeOf_.resize(n);
+  for (size_t j = 0; j < n; ++j) {
+    const std::vector<size_t>* previous = j > 0 ? &structure[j - 1] : nullptr;
+    if (previous && !previous->empty() && previous->front() == j &&
+        std::equal(previous->begin() + 1, previous->end(),
+                   structure[j].begin(), structure[j].end())) {
+      supernodeOf_[j] = supernodeOf_[j - 1];
+    } else {
+      supernodeOf_[j] = supernodeStart_.size();
+      supernodeStart_.push_back(j);
+    }
+  }
+  const size_t nrSupernodes = supernodeStart_.size();
+  supernodeStart_.push_back(n);
+
+  // Dense panel layout of every supernode: the diagonal block, then the rows
+  rows_.resize(nrSupernodes);
+  rowOffsets_.resize(nrSupernodes);
+  for (size_t s = 0; s < nrSupernodes; ++s) {
+    const size_t last = supernodeStart_[s + 1] - 1;
+    rows_[s] = std::move(structure[last]);
+    std::vector<size_t>& offsets = rowOffsets_[s];
+    offsets.reserve(rows_[s].size() + 1);
+    offsets.push_back(colOffsets_[last] + dims_[last] -
+                      colOffsets_[supernodeStart_[s]]);
+    for (size_t r : rows_[s]) offsets.push_back(offsets.back() + dims_[r]);
+  }
+
+  // Where the information blocks of each factor are added
+  factorOffsets_.resize(graph.size());
+  for (size_t f = 0; f < graph.size(); ++f) {
+    const std::vector<size_t>& positions = factorPositions[f];
+    const size_t k = positions.size();
+    factorOffsets_[f].assign(2 * k * k, 0);
+    for (size_t a = 0; a < k; ++a)
+      for (size_t b = 0; b < k; ++b)
+        if (positions[a] >= positions[b]) {
+          const size_t s = supernodeOf_[positions[b]];
+          factorOffsets_[f][2 * (a * k + b)] = rowOffset(s, positions[a]);
+          factorOffsets_[f][2 * (a * k + b) + 1] = rowOffset(s, positions[b]);
+        }
+  }
+
+  // Where the update of each supernode is subtracted
+  updateOffsets_.resize(nrSupernodes);
+  for (size_t s = 0; s < nrSupernodes; ++s) {
+    const std::vector<size_t>& rows = rows_[s];
+    for (size_t k = 0; k < rows.size(); ++k)
+      for (size_t l = k; l < rows.size(); ++l)
+        updateOffsets_[s].push_back(rowOffset(supernodeOf_[rows[k]], rows[l]));
+  }
+}
+
+/* ************************************************************************* */
+size_t SparseCholeskySolver::rowOffset(size_t s, size_t r) const {
+  // Variables of the supernode itself are in its diagonal block
+  if (supernodeOf_[r] == s)
+    return colOffsets_[r] - colOffsets_[supernodeStart_[s]];
+  const std::vector<size_t>& rows = rows_[s];
+  const auto it = std::lower_bound(rows.begin(), rows.end(), r);
+  return rowOffsets_[s][it - rows.begin()];
+}
+
+/* ************************************************************************* */
+bool SparseCholeskySolver::matches(const GaussianFactorGraph& graph) const {
+  if (graph.size() != factorKeys_.size()) return false;
+  for (size_t f = 0; f < graph.size(); ++f) {
+    if (graph[f]) {
+      if (graph[f]->keys() != factorKeys_[f]) return false;
+    } else if (!factorKeys_[f].empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+size_t SparseCholeskySolver::nnz() const {
+  size_t result = 0;
+  for (size_t s = 0; s < rows_.size(); ++s)
+    result += width(s) * rowOffsets_[s].back() - width(s) * (width(s) - 1) / 2;
+  return result;
+}
+
+/* ************************************************************************* */
+VectorValues SparseCholeskySolver::solve(
+    const GaussianFactorGraph& graph) const {
+  if (graph.size() != factorKeys_.size())
+    throw std::invalid_argument(
+        "SparseCholeskySolver::solve: graph does not match the analyzed graph");
+  const size_t n = dims_.size(), nrSupernodes = rows_.size();
+
+  // Assemble the lower triangle of A'A into the supernode panels, and A'b
+  gttic(SparseCholeskySolver_assemble);
+  std::vector<Matrix> panels(nrSupernodes);
+  for (size_t s = 0; s < nrSupernodes; ++s)
+    panels[s] = Matrix::Zero(rowOffsets_[s].back(), width(s));
+  Vector y = Vector::Zero(n == 0 ? 0 : colOffsets_.back() + dims_.back());
+  const std::unordered_map<Key, size_t> position = [this] {
+    std::unordered_map<Key, size_t> result;
+    for (size_t j = 0; j < ordering_.size(); ++j) result.emplace(ordering_[j], j);
+    return result;
+  }();
+  for (size_t f = 0; f < graph.size(); ++f) {
+    const GaussianFactor::shared_ptr& factor = graph[f];
+    if (!factor) continue;
+    if (factor->keys() != factorKeys_[f])
+      throw std::invalid_argument(
+          "SparseCholeskySolver::solve: graph does not match the analyzed graph");
+    if (auto jacobian = std::dynamic_pointer_cast<JacobianFactor>(factor))
+      if (jacobian->get_model() && jacobian->get_model()->isConstrained())
+        throw std::invalid_argument(
+            "SparseCholeskySolver::solve: constrained noise models are not "
+            "supported, use QR instead");
+
+    const size_t k = factor->size();
+    std::vector<size_t> positions(k), starts(k + 1, 0);
+    for (size_t a = 0; a < k; ++a) {
+      positions[a] = position.at(factor->keys()[a]);
+      const size_t dim = factor->getDim(factor->begin() + a);
+      if (dim != dims_[positions[a]])
+        throw std::invalid_argument(
+            "SparseCholeskySolver::solve: variable dimensions changed");
+      starts[a + 1] = starts[a] + dim;
+    }
+
+    const Matrix information = factor->augmentedInformation();
+    const size_t* offsets = factorOffsets_[f].data();
+    for (size_t a = 0; a < k; ++a) {
+      const size_t da = dims_[positions[a]];
+      for (size_t b = 0; b < k; ++b, offsets += 2)
+        if (positions[a] >= positions[b])
+          panels[supernodeOf_[positions[b]]].block(
+              offsets[0], offsets[1], da, dims_[positions[b]]) +=
+              information.block(starts[a], starts[b], da, dims_[positions[b]]);
+      y.segment(colOffsets_[positions[a]], da) +=
+          information.block(starts[a], starts[k], da, 1);
+    }
+  }
+  gttoc(SparseCholeskySolver_assemble);
+
+  // Right-looking supernodal Cholesky: factor the diagonal block of each
+  // supernode, then subtract the outer product of the rows below it from the
+  // panels of the supernodes those rows belong to
+  gttic(SparseCholeskySolver_factor);
+  Matrix update;
+  for (size_t s = 0; s < nrSupernodes; ++s) {
+    Matrix& panel = panels[s];
+    const size_t w = width(s), below = panel.rows() - w;
+    const Eigen::LLT<Matrix> llt(panel.topRows(w));
+    if (llt.info() != Eigen::Success)
+      throw IndeterminantLinearSystemException(ordering_[supernodeStart_[s]]);
+    panel.topRows(w) = llt.matrixL();
+    if (below == 0) continue;
+
+    auto L = panel.bottomRows(below);
+    llt.matrixU().solveInPlace<Eigen::OnTheRight>(L);
+    update.setZero(below, below);
+    update.selfadjointView<Eigen::Lower>().rankUpdate(L);
+
+    const std::vector<size_t>& rows = rows_[s];
+    const std::vector<size_t>& rowOffsets = rowOffsets_[s];
+    const size_t* offset = updateOffsets_[s].data();
+    for (size_t k = 0; k < rows.size(); ++k) {
+      const size_t t = supernodeOf_[rows[k]], dk = dims_[rows[k]];
+      const size_t column = rowOffset(t, rows[k]), start = rowOffsets[k] - w;
+      for (size_t l = k; l < rows.size(); ++l) {
+        const size_t dl = dims_[rows[l]];
+        panels[t].block(*offset++, column, dl, dk) -=
+            update.block(rowOffsets[l] - w, start, dl, dk);
+      }
+    }
+  }
+  gttoc(SparseCholeskySolver_factor);
+
+  // Solve L z = A'b, then L' x = z
+  gttic(SparseCholeskySolver_backsubstitute);
+  Vector rowValues;
+  for (size_t s = 0; s < nrSupernodes; ++s) {
+    const size_t w = width(s), below = panels[s].rows() - w;
+    auto ys = y.segment(colOffsets_[supernodeStart_[s]], w);
+    panels[s].topRows(w).triangularView<Eigen::Lower>().solveInPlace(ys);
+    if (below == 0) continue;
+    rowValues.noalias() = panels[s].bottomRows(below) * ys;
+    for (size_t k = 0; k < rows_[s].size(); ++k) {
+      const size_t r = rows_[s][k];
+      y.segment(colOffsets_[r], dims_[r]) -=
+          rowValues.segment(rowOffsets_[s][k] - w, dims_[r]);
+    }
+  }
+  for (size_t s = nrSupernodes; s-- > 0;) {
+    const size_t w = width(s), below = panels[s].rows() - w;
+    auto xs = y.segment(colOffsets_[supernodeStart_[s]], w);
+    if (below > 0) {
+      rowValues.resize(below);
+      for (size_t k = 0; k < rows_[s].size(); ++k) {
+        const size_t r = rows_[s][k];
+        rowValues.segment(rowOffsets_[s][k] - w, dims_[r]) =
+            y.segment(colOffsets_[r], dims_[r]);
+      }
+      xs.noalias() -= panels[s].bottomRows(below).transpose() * rowValues;
+    }
+    panels[s].topRows(w).triangularView<Eigen::Lower>().transpose()
+        .solveInPlace(xs);
+  }
+  gttoc(SparseCholeskySolver_backsubstitute);
+
+  VectorValues result;
+  for (size_t j = 0; j < n; ++j)
+    result.emplace(ordering_[j], y.segment(colOffsets_[j], dims_[j]));
+  return result;
+}
+
+}  // namespace gtsam
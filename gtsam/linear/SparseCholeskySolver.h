@@ -0,0 +1,112 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    SparseCholeskySolver.h
+ * @brief   Block-supernodal sparse Cholesky with a reusable symbolic analysis
+ */
+
+#pragma once
+
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/inference/Ordering.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Solves the normal equations A'A x = A'b of a GaussianFactorGraph with a
+ * sparse Cholesky factorization L L' of the information matrix, in the spirit
+ * of supernodal CHOLMOD: variables whose columns of L share the same sparsity
+ * are grouped into supernodes, each stored as one dense panel, so the numeric
+ * work is done with dense Eigen kernels.
+ *
+ * The constructor does the symbolic analysis once: the block sparsity pattern
+ * of L including fill-in, the supernodes and their panel layout, where every
+ * factor's information blocks are scattered to, and where the update of each
+ * supernode lands in the panels after it. solve() then only assembles the
+ * information matrix of a graph with the same layout (see matches()), factors
+ * it and does the two triangular solves, so it can be called every iteration
+ * of a nonlinear optimizer without redoing the symbolic work.
+ *
+ * Only unconstrained factors are supported, as with EliminateCholesky.
+ *
+ * Example:
+ * \code
+ * SparseCholeskySolver solver(*graph.linearize(x0), Ordering::Colamd(...));
+ * for (...) {
+ *   auto linear = graph.linearize(x);
+ *   if (!solver.matches(*linear)) { ... rebuild ... }
+ *   VectorValues delta = solver.solve(*linear);
+ * }
+ * \endcode
+ */
+class GTSAM_EXPORT SparseCholeskySolver {
+ public:
+  typedef std::shared_ptr<SparseCholeskySolver> shared_ptr;
+
+  /**
+   * Symbolic analysis of factoring the information matrix of \c graph with
+   * the variables in the given \c ordering. Throws std::invalid_argument if
+   * the ordering does not contain exactly the variables of the graph.
+   */
+  SparseCholeskySolver(const GaussianFactorGraph& graph,
+                       const Ordering& ordering);
+
+  /// Whether \c graph has the same factor layout as the analyzed graph
+  bool matches(const GaussianFactorGraph& graph) const;
+
+  /**
+   * Solve the least-squares problem of a graph with the same layout, see
+   * matches(). Throws IndeterminantLinearSystemException if the information
+   * matrix is not positive definite, and std::invalid_argument if a factor is
+   * constrained or does not fit the analyzed layout.
+   */
+  VectorValues solve(const GaussianFactorGraph& graph) const;
+
+  /// The elimination ordering
+  const Ordering& ordering() const { return ordering_; }
+
+  /// Number of scalar non-zeros in the lower triangle of the factor L
+  size_t nnz() const;
+
+  /// Number of supernodes
+  size_t nrSupernodes() const { return rows_.size(); }
+
+ private:
+  Ordering ordering_;
+  std::vector<size_t> dims_;         ///< Dimension of each variable
+  std::vector<size_t> colOffsets_;   ///< Scalar offset of each variable in x
+  std::vector<KeyVector> factorKeys_;  ///< Keys of each factor, empty if null
+
+  /// Supernodes are runs of consecutive variables whose columns of L have the
+  /// same structure below them, they are factored as one dense column panel
+  std::vector<size_t> supernodeStart_;  ///< First variable of each supernode
+  std::vector<size_t> supernodeOf_;     ///< Supernode of each variable
+  /// Sorted positions of the variables below each supernode in L
+  std::vector<std::vector<size_t>> rows_;
+  /// Row offsets of those variables in the supernode panel, which starts with
+  /// the dense diagonal block; the last entry is the height of the panel
+  std::vector<std::vector<size_t>> rowOffsets_;
+  /// Panel row and column offsets each factor's information blocks are added
+  /// to, for the pairs of keys (a, b) with a at or after b in the ordering
+  std::vector<std::vector<size_t>> factorOffsets_;
+  /// For each supernode, the row offsets of its update in the panels of the
+  /// variables below it: for each row k, the offsets of rows k and after
+  std::vector<std::vector<size_t>> updateOffsets_;
+
+  size_t width(size_t s) const { return rowOffsets_[s].front(); }
+  size_t rowOffset(size_t s, size_t r) const;
+};
+
+}  // namespace gtsam
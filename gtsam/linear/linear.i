@@ -716,6 +716,15 @@ virtual class PCGSolverParameters : gtsam::ConjugateGradientParameters {
   void setPreconditionerParams(gtsam::PreconditionerParameters* preconditioner);
 };
 
+#include <gtsam/linear/ImplicitSchurSolver.h>
+virtual class ImplicitSchurSolverParameters : gtsam::ConjugateGradientParameters {
+  ImplicitSchurSolverParameters();
+  void print(string s = "");
+  void setPreconditioner(string s);
+  string getPreconditioner() const;
+  void setEliminatedKeys(const gtsam::KeySet& keys);
+};
+
 #include <gtsam/linear/SubgraphSolver.h>
 virtual class SubgraphSolverParameters : gtsam::ConjugateGradientParameters {
   SubgraphSolverParameters();
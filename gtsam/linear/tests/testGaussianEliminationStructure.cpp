@@ -0,0 +1,91 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGaussianEliminationStructure.cpp
+ * @brief   Unit tests for GaussianEliminationStructure
+ */
+
+#include <gtsam/linear/GaussianEliminationStructure.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/inference/inferenceExceptions.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace gtsam;
+
+static const auto model = noiseModel::Isotropic::Sigma(2, 0.5);
+
+/* ************************************************************************* */
+// A chain with a loop closure, scaled so every call gives different numbers
+static GaussianFactorGraph createChain(double scale) {
+  GaussianFactorGraph graph;
+  graph.add(0, scale * I_2x2, Vector2(1, 2), model);
+  for (Key j = 1; j < 6; j++)
+    graph.add(j - 1, -I_2x2, j, scale * I_2x2, Vector2(scale, 0.5), model);
+  graph.add(0, -I_2x2, 5, I_2x2, Vector2(0, scale), model);
+  graph.push_back(GaussianFactor::shared_ptr());  // null factors are skipped
+  return graph;
+}
+
+/* ************************************************************************* */
+TEST(GaussianEliminationStructure, Eliminate) {
+  const Ordering ordering{0, 1, 2, 3, 4, 5};
+  const GaussianEliminationStructure structure(createChain(1.0), ordering);
+  EXPECT(structure.nrClusters() > 0);
+
+  for (double scale : {1.0, 2.0, -0.5}) {
+    const GaussianFactorGraph graph = createChain(scale);
+    EXPECT(structure.matches(graph, ordering));
+    for (const auto& function : {GaussianFactorGraph::Eliminate(EliminateQR),
+                                 GaussianFactorGraph::Eliminate(EliminateCholesky)}) {
+      const auto expected = graph.eliminateMultifrontal(ordering, function);
+      const auto actual = structure.eliminate(graph, function);
+      EXPECT(assert_equal(*expected, *actual, 1e-9));
+    }
+  }
+}
+
+/* ************************************************************************* */
+TEST(GaussianEliminationStructure, Matches) {
+  const Ordering ordering{0, 1, 2, 3, 4, 5};
+  const GaussianEliminationStructure structure(createChain(1.0), ordering);
+
+  // A different ordering
+  EXPECT(!structure.matches(createChain(1.0), Ordering{5, 4, 3, 2, 1, 0}));
+
+  // An extra factor
+  GaussianFactorGraph extra = createChain(1.0);
+  extra.add(2, I_2x2, Vector2(0, 0), model);
+  EXPECT(!structure.matches(extra, ordering));
+  CHECK_EXCEPTION(structure.eliminate(extra, EliminateQR), std::invalid_argument);
+
+  // Same number of factors, but different keys
+  GaussianFactorGraph rekeyed = createChain(1.0);
+  rekeyed[0] = std::make_shared<JacobianFactor>(1, I_2x2, Vector2(1, 2), model);
+  EXPECT(!structure.matches(rekeyed, ordering));
+}
+
+/* ************************************************************************* */
+TEST(GaussianEliminationStructure, IncompleteOrdering) {
+  CHECK_EXCEPTION(
+      GaussianEliminationStructure(createChain(1.0), Ordering{0, 1, 2}),
+      InconsistentEliminationRequested);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
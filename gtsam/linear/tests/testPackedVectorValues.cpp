@@ -0,0 +1,147 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testPackedVectorValues.cpp
+ * @brief   Unit tests for PackedVectorValues
+ */
+
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/IterativeSolver.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/PackedVectorValues.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+// Graph on variables 0 (dim 2), 3 (dim 3) and 5 (dim 1)
+GaussianFactorGraph createGraph() {
+  GaussianFactorGraph gfg;
+  gfg.emplace_shared<JacobianFactor>(
+      0, (Matrix(2, 2) << 1, 2, 3, 4).finished(), 3,
+      (Matrix(2, 3) << 5, 6, 7, 8, 9, 10).finished(), Vector2(1, 2),
+      noiseModel::Diagonal::Sigmas(Vector2(0.5, 2.0)));
+  gfg.emplace_shared<JacobianFactor>(5, I_1x1, Vector1(3));
+  gfg.emplace_shared<HessianFactor>(JacobianFactor(
+      3, (Matrix(1, 3) << 1, -1, 2).finished(), 5, I_1x1 * 3, Vector1(4)));
+  return gfg;
+}
+
+const VectorValues x{
+    {0, Vector2(1, -2)}, {3, Vector3(0.5, 0, 2)}, {5, Vector1(-1)}};
+
+}  // namespace
+
+/* ************************************************************************* */
+TEST(PackedVectorValues, Layout) {
+  const PackedVectorValues::Layout layout{Scatter(createGraph())};
+  EXPECT_LONGS_EQUAL(3, layout.size());
+  EXPECT_LONGS_EQUAL(6, layout.dim());
+  EXPECT_LONGS_EQUAL(3, layout.key(1));
+  EXPECT_LONGS_EQUAL(2, layout.offset(1));
+  EXPECT_LONGS_EQUAL(3, layout.dim(1));
+  EXPECT_LONGS_EQUAL(2, layout.slot(5));
+  EXPECT(layout.exists(3));
+  EXPECT(!layout.exists(4));
+  CHECK_EXCEPTION(layout.slot(4), std::out_of_range);
+
+  // The layout of a KeyInfo has its ordering and offsets
+  const KeyInfo keyInfo(createGraph(), Ordering{5, 0, 3});
+  const PackedVectorValues::Layout ordered(keyInfo);
+  EXPECT_LONGS_EQUAL(5, ordered.key(0));
+  EXPECT_LONGS_EQUAL(keyInfo.at(3).start, ordered.offset(2));
+}
+
+/* ************************************************************************* */
+TEST(PackedVectorValues, Access) {
+  auto layout =
+      std::make_shared<PackedVectorValues::Layout>(Scatter(createGraph()));
+  PackedVectorValues packed(layout, x);
+  EXPECT(assert_equal(Vector(x.vector(Ordering{0, 3, 5})), packed.vector()));
+  EXPECT(assert_equal(Vector(x.at(3)), Vector(packed.at(3))));
+  EXPECT(assert_equal(x, packed.vectorValues()));
+
+  // Writing through at() writes into the buffer
+  packed.at(5) << 7;
+  EXPECT_DOUBLES_EQUAL(7, packed.vector()(5), 1e-9);
+  CHECK_EXCEPTION(packed.at(4), std::out_of_range);
+
+  // Missing variables are zero
+  const PackedVectorValues partial(layout, VectorValues{{3, Vector3(1, 2, 3)}});
+  EXPECT(assert_equal(Vector2(0, 0), Vector(partial.at(0))));
+  EXPECT(assert_equal(Vector3(1, 2, 3), Vector(partial.at(3))));
+}
+
+/* ************************************************************************* */
+TEST(PackedVectorValues, VectorSpace) {
+  auto layout =
+      std::make_shared<PackedVectorValues::Layout>(Scatter(createGraph()));
+  const VectorValues y{
+      {0, Vector2(3, 1)}, {3, Vector3(-1, 4, 2)}, {5, Vector1(0.5)}};
+  const PackedVectorValues px(layout, x), py(layout, y);
+
+  EXPECT_DOUBLES_EQUAL(x.dot(y), px.dot(py), 1e-9);
+  EXPECT_DOUBLES_EQUAL(x.norm(), px.norm(), 1e-9);
+
+  PackedVectorValues actual = py;
+  actual.axpy(2.0, px);
+  EXPECT(assert_equal(PackedVectorValues(layout, VectorValues(y + 2.0 * x)),
+                      actual));
+  actual -= px;
+  actual *= 0.5;
+  EXPECT(assert_equal(PackedVectorValues(layout, VectorValues(0.5 * (y + x))),
+                      actual));
+
+  // Vectors with another layout are rejected
+  GaussianFactorGraph other;
+  other.emplace_shared<JacobianFactor>(0, I_2x2, Vector2(1, 2));
+  const PackedVectorValues pz(
+      std::make_shared<PackedVectorValues::Layout>(Scatter(other)));
+  CHECK_EXCEPTION(px.dot(pz), std::invalid_argument);
+  EXPECT(!px.equals(pz));
+}
+
+/* ************************************************************************* */
+TEST(PackedVectorValues, multiplyHessianAdd) {
+  const GaussianFactorGraph gfg = createGraph();
+  auto layout = std::make_shared<PackedVectorValues::Layout>(Scatter(gfg));
+  const PackedVectorValues px(layout, x);
+
+  VectorValues expected = VectorValues::Zero(x);
+  gfg.multiplyHessianAdd(2.0, x, expected);
+  PackedVectorValues actual(layout);
+  gfg.multiplyHessianAdd(2.0, px, actual);
+  EXPECT(assert_equal(PackedVectorValues(layout, expected), actual, 1e-9));
+
+  // The default implementation, through VectorValues, agrees
+  for (const auto& factor : gfg) {
+    VectorValues expectedFactor = VectorValues::Zero(x);
+    factor->multiplyHessianAdd(2.0, x, expectedFactor);
+    PackedVectorValues actualFactor(layout);
+    factor->GaussianFactor::multiplyHessianAdd(2.0, px, actualFactor);
+    EXPECT(assert_equal(PackedVectorValues(layout, expectedFactor),
+                        actualFactor, 1e-9));
+  }
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -0,0 +1,131 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testSparseCholeskySolver.cpp
+ * @brief   Unit tests for SparseCholeskySolver
+ */
+
+#include <gtsam/linear/SparseCholeskySolver.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace gtsam;
+
+static const auto model = noiseModel::Isotropic::Sigma(2, 0.5);
+
+/* ************************************************************************* */
+// A chain of 2D and 3D variables with two loop closures, which cause fill-in,
+// scaled so every call gives different numbers
+static GaussianFactorGraph createGraph(double scale) {
+  GaussianFactorGraph graph;
+  graph.add(0, scale * I_2x2, Vector2(1, 2), model);
+  for (Key j = 1; j < 8; j++) {
+    const Matrix A = (Matrix(2, 3) << scale, 0, 1, 0, 1, -scale).finished();
+    if (j % 2) {
+      graph.add(j - 1, -I_2x2, j, A, Vector2(scale, 0.5), model);
+      graph.add(j, scale * I_3x3, Vector3(1, 0, scale));
+    } else
+      graph.add(j - 1, -A, j, scale * I_2x2, Vector2(0.5, scale), model);
+  }
+  graph.add(0, -I_2x2, 6, I_2x2, Vector2(0, scale), model);
+  graph.add(3, Matrix23::Ones(), 7, Matrix23::Identity(), Vector2(scale, 1),
+            noiseModel::Diagonal::Sigmas(Vector2(0.1, 2.0)));
+  graph.push_back(GaussianFactor::shared_ptr());  // null factors are skipped
+  graph.push_back(HessianFactor(JacobianFactor(2, scale * I_2x2, 5,
+                                               Matrix23::Ones(), Vector2(1, 1))));
+  return graph;
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, Solve) {
+  for (const Ordering& ordering :
+       {Ordering{0, 1, 2, 3, 4, 5, 6, 7}, Ordering{7, 6, 5, 4, 3, 2, 1, 0},
+        Ordering::Colamd(createGraph(1.0))}) {
+    const SparseCholeskySolver solver(createGraph(1.0), ordering);
+    EXPECT(assert_equal(ordering, solver.ordering()));
+    EXPECT(solver.nnz() > 0);
+
+    for (double scale : {1.0, 2.0, -0.5}) {
+      const GaussianFactorGraph graph = createGraph(scale);
+      EXPECT(solver.matches(graph));
+      EXPECT(assert_equal(graph.optimize(), solver.solve(graph), 1e-9));
+    }
+  }
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, FillIn) {
+  // The natural ordering of a star graph fills in L completely, and L is one
+  // supernode; eliminating the leaves first causes no fill-in
+  GaussianFactorGraph star;
+  for (Key j = 1; j < 5; j++)
+    star.add(0, I_2x2, j, I_2x2, Vector2(j, 1), model);
+  star.add(0, I_2x2, Vector2(0, 0), model);
+
+  const SparseCholeskySolver dense(star, Ordering{0, 1, 2, 3, 4});
+  const SparseCholeskySolver sparse(star, Ordering{1, 2, 3, 4, 0});
+  EXPECT_LONGS_EQUAL(10 * 11 / 2, dense.nnz());
+  EXPECT_LONGS_EQUAL(5 * 3 + 4 * 4, sparse.nnz());
+  EXPECT_LONGS_EQUAL(1, dense.nrSupernodes());
+  EXPECT_LONGS_EQUAL(4, sparse.nrSupernodes());  // the last leaf joins the hub
+  EXPECT(assert_equal(star.optimize(), dense.solve(star), 1e-9));
+  EXPECT(assert_equal(star.optimize(), sparse.solve(star), 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, Matches) {
+  const SparseCholeskySolver solver(createGraph(1.0), Ordering::Colamd(createGraph(1.0)));
+
+  // An extra factor
+  GaussianFactorGraph extra = createGraph(1.0);
+  extra.add(2, I_2x2, Vector2(0, 0), model);
+  EXPECT(!solver.matches(extra));
+  CHECK_EXCEPTION(solver.solve(extra), std::invalid_argument);
+
+  // Same number of factors, but different keys
+  GaussianFactorGraph rekeyed = createGraph(1.0);
+  rekeyed[0] = std::make_shared<JacobianFactor>(2, I_2x2, Vector2(1, 2), model);
+  EXPECT(!solver.matches(rekeyed));
+  CHECK_EXCEPTION(solver.solve(rekeyed), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(SparseCholeskySolver, Errors) {
+  GaussianFactorGraph graph;
+  graph.add(0, I_2x2, 1, I_2x2, Vector2(1, 2), model);
+
+  // Orderings that do not match the graph
+  CHECK_EXCEPTION(SparseCholeskySolver(graph, Ordering{0}), std::invalid_argument);
+  CHECK_EXCEPTION(SparseCholeskySolver(graph, Ordering{0, 1, 2}),
+                  std::invalid_argument);
+
+  // Not positive definite: 1 is only determined relative to 0
+  const SparseCholeskySolver solver(graph, Ordering{0, 1});
+  CHECK_EXCEPTION(solver.solve(graph), IndeterminantLinearSystemException);
+
+  // Constrained noise models are not supported
+  GaussianFactorGraph constrained;
+  constrained.add(0, I_2x2, Vector2(1, 2), noiseModel::Constrained::All(2));
+  const SparseCholeskySolver constrainedSolver(constrained, Ordering{0});
+  CHECK_EXCEPTION(constrainedSolver.solve(constrained), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -52,35 +52,7 @@ void PreintegratedImuMeasurements::resetIntegration() {
 //------------------------------------------------------------------------------
 void PreintegratedImuMeasurements::integrateMeasurement(
     const Vector3& measuredAcc, const Vector3& measuredOmega, double dt) {
-  if (dt <= 0) {
-    throw std::runtime_error(
-        "PreintegratedImuMeasurements::integrateMeasurement: dt <=0");
-  }
-
-  // Update preintegrated measurements (also get Jacobian)
-  Matrix9 A;  // overall Jacobian wrt preintegrated measurements (df/dx)
-  Matrix93 B, C;  // Jacobian of state wrpt accel bias and omega bias respectively.
-  PreintegrationType::update(measuredAcc, measuredOmega, dt, &A, &B, &C);
-
-  // first order covariance propagation:
-  // as in [2] we consider a first order propagation that can be seen as a
-  // prediction phase in EKF
-
-  // propagate uncertainty
-  // TODO(frank): use noiseModel routine so we can have arbitrary noise models.
-  const Matrix3& aCov = p().accelerometerCovariance;
-  const Matrix3& wCov = p().gyroscopeCovariance;
-  const Matrix3& iCov = p().integrationCovariance;
-
-  // (1/dt) allows to pass from continuous time noise to discrete time noise
-  // Update the uncertainty on the state (matrix A in [4]).
-  preintMeasCov_ = A * preintMeasCov_ * A.transpose();
-  // These 2 updates account for uncertainty on the IMU measurement (matrix B in [4]).
-  preintMeasCov_.noalias() += B * (aCov / dt) * B.transpose();
-  preintMeasCov_.noalias() += C * (wCov / dt) * C.transpose();
-
-  // NOTE(frank): (Gi*dt)*(C/dt)*(Gi'*dt), with Gi << Z_3x3, I_3x3, Z_3x3 (9x3 matrix)
-  preintMeasCov_.block<3, 3>(3, 3).noalias() += iCov * dt;
+  integrateMeasurementBlock(measuredAcc.data(), measuredOmega.data(), &dt, 1);
 }
 
 //------------------------------------------------------------------------------
@@ -92,10 +64,91 @@ void PreintegratedImuMeasurements::integrateMeasurements(
   assert(dts.cols() >= 1);
   assert(measuredAccs.cols() == dts.cols());
   assert(measuredOmegas.cols() == dts.cols());
-  size_t n = static_cast<size_t>(dts.cols());
-  for (size_t j = 0; j < n; j++) {
-    integrateMeasurement(measuredAccs.col(j), measuredOmegas.col(j), dts(0, j));
+  integrateMeasurementBlock(measuredAccs.data(), measuredOmegas.data(),
+                            dts.data(), static_cast<size_t>(dts.cols()));
+}
+
+//------------------------------------------------------------------------------
+void PreintegratedImuMeasurements::integrateMeasurementBlock(
+    const double* measuredAccs, const double* measuredOmegas,
+    const double* dts, size_t n, bool deferCovariance) {
+  // Check the whole block first, so a bad sample leaves the state untouched
+  for (size_t k = 0; k < n; k++) {
+    if (dts[k] <= 0) {
+      throw std::runtime_error(
+          "PreintegratedImuMeasurements::integrateMeasurement: dt <=0");
+    }
+  }
+
+  // first order covariance propagation:
+  // as in [2] we consider a first order propagation that can be seen as a
+  // prediction phase in EKF
+
+  // TODO(frank): use noiseModel routine so we can have arbitrary noise models.
+  // Q is the continuous time noise on [acc omega], (1/dt) allows to pass from
+  // continuous time noise to discrete time noise.
+  Matrix6 Q = Matrix6::Zero();
+  Q.topLeftCorner<3, 3>() = p().accelerometerCovariance;
+  Q.bottomRightCorner<3, 3>() = p().gyroscopeCovariance;
+  const Matrix3& iCov = p().integrationCovariance;
+
+  Matrix9 A;  // overall Jacobian wrt preintegrated measurements (df/dx)
+  Matrix93 B, C;  // Jacobian of state wrpt accel bias and omega bias respectively.
+  Matrix96 G;  // [B C], Jacobian wrpt the measurement noise
+
+  if (!deferCovariance) {
+    Matrix9 AP;
+    Matrix96 GQ;
+    for (size_t k = 0; k < n; k++) {
+      const double dt = dts[k];
+
+      // Update preintegrated measurements (also get Jacobian)
+      PreintegrationType::update(Vector3::Map(measuredAccs + 3 * k),
+                                 Vector3::Map(measuredOmegas + 3 * k), dt, &A,
+                                 &B, &C);
+
+      // Update the uncertainty on the state (matrix A in [4]).
+      AP.noalias() = A * preintMeasCov_;
+      preintMeasCov_.noalias() = AP * A.transpose();
+      // Uncertainty on the IMU measurement (matrix B in [4]), in one product.
+      G << B, C;
+      GQ.noalias() = G * (Q / dt);
+      preintMeasCov_.noalias() += GQ * G.transpose();
+
+      // NOTE(frank): (Gi*dt)*(C/dt)*(Gi'*dt), with Gi << Z_3x3, I_3x3, Z_3x3 (9x3 matrix)
+      preintMeasCov_.block<3, 3>(3, 3).noalias() += iCov * dt;
+    }
+    return;
+  }
+
+  // Accumulate the Jacobians of the whole block, [Phi G], with Phi the
+  // product of all A, and G the Jacobian wrpt the (constant) measurement noise.
+  Eigen::Matrix<double, 9, 15> J, AJ;
+  J << I_9x9, Matrix96::Zero();
+  double deltaT = 0;
+  for (size_t k = 0; k < n; k++) {
+    const double dt = dts[k];
+    PreintegrationType::update(Vector3::Map(measuredAccs + 3 * k),
+                               Vector3::Map(measuredOmegas + 3 * k), dt, &A, &B,
+                               &C);
+    AJ.noalias() = A * J;
+    J = AJ;
+    J.block<9, 3>(0, 9) += B;
+    J.block<9, 3>(0, 12) += C;
+    deltaT += dt;
   }
+  if (n == 0) return;
+
+  // Propagate once, with the noise of a single interval of length deltaT
+  const auto Phi = J.leftCols<9>();
+  G = J.rightCols<6>();
+  Matrix9 PhiP;
+  PhiP.noalias() = Phi * preintMeasCov_;
+  preintMeasCov_.noalias() = PhiP * Phi.transpose();
+  Matrix96 GQ;
+  GQ.noalias() = G * (Q / deltaT);
+  preintMeasCov_.noalias() += GQ * G.transpose();
+  preintMeasCov_.block<3, 3>(3, 3).noalias() += iCov * deltaT;
 }
 
 //------------------------------------------------------------------------------
@@ -137,6 +137,28 @@ public:
   void integrateMeasurements(const Matrix& measuredAccs, const Matrix& measuredOmegas,
                              const Matrix& dts);
 
+  /**
+   * Add a block of n IMU measurements in one call. The accelerometer and
+   * gyroscope arrays hold n consecutive xyz triplets, i.e., 3xn column-major
+   * matrices, and dts holds the n time intervals.
+   *
+   * By default the result is the same as calling integrateMeasurement n times,
+   * but the Jacobian and covariance updates are fused in fixed-size matrices
+   * and the noise covariances are only assembled once per block.
+   *
+   * With deferCovariance, the covariance is propagated once for the whole
+   * block instead of once per sample: the block is treated as a single
+   * interval, whose Jacobians with respect to the preintegrated state and the
+   * measurements are accumulated sample by sample. This halves the cost of
+   * the covariance update, and is a good approximation for blocks that are
+   * short with respect to the motion, e.g., the samples between two camera
+   * frames. The preintegrated measurements themselves are exact.
+   */
+  void integrateMeasurementBlock(const double* measuredAccs,
+                                 const double* measuredOmegas,
+                                 const double* dts, size_t n,
+                                 bool deferCovariance = false);
+
   /// Return pre-integrated measurement covariance
   Matrix preintMeasCov() const { return preintMeasCov_; }
 
@@ -239,6 +239,56 @@ TEST(ImuFactor, MultipleMeasurements) {
   EXPECT(assert_equal(expected,actual));
 }
 
+/* ************************************************************************* */
+TEST(ImuFactor, MeasurementBlock) {
+  const testing::SomeMeasurements measurements;
+  const size_t n = measurements.size();
+  std::vector<double> accs, omegas, dts;
+  for (const auto& m : measurements) {
+    accs.insert(accs.end(), m.acc.data(), m.acc.data() + 3);
+    omegas.insert(omegas.end(), m.gyro.data(), m.gyro.data() + 3);
+    dts.push_back(m.dt);
+  }
+
+  PreintegratedImuMeasurements expected(testing::Params(), kZeroBiasHat);
+  testing::integrateMeasurements(measurements, &expected);
+
+  // One block gives the same result as the per-sample loop
+  PreintegratedImuMeasurements actual(testing::Params(), kZeroBiasHat);
+  actual.integrateMeasurementBlock(accs.data(), omegas.data(), dts.data(), n);
+  EXPECT(assert_equal(expected, actual));
+
+  // Deferred covariance, in blocks of 10 samples: exact mean, and a close
+  // approximation of the covariance
+  PreintegratedImuMeasurements deferred(testing::Params(), kZeroBiasHat);
+  for (size_t k = 0; k < n; k += 10) {
+    deferred.integrateMeasurementBlock(&accs[3 * k], &omegas[3 * k], &dts[k],
+                                       std::min<size_t>(10, n - k), true);
+  }
+  EXPECT(assert_equal(expected.deltaXij(), deferred.deltaXij()));
+  const Matrix9 expectedCov = expected.preintMeasCov();
+  const Matrix9 error = deferred.preintMeasCov() - expectedCov;
+  EXPECT(error.norm() < 1e-2 * expectedCov.norm());
+
+  // Invalid time steps throw
+  const double zero = 0;
+  CHECK_EXCEPTION(actual.integrateMeasurementBlock(accs.data(), omegas.data(),
+                                                   &zero, 1, true),
+                  std::runtime_error);
+
+  // ... also after valid samples, and then the block is not integrated at all
+  const PreintegratedImuMeasurements before = deferred;
+  std::vector<double> badDts(dts.begin(), dts.begin() + 10);
+  badDts[5] = -0.01;
+  for (bool deferCovariance : {true, false}) {
+    CHECK_EXCEPTION(
+        deferred.integrateMeasurementBlock(accs.data(), omegas.data(),
+                                           badDts.data(), 10, deferCovariance),
+        std::runtime_error);
+    EXPECT(assert_equal(before, deferred));
+  }
+}
+
 /* ************************************************************************* */
 TEST(ImuFactor, ErrorAndJacobians) {
   using namespace common;
@@ -0,0 +1,139 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    AsyncISAM2.cpp
+ * @brief   ISAM2 updates on a background thread, with double-buffered
+ * estimates
+ */
+
+#include <gtsam/nonlinear/AsyncISAM2.h>
+
+#include <utility>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+AsyncISAM2::AsyncISAM2(const ISAM2Params& params)
+    : isam_(params), worker_(&AsyncISAM2::run, this) {}
+
+/* ************************************************************************* */
+AsyncISAM2::~AsyncISAM2() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  queueChanged_.notify_one();
+  worker_.join();
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::update(const NonlinearFactorGraph& newFactors,
+                        const Values& newTheta) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(Job{newFactors, newTheta, {}});
+    ++queuedUpdates_;
+  }
+  queueChanged_.notify_one();
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::update(const NonlinearFactorGraph& newFactors,
+                        const Values& newTheta,
+                        const ISAM2UpdateParams& updateParams) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(Job{newFactors, newTheta, updateParams});
+    ++queuedUpdates_;
+  }
+  queueChanged_.notify_one();
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::setMarginalKeys(const KeySet& keys) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  marginalKeys_ = keys;
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::waitForUpdates() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_.wait(lock, [this] { return completedUpdates_ == queuedUpdates_; });
+  if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+/* ************************************************************************* */
+size_t AsyncISAM2::pendingUpdates() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queuedUpdates_ - completedUpdates_;
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::publish(Snapshot&& snapshot) {
+  const size_t back = 1 - front_.load();
+  // Wait for readers that registered on the back buffer before the last swap
+  while (readers_[back].load() != 0) std::this_thread::yield();
+  buffers_[back] = std::move(snapshot);
+  front_.store(back);
+}
+
+/* ************************************************************************* */
+void AsyncISAM2::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queueChanged_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) return;  // stopped, and all updates applied
+
+    Job job = std::move(queue_.front());
+    queue_.pop_front();
+    const KeySet marginalKeys = marginalKeys_;
+    std::exception_ptr error;
+    lock.unlock();
+
+    try {
+      // Merge the following plain updates into this one
+      if (!job.updateParams) {
+        lock.lock();
+        while (!queue_.empty() && !queue_.front().updateParams) {
+          job.newTheta.insert(queue_.front().newTheta);
+          job.newFactors.push_back(queue_.front().newFactors);
+          job.count += 1;
+          queue_.pop_front();
+        }
+        lock.unlock();
+      }
+
+      Snapshot snapshot;
+      snapshot.result =
+          job.updateParams
+              ? isam_.update(job.newFactors, job.newTheta, *job.updateParams)
+              : isam_.update(job.newFactors, job.newTheta);
+      snapshot.estimate = isam_.calculateEstimate();
+      for (Key key : marginalKeys) {
+        if (snapshot.estimate.exists(key))
+          snapshot.marginalCovariances.emplace(key,
+                                               isam_.marginalCovariance(key));
+      }
+      snapshot.updateCount = updateCount() + job.count;
+      publish(std::move(snapshot));
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    if (!lock.owns_lock()) lock.lock();
+    completedUpdates_ += job.count;
+    if (error) error_ = error;
+    idle_.notify_all();
+  }
+}
+
+}  // namespace gtsam
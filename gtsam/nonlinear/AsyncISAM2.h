@@ -0,0 +1,205 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    AsyncISAM2.h
+ * @brief   ISAM2 updates on a background thread, with double-buffered
+ * estimates
+ */
+
+// \callgraph
+
+#pragma once
+
+#include <gtsam/nonlinear/ISAM2.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace gtsam {
+
+/**
+ * @ingroup isam2
+ * Runs ISAM2::update on a background worker thread.
+ *
+ * update() only queues the new factors and variables and returns immediately.
+ * The worker applies the queued updates in order, merging consecutive updates
+ * without ISAM2UpdateParams into one ISAM2::update. After every update it
+ * publishes a Snapshot with the estimate, the ISAM2Result and the marginal
+ * covariances of the keys given to setMarginalKeys().
+ *
+ * Snapshots are double-buffered: the worker fills the back buffer while
+ * readers use the front buffer, and then swaps them. Readers never take a
+ * lock, they only retry when the buffers are swapped while they register, and
+ * always see the consistent state after the last completed update.
+ *
+ * Example:
+ * \code
+ * AsyncISAM2 isam(params);
+ * isam.setMarginalKeys({X(0)});
+ * isam.update(newFactors, newValues);  // returns immediately
+ * Pose3 pose = isam.calculateEstimate<Pose3>(X(0));  // last completed update
+ * isam.waitForUpdates();  // blocks until the queue is empty
+ * \endcode
+ */
+class GTSAM_EXPORT AsyncISAM2 {
+ public:
+  /// State of the optimizer after a completed update
+  struct Snapshot {
+    size_t updateCount = 0;  ///< Number of update() calls applied
+    Values estimate;         ///< ISAM2::calculateEstimate() after the update
+    ISAM2Result result;      ///< Result of the last ISAM2::update
+    /// Marginal covariances of the keys given to setMarginalKeys()
+    FastMap<Key, Matrix> marginalCovariances;
+  };
+
+ protected:
+  /// A queued update
+  struct Job {
+    NonlinearFactorGraph newFactors;
+    Values newTheta;
+    std::optional<ISAM2UpdateParams> updateParams;
+    size_t count = 1;  ///< Number of update() calls merged into this job
+  };
+
+  ISAM2 isam_;  ///< Only touched by the worker thread
+
+  // Queue, protected by mutex_
+  mutable std::mutex mutex_;
+  std::condition_variable queueChanged_;  ///< Signals the worker
+  std::condition_variable idle_;          ///< Signals waitForUpdates
+  std::deque<Job> queue_;
+  size_t queuedUpdates_ = 0;     ///< Number of update() calls so far
+  size_t completedUpdates_ = 0;  ///< Number of update() calls applied so far
+  KeySet marginalKeys_;
+  std::exception_ptr error_;
+  bool stop_ = false;
+
+  // Double-buffered snapshots, see read() and publish()
+  Snapshot buffers_[2];
+  std::atomic<size_t> front_{0};
+  mutable std::atomic<size_t> readers_[2] = {{0}, {0}};
+
+  std::thread worker_;
+
+  /// Call f on the front buffer, which is not written while it is being read
+  template <class F>
+  auto read(F&& f) const {
+    size_t front;
+    while (true) {
+      front = front_.load();
+      ++readers_[front];
+      // The buffers may have been swapped before we registered as a reader
+      if (front_.load() == front) break;
+      --readers_[front];
+    }
+    struct Release {
+      std::atomic<size_t>& readers;
+      ~Release() { --readers; }
+    } release{readers_[front]};
+    return f(buffers_[front]);
+  }
+
+ public:
+  /// @name Standard Constructors
+  /// @{
+
+  /// Start the worker thread of an ISAM2 with the given parameters
+  explicit AsyncISAM2(const ISAM2Params& params = ISAM2Params());
+
+  /// Apply the remaining queued updates, and stop the worker thread
+  ~AsyncISAM2();
+
+  AsyncISAM2(const AsyncISAM2&) = delete;
+  AsyncISAM2& operator=(const AsyncISAM2&) = delete;
+
+  /// @}
+  /// @name Updates
+  /// @{
+
+  /**
+   * Queue new factors and variables, see ISAM2::update. Consecutive updates
+   * queued with this overload may be merged into one ISAM2::update.
+   */
+  void update(const NonlinearFactorGraph& newFactors = NonlinearFactorGraph(),
+              const Values& newTheta = Values());
+
+  /// Queue new factors and variables with explicit update parameters. Such
+  /// updates are never merged with others.
+  void update(const NonlinearFactorGraph& newFactors, const Values& newTheta,
+              const ISAM2UpdateParams& updateParams);
+
+  /// Compute the marginal covariances of these keys after every update
+  void setMarginalKeys(const KeySet& keys);
+
+  /**
+   * Block until all queued updates have been applied. If an update threw an
+   * exception on the worker thread, it is rethrown here.
+   */
+  void waitForUpdates();
+
+  /// Number of queued updates that have not been applied yet
+  size_t pendingUpdates() const;
+
+  /**
+   * The underlying ISAM2. Only safe to use while no updates are pending, e.g.
+   * right after waitForUpdates() and before the next update().
+   */
+  const ISAM2& isam() const { return isam_; }
+
+  /// @}
+  /// @name Lock-free access to the last completed update
+  /// @{
+
+  /// Copy of the whole snapshot
+  Snapshot snapshot() const {
+    return read([](const Snapshot& s) { return s; });
+  }
+
+  /// Number of update() calls applied in the snapshot
+  size_t updateCount() const {
+    return read([](const Snapshot& s) { return s.updateCount; });
+  }
+
+  /// Estimate of all variables after the last completed update
+  Values calculateEstimate() const {
+    return read([](const Snapshot& s) { return s.estimate; });
+  }
+
+  /// Estimate of a single variable after the last completed update
+  template <class VALUE>
+  VALUE calculateEstimate(Key key) const {
+    return read([key](const Snapshot& s) { return s.estimate.at<VALUE>(key); });
+  }
+
+  /// Marginal covariance of a key given to setMarginalKeys(), throws
+  /// std::out_of_range if it was not computed in the last completed update
+  Matrix marginalCovariance(Key key) const {
+    return read(
+        [key](const Snapshot& s) { return s.marginalCovariances.at(key); });
+  }
+
+  /// @}
+
+ protected:
+  /// Write a snapshot into the back buffer, and swap the buffers
+  void publish(Snapshot&& snapshot);
+
+  /// Main loop of the worker thread
+  void run();
+};
+
+}  // namespace gtsam
@@ -0,0 +1,222 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file CompiledExpression.h
+ * @brief Expressions prepared once for repeated, allocation-free evaluation
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/Expression.h>
+#include <gtsam/base/VerticalBlockMatrix.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * An Expression prepared for repeated evaluation of its value and Jacobians.
+ *
+ * Expression::value with Jacobians collects the keys and dimensions of the
+ * expression in a std::map, and allocates a Jacobian matrix and the trace
+ * storage, on every call. A CompiledExpression does all of that once: it stores
+ * the sorted keys, their dimensions, the column offset of each Jacobian block
+ * and the trace size, and it owns the trace storage that every evaluation
+ * reuses. Evaluations then write the Jacobians straight into a caller-provided
+ * VerticalBlockMatrix, and allocate nothing after the first one. Evaluations
+ * into a std::vector<Matrix> go through an internal VerticalBlockMatrix, and
+ * only allocate when the matrices in the vector do not have the right size
+ * yet, so reuse the same vector.
+ *
+ * Because it reuses its own storage, a CompiledExpression must not be
+ * evaluated concurrently from several threads: give each thread a copy.
+ * @ingroup nonlinear
+ */
+template <typename T>
+class CompiledExpression {
+ public:
+  static const int Dim = traits<T>::dimension;
+  static_assert(Dim != Eigen::Dynamic,
+                "CompiledExpression needs a value type of fixed dimension");
+
+  /// Prepare the given expression for evaluation
+  explicit CompiledExpression(const Expression<T>& expression)
+      : expression_(expression), traceSize_(expression.traceSize()) {
+    std::map<Key, int> map;
+    expression.dims(map);
+    keys_.reserve(map.size());
+    dims_.reserve(map.size());
+    offsets_.reserve(map.size() + 1);
+    offsets_.push_back(0);
+    for (const auto& [key, dim] : map) {
+      keys_.push_back(key);
+      dims_.push_back(dim);
+      offsets_.push_back(offsets_.back() + dim);
+    }
+  }
+
+  /// The expression that was compiled
+  const Expression<T>& expression() const { return expression_; }
+
+  /// Sorted keys, the order of the Jacobian blocks
+  const KeyVector& keys() const { return keys_; }
+
+  /// Dimension of each key
+  const FastVector<int>& dims() const { return dims_; }
+
+  /// Column of the Jacobian block of the i-th key
+  DenseIndex offset(size_t i) const { return offsets_[i]; }
+
+  /// Total number of Jacobian columns
+  DenseIndex cols() const { return offsets_.back(); }
+
+  /// Size of the execution trace
+  size_t traceSize() const { return traceSize_; }
+
+  /**
+   * True if another expression can be evaluated with this one's storage, i.e.,
+   * it has the same trace size and the same dimensions in key order.
+   */
+  bool sameShape(const CompiledExpression& other) const {
+    return traceSize_ == other.traceSize_ && dims_ == other.dims_;
+  }
+
+  /// Return the value only
+  T value(const Values& values) const { return expression_.root()->value(values); }
+
+  /**
+   * Return the value and add the Jacobians into the rows of Ab between
+   * Ab.rowStart() and Ab.rowEnd(), which must be Dim rows. The first
+   * keys().size() blocks of Ab correspond to keys(); Ab should be zero there.
+   */
+  T valueAndJacobians(const Values& values, VerticalBlockMatrix& Ab) const {
+    // The storage is only allocated on first use
+    if (trace_.empty())
+      trace_.resize(traceSize_ / internal::TraceAlignment + 1);
+    internal::ExecutionTrace<T> trace;
+    const T value = expression_.root()->traceExecution(
+        values, trace, reinterpret_cast<char*>(trace_.data()));
+    internal::JacobianMap jacobians(keys_, Ab);
+    trace.startReverseAD1(jacobians);
+    return value;
+  }
+
+  /**
+   * Return the value and the Jacobians, blocks in the order of keys(). The
+   * matrices already in H are overwritten, so they are only allocated by the
+   * first call with a given vector.
+   */
+  T valueAndJacobians(const Values& values, std::vector<Matrix>& H) const {
+    if (Ab_.rows() == 0) Ab_ = VerticalBlockMatrix(dims_, Dim);
+    Ab_.matrix().setZero();
+    const T value = valueAndJacobians(values, Ab_);
+    H.resize(keys_.size());
+    for (size_t i = 0; i < keys_.size(); ++i) H[i] = Ab_(i);
+    return value;
+  }
+
+ private:
+  Expression<T> expression_;
+  KeyVector keys_;
+  FastVector<int> dims_;
+  FastVector<DenseIndex> offsets_;
+  size_t traceSize_;
+  mutable std::vector<internal::ExecutionTraceStorage> trace_;
+  mutable VerticalBlockMatrix Ab_;  // Jacobians for the std::vector overload
+};
+
+/**
+ * A batch of expressions of the same shape, e.g., the measurement functions of
+ * many ExpressionFactors of one kind, evaluated together.
+ *
+ * All values are returned in one vector, and all Jacobians in one stacked
+ * matrix of Dim rows per expression, whose column blocks are the dims() of the
+ * shape. The keys of those blocks differ per expression, see keys(i). As keys
+ * are sorted, expressions of one kind have the same shape when their keys sort
+ * the same way, e.g., Symbol keys X(i), L(j) and K(k) for any i, j and k. The
+ * batch shares one trace storage, one Jacobian matrix, and the keys and dims
+ * prepared at construction, so evaluation allocates nothing.
+ *
+ * Like CompiledExpression, a batch must not be evaluated concurrently.
+ * @ingroup nonlinear
+ */
+template <typename T>
+class CompiledExpressionBatch {
+ public:
+  static const int Dim = traits<T>::dimension;
+
+  /// Prepare a batch, throws std::invalid_argument if the shapes differ
+  explicit CompiledExpressionBatch(const std::vector<Expression<T>>& expressions) {
+    if (expressions.empty())
+      throw std::invalid_argument("CompiledExpressionBatch: empty batch");
+    compiled_.reserve(expressions.size());
+    for (const Expression<T>& expression : expressions) {
+      compiled_.emplace_back(expression);
+      if (!compiled_.front().sameShape(compiled_.back()))
+        throw std::invalid_argument(
+            "CompiledExpressionBatch: expressions differ in shape");
+    }
+    // All expressions are evaluated in the same trace storage
+    trace_.resize(compiled_.front().traceSize() / internal::TraceAlignment + 1);
+    Ab_ = VerticalBlockMatrix(compiled_.front().dims(), Dim * size());
+    values_.reserve(size());
+  }
+
+  /// Number of expressions in the batch
+  size_t size() const { return compiled_.size(); }
+
+  /// Dimensions of the Jacobian blocks, the same for all expressions
+  const FastVector<int>& dims() const { return compiled_.front().dims(); }
+
+  /// Keys of the Jacobian blocks of the i-th expression
+  const KeyVector& keys(size_t i) const { return compiled_[i].keys(); }
+
+  /**
+   * Evaluate all expressions. Returns the values, and leaves the Jacobians
+   * in jacobians(), where rows i*Dim to (i+1)*Dim are those of expression i.
+   */
+  const std::vector<T>& evaluate(const Values& values) {
+    values_.clear();
+    Ab_.matrix().setZero();
+    char* storage = reinterpret_cast<char*>(trace_.data());
+    for (size_t i = 0; i < size(); ++i) {
+      internal::ExecutionTrace<T> trace;
+      values_.push_back(compiled_[i].expression().root()->traceExecution(
+          values, trace, storage));
+      Ab_.rowStart() = i * Dim;
+      Ab_.rowEnd() = (i + 1) * Dim;
+      internal::JacobianMap jacobians(compiled_[i].keys(), Ab_);
+      trace.startReverseAD1(jacobians);
+    }
+    Ab_.rowStart() = 0;
+    Ab_.rowEnd() = Dim * size();
+    return values_;
+  }
+
+  /// The stacked Jacobians computed by the last call to evaluate
+  const Matrix& jacobians() const { return Ab_.matrix(); }
+
+  /// The Jacobian block of expression i with respect to its j-th key
+  Eigen::Block<const Matrix> jacobian(size_t i, size_t j) const {
+    return jacobians().block(i * Dim, compiled_.front().offset(j), Dim,
+                             dims()[j]);
+  }
+
+ private:
+  std::vector<CompiledExpression<T>> compiled_;
+  std::vector<internal::ExecutionTraceStorage> trace_;
+  VerticalBlockMatrix Ab_;
+  std::vector<T> values_;
+};
+
+}  // namespace gtsam
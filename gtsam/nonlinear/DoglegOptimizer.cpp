@@ -93,7 +93,7 @@ GaussianFactorGraph::shared_ptr DoglegOptimizer::iterate(void) {
   DoglegOptimizerImpl::IterationResult result;
 
   if ( params_.isMultifrontal() ) {
-    GaussianBayesTree bt = *linear->eliminateMultifrontal(*params_.ordering, params_.getEliminationFunction());
+    GaussianBayesTree bt = *eliminateMultifrontal(*linear, params_);
     VectorValues dx_u = bt.optimizeGradientSearch();
     VectorValues dx_n = bt.optimize();
     result = DoglegOptimizerImpl::Iterate(getDelta(), DoglegOptimizerImpl::ONE_STEP_PER_ITERATION,
@@ -106,6 +106,13 @@ GaussianFactorGraph::shared_ptr DoglegOptimizer::iterate(void) {
     result = DoglegOptimizerImpl::Iterate(getDelta(), DoglegOptimizerImpl::ONE_STEP_PER_ITERATION,
       dx_u, dx_n, bn, graph_, state_->values, state_->error, dlVerbose);
   }
+  else if ( params_.isCholmod() ) {
+    // The linear graph stands in for the Bayes net as the quadratic model
+    VectorValues dx_u = linear->optimizeGradientSearch();
+    VectorValues dx_n = solve(*linear, params_);
+    result = DoglegOptimizerImpl::Iterate(getDelta(), DoglegOptimizerImpl::ONE_STEP_PER_ITERATION,
+      dx_u, dx_n, *linear, graph_, state_->values, state_->error, dlVerbose);
+  }
   else if ( params_.isIterative() ) {
     throw std::runtime_error("Dogleg is not currently compatible with the linear conjugate gradient solver");
   }
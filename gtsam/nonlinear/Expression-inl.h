@@ -200,19 +200,53 @@ inline std::unique_ptr<internal::ExecutionTraceStorage[]> allocAligned(size_t si
       new internal::ExecutionTraceStorage[alignedSize]);
 }
 
+namespace internal {
+/**
+ * Trace storage that is reused by all evaluations on one thread, instead of
+ * being allocated for every call. Nested evaluations, e.g., of an expression
+ * inside the function of another, each take their own buffer from the pool.
+ */
+class ReusedTraceStorage {
+  typedef std::vector<ExecutionTraceStorage> Buffer;
+  Buffer buffer_;
+
+  static std::vector<Buffer>& Pool() {
+    static thread_local std::vector<Buffer> pool;
+    return pool;
+  }
+
+ public:
+  explicit ReusedTraceStorage(size_t size) {
+    std::vector<Buffer>& pool = Pool();
+    if (!pool.empty()) {
+      buffer_.swap(pool.back());
+      pool.pop_back();
+    }
+    const size_t alignedSize = (size + TraceAlignment - 1) / TraceAlignment;
+    if (buffer_.size() < alignedSize) buffer_.resize(alignedSize);
+  }
+
+  ~ReusedTraceStorage() { Pool().push_back(std::move(buffer_)); }
+
+  ReusedTraceStorage(const ReusedTraceStorage&) = delete;
+  ReusedTraceStorage& operator=(const ReusedTraceStorage&) = delete;
+
+  char* get() { return reinterpret_cast<char*>(buffer_.data()); }
+};
+}  // namespace internal
+
 template<typename T>
 T Expression<T>::valueAndJacobianMap(const Values& values,
     internal::JacobianMap& jacobians) const {
   try {
-    // We allocate a single block of aligned memory using a unique_ptr.
-    const size_t size = traceSize();
-    auto traceStorage = allocAligned(size);
+    // We use a single block of aligned memory, reused across calls.
+    internal::ReusedTraceStorage traceStorage(traceSize());
 
     // The traceExecution call then fills this memory
     // with an execution trace, made up entirely of "Record" structs, see
     // the FunctionalNode class in expression-inl.h
     internal::ExecutionTrace<T> trace;
-    T value(this->traceExecution(values, trace, reinterpret_cast<char *>(traceStorage.get())));
+    T value(this->traceExecution(values, trace, traceStorage.get()));
 
     // We then calculate the Jacobians using reverse automatic differentiation (AD).
     trace.startReverseAD1(jacobians);
@@ -221,7 +255,7 @@ T Expression<T>::valueAndJacobianMap(const Values& values,
     std::cerr << "valueAndJacobianMap exception: " << e.what() << '\n';
     throw e;
   }
-  // Here traceStorage will be de-allocated properly.
+  // Here traceStorage will be returned to the pool.
 }
 
 template<typename T>
@@ -127,8 +127,8 @@ protected:
     }
 
     // Create a writeable JacobianFactor in advance
-    std::shared_ptr<JacobianFactor> factor(
-        new JacobianFactor(keys_, dims_, Dim, noiseModel));
+    auto factor = allocateShared<JacobianFactor>(
+        keys_, dims_, static_cast<DenseIndex>(Dim), noiseModel);
 
     // Wrap keys and VerticalBlockMatrix into structure passed to expression_
     VerticalBlockMatrix& Ab = factor->matrixObject();
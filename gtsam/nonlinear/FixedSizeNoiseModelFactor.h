@@ -0,0 +1,200 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    FixedSizeNoiseModelFactor.h
+ * @brief   NoiseModelFactorN with Jacobians of compile-time size
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/NonlinearFactor.h>
+
+#include <array>
+#include <tuple>
+
+namespace gtsam {
+
+/**
+ * A NoiseModelFactorN whose error dimension ZDim is known at compile time, as
+ * are the dimensions of all ValueTypes. Instead of evaluateError, derived
+ * classes implement evaluateErrorFixed, which returns a fixed-size error and
+ * fills fixed-size OptionalJacobians:
+ * ```
+ * Vector6 evaluateErrorFixed(const Pose3& x1, const Pose3& x2,
+ *                            OptionalJacobian<6, 6> H1,
+ *                            OptionalJacobian<6, 6> H2) const override;
+ * ```
+ *
+ * linearize then keeps the Jacobians on the stack, writes them straight into
+ * the JacobianFactor it returns and whitens them there, so the only heap
+ * allocation is the factor itself. Robust and constrained noise models are
+ * supported as in NoiseModelFactor::linearize. evaluateError is implemented in
+ * terms of evaluateErrorFixed, so the factor can be used like any other
+ * NoiseModelFactorN.
+ *
+ * If ZDim or one of the value dimensions is Eigen::Dynamic, the Jacobians are
+ * OptionalJacobian<Eigen::Dynamic, Eigen::Dynamic> and linearize is the one of
+ * NoiseModelFactor, which lets templates such as BetweenFactor use this class
+ * for all value types.
+ * @ingroup nonlinear
+ */
+template <int ZDim, class... ValueTypes>
+class FixedSizeNoiseModelFactorN : public NoiseModelFactorN<ValueTypes...> {
+ public:
+  /// True if all dimensions are known at compile time
+  static constexpr bool IsFixedSize =
+      ZDim != Eigen::Dynamic &&
+      (... && (traits<ValueTypes>::dimension != Eigen::Dynamic));
+
+  /// The error vector
+  using ErrorVector = Eigen::Matrix<double, ZDim, 1>;
+
+  /// The Jacobian of the error with respect to a variable of type T
+  template <class T>
+  using JacobianType =
+      typename std::conditional<IsFixedSize,
+                                OptionalJacobian<ZDim, traits<T>::dimension>,
+                                OptionalJacobian<Eigen::Dynamic,
+                                                 Eigen::Dynamic>>::type;
+
+ protected:
+  using Base = NoiseModelFactorN<ValueTypes...>;
+  using This = FixedSizeNoiseModelFactorN<ZDim, ValueTypes...>;
+
+ public:
+  // Provide access to the Matrix& version of evaluateError:
+  using Base::evaluateError;
+
+  /// @name Constructors
+  /// @{
+
+  /// Default Constructor for I/O
+  FixedSizeNoiseModelFactorN() {}
+
+  /// Constructor from keys given as separate arguments, see NoiseModelFactorN
+  FixedSizeNoiseModelFactorN(
+      const SharedNoiseModel& noiseModel,
+      typename Base::template KeyType<ValueTypes>... keys)
+      : Base(noiseModel, keys...) {}
+
+  /// Constructor from a container of keys, see NoiseModelFactorN
+  template <typename CONTAINER = std::initializer_list<Key>,
+            typename = typename Base::template IsContainerOfKeys<CONTAINER>>
+  FixedSizeNoiseModelFactorN(const SharedNoiseModel& noiseModel,
+                             CONTAINER keys)
+      : Base(noiseModel, keys) {}
+
+  /// @}
+
+  ~FixedSizeNoiseModelFactorN() override {}
+
+  /// @name Virtual methods
+  /// @{
+
+  /**
+   * Override `evaluateErrorFixed` to finish implementing the factor. If any
+   * of the Jacobians is given, it should be computed along with the error.
+   * @param x The values of the variables to evaluate the error for.
+   * @param[out] H The Jacobian with respect to each variable (optional).
+   */
+  virtual ErrorVector evaluateErrorFixed(
+      const ValueTypes&... x, JacobianType<ValueTypes>... H) const = 0;
+
+  /// Implements evaluateError by calling evaluateErrorFixed
+  Vector evaluateError(const ValueTypes&... x,
+                       typename Base::template OptionalMatrixTypeT<ValueTypes>...
+                           H) const override {
+    return evaluateErrorFixed(x..., JacobianType<ValueTypes>(H)...);
+  }
+
+  /// @}
+  /// @name NoiseModelFactor methods
+  /// @{
+
+  /// Linearize to a JacobianFactor, without temporary Jacobians on the heap
+  std::shared_ptr<GaussianFactor> linearize(const Values& x) const override {
+    return linearizeFixed(std::integral_constant<bool, IsFixedSize>(),
+                          gtsam::index_sequence_for<ValueTypes...>{}, x);
+  }
+
+  /// @}
+
+ private:
+  /// Some dimension is dynamic: linearize as NoiseModelFactor does
+  template <std::size_t... Indices>
+  std::shared_ptr<GaussianFactor> linearizeFixed(
+      std::false_type, gtsam::index_sequence<Indices...>,
+      const Values& x) const {
+    return NoiseModelFactor::linearize(x);
+  }
+
+  /// All dimensions are fixed: evaluate into stack storage
+  template <std::size_t... Indices>
+  std::shared_ptr<GaussianFactor> linearizeFixed(
+      std::true_type, gtsam::index_sequence<Indices...>,
+      const Values& x) const {
+    // Only linearize if the factor is active
+    if (!this->active(x)) return std::shared_ptr<JacobianFactor>();
+
+    const SharedNoiseModel& model = this->noiseModel_;
+    if (model && model->dim() != ZDim)
+      throw std::invalid_argument(
+          "NoiseModelFactor: NoiseModel has dimension " +
+          std::to_string(model->dim()) + " instead of " +
+          std::to_string(ZDim) + ".");
+
+    // Error and Jacobians, with all sizes known at compile time
+    std::tuple<Eigen::Matrix<double, ZDim, traits<ValueTypes>::dimension>...> H;
+    const ErrorVector error = evaluateErrorFixed(
+        x.at<ValueTypes>(this->keys_[Indices])...,
+        JacobianType<ValueTypes>(&std::get<Indices>(H))...);
+
+    // In case noise model is constrained, we need to provide a noise model
+    SharedDiagonal constrainedModel;
+    if (model && model->isConstrained())
+      constrainedModel =
+          std::static_pointer_cast<noiseModel::Constrained>(model)->unit();
+
+    // Create the JacobianFactor and copy the system into it
+    static constexpr std::array<int, sizeof...(ValueTypes)> dims{
+        traits<ValueTypes>::dimension...};
+    auto factor = allocateShared<JacobianFactor>(this->keys_, dims, ZDim,
+                                                 constrainedModel);
+    VerticalBlockMatrix& Ab = factor->matrixObject();
+    (void)std::initializer_list<int>{(Ab(Indices) = std::get<Indices>(H), 0)...};
+    Ab(sizeof...(ValueTypes)).col(0) = -error;
+
+    // Whiten the system in place, Ab already contains RHS
+    if (model) {
+      const auto gaussian = dynamic_cast<const noiseModel::Gaussian*>(model.get());
+      if (gaussian && !gaussian->isConstrained()) {
+        gaussian->WhitenInPlace(Ab.matrix());
+      } else {
+        Vector b = Ab(sizeof...(ValueTypes)).col(0);  // Robust models need b
+        model->WhitenSystem(Ab.matrix(), b);
+      }
+    }
+    return std::move(factor);
+  }
+
+#ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
+  /** Serialization function */
+  friend class boost::serialization::access;
+  template <class ARCHIVE>
+  void serialize(ARCHIVE& ar, const unsigned int /*version*/) {
+    ar& boost::serialization::make_nvp(
+        "NoiseModelFactorN", boost::serialization::base_object<Base>(*this));
+  }
+#endif
+};  // \class FixedSizeNoiseModelFactorN
+
+}  // namespace gtsam
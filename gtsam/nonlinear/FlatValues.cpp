@@ -0,0 +1,213 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file FlatValues.cpp
+ * @brief A Values-like container that stores same-type variables contiguously
+ */
+
+#include <gtsam/nonlinear/FlatValues.h>
+
+#include <iostream>
+
+using namespace std;
+
+namespace gtsam {
+
+namespace internal {
+
+/* ************************************************************************* */
+std::unique_ptr<FlatValuesBlock> GenericFlatValuesBlock::clone() const {
+  return std::make_unique<GenericFlatValuesBlock>(*this);
+}
+
+/* ************************************************************************* */
+void GenericFlatValuesBlock::retract(const VectorValues& delta) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto it = delta.find(keys[i]);
+    if (it != delta.end()) {
+      Value* retracted = values[i]->retract_(it->second);
+      *values[i] = *retracted;
+      retracted->deallocate_();
+    }
+  }
+}
+
+/* ************************************************************************* */
+Vector GenericFlatValuesBlock::localCoordinates(size_t i,
+                                                const FlatValuesBlock& other,
+                                                size_t j) const {
+  const auto& generic = static_cast<const GenericFlatValuesBlock&>(other);
+  return values[i]->localCoordinates_(*generic.values[j]);
+}
+
+/* ************************************************************************* */
+bool GenericFlatValuesBlock::equals(size_t i, const FlatValuesBlock& other,
+                                    size_t j, double tol) const {
+  const auto& generic = static_cast<const GenericFlatValuesBlock&>(other);
+  const Value& value1 = *values[i];
+  const Value& value2 = *generic.values[j];
+  return typeid(value1) == typeid(value2) && value1.equals_(value2, tol);
+}
+
+/* ************************************************************************* */
+void GenericFlatValuesBlock::print(size_t i) const { values[i]->print(""); }
+
+/* ************************************************************************* */
+void GenericFlatValuesBlock::bind(const Values& view) {
+  for (size_t i = 0; i < keys.size(); ++i) values[i] = &ViewAt(view, keys[i]);
+}
+
+/* ************************************************************************* */
+void GenericFlatValuesBlock::updateInto(Values& result) const {
+  for (size_t i = 0; i < keys.size(); ++i) result.update(keys[i], *values[i]);
+}
+
+}  // namespace internal
+
+/* ************************************************************************* */
+FlatValues::FlatValues(const FlatValues& other)
+    : keys_(other.keys_), slots_(other.slots_), values_(other.values_) {
+  blocks_.reserve(other.blocks_.size());
+  for (const auto& block : other.blocks_) {
+    blocks_.push_back(block->clone());
+    blocks_.back()->bind(values_);
+  }
+}
+
+/* ************************************************************************* */
+FlatValues& FlatValues::operator=(const FlatValues& other) {
+  if (this != &other) {
+    FlatValues copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+/* ************************************************************************* */
+FlatValues& FlatValues::operator=(FlatValues&& other) {
+  // Values has no move assignment, and swapping keeps the variables in place
+  blocks_ = std::move(other.blocks_);
+  keys_ = std::move(other.keys_);
+  slots_ = std::move(other.slots_);
+  values_.swap(other.values_);
+  return *this;
+}
+
+/* ************************************************************************* */
+size_t FlatValues::genericBlock() {
+  for (size_t b = 0; b < blocks_.size(); ++b)
+    if (blocks_[b]->type() == typeid(Value)) return b;
+  blocks_.push_back(std::make_unique<internal::GenericFlatValuesBlock>());
+  return blocks_.size() - 1;
+}
+
+/* ************************************************************************* */
+void FlatValues::addKey(Key j, const Slot& slot) {
+  // Appending in key order, as when converting from a Values, is O(1)
+  if (keys_.empty() || keys_.back() < j) {
+    keys_.push_back(j);
+    slots_.push_back(slot);
+    return;
+  }
+  const auto it = std::lower_bound(keys_.begin(), keys_.end(), j);
+  const size_t position = it - keys_.begin();
+  keys_.insert(it, j);
+  slots_.insert(slots_.begin() + position, slot);
+}
+
+/* ************************************************************************* */
+void FlatValues::print(const string& str,
+                       const KeyFormatter& keyFormatter) const {
+  cout << str << (str.empty() ? "" : "\n");
+  cout << "FlatValues with " << size() << " values in " << nrBlocks()
+       << " blocks:\n";
+  for (size_t k = 0; k < keys_.size(); ++k) {
+    cout << "Value " << keyFormatter(keys_[k]) << ": ";
+    blocks_[slots_[k].block]->print(slots_[k].index);
+    cout << "\n";
+  }
+}
+
+/* ************************************************************************* */
+bool FlatValues::equals(const FlatValues& other, double tol) const {
+  if (keys_ != other.keys_) return false;
+  for (size_t k = 0; k < keys_.size(); ++k) {
+    const auto& block1 = *blocks_[slots_[k].block];
+    const auto& block2 = *other.blocks_[other.slots_[k].block];
+    if (block1.type() != block2.type() ||
+        !block1.equals(slots_[k].index, block2, other.slots_[k].index, tol))
+      return false;
+  }
+  return true;
+}
+
+/* ************************************************************************* */
+bool FlatValues::exists(Key j) const {
+  return std::binary_search(keys_.begin(), keys_.end(), j);
+}
+
+/* ************************************************************************* */
+const FlatValues::Slot& FlatValues::slot(Key j) const {
+  const auto it = std::lower_bound(keys_.begin(), keys_.end(), j);
+  if (it == keys_.end() || *it != j) throw ValuesKeyDoesNotExist("at", j);
+  return slots_[it - keys_.begin()];
+}
+
+/* ************************************************************************* */
+size_t FlatValues::dim() const {
+  size_t result = 0;
+  for (const auto& block : blocks_)
+    for (size_t i = 0; i < block->size(); ++i) result += block->dim(i);
+  return result;
+}
+
+/* ************************************************************************* */
+VectorValues FlatValues::zeroVectors() const {
+  VectorValues result;
+  for (size_t k = 0; k < keys_.size(); ++k)
+    result.insert(keys_[k],
+                  Vector::Zero(blocks_[slots_[k].block]->dim(slots_[k].index)));
+  return result;
+}
+
+/* ************************************************************************* */
+void FlatValues::update(Values& result) const {
+  for (const auto& block : blocks_) block->updateInto(result);
+}
+
+/* ************************************************************************* */
+void FlatValues::retractInPlace(const VectorValues& delta) {
+  for (auto& block : blocks_) block->retract(delta);
+}
+
+/* ************************************************************************* */
+FlatValues FlatValues::retract(const VectorValues& delta) const {
+  FlatValues result(*this);
+  result.retractInPlace(delta);
+  return result;
+}
+
+/* ************************************************************************* */
+VectorValues FlatValues::localCoordinates(const FlatValues& cp) const {
+  if (keys_ != cp.keys_) throw DynamicValuesMismatched();
+  VectorValues result;
+  for (size_t k = 0; k < keys_.size(); ++k) {
+    const auto& block1 = *blocks_[slots_[k].block];
+    const auto& block2 = *cp.blocks_[cp.slots_[k].block];
+    if (block1.type() != block2.type()) throw DynamicValuesMismatched();
+    result.insert(keys_[k], block1.localCoordinates(slots_[k].index, block2,
+                                                    cp.slots_[k].index));
+  }
+  return result;
+}
+
+}  // namespace gtsam
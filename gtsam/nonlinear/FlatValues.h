@@ -0,0 +1,398 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file FlatValues.h
+ * @brief A Values-like container that stores same-type variables contiguously
+ *
+ *  Detailed story:
+ *  Values stores every variable as a heap-allocated GenericValue in a
+ *  std::map, so every retract, localCoordinates and at<T> pointer-chases
+ *  through a red-black tree and a virtual Value wrapper.  FlatValues keeps all
+ *  variables of the same type in one typed std::vector, and indexes them with a
+ *  sorted key -> slot table.  Retracting by a VectorValues is done in place,
+ *  without allocating any per-variable objects.  Factors read their variables
+ *  from a Values, so FlatValues also keeps one with the same variables, and
+ *  writes every retracted variable through to it.
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/linear/VectorValues.h>
+
+#include <algorithm>
+#include <memory>
+#include <typeinfo>
+#include <vector>
+
+namespace gtsam {
+
+namespace internal {
+
+/// Mutable access to a variable of a Values that is owned by a FlatValues
+inline Value& ViewAt(const Values& view, Key j) {
+  return const_cast<Value&>(view.at(j));
+}
+
+/**
+ * Type-erased interface for one contiguous block of FlatValues. Each block
+ * stores the keys of its variables and their values in insertion order.
+ */
+class GTSAM_EXPORT FlatValuesBlock {
+ public:
+  virtual ~FlatValuesBlock() = default;
+
+  /// Deep copy of this block
+  virtual std::unique_ptr<FlatValuesBlock> clone() const = 0;
+
+  /// The type_info of the stored variables (Value if heterogeneous)
+  virtual const std::type_info& type() const = 0;
+
+  /// Number of variables in the block
+  size_t size() const { return keys.size(); }
+
+  /// Tangent-space dimension of variable i
+  virtual size_t dim(size_t i) const = 0;
+
+  /// Retract all variables with an entry in delta, in place
+  virtual void retract(const VectorValues& delta) = 0;
+
+  /// Local coordinates of variable j in other, w.r.t. variable i in this
+  virtual Vector localCoordinates(size_t i, const FlatValuesBlock& other,
+                                  size_t j) const = 0;
+
+  /// Equality of variable i in this and variable j in other
+  virtual bool equals(size_t i, const FlatValuesBlock& other, size_t j,
+                      double tol) const = 0;
+
+  /// Print variable i
+  virtual void print(size_t i) const = 0;
+
+  /// Point the block at the variables of the given Values, with the same keys
+  virtual void bind(const Values& view) = 0;
+
+  /// Assign all variables of the block to existing entries of a Values
+  virtual void updateInto(Values& values) const = 0;
+
+  std::vector<Key> keys;  ///< Keys of the variables, parallel to the values
+};
+
+/// Block for a known type T, stored contiguously in a std::vector<T>.
+template <class T>
+class TypedFlatValuesBlock : public FlatValuesBlock {
+ public:
+  std::vector<T> values;  ///< Values of the variables, parallel to keys
+  std::vector<GenericValue<T>*> view;  ///< The same variables in a Values
+
+  std::unique_ptr<FlatValuesBlock> clone() const override {
+    return std::make_unique<TypedFlatValuesBlock<T>>(*this);
+  }
+
+  const std::type_info& type() const override { return typeid(T); }
+
+  size_t dim(size_t i) const override {
+    return traits<T>::GetDimension(values[i]);
+  }
+
+  void retract(const VectorValues& delta) override {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      auto it = delta.find(keys[i]);
+      if (it != delta.end()) {
+        values[i] = traits<T>::Retract(values[i], it->second);
+        view[i]->value() = values[i];
+      }
+    }
+  }
+
+  Vector localCoordinates(size_t i, const FlatValuesBlock& other,
+                          size_t j) const override {
+    const auto& typed = static_cast<const TypedFlatValuesBlock<T>&>(other);
+    return traits<T>::Local(values[i], typed.values[j]);
+  }
+
+  bool equals(size_t i, const FlatValuesBlock& other, size_t j,
+              double tol) const override {
+    const auto& typed = static_cast<const TypedFlatValuesBlock<T>&>(other);
+    return traits<T>::Equals(values[i], typed.values[j], tol);
+  }
+
+  void print(size_t i) const override { traits<T>::Print(values[i]); }
+
+  void bind(const Values& v) override {
+    for (size_t i = 0; i < keys.size(); ++i)
+      view[i] = static_cast<GenericValue<T>*>(&ViewAt(v, keys[i]));
+  }
+
+  void updateInto(Values& result) const override {
+    for (size_t i = 0; i < keys.size(); ++i)
+      result.update(keys[i], values[i]);
+  }
+};
+
+/// Fallback block for types that were not registered, pointing into the Values.
+class GTSAM_EXPORT GenericFlatValuesBlock : public FlatValuesBlock {
+ public:
+  std::vector<Value*> values;  ///< Variables of the Values, parallel to keys
+
+  std::unique_ptr<FlatValuesBlock> clone() const override;
+  const std::type_info& type() const override { return typeid(Value); }
+  size_t dim(size_t i) const override { return values[i]->dim(); }
+  void retract(const VectorValues& delta) override;
+  Vector localCoordinates(size_t i, const FlatValuesBlock& other,
+                          size_t j) const override;
+  bool equals(size_t i, const FlatValuesBlock& other, size_t j,
+              double tol) const override;
+  void print(size_t i) const override;
+  void bind(const Values& view) override;
+  void updateInto(Values& result) const override;
+};
+
+}  // namespace internal
+
+/**
+ * A Values-like container that keeps all variables of the same type in one
+ * contiguous, typed array, with a sorted key -> slot index. Supports the
+ * manifold operations used by the optimizers (retract, localCoordinates, dim).
+ *
+ * Factors read their variables from a Values, so a FlatValues also owns a
+ * Values with the same variables, returned by values(). retractInPlace writes
+ * each retracted variable to it in place, so the factor graph can be
+ * evaluated and linearized between retractions without allocating anything:
+ * \code
+ * auto flat = FlatValues::FromValues<Pose3, Point3>(initial);
+ * for (...) {
+ *   auto linear = graph.linearize(flat);
+ *   flat.retractInPlace(linear->optimize());
+ * }
+ * const Values& result = flat.values();
+ * \endcode
+ * Variables whose type is not in the list are stored in a generic fallback
+ * block and behave exactly like they do in Values. Copying a FlatValues also
+ * copies its Values, so use retractInPlace rather than retract in loops.
+ */
+class GTSAM_EXPORT FlatValues {
+ public:
+  /// Location of a variable: index of its block and index within the block
+  struct Slot {
+    size_t block;
+    size_t index;
+  };
+
+ private:
+  std::vector<std::unique_ptr<internal::FlatValuesBlock>> blocks_;
+  KeyVector keys_;           ///< All keys, sorted
+  std::vector<Slot> slots_;  ///< Slot of each key, parallel to keys_
+  Values values_;            ///< The same variables, for the factors
+
+  /// Add j, which is already in values_, to the block for its type T
+  template <class T>
+  void add(Key j);
+
+  /// Block index for type T, creating the block if needed
+  template <class T>
+  size_t typedBlock();
+
+  /// Block index of the generic fallback block, creating it if needed
+  size_t genericBlock();
+
+  /// Register a key at the given slot, keeping keys_ sorted
+  void addKey(Key j, const Slot& slot);
+
+  /// Add j to the block for type T if values_ stores it as a T
+  template <class T>
+  bool tryAdd(Key j);
+
+ public:
+  /// A shared_ptr to this class
+  typedef std::shared_ptr<FlatValues> shared_ptr;
+
+  /// @name Constructors
+  /// @{
+
+  /// Default constructor creates an empty FlatValues
+  FlatValues() = default;
+
+  /// Copy constructor duplicates all blocks
+  FlatValues(const FlatValues& other);
+
+  /// Move constructor
+  FlatValues(FlatValues&& other) = default;
+
+  /// Copy assignment
+  FlatValues& operator=(const FlatValues& other);
+
+  /// Move assignment
+  FlatValues& operator=(FlatValues&& other);
+
+  /**
+   * Create from a Values, storing the variables of each of the listed
+   * ValueTypes in their own contiguous block. All other variables go into a
+   * generic block that holds clones of the original Value objects.
+   */
+  template <class... ValueTypes>
+  static FlatValues FromValues(const Values& values);
+
+  /// @}
+  /// @name Testable
+  /// @{
+
+  /// print method for testing and debugging
+  void print(const std::string& str = "",
+             const KeyFormatter& keyFormatter = DefaultKeyFormatter) const;
+
+  /// Test whether the sets of keys and values are identical
+  bool equals(const FlatValues& other, double tol = 1e-9) const;
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  /// Add a variable with the given key, throws ValuesKeyAlreadyExists
+  template <class ValueType>
+  void insert(Key j, const ValueType& val);
+
+  /**
+   * Retrieve a variable by key \c j. Throws ValuesKeyDoesNotExist if the key is
+   * not present, and ValuesIncorrectType if it is not stored as a ValueType.
+   */
+  template <class ValueType>
+  const ValueType& at(Key j) const;
+
+  /// Check if a value exists with key \c j
+  bool exists(Key j) const;
+
+  /// Return the slot of key \c j, throws ValuesKeyDoesNotExist
+  const Slot& slot(Key j) const;
+
+  /// The number of variables
+  size_t size() const { return keys_.size(); }
+
+  /// Whether there are no variables
+  bool empty() const { return keys_.empty(); }
+
+  /// The number of contiguous blocks
+  size_t nrBlocks() const { return blocks_.size(); }
+
+  /// Sorted vector of all keys
+  const KeyVector& keys() const { return keys_; }
+
+  /// Total dimensionality of all values
+  size_t dim() const;
+
+  /// Return a VectorValues of zero vectors for each variable
+  VectorValues zeroVectors() const;
+
+  /// The same variables as a Values, kept up to date by retractInPlace
+  const Values& values() const { return values_; }
+
+  /// Assign all variables to the existing entries of a Values
+  void update(Values& result) const;
+
+  /// @}
+  /// @name Manifold Operations
+  /// @{
+
+  /// Retract all variables with an entry in delta, in place
+  void retractInPlace(const VectorValues& delta);
+
+  /// Add a delta config to current config and return a new config
+  FlatValues retract(const VectorValues& delta) const;
+
+  /// Get a delta config about a linearization point c0 (*this)
+  VectorValues localCoordinates(const FlatValues& cp) const;
+
+  /// @}
+};
+
+/* ************************************************************************* */
+template <class T>
+size_t FlatValues::typedBlock() {
+  for (size_t b = 0; b < blocks_.size(); ++b)
+    if (blocks_[b]->type() == typeid(T)) return b;
+  blocks_.push_back(std::make_unique<internal::TypedFlatValuesBlock<T>>());
+  return blocks_.size() - 1;
+}
+
+/* ************************************************************************* */
+template <class T>
+void FlatValues::add(Key j) {
+  auto& value = static_cast<GenericValue<T>&>(internal::ViewAt(values_, j));
+  const size_t b = typedBlock<T>();
+  auto& block = static_cast<internal::TypedFlatValuesBlock<T>&>(*blocks_[b]);
+  block.keys.push_back(j);
+  block.values.push_back(value.value());
+  block.view.push_back(&value);
+  addKey(j, Slot{b, block.values.size() - 1});
+}
+
+/* ************************************************************************* */
+template <class ValueType>
+void FlatValues::insert(Key j, const ValueType& val) {
+  if (exists(j)) throw ValuesKeyAlreadyExists(j);
+  values_.insert(j, val);
+  add<ValueType>(j);
+}
+
+/* ************************************************************************* */
+template <class T>
+bool FlatValues::tryAdd(Key j) {
+  if (!dynamic_cast<const GenericValue<T>*>(&values_.at(j))) return false;
+  add<T>(j);
+  return true;
+}
+
+/* ************************************************************************* */
+template <class... ValueTypes>
+FlatValues FlatValues::FromValues(const Values& values) {
+  FlatValues result;
+  result.values_ = values;
+  result.keys_.reserve(values.size());
+  result.slots_.reserve(values.size());
+  for (Key j : values.keys()) {
+    const bool added = (false || ... || result.tryAdd<ValueTypes>(j));
+    if (!added) {
+      const size_t b = result.genericBlock();
+      auto& block =
+          static_cast<internal::GenericFlatValuesBlock&>(*result.blocks_[b]);
+      block.keys.push_back(j);
+      block.values.push_back(&internal::ViewAt(result.values_, j));
+      result.addKey(j, Slot{b, block.values.size() - 1});
+    }
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+template <class ValueType>
+const ValueType& FlatValues::at(Key j) const {
+  const Slot& s = slot(j);
+  const internal::FlatValuesBlock& block = *blocks_[s.block];
+  if (block.type() != typeid(ValueType)) {
+    if (block.type() == typeid(Value)) {
+      const auto& generic =
+          static_cast<const internal::GenericFlatValuesBlock&>(block);
+      const Value& value = *generic.values[s.index];
+      auto ptr = dynamic_cast<const GenericValue<ValueType>*>(&value);
+      if (ptr) return ptr->value();
+      throw ValuesIncorrectType(j, typeid(value), typeid(ValueType));
+    }
+    throw ValuesIncorrectType(j, block.type(), typeid(ValueType));
+  }
+  return static_cast<const internal::TypedFlatValuesBlock<ValueType>&>(block)
+      .values[s.index];
+}
+
+/// traits
+template <>
+struct traits<FlatValues> : public Testable<FlatValues> {};
+
+}  // namespace gtsam
@@ -60,7 +60,7 @@ size_t DeltaImpl::UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
     // Optimize with wildfire
     lastBacksubVariableCount = 0;
     for (const ISAM2::sharedClique& root : roots)
-      lastBacksubVariableCount += optimizeWildfireNonRecursive(
+      lastBacksubVariableCount += optimizeWildfireParallel(
           root, wildfireThreshold, replacedKeys, delta);  // modifies delta
 
 #if !defined(NDEBUG) && defined(GTSAM_EXTRA_CONSISTENCY_CHECKS)
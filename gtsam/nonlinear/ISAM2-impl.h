@@ -29,10 +29,12 @@
 #include <gtsam/linear/GaussianEliminationTree.h>
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace gtsam {
 
@@ -366,11 +368,46 @@ struct GTSAM_EXPORT UpdateImpl {
     return relinKeys;
   }
 
+  /**
+   * Keep the \c maxKeys keys in \c relinKeys whose deltas are largest relative
+   * to the relinearization threshold, and return the other keys.
+   */
+  static KeySet DeferRelinearizeKeys(
+      size_t maxKeys, const VectorValues& delta,
+      const ISAM2Params::RelinearizationThreshold& relinearizeThreshold,
+      KeySet* relinKeys) {
+    if (relinKeys->size() <= maxKeys) return KeySet();
+
+    std::vector<std::pair<double, Key>> scores;
+    scores.reserve(relinKeys->size());
+    for (Key key : *relinKeys) {
+      const Vector& d = delta.at(key);
+      double score = d.lpNorm<Eigen::Infinity>();
+      if (const FastMap<char, Vector>* thresholds =
+              std::get_if<FastMap<char, Vector> >(&relinearizeThreshold)) {
+        const Vector& threshold = thresholds->find(Symbol(key).chr())->second;
+        score = (d.array().abs() / threshold.array()).maxCoeff();
+      }
+      scores.emplace_back(score, key);
+    }
+    std::nth_element(scores.begin(), scores.begin() + maxKeys, scores.end(),
+                     std::greater<std::pair<double, Key> >());
+
+    KeySet deferred;
+    for (size_t i = maxKeys; i < scores.size(); ++i) {
+      relinKeys->erase(scores[i].second);
+      deferred.insert(scores[i].second);
+    }
+    return deferred;
+  }
+
   // Mark keys in \Delta above threshold \beta:
   KeySet gatherRelinearizeKeys(const ISAM2::Roots& roots,
                                const VectorValues& delta,
                                const KeySet& fixedVariables,
-                               KeySet* markedKeys) const {
+                               KeySet* markedKeys,
+                               std::optional<size_t> maxRelinearized = {},
+                               KeySet* deferredKeys = nullptr) const {
     gttic(gatherRelinearizeKeys);
     // J=\{\Delta_{j}\in\Delta|\Delta_{j}\geq\beta\}.
     KeySet relinKeys =
@@ -391,6 +428,13 @@ struct GTSAM_EXPORT UpdateImpl {
       }
     }
 
+    // Leave the variables with the smallest deltas for later updates
+    if (maxRelinearized) {
+      KeySet deferred = DeferRelinearizeKeys(
+          *maxRelinearized, delta, params_.relinearizeThreshold, &relinKeys);
+      if (deferredKeys) deferredKeys->insert(deferred.begin(), deferred.end());
+    }
+
     // Add the variables being relinearized to the marked keys
     markedKeys->insert(relinKeys.begin(), relinKeys.end());
     return relinKeys;
@@ -25,8 +25,16 @@
 #include <gtsam/inference/BayesTree-inst.h>
 #include <gtsam/nonlinear/LinearContainerFactor.h>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 #include <algorithm>
+#include <chrono>
+#include <limits>
 #include <map>
+#include <optional>
 #include <utility>
 #include <variant>
 
@@ -37,6 +45,66 @@ namespace gtsam {
 // Instantiate base class
 template class BayesTree<ISAM2Clique>;
 
+/* ************************************************************************* */
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Wall-clock seconds elapsed since start
+double secondsSince(const Clock::time_point& start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Update a moving average of the measured seconds per variable
+void updateSecondsPerVariable(double seconds, size_t count, double* average) {
+  if (count == 0) return;
+  const double sample = seconds / count;
+  *average = *average > 0.0 ? 0.8 * *average + 0.2 * sample : sample;
+}
+
+// Number of variables that can be processed in the given time, if known
+std::optional<size_t> variablesInTime(double seconds, double secondsPerVariable) {
+  if (secondsPerVariable <= 0.0) return {};
+  return static_cast<size_t>(std::max(0.0, seconds) / secondsPerVariable);
+}
+
+// The smaller of two optional limits
+std::optional<size_t> minLimit(std::optional<size_t> a, std::optional<size_t> b) {
+  if (a && b) return std::min(*a, *b);
+  return a ? a : b;
+}
+
+#ifdef GTSAM_USE_TBB
+// Linearizes the sendable factors of a list of (slot, factor index) pairs into
+// the given slots of the result
+class _RelinearizeFactors {
+  const NonlinearFactorGraph& nonlinearFactors_;
+  const Values& theta_;
+  const std::vector<std::pair<size_t, FactorIndex>>& toLinearize_;
+  GaussianFactorGraph& result_;
+
+ public:
+  _RelinearizeFactors(
+      const NonlinearFactorGraph& nonlinearFactors, const Values& theta,
+      const std::vector<std::pair<size_t, FactorIndex>>& toLinearize,
+      GaussianFactorGraph& result)
+      : nonlinearFactors_(nonlinearFactors),
+        theta_(theta),
+        toLinearize_(toLinearize),
+        result_(result) {}
+
+  void operator()(const tbb::blocked_range<size_t>& blocked_range) const {
+    for (size_t i = blocked_range.begin(); i != blocked_range.end(); ++i) {
+      const auto& [slot, idx] = toLinearize_[i];
+      if (nonlinearFactors_[idx]->sendable())
+        result_[slot] = nonlinearFactors_[idx]->linearize(theta_);
+    }
+  }
+};
+#endif
+
+}  // namespace
+
 /* ************************************************************************* */
 ISAM2::ISAM2(const ISAM2Params& params) : params_(params), update_count_(0) {
   if (std::holds_alternative<ISAM2DoglegParams>(params_.optimizationParams)) {
@@ -77,6 +145,8 @@ GaussianFactorGraph ISAM2::relinearizeAffectedFactors(
 
   gttic(check_candidates_and_linearize);
   GaussianFactorGraph linearized;
+  // Factors to relinearize, as (slot in linearized, factor index) pairs
+  std::vector<std::pair<size_t, FactorIndex>> toLinearize;
   for (const FactorIndex idx : candidates) {
     bool inside = true;
     bool useCachedLinear = params_.cacheLinearizedFactors;
@@ -96,15 +166,33 @@ GaussianFactorGraph ISAM2::relinearizeAffectedFactors(
 #endif
         linearized.push_back(linearFactors_[idx]);
       } else {
-        auto linearFactor = nonlinearFactors_[idx]->linearize(theta_);
-        linearized.push_back(linearFactor);
-        if (params_.cacheLinearizedFactors) {
+        toLinearize.emplace_back(linearized.size(), idx);
+        linearized.push_back(GaussianFactor::shared_ptr());
+      }
+    }
+  }
+
+#ifdef GTSAM_USE_TBB
+  {
+    // First linearize all sendable factors in parallel
+    TbbOpenMPMixedScope threadLimiter;  // Limits OpenMP threads since we're mixing TBB and OpenMP
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, toLinearize.size()),
+        _RelinearizeFactors(nonlinearFactors_, theta_, toLinearize, linearized));
+  }
+#endif
+
+  // Linearize the remaining factors and update the cache
+  for (const auto& [slot, idx] : toLinearize) {
+#ifdef GTSAM_USE_TBB
+    if (!nonlinearFactors_[idx]->sendable())
+#endif
+      linearized[slot] = nonlinearFactors_[idx]->linearize(theta_);
+    if (params_.cacheLinearizedFactors) {
 #ifdef GTSAM_EXTRA_CONSISTENCY_CHECKS
-          assert(linearFactors_[idx]->keys() == linearFactor->keys());
+      assert(linearFactors_[idx]->keys() == linearized[slot]->keys());
 #endif
-          linearFactors_[idx] = linearFactor;
-        }
-      }
+      linearFactors_[idx] = linearized[slot];
     }
   }
   gttoc(check_candidates_and_linearize);
@@ -170,6 +258,13 @@ void ISAM2::recalculate(const ISAM2UpdateParams& updateParams,
 
     // Update replaced keys mask (accumulates until back-substitution happens)
     deltaReplacedMask_.insert(affectedKeysSet.begin(), affectedKeysSet.end());
+
+    // Cached marginals of re-eliminated variables are stale, those in the
+    // orphaned subtrees are detected when queried
+    std::lock_guard<std::mutex> lock(marginalCache_.mutex);
+    for (Key key : affectedKeysSet)
+      marginalCache_.statistics.invalidated +=
+          marginalCache_.entries.erase(key);
   }
 }
 
@@ -214,16 +309,20 @@ void ISAM2::recalculateBatch(const ISAM2UpdateParams& updateParams,
   gttoc(ordering);
 
   gttic(linearize);
+  auto start = Clock::now();
   auto linearized = nonlinearFactors_.linearize(theta_);
   if (params_.cacheLinearizedFactors) linearFactors_ = *linearized;
+  if (result->details()) result->details()->relinearizeTime = secondsSince(start);
   gttoc(linearize);
 
   gttic(eliminate);
+  start = Clock::now();
   ISAM2BayesTree::shared_ptr bayesTree =
       ISAM2JunctionTree(
           GaussianEliminationTree(*linearized, affectedFactorsVarIndex, order))
           .eliminate(params_.getEliminationFunction())
           .first;
+  if (result->details()) result->details()->eliminateTime = secondsSince(start);
   gttoc(eliminate);
 
   gttic(insert);
@@ -261,8 +360,10 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   affectedAndNewKeys.insert(affectedAndNewKeys.end(),
                             result->observedKeys.begin(),
                             result->observedKeys.end());
+  auto start = Clock::now();
   GaussianFactorGraph factors =
       relinearizeAffectedFactors(updateParams, affectedAndNewKeys, relinKeys);
+  if (result->details()) result->details()->relinearizeTime = secondsSince(start);
 
   if (debug) {
     factors.print("Relinearized factors: ");
@@ -283,18 +384,29 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   result->variablesReeliminated = affectedAndNewKeys.size();
   result->factorsRecalculated = factors.size();
 
-  gttic(cached);
-  // Add the cached intermediate results from the boundary of the orphans...
-  GaussianFactorGraph cachedBoundary =
-      UpdateImpl::GetCachedBoundaryFactors(*orphans);
-  if (debug) cachedBoundary.print("Boundary factors: ");
-  factors.push_back(cachedBoundary);
-  gttoc(cached);
-
   gttic(orphans);
-  // Add the orphaned subtrees
-  for (const auto& orphan : *orphans)
-    factors.emplace_shared<BayesTreeOrphanWrapper<ISAM2::Clique> >(orphan);
+  start = Clock::now();
+  if (debug)
+    UpdateImpl::GetCachedBoundaryFactors(*orphans).print("Boundary factors: ");
+  // Add the cached intermediate results from the boundary of the orphans,
+  // followed by the orphaned subtrees
+  const std::vector<sharedClique> orphanCliques(orphans->begin(),
+                                                orphans->end());
+  const size_t nrOrphans = orphanCliques.size(), offset = factors.size();
+  factors.resize(offset + 2 * nrOrphans);
+  auto gatherOrphan = [&](size_t i) {
+    factors[offset + i] = orphanCliques[i]->cachedFactor();
+    factors[offset + nrOrphans + i] =
+        std::make_shared<BayesTreeOrphanWrapper<ISAM2::Clique> >(
+            orphanCliques[i]);
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(size_t(0), nrOrphans, gatherOrphan);
+#else
+  for (size_t i = 0; i < nrOrphans; ++i) gatherOrphan(i);
+#endif
+  if (result->details())
+    result->details()->gatherOrphansTime = secondsSince(start);
   gttoc(orphans);
 
   // 3. Re-order and eliminate the factor graph into a Bayes net (Algorithm
@@ -345,10 +457,12 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   gttoc(Ordering);
 
   // Do elimination
+  start = Clock::now();
   GaussianEliminationTree etree(factors, affectedFactorsVarIndex, ordering);
   auto bayesTree = ISAM2JunctionTree(etree)
                        .eliminate(params_.getEliminationFunction())
                        .first;
+  if (result->details()) result->details()->eliminateTime = secondsSince(start);
   gttoc(reorder_and_eliminate);
 
   gttic(reassemble);
@@ -390,10 +504,15 @@ void ISAM2::removeVariables(const KeySet& unusedKeys) {
     deltaNewton_.erase(key);
     RgProd_.erase(key);
     deltaReplacedMask_.erase(key);
+    deltaDeferredKeys_.erase(key);
     Base::nodes_.unsafe_erase(key);
     theta_.erase(key);
     fixedVariables_.erase(key);
   }
+
+  std::lock_guard<std::mutex> lock(marginalCache_.mutex);
+  for (Key key : unusedKeys)
+    marginalCache_.statistics.invalidated += marginalCache_.entries.erase(key);
 }
 
 /* ************************************************************************* */
@@ -419,14 +538,29 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
                           const Values& newTheta,
                           const ISAM2UpdateParams& updateParams) {
   gttic(ISAM2_update);
+  const auto updateStart = Clock::now();
   this->update_count_ += 1;
   UpdateImpl::LogStartingUpdate(newFactors, *this);
   ISAM2Result result(params_.enableDetailedResults);
   UpdateImpl update(params_, updateParams);
 
   // Update delta if we need it to check relinearization later
-  if (update.relinarizationNeeded(update_count_))
-    updateDelta(updateParams.forceFullSolve);
+  if (update.relinarizationNeeded(update_count_)) {
+    std::optional<size_t> maxBacksubstituted =
+        updateParams.maxBacksubstitutedVariables;
+    if (updateParams.timeBudget)
+      maxBacksubstituted = minLimit(
+          maxBacksubstituted, variablesInTime(*updateParams.timeBudget,
+                                              secondsPerBacksubstitutedVariable_));
+    const auto start = Clock::now();
+    const size_t backsubstituted =
+        updateDelta(updateParams.forceFullSolve, maxBacksubstituted);
+    const double seconds = secondsSince(start);
+    updateSecondsPerVariable(seconds, backsubstituted,
+                             &secondsPerBacksubstitutedVariable_);
+    result.deferredBacksubstituteKeys = deltaDeferredKeys_;
+    if (result.details()) result.details()->updateDeltaTime = seconds;
+  }
 
   // 1. Add any new factors \Factors:=\Factors\cup\Factors'.
   update.pushBackFactors(newFactors, &nonlinearFactors_, &linearFactors_,
@@ -449,9 +583,25 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
   KeySet relinKeys;
   result.variablesRelinearized = 0;
   if (update.relinarizationNeeded(update_count_)) {
+    // Limit the relinearized variables to what can be re-eliminated in the
+    // remaining time, besides the variables already marked
+    std::optional<size_t> maxRelinearized =
+        updateParams.maxRelinearizedVariables;
+    if (updateParams.timeBudget) {
+      const std::optional<size_t> affordable = variablesInTime(
+          *updateParams.timeBudget - secondsSince(updateStart),
+          secondsPerReeliminatedVariable_);
+      if (affordable)
+        maxRelinearized = minLimit(
+            maxRelinearized, *affordable > result.markedKeys.size()
+                                 ? *affordable - result.markedKeys.size()
+                                 : 0);
+    }
+
     // 4. Mark keys in \Delta above threshold \beta:
     relinKeys = update.gatherRelinearizeKeys(roots_, delta_, fixedVariables_,
-                                             &result.markedKeys);
+                                             &result.markedKeys, maxRelinearized,
+                                             &result.deferredRelinearizeKeys);
     update.recordRelinearizeDetail(relinKeys, result.details());
     if (!relinKeys.empty()) {
       // 5. Mark cliques that involve marked variables \Theta_{J} and ancestors.
@@ -464,6 +614,7 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
   }
 
   // 7. Linearize new factors
+  const auto recalculateStart = Clock::now();
   update.linearizeNewFactors(newFactors, theta_, nonlinearFactors_.size(),
                              result.newFactorsIndices, &linearFactors_);
   update.augmentVariableIndex(newFactors, result.newFactorsIndices,
@@ -471,6 +622,9 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
 
   // 8. Redo top of Bayes tree and update data structures
   recalculate(updateParams, relinKeys, &result);
+  updateSecondsPerVariable(secondsSince(recalculateStart),
+                           result.variablesReeliminated,
+                           &secondsPerReeliminatedVariable_);
   if (!result.unusedKeys.empty()) removeVariables(result.unusedKeys);
   result.cliques = this->nodes().size();
 
@@ -487,6 +641,13 @@ void ISAM2::marginalizeLeaves(
   // Convert to ordered set
   KeySet leafKeys(leafKeysList.begin(), leafKeysList.end());
 
+  // Cliques may be split in place below, so drop all cached marginals
+  {
+    std::lock_guard<std::mutex> lock(marginalCache_.mutex);
+    marginalCache_.statistics.invalidated += marginalCache_.entries.size();
+    marginalCache_.entries.clear();
+  }
+
   // Keep track of marginal factors - map from clique to the marginal factors
   // that should be incorporated into it, passed up from it's children.
   //  multimap<sharedClique, GaussianFactor::shared_ptr> marginalFactors;
@@ -719,7 +880,14 @@ void ISAM2::marginalizeLeaves(
 /* ************************************************************************* */
 // Marked const but actually changes mutable delta
 void ISAM2::updateDelta(bool forceFullSolve) const {
+  updateDelta(forceFullSolve, {});
+}
+
+/* ************************************************************************* */
+size_t ISAM2::updateDelta(bool forceFullSolve,
+                          std::optional<size_t> maxBacksubstituted) const {
   gttic(updateDelta);
+  size_t backsubstituted = 0;
   if (std::holds_alternative<ISAM2GaussNewtonParams>(params_.optimizationParams)) {
     // If using Gauss-Newton, update with wildfireThreshold
     const ISAM2GaussNewtonParams& gaussNewtonParams =
@@ -727,9 +895,41 @@ void ISAM2::updateDelta(bool forceFullSolve) const {
     const double effectiveWildfireThreshold =
         forceFullSolve ? 0.0 : gaussNewtonParams.wildfireThreshold;
     gttic(Wildfire_update);
-    DeltaImpl::UpdateGaussNewtonDelta(roots_, deltaReplacedMask_,
-                                      effectiveWildfireThreshold, &delta_);
-    deltaReplacedMask_.clear();
+    if (!forceFullSolve &&
+        (maxBacksubstituted || !deltaDeferredKeys_.empty())) {
+      // Bounded wildfire from the roots, then from the cliques deferred by
+      // earlier calls, ancestors first. With a zero threshold this visits
+      // every clique below a replaced one, which a full solve would
+      // recompute anyway.
+      std::vector<std::pair<size_t, sharedClique>> deferred;
+      for (Key key : deltaDeferredKeys_) {
+        auto node = nodes_.find(key);
+        if (node == nodes_.end()) continue;
+        size_t depth = 0;
+        for (auto parent = node->second->parent(); parent;
+             parent = parent->parent())
+          ++depth;
+        deferred.emplace_back(depth, node->second);
+      }
+      std::stable_sort(
+          deferred.begin(), deferred.end(),
+          [](const auto& a, const auto& b) { return a.first < b.first; });
+      std::vector<sharedClique> starts(roots_.begin(), roots_.end());
+      for (const auto& [depth, clique] : deferred) starts.push_back(clique);
+
+      KeySet stillDeferred;
+      backsubstituted = optimizeWildfireBounded(
+          starts, effectiveWildfireThreshold, deltaReplacedMask_,
+          maxBacksubstituted.value_or(std::numeric_limits<size_t>::max()),
+          &delta_, &stillDeferred);
+      deltaReplacedMask_ = stillDeferred;
+      deltaDeferredKeys_ = std::move(stillDeferred);
+    } else {
+      backsubstituted = DeltaImpl::UpdateGaussNewtonDelta(
+          roots_, deltaReplacedMask_, effectiveWildfireThreshold, &delta_);
+      deltaReplacedMask_.clear();
+      deltaDeferredKeys_.clear();
+    }
     gttoc(Wildfire_update);
   } else if (std::holds_alternative<ISAM2DoglegParams>(params_.optimizationParams)) {
     // If using Dogleg, do a Dogleg step
@@ -743,7 +943,7 @@ void ISAM2::updateDelta(bool forceFullSolve) const {
 
     // Compute Newton's method step
     gttic(Wildfire_update);
-    DeltaImpl::UpdateGaussNewtonDelta(
+    backsubstituted = DeltaImpl::UpdateGaussNewtonDelta(
         roots_, deltaReplacedMask_, effectiveWildfireThreshold, &deltaNewton_);
     gttoc(Wildfire_update);
 
@@ -776,6 +976,7 @@ void ISAM2::updateDelta(bool forceFullSolve) const {
   } else {
     throw std::runtime_error("iSAM2: unknown ISAM2Params type");
   }
+  return backsubstituted;
 }
 
 /* ************************************************************************* */
@@ -801,9 +1002,83 @@ Values ISAM2::calculateBestEstimate() const {
 
 /* ************************************************************************* */
 Matrix ISAM2::marginalCovariance(Key key) const {
-  return marginalFactor(key, params_.getEliminationFunction())
-      ->information()
-      .inverse();
+  if (params_.marginalCacheCapacity == 0) {
+    return marginalFactor(key, params_.getEliminationFunction())
+        ->information()
+        .inverse();
+  }
+
+  // A cached entry is valid if it was computed in the same clique, from the
+  // separator marginal that is still cached in it
+  const sharedClique clique = (*this)[key];
+  auto isValid = [](const MarginalCache::Entry& entry, const sharedClique& clique) {
+    if (entry.clique.lock() != clique) return false;
+    const auto separatorMarginal = clique->cachedSeparatorMarginal();
+    if (!separatorMarginal ||
+        separatorMarginal->size() != entry.separatorMarginal.size())
+      return false;
+    for (size_t i = 0; i < separatorMarginal->size(); ++i)
+      if (separatorMarginal->at(i) != entry.separatorMarginal.at(i))
+        return false;
+    return true;
+  };
+
+  {
+    std::lock_guard<std::mutex> lock(marginalCache_.mutex);
+    auto entry = marginalCache_.entries.find(key);
+    if (entry != marginalCache_.entries.end()) {
+      if (isValid(entry->second, clique)) {
+        ++marginalCache_.statistics.hits;
+        entry->second.lastUsed = ++marginalCache_.clock;
+        return entry->second.covariance;
+      }
+      marginalCache_.entries.erase(entry);
+      ++marginalCache_.statistics.invalidated;
+    }
+    ++marginalCache_.statistics.misses;
+  }
+
+  // Computing the marginal caches the separator marginals up to the root
+  Matrix covariance = marginalFactor(key, params_.getEliminationFunction())
+                          ->information()
+                          .inverse();
+  MarginalCache::Entry computed{
+      clique, clique->cachedSeparatorMarginal().value_or(GaussianFactorGraph()),
+      covariance, 0};
+
+  std::lock_guard<std::mutex> lock(marginalCache_.mutex);
+  auto& entries = marginalCache_.entries;
+  if (entries.size() >= params_.marginalCacheCapacity) {
+    // Drop invalid entries first, then the least recently used one
+    for (auto it = entries.begin(); it != entries.end();) {
+      const auto node = nodes_.find(it->first);
+      if (node == nodes_.end() || !isValid(it->second, node->second)) {
+        it = entries.erase(it);
+        ++marginalCache_.statistics.invalidated;
+      } else {
+        ++it;
+      }
+    }
+    while (entries.size() >= params_.marginalCacheCapacity) {
+      entries.erase(std::min_element(entries.begin(), entries.end(),
+                                     [](const auto& a, const auto& b) {
+                                       return a.second.lastUsed <
+                                              b.second.lastUsed;
+                                     }));
+      ++marginalCache_.statistics.evicted;
+    }
+  }
+  computed.lastUsed = ++marginalCache_.clock;
+  entries[key] = std::move(computed);
+  return covariance;
+}
+
+/* ************************************************************************* */
+ISAM2::MarginalCacheStatistics ISAM2::marginalCacheStatistics() const {
+  std::lock_guard<std::mutex> lock(marginalCache_.mutex);
+  MarginalCacheStatistics statistics = marginalCache_.statistics;
+  statistics.size = marginalCache_.entries.size();
+  return statistics;
 }
 
 /* ************************************************************************* */
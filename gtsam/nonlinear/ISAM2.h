@@ -27,6 +27,7 @@
 #include <gtsam/nonlinear/ISAM2UpdateParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 
+#include <mutex>
 #include <vector>
 
 namespace gtsam {
@@ -96,6 +97,56 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   int update_count_;  ///< Counter incremented every update(), used to determine
                       ///< periodic relinearization
 
+  /** Keys in deltaReplacedMask_ whose cliques were not reached by a bounded
+   * back-substitution (see ISAM2UpdateParams::maxBacksubstitutedVariables),
+   * and hence have to be visited explicitly by the next one. */
+  mutable KeySet deltaDeferredKeys_;
+
+  /** Seconds per re-eliminated and per back-substituted variable, measured
+   * in previous updates and used to convert ISAM2UpdateParams::timeBudget into
+   * limits on the work done. Zero until measured. */
+  double secondsPerReeliminatedVariable_ = 0.0;
+  double secondsPerBacksubstitutedVariable_ = 0.0;
+
+ public:
+  /// Statistics of the cache used by marginalCovariance
+  struct MarginalCacheStatistics {
+    size_t hits = 0;         ///< Queries answered from the cache
+    size_t misses = 0;       ///< Queries that computed the marginal
+    size_t invalidated = 0;  ///< Entries dropped because their clique changed
+    size_t evicted = 0;      ///< Entries dropped because the cache was full
+    size_t size = 0;         ///< Current number of entries
+  };
+
+ protected:
+  /** Marginal covariances computed by marginalCovariance. An entry is valid
+   * as long as the clique of its key is the same, and the separator marginal
+   * cached in that clique is the one the entry was computed from: when an
+   * update changes an ancestor, BayesTree::removeTop deletes the cached
+   * separator marginals of the whole subtree. Copies start out empty. */
+  struct MarginalCache {
+    struct Entry {
+      std::weak_ptr<ISAM2Clique> clique;
+      GaussianFactorGraph separatorMarginal;
+      Matrix covariance;
+      size_t lastUsed;
+    };
+    FastMap<Key, Entry> entries;
+    MarginalCacheStatistics statistics;
+    size_t clock = 0;
+    std::mutex mutex;
+
+    MarginalCache() {}
+    MarginalCache(const MarginalCache&) {}
+    MarginalCache& operator=(const MarginalCache&) {
+      entries.clear();
+      statistics = MarginalCacheStatistics();
+      clock = 0;
+      return *this;
+    }
+  };
+  mutable MarginalCache marginalCache_;
+
  public:
   using This = ISAM2;                       ///< This class
   using Base = BayesTree<ISAM2Clique>;      ///< The BayesTree base class
@@ -248,9 +299,15 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
    */
   const Value& calculateEstimate(Key key) const;
 
-  /** Return marginal on any variable as a covariance matrix */
+  /** Return marginal on any variable as a covariance matrix. Results are
+   * cached, see ISAM2Params::marginalCacheCapacity: repeated queries are
+   * answered from the cache until an update changes the clique of the
+   * variable or one of its ancestors. */
   Matrix marginalCovariance(Key key) const;
 
+  /** Hit, miss and size statistics of the marginalCovariance cache */
+  MarginalCacheStatistics marginalCacheStatistics() const;
+
   /// @name Public members for non-typical usage
   /// @{
 
@@ -339,6 +396,15 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
 
   void updateDelta(bool forceFullSolve = false) const;
 
+  /**
+   * Update delta_ like updateDelta(), but with Gauss-Newton back-substitute
+   * at most about \c maxBacksubstituted variables. The frontal keys of the
+   * cliques left for later are kept in deltaDeferredKeys_.
+   * @return The number of variables back-substituted
+   */
+  size_t updateDelta(bool forceFullSolve,
+                     std::optional<size_t> maxBacksubstituted) const;
+
  private:
 #ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
   /** Serialization function */
@@ -352,6 +418,7 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
       ar & BOOST_SERIALIZATION_NVP(deltaNewton_);
       ar & BOOST_SERIALIZATION_NVP(RgProd_);
       ar & BOOST_SERIALIZATION_NVP(deltaReplacedMask_);
+      ar & BOOST_SERIALIZATION_NVP(deltaDeferredKeys_);
       ar & BOOST_SERIALIZATION_NVP(nonlinearFactors_);
       ar & BOOST_SERIALIZATION_NVP(linearFactors_);
       ar & BOOST_SERIALIZATION_NVP(doglegDelta_);
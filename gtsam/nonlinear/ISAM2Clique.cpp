@@ -20,7 +20,13 @@
 #include <gtsam/linear/linearAlgorithms-inst.h>
 #include <gtsam/nonlinear/ISAM2Clique.h>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/task_group.h>
+#endif
+
+#include <atomic>
 #include <stack>
+#include <unordered_set>
 #include <utility>
 
 using namespace std;
@@ -283,6 +289,116 @@ size_t optimizeWildfireNonRecursive(const ISAM2Clique::shared_ptr& root,
   return count;
 }
 
+/* ************************************************************************* */
+#ifdef GTSAM_USE_TBB
+namespace {
+// Cliques with at least this problem size spawn tasks for their children
+const int kWildfireTaskThreshold = 10;
+
+// Wildfire back-substitution of a subtree in one task. The separator of every
+// clique in the subtree only contains keys of the subtree and of the separator
+// of its root, so a task only needs the changed keys of that separator.
+class WildfireTask {
+  ISAM2Clique::shared_ptr root_;
+  KeySet changed_;
+  const KeySet& replaced_;
+  double threshold_;
+  VectorValues* delta_;
+  std::atomic<size_t>& count_;
+
+ public:
+  WildfireTask(const ISAM2Clique::shared_ptr& root, KeySet&& changed,
+               const KeySet& replaced, double threshold, VectorValues* delta,
+               std::atomic<size_t>& count)
+      : root_(root), changed_(std::move(changed)), replaced_(replaced),
+        threshold_(threshold), delta_(delta), count_(count) {}
+
+  void operator()() const {
+    KeySet changed = changed_;
+    size_t count = 0;
+    tbb::task_group tg;
+    std::stack<ISAM2Clique::shared_ptr> travStack;
+    travStack.push(root_);
+    while (!travStack.empty()) {
+      ISAM2Clique::shared_ptr clique = travStack.top();
+      travStack.pop();
+      if (!clique->optimizeWildfireNode(replaced_, threshold_, &changed, delta_,
+                                        &count))
+        continue;
+      if (clique->children.size() > 1 &&
+          clique->problemSize() >= kWildfireTaskThreshold) {
+        for (const auto& child : clique->children) {
+          KeySet childChanged;
+          for (Key parent : child->conditional()->parents())
+            if (changed.exists(parent)) childChanged.insert(parent);
+          tg.run(WildfireTask(child, std::move(childChanged), replaced_,
+                              threshold_, delta_, count_));
+        }
+      } else {
+        for (const auto& child : clique->children) travStack.push(child);
+      }
+    }
+    tg.wait();
+    count_ += count;
+  }
+};
+}  // namespace
+#endif
+
+size_t optimizeWildfireParallel(const ISAM2Clique::shared_ptr& root,
+                                double threshold, const KeySet& keys,
+                                VectorValues* delta) {
+#ifdef GTSAM_USE_TBB
+  std::atomic<size_t> count(0);
+  if (root) {
+    TbbOpenMPMixedScope threadLimiter;  // Limits OpenMP threads since we're mixing TBB and OpenMP
+    tbb::task_group tg;
+    tg.run_and_wait(WildfireTask(root, KeySet(), keys, threshold, delta, count));
+  }
+  return count;
+#else
+  return optimizeWildfireNonRecursive(root, threshold, keys, delta);
+#endif
+}
+
+/* ************************************************************************* */
+size_t optimizeWildfireBounded(const std::vector<ISAM2Clique::shared_ptr>& starts,
+                               double threshold, const KeySet& keys,
+                               size_t maxCount, VectorValues* delta,
+                               KeySet* deferred) {
+  KeySet changed;
+  size_t count = 0;
+  std::unordered_set<const ISAM2Clique*> visited;
+
+  for (const ISAM2Clique::shared_ptr& start : starts) {
+    if (!start || visited.count(start.get())) continue;
+    std::stack<ISAM2Clique::shared_ptr> travStack;
+    travStack.push(start);
+    while (!travStack.empty()) {
+      ISAM2Clique::shared_ptr currentNode = travStack.top();
+      travStack.pop();
+      if (!visited.insert(currentNode.get()).second) continue;
+      if (count >= maxCount) {
+        // Out of budget, remember this clique if it needs back-substitution
+        if (currentNode->isDirty(keys, changed)) {
+          for (Key frontal : currentNode->conditional()->frontals())
+            deferred->insert(frontal);
+        }
+        continue;
+      }
+      bool dirty = currentNode->optimizeWildfireNode(keys, threshold, &changed,
+                                                     delta, &count);
+      if (dirty) {
+        for (const auto& child : currentNode->children) {
+          travStack.push(child);
+        }
+      }
+    }
+  }
+
+  return count;
+}
+
 /* ************************************************************************* */
 void ISAM2Clique::nnz_internal(size_t* result) const {
   size_t dimR = conditional_->rows();
@@ -119,13 +119,13 @@ class GTSAM_EXPORT ISAM2Clique
    */
   void findAll(const KeySet& markedMask, KeySet* keys) const;
 
- private:
   /**
    * Check if clique was replaced, or if any parents were changed above the
    * threshold or themselves replaced.
    */
   bool isDirty(const KeySet& replaced, const KeySet& changed) const;
 
+ private:
   /**
    * Back-substitute - special version stores solution pointers in cliques for
    * fast access.
@@ -176,4 +176,27 @@ size_t optimizeWildfireNonRecursive(const ISAM2Clique::shared_ptr& root,
                                     double threshold, const KeySet& replaced,
                                     VectorValues* delta);
 
+/**
+ * Same as optimizeWildfireNonRecursive, but with TBB the subtrees below cliques
+ * with several children are back-substituted in parallel. Without TBB this is
+ * optimizeWildfireNonRecursive.
+ */
+size_t optimizeWildfireParallel(const ISAM2Clique::shared_ptr& root,
+                                double threshold, const KeySet& replaced,
+                                VectorValues* delta);
+
+/**
+ * Wildfire back-substitution that stops after back-substituting about
+ * \c maxCount variables. The traversal starts from each clique in \c starts
+ * in turn, skipping the ones already visited, so ancestors should come before
+ * their descendants. Cliques that still needed back-substitution when the
+ * limit was hit are not visited, and their frontal keys are added to
+ * \c deferred. Passing those keys as replaced keys, and their cliques as
+ * starts, to a later call resumes the back-substitution.
+ */
+size_t optimizeWildfireBounded(const std::vector<ISAM2Clique::shared_ptr>& starts,
+                               double threshold, const KeySet& replaced,
+                               size_t maxCount, VectorValues* delta,
+                               KeySet* deferred);
+
 }  // namespace gtsam
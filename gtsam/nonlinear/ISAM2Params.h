@@ -224,6 +224,12 @@ struct GTSAM_EXPORT ISAM2Params {
   /// cost of having to search for slots every time a factor is added.
   bool findUnusedFactorSlots;
 
+  /// Maximum number of marginal covariances that ISAM2::marginalCovariance
+  /// keeps for repeated queries, 0 disables the cache (default: 100). When
+  /// full, entries invalidated by updates go first, then the least recently
+  /// used. See ISAM2::marginalCacheStatistics to size it.
+  size_t marginalCacheCapacity;
+
   /**
    * Specify parameters as constructor arguments
    * See the documentation of member variables above.
@@ -247,7 +253,8 @@ struct GTSAM_EXPORT ISAM2Params {
         keyFormatter(_keyFormatter),
         enableDetailedResults(_enableDetailedResults),
         enablePartialRelinearizationCheck(false),
-        findUnusedFactorSlots(false) {}
+        findUnusedFactorSlots(false),
+        marginalCacheCapacity(100) {}
 
   /// print iSAM2 parameters
   void print(const std::string& str = "") const {
@@ -290,6 +297,8 @@ struct GTSAM_EXPORT ISAM2Params {
          << enablePartialRelinearizationCheck << "\n";
     cout << "findUnusedFactorSlots:             " << findUnusedFactorSlots
          << "\n";
+    cout << "marginalCacheCapacity:             " << marginalCacheCapacity
+         << "\n";
     cout.flush();
   }
 
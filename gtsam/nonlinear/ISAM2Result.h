@@ -108,6 +108,17 @@ struct ISAM2Result {
   /** All keys that were marked during the update process. */
   KeySet markedKeys;
 
+  /** Keys of variables above the relinearization threshold that were not
+   * relinearized, because of ISAM2UpdateParams::maxRelinearizedVariables or
+   * ISAM2UpdateParams::timeBudget. They are relinearized by later updates if
+   * they are still above the threshold. */
+  KeySet deferredRelinearizeKeys;
+
+  /** Frontal keys of the cliques whose back-substitution was deferred, because
+   * of ISAM2UpdateParams::maxBacksubstitutedVariables or
+   * ISAM2UpdateParams::timeBudget. */
+  KeySet deferredBacksubstituteKeys;
+
   /**
    * A struct holding detailed results, which must be enabled with
    * ISAM2Params::enableDetailedResults.
@@ -149,6 +160,14 @@ struct ISAM2Result {
 
     /// The status of each variable during this update, see VariableStatus.
     StatusMap variableStatus;
+
+    /// @name Wall-clock time in seconds spent in the stages of the update
+    /// @{
+    double updateDeltaTime = 0.0;  ///< Back-substitution before relinearizing
+    double relinearizeTime = 0.0;  ///< Relinearizing the affected factors
+    double gatherOrphansTime = 0.0;  ///< Gathering the orphaned subtrees
+    double eliminateTime = 0.0;  ///< Re-eliminating the top of the Bayes tree
+    /// @}
   };
 
   /** Detailed results, if enabled by ISAM2Params::enableDetailedResults.  See
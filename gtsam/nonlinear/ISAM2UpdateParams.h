@@ -69,6 +69,25 @@ struct ISAM2UpdateParams {
    * the deltas become too small down in the tree. This flagg forces a full
    * solve instead. */
   bool forceFullSolve{false};
+
+  /** An optional limit on the number of variables relinearized in this
+   * update. If more variables are above the relinearization threshold, only
+   * the ones with the largest deltas are relinearized, and the others are
+   * left for later updates (see ISAM2Result::deferredRelinearizeKeys). */
+  std::optional<size_t> maxRelinearizedVariables;
+
+  /** An optional limit on the number of variables back-substituted by the
+   * wildfire update of the linear delta at the start of this update. Cliques
+   * that are not reached are back-substituted by later updates, or when the
+   * estimate is requested (see ISAM2Result::deferredBacksubstituteKeys).
+   * Only used with ISAM2GaussNewtonParams. */
+  std::optional<size_t> maxBacksubstitutedVariables;
+
+  /** An optional time budget for this update, in seconds. It is converted into
+   * the limits above using the time per variable measured in previous
+   * updates, so it is a soft bound: new factors are always added, and the
+   * first updates are not limited. */
+  std::optional<double> timeBudget;
 };
 
 }  // namespace gtsam
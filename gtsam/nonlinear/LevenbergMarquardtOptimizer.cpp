@@ -23,6 +23,7 @@
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/Values.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/JacobianFactor.h>
 #include <gtsam/linear/linearExceptions.h>
 #include <gtsam/inference/Ordering.h>
 #include <gtsam/base/Vector.h>
@@ -50,7 +51,9 @@ LevenbergMarquardtOptimizer::LevenbergMarquardtOptimizer(const NonlinearFactorGr
     : NonlinearOptimizer(
           graph, std::unique_ptr<State>(new State(initialValues, graph.error(initialValues),
                                                   params.lambdaInitial, params.lambdaFactor))),
-      params_(LevenbergMarquardtParams::EnsureHasOrdering(params, graph)) {}
+      params_(LevenbergMarquardtParams::EnsureHasOrdering(params, graph)) {
+  cacheEliminationStructure_ = params_.reuseEliminationAcrossLambdas;
+}
 
 LevenbergMarquardtOptimizer::LevenbergMarquardtOptimizer(const NonlinearFactorGraph& graph,
                                                          const Values& initialValues,
@@ -59,7 +62,9 @@ LevenbergMarquardtOptimizer::LevenbergMarquardtOptimizer(const NonlinearFactorGr
     : NonlinearOptimizer(
           graph, std::unique_ptr<State>(new State(initialValues, graph.error(initialValues),
                                                   params.lambdaInitial, params.lambdaFactor))),
-      params_(LevenbergMarquardtParams::ReplaceOrdering(params, ordering)) {}
+      params_(LevenbergMarquardtParams::ReplaceOrdering(params, ordering)) {
+  cacheEliminationStructure_ = params_.reuseEliminationAcrossLambdas;
+}
 
 /* ************************************************************************* */
 void LevenbergMarquardtOptimizer::initTime() {
@@ -79,6 +84,12 @@ int LevenbergMarquardtOptimizer::getInnerIterations() const {
   return currentState->totalNumberInnerIterations;
 }
 
+/* ************************************************************************* */
+int LevenbergMarquardtOptimizer::getRejectedSteps() const {
+  auto currentState = static_cast<const State*>(state_.get());
+  return currentState->rejectedSteps;
+}
+
 /* ************************************************************************* */
 GaussianFactorGraph::shared_ptr LevenbergMarquardtOptimizer::linearize() const {
   return graph_.linearize(state_->values);
@@ -99,6 +110,49 @@ GaussianFactorGraph LevenbergMarquardtOptimizer::buildDampedSystem(
     return currentState->buildDampedSystem(linear);
 }
 
+/* ************************************************************************* */
+const GaussianFactorGraph& LevenbergMarquardtOptimizer::updateDampedSystem(
+    const GaussianFactorGraph& linear, const VectorValues& sqrtHessianDiagonal) {
+  gttic(damp);
+  auto currentState = static_cast<const State*>(state_.get());
+  const double sqrtLambda = std::sqrt(currentState->lambda);
+
+  if (params_.verbosityLM >= LevenbergMarquardtParams::DAMPED)
+    std::cout << "building damped system with lambda " << currentState->lambda << std::endl;
+
+  if (!dampedSystemValid_) {
+    // Add a prior on every variable, with sqrt(lambda) folded into A so that a
+    // new lambda does not need new factors or noise models.
+    dampedSystem_ = linear;
+    dampedSystem_.reserve(linear.size() + currentState->values.size());
+    dampingFactors_.clear();
+    std::vector<SharedDiagonal> unitModels;
+    auto addDamping = [&](Key key, const Vector& diagonal) {
+      const size_t dim = diagonal.size();
+      if (dim >= unitModels.size()) unitModels.resize(dim + 1);
+      if (!unitModels[dim]) unitModels[dim] = noiseModel::Unit::Create(dim);
+      Matrix A = (sqrtLambda * diagonal).asDiagonal();
+      auto factor = std::make_shared<JacobianFactor>(key, A, Vector::Zero(dim),
+                                                     unitModels[dim]);
+      dampedSystem_.push_back(factor);
+      dampingFactors_.emplace_back(factor, diagonal);
+    };
+    if (params_.diagonalDamping) {
+      for (const auto& [key, diagonal] : sqrtHessianDiagonal)
+        addDamping(key, diagonal);
+    } else {
+      for (const auto& [key, dim] : currentState->values.dims())
+        addDamping(key, Vector::Ones(dim));
+    }
+    dampedSystemValid_ = true;
+  } else {
+    // Only rescale the damping factors for the new lambda
+    for (auto& [factor, diagonal] : dampingFactors_)
+      factor->getA(factor->begin()).diagonal() = sqrtLambda * diagonal;
+  }
+  return dampedSystem_;
+}
+
 /* ************************************************************************* */
 // Log current error/lambda to file
 inline void LevenbergMarquardtOptimizer::writeLogFile(double currentError){
@@ -138,8 +192,8 @@ bool LevenbergMarquardtOptimizer::tryLambda(const GaussianFactorGraph& linear,
   if (verbose)
     cout << "trying lambda = " << currentState->lambda << endl;
 
-  // Build damped system for this lambda (adds prior factors that make it like gradient descent)
-  auto dampedSystem = buildDampedSystem(linear, sqrtHessianDiagonal);
+  // Damp the system for this lambda (adds prior factors that make it like gradient descent)
+  const GaussianFactorGraph& dampedSystem = updateDampedSystem(linear, sqrtHessianDiagonal);
 
   // Try solving
   double modelFidelity = 0.0;
@@ -298,6 +352,12 @@ GaussianFactorGraph::shared_ptr LevenbergMarquardtOptimizer::iterate() {
     }
   }
 
+  // The damped system and, unless it is reused across iterations, the symbolic
+  // elimination are built on the first lambda trial and shared by the retries.
+  dampedSystemValid_ = false;
+  if (!params_.reuseEliminationStructure) eliminationStructure_.reset();
+  static_cast<State*>(state_.get())->rejectedSteps = 0;
+
   // Keep increasing lambda until we make make progress
   while (!tryLambda(*linear, sqrtHessianDiagonal)) {
     auto newState = static_cast<const State*>(state_.get());
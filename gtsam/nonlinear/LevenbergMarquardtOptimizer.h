@@ -29,6 +29,8 @@ class NonlinearOptimizerMoreOptimizationTest;
 
 namespace gtsam {
 
+class JacobianFactor;
+
 /**
  * This class performs Levenberg-Marquardt nonlinear optimization
  */
@@ -40,8 +42,25 @@ protected:
   // startTime_ is a chrono time point
   std::chrono::time_point<std::chrono::high_resolution_clock> startTime_; ///< time when optimization started
 
+  /// Damped system of the current outer iteration, shared by all lambda trials
+  GaussianFactorGraph dampedSystem_;
+
+  /// Damping factors in dampedSystem_, with the diagonal they scale by sqrt(lambda)
+  std::vector<std::pair<std::shared_ptr<JacobianFactor>, Vector>> dampingFactors_;
+
+  /// Whether dampedSystem_ was built for the current linearization
+  bool dampedSystemValid_ = false;
+
   void initTime();
 
+  /**
+   * Damp the linear system for the current lambda. The damped system is built
+   * once per linearization, later lambda trials only rescale the damping
+   * factors in place.
+   */
+  const GaussianFactorGraph& updateDampedSystem(
+      const GaussianFactorGraph& linear, const VectorValues& sqrtHessianDiagonal);
+
 public:
   typedef std::shared_ptr<LevenbergMarquardtOptimizer> shared_ptr;
 
@@ -85,6 +104,13 @@ public:
   /// Access the current number of inner iterations
   int getInnerIterations() const;
 
+  /**
+   * Number of rejected lambda trials in the last outer iteration, i.e., the
+   * number of times lambda was increased. Can be queried from the
+   * NonlinearOptimizerParams::iterationHook.
+   */
+  int getRejectedSteps() const;
+
   /// print
   void print(const std::string& str = "") const {
     std::cout << str << "LevenbergMarquardtOptimizer" << std::endl;
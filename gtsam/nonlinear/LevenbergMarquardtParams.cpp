@@ -100,6 +100,8 @@ void LevenbergMarquardtParams::print(const std::string& str) const {
   std::cout << "            diagonalDamping: " << diagonalDamping << "\n";
   std::cout << "                minDiagonal: " << minDiagonal << "\n";
   std::cout << "                maxDiagonal: " << maxDiagonal << "\n";
+  std::cout << "reuseEliminationAcrossLambdas: " << reuseEliminationAcrossLambdas
+            << "\n";
   std::cout << "                verbosityLM: "
       << verbosityLMTranslator(verbosityLM) << "\n";
   std::cout.flush();
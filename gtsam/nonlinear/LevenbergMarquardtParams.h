@@ -55,12 +55,14 @@ public:
   std::string logFile; ///< an optional CSV log file, with [iteration, time, error, lambda]
   bool diagonalDamping; ///< if true, use diagonal of Hessian
   bool useFixedLambdaFactor; ///< if true applies constant increase (or decrease) to lambda according to lambdaFactor
+  bool reuseEliminationAcrossLambdas; ///< if true, the lambda trials of one iteration share the symbolic elimination, also without reuseEliminationStructure (default: false)
   double minDiagonal; ///< when using diagonal damping saturates the minimum diagonal entries (default: 1e-6)
   double maxDiagonal; ///< when using diagonal damping saturates the maximum diagonal entries (default: 1e32)
 
   LevenbergMarquardtParams()
       : verbosityLM(SILENT),
         diagonalDamping(false),
+        reuseEliminationAcrossLambdas(false),
         minDiagonal(1e-6),
         maxDiagonal(1e32) {
     SetLegacyDefaults(this);
@@ -133,6 +135,7 @@ public:
   double getlambdaLowerBound() const { return lambdaLowerBound; }
   double getlambdaUpperBound() const { return lambdaUpperBound; }
   bool getUseFixedLambdaFactor() { return useFixedLambdaFactor; }
+  bool getReuseEliminationAcrossLambdas() const { return reuseEliminationAcrossLambdas; }
   std::string getLogFile() const { return logFile; }
   std::string getVerbosityLM() const { return verbosityLMTranslator(verbosityLM);}
   
@@ -142,6 +145,7 @@ public:
   void setlambdaLowerBound(double value) { lambdaLowerBound = value; }
   void setlambdaUpperBound(double value) { lambdaUpperBound = value; }
   void setUseFixedLambdaFactor(bool flag) { useFixedLambdaFactor = flag;}
+  void setReuseEliminationAcrossLambdas(bool flag) { reuseEliminationAcrossLambdas = flag; }
   void setLogFile(const std::string& s) { logFile = s; }
   void setVerbosityLM(const std::string& s) { verbosityLM = verbosityLMTranslator(s);}
   // @}
@@ -20,6 +20,13 @@
 #include <gtsam/linear/JacobianFactor.h>
 #include <gtsam/linear/HessianFactor.h>
 #include <gtsam/nonlinear/Marginals.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
+
+#include <unordered_set>
 
 using namespace std;
 
@@ -134,6 +141,149 @@ Matrix Marginals::marginalCovariance(Key variable) const {
   return marginalInformation(variable).inverse();
 }
 
+/* ************************************************************************* */
+namespace {
+
+/// The joint covariance of the frontal and separator variables of a clique
+struct CliqueCovariance {
+  KeyVector keys;                  // frontals, then separator
+  FastVector<DenseIndex> offsets;  // start of each key, then the total size
+  Matrix covariance;
+
+  DenseIndex dim(size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+  size_t index(Key key) const {
+    return std::find(keys.begin(), keys.end(), key) - keys.begin();
+  }
+};
+
+/**
+ * Recovers the covariance from the root of a Bayes tree down. The covariance
+ * of the separator of a clique is contained in the joint covariance of its
+ * parent, and with the whitened conditional R x_F + S x_S = d, the rest is
+ *   Sigma_FS = - R^-1 S Sigma_SS,
+ *   Sigma_FF = R^-1 R^-T - Sigma_FS (R^-1 S)^T.
+ */
+class CovarianceRecovery {
+  typedef GaussianBayesTree::sharedClique sharedClique;
+
+  const std::unordered_set<const GaussianBayesTreeClique*>& needed_;
+  FastMap<Key, Matrix>& result_;  // entries are created up front
+
+ public:
+  CovarianceRecovery(
+      const std::unordered_set<const GaussianBayesTreeClique*>& needed,
+      FastMap<Key, Matrix>& result)
+      : needed_(needed), result_(result) {}
+
+  void recoverCliques(const FastVector<sharedClique>& cliques,
+                      const CliqueCovariance* parent) const {
+    FastVector<sharedClique> todo;
+    for (const sharedClique& clique : cliques)
+      if (needed_.count(clique.get())) todo.push_back(clique);
+#ifdef GTSAM_USE_TBB
+    if (todo.size() > 1) {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, todo.size()),
+                        [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t i = range.begin(); i != range.end(); ++i)
+                            recoverClique(todo[i], parent);
+                        });
+      return;
+    }
+#endif
+    for (const sharedClique& clique : todo) recoverClique(clique, parent);
+  }
+
+ private:
+  void recoverClique(const sharedClique& clique,
+                     const CliqueCovariance* parent) const {
+    const GaussianConditional& conditional = *clique->conditional();
+    const size_t nrFrontals = conditional.nrFrontals();
+
+    CliqueCovariance mine;
+    mine.keys.assign(conditional.begin(), conditional.end());
+    mine.offsets.push_back(0);
+    for (auto it = conditional.begin(); it != conditional.end(); ++it)
+      mine.offsets.push_back(mine.offsets.back() + conditional.getDim(it));
+
+    Matrix R = conditional.R(), S = conditional.S();
+    if (conditional.get_model()) {
+      R = conditional.get_model()->Whiten(R);
+      S = conditional.get_model()->Whiten(S);
+    }
+    const DenseIndex nF = R.cols(), nS = S.cols();
+    const auto upperR = R.triangularView<Eigen::Upper>();
+    const Matrix Rinv = upperR.solve(Matrix::Identity(nF, nF));
+
+    Matrix& covariance = mine.covariance;
+    covariance.resize(nF + nS, nF + nS);
+    covariance.topLeftCorner(nF, nF).noalias() = Rinv * Rinv.transpose();
+    if (nS > 0) {
+      // Gather the separator covariance from the parent
+      auto Sigma_SS = covariance.bottomRightCorner(nS, nS);
+      for (size_t i = nrFrontals; i < mine.keys.size(); ++i) {
+        const size_t pi = parent->index(mine.keys[i]);
+        for (size_t j = nrFrontals; j < mine.keys.size(); ++j) {
+          const size_t pj = parent->index(mine.keys[j]);
+          Sigma_SS.block(mine.offsets[i] - nF, mine.offsets[j] - nF,
+                         mine.dim(i), mine.dim(j)) =
+              parent->covariance.block(parent->offsets[pi],
+                                       parent->offsets[pj], parent->dim(pi),
+                                       parent->dim(pj));
+        }
+      }
+      const Matrix RinvS = upperR.solve(S);
+      auto Sigma_FS = covariance.topRightCorner(nF, nS);
+      Sigma_FS.noalias() = -RinvS * Sigma_SS;
+      covariance.topLeftCorner(nF, nF).noalias() -= Sigma_FS * RinvS.transpose();
+      covariance.bottomLeftCorner(nS, nF) = Sigma_FS.transpose();
+    }
+
+    // Store the requested marginals, every key is frontal in only one clique
+    for (size_t i = 0; i < nrFrontals; ++i) {
+      auto entry = result_.find(mine.keys[i]);
+      if (entry != result_.end())
+        entry->second = covariance.block(mine.offsets[i], mine.offsets[i],
+                                         mine.dim(i), mine.dim(i));
+    }
+
+    recoverCliques(clique->children, &mine);
+  }
+};
+
+}  // namespace
+
+/* ************************************************************************* */
+FastMap<Key, Matrix> Marginals::marginalCovariances(
+    const KeyVector& variables) const {
+  gttic(marginalCovariances);
+
+  // Only the cliques of the variables and their ancestors are needed
+  FastMap<Key, Matrix> result;
+  std::unordered_set<const GaussianBayesTreeClique*> needed;
+  for (Key key : variables) {
+    result.emplace(key, Matrix());
+    for (auto clique = bayesTree_[key]; clique; clique = clique->parent())
+      if (!needed.insert(clique.get()).second) break;
+  }
+
+#ifdef GTSAM_USE_TBB
+  TbbOpenMPMixedScope threadLimiter;
+#endif
+  CovarianceRecovery(needed, result).recoverCliques(bayesTree_.roots(),
+                                                    nullptr);
+  return result;
+}
+
+/* ************************************************************************* */
+FastMap<Key, Matrix> Marginals::marginalCovariances() const {
+  KeyVector variables;
+  variables.reserve(bayesTree_.nodes().size());
+  for (const auto& keyClique : bayesTree_.nodes())
+    variables.push_back(keyClique.first);
+  return marginalCovariances(variables);
+}
+
 /* ************************************************************************* */
 JointMarginal Marginals::jointMarginalCovariance(const KeyVector& variables) const {
   JointMarginal info = jointMarginalInformation(variables);
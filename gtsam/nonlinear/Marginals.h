@@ -113,6 +113,19 @@ public:
   /** Compute the marginal covariance of a single variable */
   Matrix marginalCovariance(Key variable) const;
 
+  /**
+   * Compute the marginal covariances of many variables at once. Instead of
+   * marginalizing the Bayes tree once per variable, this recovers the
+   * covariance recursively from the root down (as in Golub and Plemmons),
+   * only for the entries on the sparsity pattern of the cliques that contain
+   * the variables, and their ancestors. Independent subtrees are processed in
+   * parallel when GTSAM is built with TBB.
+   */
+  FastMap<Key, Matrix> marginalCovariances(const KeyVector& variables) const;
+
+  /** Compute the marginal covariances of all variables, see above */
+  FastMap<Key, Matrix> marginalCovariances() const;
+
   /** Compute the joint marginal covariance of several variables */
   JointMarginal jointMarginalCovariance(const KeyVector& variables) const;
 
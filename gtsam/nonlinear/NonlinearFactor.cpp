@@ -173,11 +173,10 @@ std::shared_ptr<GaussianFactor> NoiseModelFactor::linearize(
   // TODO pass unwhitened + noise model to Gaussian factor
   using noiseModel::Constrained;
   if (noiseModel_ && noiseModel_->isConstrained())
-    return GaussianFactor::shared_ptr(
-        new JacobianFactor(terms, b,
-            std::static_pointer_cast<Constrained>(noiseModel_)->unit()));
+    return allocateShared<JacobianFactor>(
+        terms, b, std::static_pointer_cast<Constrained>(noiseModel_)->unit());
   else {
-    return GaussianFactor::shared_ptr(new JacobianFactor(terms, b));
+    return allocateShared<JacobianFactor>(terms, b);
   }
 }
 
@@ -25,6 +25,7 @@
 #include <gtsam/linear/NoiseModel.h>
 #include <gtsam/linear/JacobianFactor.h>
 #include <gtsam/inference/Factor.h>
+#include <gtsam/base/MonotonicArena.h>
 #include <gtsam/base/OptionalJacobian.h>
 #include <gtsam/base/utilities.h>
 
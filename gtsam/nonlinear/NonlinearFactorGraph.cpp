@@ -21,6 +21,7 @@
 #include <gtsam/geometry/Pose3.h>
 #include <gtsam/symbolic/SymbolicFactorGraph.h>
 #include <gtsam/nonlinear/Values.h>
+#include <gtsam/nonlinear/FlatValues.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/linearExceptions.h>
@@ -31,6 +32,8 @@
 
 #ifdef GTSAM_USE_TBB
 #  include <tbb/parallel_for.h>
+#  include <tbb/parallel_reduce.h>
+#  include <tbb/task_arena.h>
 #endif
 
 #include <algorithm>
@@ -178,6 +181,11 @@ double NonlinearFactorGraph::error(const Values& values) const {
   return total_error;
 }
 
+/* ************************************************************************* */
+double NonlinearFactorGraph::error(const FlatValues& values) const {
+  return error(values.values());
+}
+
 /* ************************************************************************* */
 Ordering NonlinearFactorGraph::orderingCOLAMD() const
 {
@@ -215,14 +223,17 @@ class _LinearizeOneFactor {
   const NonlinearFactorGraph& nonlinearGraph_;
   const Values& linearizationPoint_;
   GaussianFactorGraph& result_;
+  MonotonicArena* arena_;  // Arena of the calling thread, if any
 public:
   // Create functor with constant parameters
   _LinearizeOneFactor(const NonlinearFactorGraph& graph,
       const Values& linearizationPoint, GaussianFactorGraph& result) :
-      nonlinearGraph_(graph), linearizationPoint_(linearizationPoint), result_(result) {
+      nonlinearGraph_(graph), linearizationPoint_(linearizationPoint), result_(result),
+      arena_(MonotonicArena::Current()) {
   }
   // Operator that linearizes a given range of the factors
   void operator()(const tbb::blocked_range<size_t>& blocked_range) const {
+    MonotonicArena::Scope scope(arena_);
     for (size_t i = blocked_range.begin(); i != blocked_range.end(); ++i) {
       if (nonlinearGraph_[i] && nonlinearGraph_[i]->sendable())
         result_[i] = nonlinearGraph_[i]->linearize(linearizationPoint_);
@@ -277,6 +288,12 @@ GaussianFactorGraph::shared_ptr NonlinearFactorGraph::linearize(const Values& li
   return linearFG;
 }
 
+/* ************************************************************************* */
+GaussianFactorGraph::shared_ptr NonlinearFactorGraph::linearize(
+    const FlatValues& linearizationPoint) const {
+  return linearize(linearizationPoint.values());
+}
+
 /* ************************************************************************* */
 static Scatter scatterFromValues(const Values& values) {
   gttic(scatterFromValues);
@@ -308,6 +325,47 @@ static Scatter scatterFromValues(const Values& values, const Ordering& ordering)
   return scatter;
 }
 
+/* ************************************************************************* */
+namespace {
+
+#ifdef GTSAM_USE_TBB
+class _LinearizeIntoHessian {
+  const NonlinearFactorGraph& nonlinearGraph_;
+  const Values& linearizationPoint_;
+  const KeyVector& keys_;
+public:
+  // Partial Hessian accumulated by this body
+  SymmetricBlockMatrix info;
+
+  // Create functor with constant parameters and a zeroed accumulator
+  _LinearizeIntoHessian(const NonlinearFactorGraph& graph,
+      const Values& linearizationPoint, const KeyVector& keys,
+      const SymmetricBlockMatrix& zero) :
+      nonlinearGraph_(graph), linearizationPoint_(linearizationPoint),
+      keys_(keys), info(zero) {
+  }
+  // Splitting constructor, each split accumulates into its own zeroed Hessian
+  _LinearizeIntoHessian(const _LinearizeIntoHessian& other, tbb::split) :
+      nonlinearGraph_(other.nonlinearGraph_),
+      linearizationPoint_(other.linearizationPoint_), keys_(other.keys_),
+      info(other.info) {
+    info.setZero();
+  }
+  // Operator that linearizes a given range of the factors into info
+  void operator()(const tbb::blocked_range<size_t>& blocked_range) {
+    for (size_t i = blocked_range.begin(); i != blocked_range.end(); ++i) {
+      const auto& factor = nonlinearGraph_[i];
+      if (factor && factor->sendable())
+        factor->linearize(linearizationPoint_)->updateHessian(keys_, &info);
+    }
+  }
+  // Reduce the partial Hessian of a right split into this one
+  void join(const _LinearizeIntoHessian& rhs) { info.updateFullMatrix(rhs.info); }
+};
+#endif
+
+}
+
 /* ************************************************************************* */
 HessianFactor::shared_ptr NonlinearFactorGraph::linearizeToHessianFactor(
     const Values& values, const Scatter& scatter, const Dampen& dampen) const {
@@ -319,10 +377,36 @@ HessianFactor::shared_ptr NonlinearFactorGraph::linearizeToHessianFactor(
 
   // linearize all factors straight into the Hessian
   // TODO(frank): this saves on creating the graph, but still mallocs a gaussianFactor!
-  for (const sharedFactor& nonlinearFactor : factors_) {
-    if (nonlinearFactor) {
-      const auto& gaussianFactor = nonlinearFactor->linearize(values);
-      gaussianFactor->updateHessian(hessianFactor->keys_, &hessianFactor->info_);
+#ifdef GTSAM_USE_TBB
+  TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
+
+  // Each split accumulates into its own copy of the Hessian, and the copies are
+  // summed in a fixed order, so the result does not depend on scheduling. The
+  // grain size bounds the number of copies to a few per thread.
+  const size_t nrThreads = tbb::this_task_arena::max_concurrency();
+  if (nrThreads > 1 && size() > 1) {
+    const size_t grainSize = std::max<size_t>(1, size() / (4 * nrThreads));
+    _LinearizeIntoHessian body(*this, values, hessianFactor->keys_,
+                               hessianFactor->info_);
+    tbb::parallel_deterministic_reduce(
+        tbb::blocked_range<size_t>(0, size(), grainSize), body);
+    hessianFactor->info_ = std::move(body.info);
+
+    // Linearize all non-sendable factors
+    for (const sharedFactor& nonlinearFactor : factors_) {
+      if (nonlinearFactor && !nonlinearFactor->sendable()) {
+        const auto& gaussianFactor = nonlinearFactor->linearize(values);
+        gaussianFactor->updateHessian(hessianFactor->keys_, &hessianFactor->info_);
+      }
+    }
+  } else
+#endif
+  {
+    for (const sharedFactor& nonlinearFactor : factors_) {
+      if (nonlinearFactor) {
+        const auto& gaussianFactor = nonlinearFactor->linearize(values);
+        gaussianFactor->updateHessian(hessianFactor->keys_, &hessianFactor->info_);
+      }
     }
   }
 
@@ -34,6 +34,7 @@ namespace gtsam {
 
   // Forward declarations
   class Values;
+  class FlatValues;
   class Ordering;
   class GaussianFactorGraph;
   class SymbolicFactorGraph;
@@ -103,6 +104,9 @@ namespace gtsam {
     /** unnormalized error, \f$ \sum_i 0.5 (h_i(X_i)-z)^2 / \sigma^2 \f$ in the most common case */
     double error(const Values& values) const;
 
+    /// Error at the variables of a FlatValues, see FlatValues::values()
+    double error(const FlatValues& values) const;
+
     /** Unnormalized probability. O(n) */
     double probPrime(const Values& values) const;
 
@@ -126,9 +130,20 @@ namespace gtsam {
      */
     Ordering orderingCOLAMDConstrained(const FastMap<Key, int>& constraints) const;
 
-    /// Linearize a nonlinear factor graph
+    /**
+     * Linearize a nonlinear factor graph. If a MonotonicArena::Scope is active
+     * on the calling thread, the linear factors are allocated in its arena,
+     * but their matrix buffers are not.
+     */
     std::shared_ptr<GaussianFactorGraph> linearize(const Values& linearizationPoint) const;
 
+    /**
+     * Linearize at the variables of a FlatValues, for optimization loops that
+     * retract with FlatValues::retractInPlace.
+     */
+    std::shared_ptr<GaussianFactorGraph> linearize(
+        const FlatValues& linearizationPoint) const;
+
     /// typdef for dampen functions used below
     typedef std::function<void(const std::shared_ptr<HessianFactor>& hessianFactor)> Dampen;
 
@@ -137,7 +152,9 @@ namespace gtsam {
      * into a HessianFactor. Avoids the many mallocs and pointer indirection in constructing
      * a new graph, and hence useful in case a dense solve is appropriate for your problem.
      * An optional lambda function can be used to apply damping on the filled Hessian.
-     * No parallelism is exploited, because all the factors write in the same memory.
+     * When GTSAM is built with TBB, factors are linearized in parallel, each thread
+     * accumulating into its own copy of the Hessian, and the copies are summed in a
+     * deterministic order. The result equals the serial one up to round-off.
      */
     std::shared_ptr<HessianFactor> linearizeToHessianFactor(
         const Values& values, const Dampen& dampen = nullptr) const;
@@ -148,7 +165,9 @@ namespace gtsam {
      * a new graph, and hence useful in case a dense solve is appropriate for your problem.
      * An ordering is given that still decides how the Hessian is laid out.
      * An optional lambda function can be used to apply damping on the filled Hessian.
-     * No parallelism is exploited, because all the factors write in the same memory.
+     * When GTSAM is built with TBB, factors are linearized in parallel, each thread
+     * accumulating into its own copy of the Hessian, and the copies are summed in a
+     * deterministic order. The result equals the serial one up to round-off.
      */
     std::shared_ptr<HessianFactor> linearizeToHessianFactor(
         const Values& values, const Ordering& ordering, const Dampen& dampen = nullptr) const;
@@ -19,9 +19,13 @@
 #include <gtsam/nonlinear/NonlinearOptimizer.h>
 #include <gtsam/nonlinear/internal/NonlinearOptimizerState.h>
 #include <gtsam/linear/GaussianEliminationTree.h>
+#include <gtsam/linear/GaussianEliminationStructure.h>
+#include <gtsam/linear/GaussianBayesTree.h>
 #include <gtsam/linear/VectorValues.h>
 #include <gtsam/linear/SubgraphSolver.h>
 #include <gtsam/linear/PCGSolver.h>
+#include <gtsam/linear/ImplicitSchurSolver.h>
+#include <gtsam/linear/SparseCholeskySolver.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/VectorValues.h>
 
@@ -128,6 +132,24 @@ const Values& NonlinearOptimizer::optimizeSafely() {
   }
 }
 
+/* ************************************************************************* */
+GaussianBayesTree::shared_ptr NonlinearOptimizer::eliminateMultifrontal(
+    const GaussianFactorGraph& gfg, const NonlinearOptimizerParams& params) const {
+  if (!params.ordering)
+    return gfg.eliminateMultifrontal(params.orderingType,
+                                     params.getEliminationFunction());
+  if (!params.reuseEliminationStructure && !cacheEliminationStructure_)
+    return gfg.eliminateMultifrontal(*params.ordering,
+                                     params.getEliminationFunction());
+
+  // Build the symbolic structure on first use, or if the graph changed
+  if (!eliminationStructure_ ||
+      !eliminationStructure_->matches(gfg, *params.ordering))
+    eliminationStructure_ =
+        std::make_shared<GaussianEliminationStructure>(gfg, *params.ordering);
+  return eliminationStructure_->eliminate(gfg, params.getEliminationFunction());
+}
+
 /* ************************************************************************* */
 VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
                                        const NonlinearOptimizerParams& params) const {
@@ -137,7 +159,10 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
   // Check which solver we are using
   if (params.isMultifrontal()) {
     // Multifrontal QR or Cholesky (decided by params.getEliminationFunction())
-    if (params.ordering)
+    if (params.ordering &&
+        (params.reuseEliminationStructure || cacheEliminationStructure_))
+      delta = eliminateMultifrontal(gfg, params)->optimize();
+    else if (params.ordering)
       delta = gfg.optimize(*params.ordering, params.getEliminationFunction());
     else
       delta = gfg.optimize(params.getEliminationFunction());
@@ -160,6 +185,10 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
     if (auto pcg = std::dynamic_pointer_cast<PCGSolverParameters>(
             params.iterativeParams)) {
       delta = PCGSolver(*pcg).optimize(gfg);
+    } else if (auto schur =
+                   std::dynamic_pointer_cast<ImplicitSchurSolverParameters>(
+                       params.iterativeParams)) {
+      delta = ImplicitSchurSolver(*schur).optimize(gfg);
     } else if (auto spcg =
                    std::dynamic_pointer_cast<SubgraphSolverParameters>(
                        params.iterativeParams)) {
@@ -170,6 +199,20 @@ VectorValues NonlinearOptimizer::solve(const GaussianFactorGraph& gfg,
       throw std::runtime_error(
           "NonlinearOptimizer::solve: special cg parameter type is not handled in LM solver ...");
     }
+  } else if (params.isCholmod()) {
+    // Sparse Cholesky, redoing the symbolic analysis only if the graph changed
+    if (!sparseCholesky_ || !sparseCholesky_->matches(gfg) ||
+        (params.ordering && *params.ordering != sparseCholesky_->ordering()))
+      sparseCholesky_ = std::make_shared<SparseCholeskySolver>(
+          gfg, params.ordering ? *params.ordering
+                               : Ordering::Create(params.orderingType, gfg));
+    delta = sparseCholesky_->solve(gfg);
+  } else if (params.isImplicitSchur()) {
+    // Uses the default parameters unless iterativeParams are given
+    auto schur = std::dynamic_pointer_cast<ImplicitSchurSolverParameters>(
+        params.iterativeParams);
+    delta = ImplicitSchurSolver(schur ? *schur : ImplicitSchurSolverParameters())
+                .optimize(gfg);
   } else {
     throw std::runtime_error("NonlinearOptimizer::solve: Optimization parameter is invalid");
   }
@@ -24,6 +24,9 @@
 namespace gtsam {
 
 namespace internal { struct NonlinearOptimizerState; }
+class GaussianBayesTree;
+class GaussianEliminationStructure;
+class SparseCholeskySolver;
 
 /**
  * This is the abstract interface for classes that can optimize for the
@@ -79,6 +82,17 @@ protected:
 
   std::unique_ptr<internal::NonlinearOptimizerState> state_; ///< PIMPL'd state
 
+  /// Cached symbolic elimination, see NonlinearOptimizerParams::reuseEliminationStructure
+  mutable std::shared_ptr<GaussianEliminationStructure> eliminationStructure_;
+
+  /// Cached symbolic analysis of the CHOLMOD linear solver
+  mutable std::shared_ptr<SparseCholeskySolver> sparseCholesky_;
+
+  /// Use the cached elimination structure even if the params do not ask for it,
+  /// e.g. for the lambda retries of Levenberg-Marquardt, which eliminate graphs
+  /// with the same structure. The optimizer then resets it when needed.
+  bool cacheEliminationStructure_ = false;
+
 public:
   /** A shared pointer to this class */
   using shared_ptr = std::shared_ptr<const NonlinearOptimizer>;
@@ -125,6 +139,14 @@ public:
   /** Virtual destructor */
   virtual ~NonlinearOptimizer();
 
+  /**
+   * Multifrontal elimination of a linearized graph, with params' ordering and
+   * elimination function. Reuses the cached elimination structure if
+   * params.reuseEliminationStructure is set, or the optimizer caches it itself.
+   */
+  std::shared_ptr<GaussianBayesTree> eliminateMultifrontal(
+      const GaussianFactorGraph& gfg, const NonlinearOptimizerParams& params) const;
+
   /** Default function to do linear solve, i.e. optimize a GaussianFactorGraph */
   virtual VectorValues solve(const GaussianFactorGraph &gfg,
       const NonlinearOptimizerParams& params) const;
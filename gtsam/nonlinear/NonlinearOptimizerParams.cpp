@@ -103,6 +103,9 @@ void NonlinearOptimizerParams::print(const std::string& str) const {
   case Iterative:
     std::cout << "         linear solver type: ITERATIVE\n";
     break;
+  case IMPLICIT_SCHUR:
+    std::cout << "         linear solver type: IMPLICIT SCHUR\n";
+    break;
   default:
     std::cout << "         linear solver type: (invalid)\n";
     break;
@@ -120,6 +123,9 @@ void NonlinearOptimizerParams::print(const std::string& str) const {
     break;
   }
 
+  std::cout << "reuse elimination structure: "
+            << (reuseEliminationStructure ? "true" : "false") << "\n";
+
   std::cout.flush();
 }
 
@@ -139,6 +145,8 @@ std::string NonlinearOptimizerParams::linearSolverTranslator(
     return "ITERATIVE";
   case CHOLMOD:
     return "CHOLMOD";
+  case IMPLICIT_SCHUR:
+    return "IMPLICIT_SCHUR";
   default:
     throw std::invalid_argument(
         "Unknown linear solver type in SuccessiveLinearizationOptimizer");
@@ -160,6 +168,8 @@ NonlinearOptimizerParams::LinearSolverType NonlinearOptimizerParams::linearSolve
     return Iterative;
   if (linearSolverType == "CHOLMOD")
     return CHOLMOD;
+  if (linearSolverType == "IMPLICIT_SCHUR")
+    return IMPLICIT_SCHUR;
   throw std::invalid_argument(
       "Unknown linear solver type in SuccessiveLinearizationOptimizer");
 }
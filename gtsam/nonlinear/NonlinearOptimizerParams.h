@@ -101,12 +101,20 @@ public:
     SEQUENTIAL_CHOLESKY,
     SEQUENTIAL_QR,
     Iterative, /* Experimental Flag */
-    CHOLMOD, /* Experimental Flag */
+    CHOLMOD, ///< Block-supernodal sparse Cholesky, see SparseCholeskySolver
+    IMPLICIT_SCHUR, ///< Conjugate gradient on the Schur complement, see ImplicitSchurSolver
   };
 
   LinearSolverType linearSolverType = MULTIFRONTAL_CHOLESKY; ///< The type of linear solver to use in the nonlinear optimizer
   std::optional<Ordering> ordering; ///< The optional variable elimination ordering, or empty to use COLAMD (default: empty)
-  IterativeOptimizationParameters::shared_ptr iterativeParams; ///< The container for iterativeOptimization parameters. used in CG Solvers.
+  IterativeOptimizationParameters::shared_ptr iterativeParams; ///< The container for iterativeOptimization parameters. used in CG Solvers, and by IMPLICIT_SCHUR if it holds ImplicitSchurSolverParameters.
+
+  /** If true, multifrontal solvers build the elimination and junction tree
+   * only once, and re-fill it with the newly linearized factors in later
+   * iterations. Requires an ordering, and that the linearized graph keeps the
+   * same factor layout between iterations, otherwise the structure is rebuilt
+   * (default: false). */
+  bool reuseEliminationStructure = false;
 
   NonlinearOptimizerParams() = default;
   virtual ~NonlinearOptimizerParams() {
@@ -143,6 +151,10 @@ public:
     return (linearSolverType == Iterative);
   }
 
+  inline bool isImplicitSchur() const {
+    return (linearSolverType == IMPLICIT_SCHUR);
+  }
+
   GaussianFactorGraph::Eliminate getEliminationFunction() const {
     switch (linearSolverType) {
     case MULTIFRONTAL_CHOLESKY:
@@ -169,6 +181,9 @@ public:
 
   void setIterativeParams(const std::shared_ptr<IterativeOptimizationParameters> params);
 
+  bool getReuseEliminationStructure() const { return reuseEliminationStructure; }
+  void setReuseEliminationStructure(bool value) { reuseEliminationStructure = value; }
+
   void setOrdering(const Ordering& ordering) {
     this->ordering = ordering;
     this->orderingType = Ordering::CUSTOM;
@@ -48,6 +48,8 @@ struct LevenbergMarquardtState : public NonlinearOptimizerState {
   int totalNumberInnerIterations;  ///< The total number of inner iterations in the
                                    // optimization (for each iteration, LM tries multiple
                                    // inner iterations with different lambdas)
+  int rejectedSteps = 0;  ///< Number of times lambda was increased in the last
+                         // outer iteration
 
   LevenbergMarquardtState(const Values& initialValues, double _error, double _lambda,
                           double currentFactor, unsigned int _iterations = 0,
@@ -70,6 +72,7 @@ struct LevenbergMarquardtState : public NonlinearOptimizerState {
   void increaseLambda(const LevenbergMarquardtParams& params) {
     lambda *= currentFactor;
     totalNumberInnerIterations += 1;
+    rejectedSteps += 1;
     if (!params.useFixedLambdaFactor) {
       currentFactor *= 2.0;
     }
@@ -89,8 +92,11 @@ struct LevenbergMarquardtState : public NonlinearOptimizerState {
       newFactor = 2.0 * currentFactor;
     }
     newLambda = std::max(params.lambdaLowerBound, newLambda);
-    return std::unique_ptr<This>(new This(std::move(newValues), newError, newLambda, newFactor,
-                                          iterations + 1, totalNumberInnerIterations + 1));
+    std::unique_ptr<This> newState(new This(std::move(newValues), newError, newLambda,
+                                            newFactor, iterations + 1,
+                                            totalNumberInnerIterations + 1));
+    newState->rejectedSteps = rejectedSteps;
+    return newState;
   }
 
   /** Small struct to cache objects needed for damping.
@@ -0,0 +1,199 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testFlatValues.cpp
+ * @brief Unit tests for FlatValues
+ */
+
+#include <gtsam/nonlinear/FlatValues.h>
+#include <gtsam/nonlinear/GaussNewtonOptimizer.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+static Values createValues() {
+  Values values;
+  values.insert(X(0), Pose3());
+  values.insert(L(1), Point3(1, 2, 3));
+  values.insert(X(1), Pose3(Rot3::RzRyRx(0.1, 0.2, 0.3), Point3(4, 5, 6)));
+  values.insert(L(0), Point3(-1, 0, 2));
+  values.insert(X(2), Pose2(1, 2, 0.3));  // not registered below
+  return values;
+}
+
+/* ************************************************************************* */
+TEST(FlatValues, FromValues) {
+  const Values values = createValues();
+  const auto flat = FlatValues::FromValues<Pose3, Point3>(values);
+
+  LONGS_EQUAL(5, flat.size());
+  LONGS_EQUAL(3, flat.nrBlocks());  // Pose3, Point3, and generic fallback
+  EXPECT(assert_container_equality(values.keys(), flat.keys()));
+  LONGS_EQUAL(values.dim(), flat.dim());
+
+  EXPECT(assert_equal(values.at<Pose3>(X(1)), flat.at<Pose3>(X(1))));
+  EXPECT(assert_equal(values.at<Point3>(L(0)), flat.at<Point3>(L(0))));
+  EXPECT(assert_equal(values.at<Pose2>(X(2)), flat.at<Pose2>(X(2))));
+
+  // Variables of the same type share a block
+  EXPECT(flat.slot(X(0)).block == flat.slot(X(1)).block);
+  EXPECT(flat.slot(L(0)).block != flat.slot(X(0)).block);
+
+  EXPECT(assert_equal(values, flat.values()));
+}
+
+/* ************************************************************************* */
+TEST(FlatValues, Insert) {
+  FlatValues flat;
+  flat.insert(X(1), Pose2(1, 2, 3));
+  flat.insert(X(0), Pose2(4, 5, 6));
+  flat.insert(L(0), Point3(1, 1, 1));
+
+  LONGS_EQUAL(3, flat.size());
+  LONGS_EQUAL(2, flat.nrBlocks());
+  EXPECT(flat.exists(X(0)));
+  EXPECT(!flat.exists(X(2)));
+  EXPECT(assert_equal(Pose2(4, 5, 6), flat.at<Pose2>(X(0))));
+
+  // Keys are kept sorted regardless of insertion order
+  const KeyVector expectedKeys{L(0), X(0), X(1)};
+  EXPECT(assert_container_equality(expectedKeys, flat.keys()));
+
+  CHECK_EXCEPTION(flat.insert(X(0), Pose2()), ValuesKeyAlreadyExists);
+  CHECK_EXCEPTION(flat.at<Pose2>(X(2)), ValuesKeyDoesNotExist);
+  CHECK_EXCEPTION(flat.at<Pose3>(X(0)), ValuesIncorrectType);
+}
+
+/* ************************************************************************* */
+TEST(FlatValues, Retract) {
+  const Values values = createValues();
+  auto flat = FlatValues::FromValues<Pose3, Point3>(values);
+
+  VectorValues delta = values.zeroVectors();
+  delta[X(0)] << 0.1, -0.2, 0.3, 1, 2, 3;
+  delta[L(1)] << 0.5, 0.5, -0.5;
+  delta[X(2)] << 0.1, 0.2, -0.1;
+
+  const Values expected = values.retract(delta);
+  EXPECT(assert_equal(expected, flat.retract(delta).values()));
+
+  flat.retractInPlace(delta);
+  EXPECT(assert_equal(expected, flat.values()));
+
+  // Retracting only part of the variables leaves the others untouched
+  VectorValues partial;
+  partial.insert(L(0), Vector3(1, 1, 1));
+  flat.retractInPlace(partial);
+  EXPECT(assert_equal(Point3(0, 1, 3), flat.at<Point3>(L(0))));
+  EXPECT(assert_equal(expected.at<Pose3>(X(0)), flat.at<Pose3>(X(0))));
+}
+
+/* ************************************************************************* */
+TEST(FlatValues, LocalCoordinates) {
+  const Values values = createValues();
+  VectorValues delta = values.zeroVectors();
+  delta[X(1)] << 0.1, -0.2, 0.3, 1, 2, 3;
+  delta[L(0)] << 0.5, 0.5, -0.5;
+  delta[X(2)] << 0.1, 0.2, -0.1;
+
+  const auto flat = FlatValues::FromValues<Pose3, Point3>(values);
+  const auto retracted = flat.retract(delta);
+  EXPECT(assert_equal(delta, flat.localCoordinates(retracted)));
+  EXPECT(assert_equal(values.localCoordinates(retracted.values()),
+                      flat.localCoordinates(retracted)));
+
+  FlatValues other;
+  other.insert(X(0), Pose3());
+  CHECK_EXCEPTION(flat.localCoordinates(other), DynamicValuesMismatched);
+}
+
+/* ************************************************************************* */
+TEST(FlatValues, UpdateAndCopy) {
+  Values values = createValues();
+  const auto flat = FlatValues::FromValues<Pose3, Point3>(values);
+
+  // Copies are deep
+  FlatValues copy = flat;
+  VectorValues delta;
+  delta.insert(L(1), Vector3(1, 0, 0));
+  copy.retractInPlace(delta);
+  EXPECT(!flat.equals(copy));
+  EXPECT(assert_equal(Point3(1, 2, 3), flat.at<Point3>(L(1))));
+
+  // Write the updated values back into the Values
+  copy.update(values);
+  EXPECT(assert_equal(Point3(2, 2, 3), values.at<Point3>(L(1))));
+  EXPECT(assert_equal(copy.values(), values));
+}
+
+/* ************************************************************************* */
+TEST(FlatValues, ValuesStayInSync) {
+  const Values values = createValues();
+  VectorValues delta;
+  delta.insert(X(1), (Vector6() << 0.1, -0.2, 0.3, 1, 2, 3).finished());
+  delta.insert(X(2), Vector3(0.1, 0.2, -0.1));
+  const Values expected = values.retract(delta);
+
+  // Copies, moves and assignments all write through to their own Values
+  const auto flat = FlatValues::FromValues<Pose3, Point3>(values);
+  FlatValues copy(flat), assigned, moved{FlatValues(flat)};
+  assigned = flat;
+  for (FlatValues* other : {&copy, &assigned, &moved}) {
+    other->retractInPlace(delta);
+    EXPECT(assert_equal(expected, other->values()));
+  }
+  assigned = std::move(copy);
+  assigned.retractInPlace(delta);
+  EXPECT(assert_equal(expected.retract(delta), assigned.values()));
+  EXPECT(assert_equal(values, flat.values()));
+}
+
+/* ************************************************************************* */
+TEST(FlatValues, Optimize) {
+  NonlinearFactorGraph graph;
+  const auto noise = noiseModel::Isotropic::Sigma(3, 0.1);
+  graph.addPrior(X(0), Pose2(), noise);
+  graph.emplace_shared<BetweenFactor<Pose2>>(X(0), X(1), Pose2(1, 0, 0.5), noise);
+  graph.emplace_shared<BetweenFactor<Pose2>>(X(1), X(2), Pose2(1, 0, 0.5), noise);
+  graph.emplace_shared<BetweenFactor<Pose2>>(X(2), X(0), Pose2(-1, 1, -1), noise);
+  Values initial;
+  initial.insert(X(0), Pose2(0.1, 0.2, 0.1));
+  initial.insert(X(1), Pose2(1.2, 0.1, 0.4));
+  initial.insert(X(2), Pose2(1.5, 1.1, 1.2));
+  const Values expected = GaussNewtonOptimizer(graph, initial).optimize();
+
+  // Gauss-Newton on FlatValues, linearizing and retracting in place
+  auto flat = FlatValues::FromValues<Pose2>(initial);
+  EXPECT_DOUBLES_EQUAL(graph.error(initial), graph.error(flat), 1e-9);
+  for (size_t iteration = 0; iteration < 10; ++iteration)
+    flat.retractInPlace(graph.linearize(flat)->optimize());
+  EXPECT(assert_equal(expected, flat.values(), 1e-5));
+  EXPECT_DOUBLES_EQUAL(graph.error(expected), graph.error(flat), 1e-4);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -19,7 +19,7 @@
 
 #include <gtsam/base/Testable.h>
 #include <gtsam/base/Lie.h>
-#include <gtsam/nonlinear/NonlinearFactor.h>
+#include <gtsam/nonlinear/FixedSizeNoiseModelFactor.h>
 
 #ifdef _WIN32
 #define BETWEENFACTOR_VISIBILITY
@@ -37,7 +37,8 @@ namespace gtsam {
    * @ingroup slam
    */
   template<class VALUE>
-  class BetweenFactor: public NoiseModelFactorN<VALUE, VALUE> {
+  class BetweenFactor
+      : public FixedSizeNoiseModelFactorN<traits<VALUE>::dimension, VALUE, VALUE> {
 
     // Check that VALUE type is a testable Lie group
     GTSAM_CONCEPT_ASSERT(IsTestable<VALUE>);
@@ -50,7 +51,10 @@ namespace gtsam {
   private:
 
     typedef BetweenFactor<VALUE> This;
-    typedef NoiseModelFactorN<VALUE, VALUE> Base;
+    typedef FixedSizeNoiseModelFactorN<traits<VALUE>::dimension, VALUE, VALUE>
+        Base;
+    typedef typename Base::ErrorVector ErrorVector;
+    typedef typename Base::template JacobianType<VALUE> Jacobian;
 
     VALUE measured_; /** The measurement */
 
@@ -108,13 +112,13 @@ namespace gtsam {
     /// @{
 
     /// evaluate error, returns vector of errors size of tangent space
-    Vector evaluateError(const T& p1, const T& p2,
-			OptionalMatrixType H1, OptionalMatrixType H2) const override {
+    ErrorVector evaluateErrorFixed(const T& p1, const T& p2, Jacobian H1,
+                                   Jacobian H2) const override {
       T hx = traits<T>::Between(p1, p2, H1, H2); // h(x)
       // manifold equivalent of h(x)-z -> log(z,h(x))
 #ifdef GTSAM_SLOW_BUT_CORRECT_BETWEENFACTOR
       typename traits<T>::ChartJacobian::Jacobian Hlocal;
-      Vector rval = traits<T>::Local(measured_, hx, OptionalNone, (H1 || H2) ? &Hlocal : 0);
+      ErrorVector rval = traits<T>::Local(measured_, hx, OptionalNone, (H1 || H2) ? &Hlocal : 0);
       if (H1) *H1 = Hlocal * (*H1);
       if (H2) *H2 = Hlocal * (*H2);
       return rval;
@@ -142,7 +146,7 @@ namespace gtsam {
     void serialize(ARCHIVE & ar, const unsigned int /*version*/) {
       // NoiseModelFactor2 instead of NoiseModelFactorN for backward compatibility
       ar & boost::serialization::make_nvp("NoiseModelFactor2",
-          boost::serialization::base_object<Base>(*this));
+          boost::serialization::base_object<NoiseModelFactorN<VALUE, VALUE>>(*this));
       ar & BOOST_SERIALIZATION_NVP(measured_);
     }
 #endif
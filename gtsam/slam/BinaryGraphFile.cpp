@@ -0,0 +1,892 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file BinaryGraphFile.cpp
+ * @brief Versioned binary file format for factor graphs and Values, which is
+ * memory-mapped and decoded lazily
+ */
+
+#include <gtsam/slam/BinaryGraphFile.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/geometry/Cal3_S2Stereo.h>
+#include <gtsam/geometry/StereoPoint2.h>
+#include <gtsam/nonlinear/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/slam/ProjectionFactor.h>
+#include <gtsam/slam/StereoFactor.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <typeinfo>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gtsam {
+
+namespace {
+
+// Record types. These numbers are part of the file format: never change them,
+// only add new ones.
+enum RecordType : uint32_t {
+  kNullFactor = 0,
+  // Values
+  kPoint2 = 1,
+  kPoint3 = 2,
+  kPose2 = 3,
+  kPose3 = 4,
+  kRot3 = 5,
+  kCal3_S2 = 6,
+  kCal3Bundler = 7,
+  kSfmCamera = 8,
+  // Factors
+  kPriorPoint2 = 100,
+  kPriorPoint3 = 101,
+  kPriorPose2 = 102,
+  kPriorPose3 = 103,
+  kPriorSfmCamera = 104,
+  kBetweenPoint2 = 200,
+  kBetweenPoint3 = 201,
+  kBetweenPose2 = 202,
+  kBetweenPose3 = 203,
+  kProjectionPose3Point3Cal3_S2 = 300,
+  kGeneralSFMCal3Bundler = 301,
+  kStereoPose3Point3 = 302
+};
+
+// Record flags: the noise model kind, its robust kernel, and factor options
+enum : uint32_t {
+  kNoiseMask = 0xF,
+  kKernelShift = 4,
+  kKernelMask = 0xF << kKernelShift,
+  kScalarReweight = 1 << 8,
+  kBodyPSensor = 1 << 16,
+  kThrowCheirality = 1 << 17,
+  kVerboseCheirality = 1 << 18
+};
+
+enum NoiseKind : uint32_t {
+  kNoNoise = 0,
+  kUnit = 1,
+  kIsotropic = 2,
+  kDiagonal = 3,
+  kConstrained = 4,
+  kGaussian = 5
+};
+
+enum KernelKind : uint32_t { kNoKernel = 0, kHuber = 1, kTukey = 2 };
+
+const char kMagic[8] = {'G', 'T', 'S', 'A', 'M', 'B', 'I', 'N'};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t nrValues, nrFactors;
+  uint64_t valueKeysOffset, valueOffsetsOffset, factorOffsetsOffset;
+  uint64_t fileSize;
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+
+struct RecordHeader {
+  uint32_t type, flags, nrKeys, nrDoubles;
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader must be 16 bytes");
+
+/// A record in the mapped file, keys and data point into the mapping
+struct Record {
+  RecordHeader header;
+  const Key* keys;
+  const double* data;
+};
+
+bool isLittleEndian() {
+  const uint32_t one = 1;
+  char first;
+  std::memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+[[noreturn]] void corrupt(const std::string& what) {
+  throw std::runtime_error("BinaryGraphFile: corrupt file, " + what);
+}
+
+/* ************************************************************************* */
+// Fixed-size encoding of the supported types as doubles
+template <class T>
+struct Codec;
+
+template <>
+struct Codec<Point2> {
+  static constexpr size_t size = 2;
+  static void write(const Point2& p, double* d) {
+    d[0] = p.x();
+    d[1] = p.y();
+  }
+  static Point2 read(const double* d) { return Point2(d[0], d[1]); }
+};
+
+template <>
+struct Codec<Point3> {
+  static constexpr size_t size = 3;
+  static void write(const Point3& p, double* d) {
+    d[0] = p.x();
+    d[1] = p.y();
+    d[2] = p.z();
+  }
+  static Point3 read(const double* d) { return Point3(d[0], d[1], d[2]); }
+};
+
+template <>
+struct Codec<Pose2> {
+  static constexpr size_t size = 3;
+  static void write(const Pose2& p, double* d) {
+    d[0] = p.x();
+    d[1] = p.y();
+    d[2] = p.theta();
+  }
+  static Pose2 read(const double* d) { return Pose2(d[0], d[1], d[2]); }
+};
+
+// Rotation matrix in row-major order
+template <>
+struct Codec<Rot3> {
+  static constexpr size_t size = 9;
+  static void write(const Rot3& R, double* d) {
+    Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor>> m(d);
+    m = R.matrix();
+  }
+  static Rot3 read(const double* d) {
+    return Rot3(Matrix3(
+        Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>(d)));
+  }
+};
+
+template <>
+struct Codec<Pose3> {
+  static constexpr size_t size = 12;
+  static void write(const Pose3& p, double* d) {
+    Codec<Rot3>::write(p.rotation(), d);
+    Codec<Point3>::write(p.translation(), d + 9);
+  }
+  static Pose3 read(const double* d) {
+    return Pose3(Codec<Rot3>::read(d), Codec<Point3>::read(d + 9));
+  }
+};
+
+template <>
+struct Codec<Cal3_S2> {
+  static constexpr size_t size = 5;
+  static void write(const Cal3_S2& K, double* d) {
+    Vector5::Map(d) = K.vector();
+  }
+  static Cal3_S2 read(const double* d) {
+    return Cal3_S2(d[0], d[1], d[2], d[3], d[4]);
+  }
+};
+
+template <>
+struct Codec<Cal3_S2Stereo> {
+  static constexpr size_t size = 6;
+  static void write(const Cal3_S2Stereo& K, double* d) {
+    Vector6::Map(d) = K.vector();
+  }
+  static Cal3_S2Stereo read(const double* d) {
+    return Cal3_S2Stereo(d[0], d[1], d[2], d[3], d[4], d[5]);
+  }
+};
+
+template <>
+struct Codec<Cal3Bundler> {
+  static constexpr size_t size = 5;
+  static void write(const Cal3Bundler& K, double* d) {
+    d[0] = K.fx();
+    d[1] = K.k1();
+    d[2] = K.k2();
+    d[3] = K.px();
+    d[4] = K.py();
+  }
+  static Cal3Bundler read(const double* d) {
+    return Cal3Bundler(d[0], d[1], d[2], d[3], d[4]);
+  }
+};
+
+template <>
+struct Codec<SfmCamera> {
+  static constexpr size_t size = 17;
+  static void write(const SfmCamera& camera, double* d) {
+    Codec<Pose3>::write(camera.pose(), d);
+    Codec<Cal3Bundler>::write(camera.calibration(), d + 12);
+  }
+  static SfmCamera read(const double* d) {
+    return SfmCamera(Codec<Pose3>::read(d), Codec<Cal3Bundler>::read(d + 12));
+  }
+};
+
+template <>
+struct Codec<StereoPoint2> {
+  static constexpr size_t size = 3;
+  static void write(const StereoPoint2& p, double* d) {
+    d[0] = p.uL();
+    d[1] = p.uR();
+    d[2] = p.v();
+  }
+  static StereoPoint2 read(const double* d) {
+    return StereoPoint2(d[0], d[1], d[2]);
+  }
+};
+
+/// Append the encoding of x to data
+template <class T>
+void append(const T& x, std::vector<double>* data) {
+  const size_t start = data->size();
+  data->resize(start + Codec<T>::size);
+  Codec<T>::write(x, data->data() + start);
+}
+
+/* ************************************************************************* */
+// Encoding of values, factors and noise models into records
+
+/// Type, flags and doubles of a record being written
+struct Encoded {
+  uint32_t type = kNullFactor;
+  uint32_t flags = 0;
+  std::vector<double> data;
+};
+
+template <class T>
+bool encodeValue(uint32_t type, const Value& value, Encoded* encoded) {
+  const auto generic = dynamic_cast<const GenericValue<T>*>(&value);
+  if (!generic) return false;
+  encoded->type = type;
+  append(generic->value(), &encoded->data);
+  return true;
+}
+
+uint32_t encodeNoiseModel(const SharedNoiseModel& model,
+                          std::vector<double>* data) {
+  using namespace noiseModel;
+  if (!model) return kNoNoise;
+
+  if (const auto robust = std::dynamic_pointer_cast<Robust>(model)) {
+    uint32_t flags = encodeNoiseModel(robust->noise(), data);
+    const auto& kernel = robust->robust();
+    if (const auto huber =
+            std::dynamic_pointer_cast<mEstimator::Huber>(kernel)) {
+      flags |= kHuber << kKernelShift;
+      data->push_back(huber->modelParameter());
+    } else if (const auto tukey =
+                   std::dynamic_pointer_cast<mEstimator::Tukey>(kernel)) {
+      flags |= kTukey << kKernelShift;
+      data->push_back(tukey->modelParameter());
+    } else {
+      throw std::invalid_argument(
+          "writeBinaryGraph: unsupported robust kernel");
+    }
+    if (kernel->reweightScheme() == mEstimator::Base::Scalar)
+      flags |= kScalarReweight;
+    return flags;
+  }
+
+  // Check derived classes before their bases
+  if (std::dynamic_pointer_cast<Unit>(model)) return kUnit;
+  if (const auto isotropic = std::dynamic_pointer_cast<Isotropic>(model)) {
+    data->push_back(isotropic->sigma());
+    return kIsotropic;
+  }
+  if (const auto constrained = std::dynamic_pointer_cast<Constrained>(model)) {
+    const Vector& sigmas = constrained->sigmas();
+    const Vector& mu = constrained->mu();
+    data->insert(data->end(), sigmas.data(), sigmas.data() + sigmas.size());
+    data->insert(data->end(), mu.data(), mu.data() + mu.size());
+    return kConstrained;
+  }
+  if (const auto diagonal = std::dynamic_pointer_cast<Diagonal>(model)) {
+    const Vector sigmas = diagonal->sigmas();
+    data->insert(data->end(), sigmas.data(), sigmas.data() + sigmas.size());
+    return kDiagonal;
+  }
+  if (const auto gaussian = std::dynamic_pointer_cast<Gaussian>(model)) {
+    const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        R = gaussian->R();
+    data->insert(data->end(), R.data(), R.data() + R.size());
+    return kGaussian;
+  }
+  throw std::invalid_argument("writeBinaryGraph: unsupported noise model");
+}
+
+template <class T>
+bool encodePrior(uint32_t type, const NonlinearFactor& factor,
+                 Encoded* encoded) {
+  const auto prior = dynamic_cast<const PriorFactor<T>*>(&factor);
+  if (!prior) return false;
+  encoded->type = type;
+  append(prior->prior(), &encoded->data);
+  encoded->flags = encodeNoiseModel(prior->noiseModel(), &encoded->data);
+  return true;
+}
+
+template <class T>
+bool encodeBetween(uint32_t type, const NonlinearFactor& factor,
+                   Encoded* encoded) {
+  const auto between = dynamic_cast<const BetweenFactor<T>*>(&factor);
+  if (!between) return false;
+  encoded->type = type;
+  append(between->measured(), &encoded->data);
+  encoded->flags = encodeNoiseModel(between->noiseModel(), &encoded->data);
+  return true;
+}
+
+/// Flags and doubles shared by projection and stereo factors
+template <class FACTOR>
+void encodeCameraFactor(const FACTOR& factor, Encoded* encoded) {
+  append(factor.measured(), &encoded->data);
+  append(*factor.calibration(), &encoded->data);
+  if (factor.body_P_sensor()) {
+    encoded->flags |= kBodyPSensor;
+    append(*factor.body_P_sensor(), &encoded->data);
+  }
+  if (factor.throwCheirality()) encoded->flags |= kThrowCheirality;
+  if (factor.verboseCheirality()) encoded->flags |= kVerboseCheirality;
+  encoded->flags |= encodeNoiseModel(factor.noiseModel(), &encoded->data);
+}
+
+void encodeFactor(const NonlinearFactor& factor, Encoded* encoded) {
+  using Projection = GenericProjectionFactor<Pose3, Point3, Cal3_S2>;
+  using Stereo = GenericStereoFactor<Pose3, Point3>;
+  using GeneralSFM = GeneralSFMFactor<SfmCamera, Point3>;
+
+  if (encodePrior<Point2>(kPriorPoint2, factor, encoded) ||
+      encodePrior<Point3>(kPriorPoint3, factor, encoded) ||
+      encodePrior<Pose2>(kPriorPose2, factor, encoded) ||
+      encodePrior<Pose3>(kPriorPose3, factor, encoded) ||
+      encodePrior<SfmCamera>(kPriorSfmCamera, factor, encoded) ||
+      encodeBetween<Point2>(kBetweenPoint2, factor, encoded) ||
+      encodeBetween<Point3>(kBetweenPoint3, factor, encoded) ||
+      encodeBetween<Pose2>(kBetweenPose2, factor, encoded) ||
+      encodeBetween<Pose3>(kBetweenPose3, factor, encoded))
+    return;
+
+  if (const auto projection = dynamic_cast<const Projection*>(&factor)) {
+    encoded->type = kProjectionPose3Point3Cal3_S2;
+    encodeCameraFactor(*projection, encoded);
+  } else if (const auto stereo = dynamic_cast<const Stereo*>(&factor)) {
+    encoded->type = kStereoPose3Point3;
+    encodeCameraFactor(*stereo, encoded);
+  } else if (const auto sfm = dynamic_cast<const GeneralSFM*>(&factor)) {
+    encoded->type = kGeneralSFMCal3Bundler;
+    append(sfm->measured(), &encoded->data);
+    encoded->flags = encodeNoiseModel(sfm->noiseModel(), &encoded->data);
+  } else {
+    throw std::invalid_argument("writeBinaryGraph: unsupported factor type " +
+                                std::string(typeid(factor).name()));
+  }
+}
+
+/// Byte buffer of the file being written
+class Writer {
+ public:
+  std::vector<char> bytes;
+
+  template <class T>
+  void append(const T* p, size_t n) {
+    const char* c = reinterpret_cast<const char*>(p);
+    bytes.insert(bytes.end(), c, c + n * sizeof(T));
+  }
+
+  /// Append a record, and return its offset
+  uint64_t record(const Encoded& encoded, const KeyVector& keys) {
+    const uint64_t offset = bytes.size();
+    const RecordHeader header{encoded.type, encoded.flags,
+                              static_cast<uint32_t>(keys.size()),
+                              static_cast<uint32_t>(encoded.data.size())};
+    append(&header, 1);
+    append(keys.data(), keys.size());
+    append(encoded.data.data(), encoded.data.size());
+    return offset;
+  }
+};
+
+/* ************************************************************************* */
+// Decoding of records into values, factors and noise models
+
+Record recordAt(const char* data, size_t size, uint64_t offset) {
+  if (offset % 8 != 0 || offset + sizeof(RecordHeader) > size)
+    corrupt("record offset out of range");
+  Record record;
+  std::memcpy(&record.header, data + offset, sizeof(RecordHeader));
+  const uint64_t keysOffset = offset + sizeof(RecordHeader);
+  const uint64_t dataOffset = keysOffset + 8 * uint64_t(record.header.nrKeys);
+  if (dataOffset + 8 * uint64_t(record.header.nrDoubles) > size)
+    corrupt("record extends past the end of the file");
+  // Records are 8 byte aligned, and so are the mapping and the buffer
+  record.keys = reinterpret_cast<const Key*>(data + keysOffset);
+  record.data = reinterpret_cast<const double*>(data + dataOffset);
+  return record;
+}
+
+void checkRecord(const Record& record, uint32_t nrKeys, size_t minDoubles) {
+  if (record.header.nrKeys != nrKeys || record.header.nrDoubles < minDoubles)
+    corrupt("unexpected record size for type " +
+            std::to_string(record.header.type));
+}
+
+template <class T>
+void decodeValue(const Record& record, Values* values) {
+  checkRecord(record, 1, Codec<T>::size);
+  values->insert(record.keys[0], Codec<T>::read(record.data));
+}
+
+/**
+ * Decodes factor records. Consecutive factors with identical noise models or
+ * calibrations, as written for a whole dataset, share a single object.
+ */
+class FactorDecoder {
+  uint32_t noiseFlags_ = 0;
+  size_t noiseDim_ = 0;
+  std::vector<double> noiseData_;
+  SharedNoiseModel noiseModel_;
+
+  Cal3_S2::shared_ptr K_;
+  Cal3_S2Stereo::shared_ptr stereoK_;
+
+  /// Noise model stored after the first `offset` doubles of the record
+  SharedNoiseModel noiseModel(const Record& record, size_t dim, size_t offset) {
+    const uint32_t flags = record.header.flags & (kNoiseMask | kKernelMask |
+                                                  kScalarReweight);
+    const double* d = record.data + offset;
+    const size_t n = record.header.nrDoubles - offset;
+    if (noiseModel_ && flags == noiseFlags_ && dim == noiseDim_ &&
+        n == noiseData_.size() && std::equal(d, d + n, noiseData_.begin()))
+      return noiseModel_;
+    noiseModel_ = decodeNoiseModel(flags, dim, d, n);
+    noiseFlags_ = flags;
+    noiseDim_ = dim;
+    noiseData_.assign(d, d + n);
+    return noiseModel_;
+  }
+
+  static SharedNoiseModel decodeNoiseModel(uint32_t flags, size_t dim,
+                                           const double* d, size_t n) {
+    using namespace noiseModel;
+    using RowMajorMatrix =
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    const uint32_t kind = flags & kNoiseMask;
+    const uint32_t kernel = (flags & kKernelMask) >> kKernelShift;
+    const size_t expected =
+        (kind == kIsotropic    ? 1
+         : kind == kDiagonal    ? dim
+         : kind == kConstrained ? 2 * dim
+         : kind == kGaussian    ? dim * dim
+                                : 0) +
+        (kernel != kNoKernel ? 1 : 0);
+    if (n != expected) corrupt("unexpected noise model size");
+
+    SharedNoiseModel model;
+    switch (kind) {
+      case kNoNoise:
+        return model;
+      case kUnit:
+        model = Unit::Create(dim);
+        break;
+      case kIsotropic:
+        model = Isotropic::Sigma(dim, d[0], false);
+        break;
+      case kDiagonal:
+        model = Diagonal::Sigmas(Eigen::Map<const Vector>(d, dim), false);
+        break;
+      case kConstrained:
+        model = Constrained::MixedSigmas(Eigen::Map<const Vector>(d + dim, dim),
+                                         Eigen::Map<const Vector>(d, dim));
+        break;
+      case kGaussian:
+        model = Gaussian::SqrtInformation(
+            Matrix(Eigen::Map<const RowMajorMatrix>(d, dim, dim)), false);
+        break;
+      default:
+        corrupt("unknown noise model " + std::to_string(kind));
+    }
+
+    if (kernel == kNoKernel) return model;
+    const auto reweight = (flags & kScalarReweight) ? mEstimator::Base::Scalar
+                                                    : mEstimator::Base::Block;
+    const double k = d[n - 1];
+    if (kernel == kHuber)
+      return Robust::Create(mEstimator::Huber::Create(k, reweight), model);
+    if (kernel == kTukey)
+      return Robust::Create(mEstimator::Tukey::Create(k, reweight), model);
+    corrupt("unknown robust kernel " + std::to_string(kernel));
+  }
+
+  template <class T>
+  NonlinearFactor::shared_ptr prior(const Record& record) {
+    checkRecord(record, 1, Codec<T>::size);
+    return std::make_shared<PriorFactor<T>>(
+        record.keys[0], Codec<T>::read(record.data),
+        noiseModel(record, traits<T>::dimension, Codec<T>::size));
+  }
+
+  template <class T>
+  NonlinearFactor::shared_ptr between(const Record& record) {
+    checkRecord(record, 2, Codec<T>::size);
+    return std::make_shared<BetweenFactor<T>>(
+        record.keys[0], record.keys[1], Codec<T>::read(record.data),
+        noiseModel(record, traits<T>::dimension, Codec<T>::size));
+  }
+
+  /// Calibration at offset, shared with the previous factor if identical
+  template <class CALIBRATION>
+  std::shared_ptr<CALIBRATION> calibration(
+      const Record& record, size_t offset,
+      std::shared_ptr<CALIBRATION>* previous) {
+    const CALIBRATION K = Codec<CALIBRATION>::read(record.data + offset);
+    if (!*previous || (*previous)->vector() != K.vector())
+      *previous = std::make_shared<CALIBRATION>(K);
+    return *previous;
+  }
+
+  /// Decode a projection or stereo factor
+  template <class FACTOR, class MEASUREMENT, class CALIBRATION>
+  NonlinearFactor::shared_ptr cameraFactor(
+      const Record& record, size_t dim,
+      std::shared_ptr<CALIBRATION>* previousK) {
+    const uint32_t flags = record.header.flags;
+    const size_t calibrationOffset = Codec<MEASUREMENT>::size;
+    const size_t poseOffset = calibrationOffset + Codec<CALIBRATION>::size;
+    const size_t noiseOffset =
+        poseOffset + ((flags & kBodyPSensor) ? Codec<Pose3>::size : 0);
+    checkRecord(record, 2, noiseOffset);
+    std::optional<Pose3> body_P_sensor;
+    if (flags & kBodyPSensor)
+      body_P_sensor = Codec<Pose3>::read(record.data + poseOffset);
+    return std::make_shared<FACTOR>(
+        Codec<MEASUREMENT>::read(record.data),
+        noiseModel(record, dim, noiseOffset), record.keys[0], record.keys[1],
+        calibration(record, calibrationOffset, previousK),
+        (flags & kThrowCheirality) != 0, (flags & kVerboseCheirality) != 0,
+        body_P_sensor);
+  }
+
+ public:
+  NonlinearFactor::shared_ptr operator()(const Record& record) {
+    switch (record.header.type) {
+      case kNullFactor:
+        return nullptr;
+      case kPriorPoint2:
+        return prior<Point2>(record);
+      case kPriorPoint3:
+        return prior<Point3>(record);
+      case kPriorPose2:
+        return prior<Pose2>(record);
+      case kPriorPose3:
+        return prior<Pose3>(record);
+      case kPriorSfmCamera:
+        return prior<SfmCamera>(record);
+      case kBetweenPoint2:
+        return between<Point2>(record);
+      case kBetweenPoint3:
+        return between<Point3>(record);
+      case kBetweenPose2:
+        return between<Pose2>(record);
+      case kBetweenPose3:
+        return between<Pose3>(record);
+      case kProjectionPose3Point3Cal3_S2:
+        return cameraFactor<GenericProjectionFactor<Pose3, Point3, Cal3_S2>,
+                            Point2>(record, 2, &K_);
+      case kStereoPose3Point3:
+        return cameraFactor<GenericStereoFactor<Pose3, Point3>, StereoPoint2>(
+            record, 3, &stereoK_);
+      case kGeneralSFMCal3Bundler:
+        checkRecord(record, 2, Codec<Point2>::size);
+        return std::make_shared<GeneralSFMFactor<SfmCamera, Point3>>(
+            Codec<Point2>::read(record.data),
+            noiseModel(record, 2, Codec<Point2>::size), record.keys[0],
+            record.keys[1]);
+      default:
+        corrupt("unknown factor type " + std::to_string(record.header.type));
+    }
+  }
+};
+
+}  // namespace
+
+/* ************************************************************************* */
+BinaryGraphFile::BinaryGraphFile(const std::string& filename) {
+  if (!isLittleEndian())
+    throw std::runtime_error(
+        "BinaryGraphFile: only little-endian platforms are supported");
+
+#ifndef _WIN32
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("BinaryGraphFile: cannot open " + filename);
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    ::close(fd);
+    throw std::runtime_error("BinaryGraphFile: cannot stat " + filename);
+  }
+  size_ = status.st_size;
+  if (size_ > 0) {
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+      throw std::runtime_error("BinaryGraphFile: cannot map " + filename);
+    data_ = static_cast<const char*>(mapping);
+  } else {
+    ::close(fd);
+  }
+#else
+  std::ifstream is(filename.c_str(), std::ios::binary);
+  if (!is) throw std::runtime_error("BinaryGraphFile: cannot open " + filename);
+  buffer_.assign(std::istreambuf_iterator<char>(is),
+                 std::istreambuf_iterator<char>());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#endif
+
+  try {
+    FileHeader header;
+    if (size_ < sizeof(FileHeader)) corrupt("file too small");
+    std::memcpy(&header, data_, sizeof(FileHeader));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+      throw std::runtime_error("BinaryGraphFile: " + filename +
+                               " is not a binary graph file");
+    if (header.version == 0 || header.version > kVersion)
+      throw std::runtime_error("BinaryGraphFile: unsupported format version " +
+                               std::to_string(header.version));
+    if (header.fileSize != size_) corrupt("file size does not match header");
+
+    // Every table must lie inside the file
+    auto checkTable = [this](uint64_t offset, uint64_t n) {
+      if (offset % 8 != 0 || offset > size_ || n > (size_ - offset) / 8)
+        corrupt("index table out of range");
+    };
+    checkTable(header.valueKeysOffset, header.nrValues);
+    checkTable(header.valueOffsetsOffset, header.nrValues);
+    checkTable(header.factorOffsetsOffset, header.nrFactors);
+
+    nrValues_ = header.nrValues;
+    nrFactors_ = header.nrFactors;
+    valueKeysOffset_ = header.valueKeysOffset;
+    valueOffsetsOffset_ = header.valueOffsetsOffset;
+    factorOffsetsOffset_ = header.factorOffsetsOffset;
+  } catch (...) {
+#ifndef _WIN32
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    throw;
+  }
+}
+
+/* ************************************************************************* */
+BinaryGraphFile::~BinaryGraphFile() {
+#ifndef _WIN32
+  if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+/* ************************************************************************* */
+uint32_t BinaryGraphFile::version() const {
+  FileHeader header;
+  std::memcpy(&header, data_, sizeof(FileHeader));
+  return header.version;
+}
+
+/* ************************************************************************* */
+uint64_t BinaryGraphFile::tableEntry(uint64_t table, size_t i) const {
+  uint64_t entry;
+  std::memcpy(&entry, data_ + table + 8 * i, sizeof(entry));
+  return entry;
+}
+
+/* ************************************************************************* */
+KeyVector BinaryGraphFile::factorKeys(size_t i) const {
+  if (i >= nrFactors_)
+    throw std::out_of_range("BinaryGraphFile: no factor " + std::to_string(i));
+  const Record record =
+      recordAt(data_, size_, tableEntry(factorOffsetsOffset_, i));
+  return KeyVector(record.keys, record.keys + record.header.nrKeys);
+}
+
+/* ************************************************************************* */
+NonlinearFactor::shared_ptr BinaryGraphFile::factor(size_t i) const {
+  if (i >= nrFactors_)
+    throw std::out_of_range("BinaryGraphFile: no factor " + std::to_string(i));
+  FactorDecoder decode;
+  return decode(recordAt(data_, size_, tableEntry(factorOffsetsOffset_, i)));
+}
+
+/* ************************************************************************* */
+NonlinearFactorGraph BinaryGraphFile::factors() const {
+  NonlinearFactorGraph graph;
+  graph.reserve(nrFactors_);
+  FactorDecoder decode;
+  for (size_t i = 0; i < nrFactors_; ++i)
+    graph.push_back(
+        decode(recordAt(data_, size_, tableEntry(factorOffsetsOffset_, i))));
+  return graph;
+}
+
+/* ************************************************************************* */
+KeyVector BinaryGraphFile::keys() const {
+  KeyVector keys(nrValues_);
+  std::memcpy(keys.data(), data_ + valueKeysOffset_, 8 * nrValues_);
+  return keys;
+}
+
+/* ************************************************************************* */
+size_t BinaryGraphFile::findValue(Key key) const {
+  // Binary search in the sorted key table
+  size_t first = 0, count = nrValues_;
+  while (count > 0) {
+    const size_t step = count / 2;
+    if (tableEntry(valueKeysOffset_, first + step) < key) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  if (first < nrValues_ && tableEntry(valueKeysOffset_, first) == key)
+    return first;
+  return nrValues_;
+}
+
+/* ************************************************************************* */
+bool BinaryGraphFile::exists(Key key) const {
+  return findValue(key) < nrValues_;
+}
+
+/* ************************************************************************* */
+void BinaryGraphFile::insertValue(size_t i, Values* values) const {
+  const Record record =
+      recordAt(data_, size_, tableEntry(valueOffsetsOffset_, i));
+  switch (record.header.type) {
+    case kPoint2:
+      return decodeValue<Point2>(record, values);
+    case kPoint3:
+      return decodeValue<Point3>(record, values);
+    case kPose2:
+      return decodeValue<Pose2>(record, values);
+    case kPose3:
+      return decodeValue<Pose3>(record, values);
+    case kRot3:
+      return decodeValue<Rot3>(record, values);
+    case kCal3_S2:
+      return decodeValue<Cal3_S2>(record, values);
+    case kCal3Bundler:
+      return decodeValue<Cal3Bundler>(record, values);
+    case kSfmCamera:
+      return decodeValue<SfmCamera>(record, values);
+    default:
+      corrupt("unknown value type " + std::to_string(record.header.type));
+  }
+}
+
+/* ************************************************************************* */
+Values BinaryGraphFile::values(const KeyVector& keys) const {
+  Values values;
+  for (Key key : keys) {
+    const size_t i = findValue(key);
+    if (i == nrValues_)
+      throw std::out_of_range("BinaryGraphFile: no value for key " +
+                              DefaultKeyFormatter(key));
+    insertValue(i, &values);
+  }
+  return values;
+}
+
+/* ************************************************************************* */
+Values BinaryGraphFile::values() const {
+  Values values;
+  for (size_t i = 0; i < nrValues_; ++i) insertValue(i, &values);
+  return values;
+}
+
+/* ************************************************************************* */
+void writeBinaryGraph(const NonlinearFactorGraph& graph, const Values& values,
+                      const std::string& filename) {
+  if (!isLittleEndian())
+    throw std::runtime_error(
+        "writeBinaryGraph: only little-endian platforms are supported");
+
+  Writer writer;
+  writer.bytes.resize(sizeof(FileHeader));
+
+  // Values iterate in increasing key order, which the key table relies on
+  KeyVector valueKeys;
+  std::vector<uint64_t> valueOffsets, factorOffsets;
+  valueKeys.reserve(values.size());
+  valueOffsets.reserve(values.size());
+  for (const auto& key_value : values) {
+    Encoded encoded;
+    if (!(encodeValue<Point2>(kPoint2, key_value.value, &encoded) ||
+          encodeValue<Point3>(kPoint3, key_value.value, &encoded) ||
+          encodeValue<Pose2>(kPose2, key_value.value, &encoded) ||
+          encodeValue<Pose3>(kPose3, key_value.value, &encoded) ||
+          encodeValue<Rot3>(kRot3, key_value.value, &encoded) ||
+          encodeValue<Cal3_S2>(kCal3_S2, key_value.value, &encoded) ||
+          encodeValue<Cal3Bundler>(kCal3Bundler, key_value.value, &encoded) ||
+          encodeValue<SfmCamera>(kSfmCamera, key_value.value, &encoded)))
+      throw std::invalid_argument(
+          "writeBinaryGraph: unsupported value type for key " +
+          DefaultKeyFormatter(key_value.key));
+    valueKeys.push_back(key_value.key);
+    valueOffsets.push_back(writer.record(encoded, {key_value.key}));
+  }
+
+  // Null factors are kept, so that factor indices do not change
+  factorOffsets.reserve(graph.size());
+  for (const auto& factor : graph) {
+    Encoded encoded;
+    if (factor) encodeFactor(*factor, &encoded);
+    factorOffsets.push_back(
+        writer.record(encoded, factor ? factor->keys() : KeyVector()));
+  }
+
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = BinaryGraphFile::kVersion;
+  header.reserved = 0;
+  header.nrValues = valueKeys.size();
+  header.nrFactors = factorOffsets.size();
+  header.valueKeysOffset = writer.bytes.size();
+  writer.append(valueKeys.data(), valueKeys.size());
+  header.valueOffsetsOffset = writer.bytes.size();
+  writer.append(valueOffsets.data(), valueOffsets.size());
+  header.factorOffsetsOffset = writer.bytes.size();
+  writer.append(factorOffsets.data(), factorOffsets.size());
+  header.fileSize = writer.bytes.size();
+  std::memcpy(writer.bytes.data(), &header, sizeof(FileHeader));
+
+  std::ofstream os(filename.c_str(), std::ios::binary);
+  if (!os) throw std::runtime_error("writeBinaryGraph: cannot open " + filename);
+  os.write(writer.bytes.data(), writer.bytes.size());
+  if (!os) throw std::runtime_error("writeBinaryGraph: cannot write " + filename);
+}
+
+/* ************************************************************************* */
+GraphAndValues readBinaryGraph(const std::string& filename) {
+  const BinaryGraphFile file(filename);
+  return {std::make_shared<NonlinearFactorGraph>(file.factors()),
+          std::make_shared<Values>(file.values())};
+}
+
+}  // namespace gtsam
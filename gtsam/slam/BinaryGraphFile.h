@@ -0,0 +1,135 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file BinaryGraphFile.h
+ * @brief Versioned binary file format for factor graphs and Values, which is
+ * memory-mapped and decoded lazily
+ */
+
+#pragma once
+
+#include <gtsam/slam/dataset.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * A factor graph and Values stored in the GTSAM binary graph format.
+ *
+ * The file starts with a 64 byte header (magic "GTSAMBIN", format version,
+ * number of values and factors, and the offsets of the index tables). It is
+ * followed by one record per value and per factor, and by the index tables: the
+ * sorted value keys, the value record offsets and the factor record offsets.
+ * Every record is a 16 byte header (type, flags, number of keys and number of
+ * doubles), the keys, and the doubles of the measurement, calibration and
+ * noise model. All fields are 8 byte aligned and stored in little-endian
+ * order, so decoding a record is a plain copy, without any text parsing.
+ *
+ * Opening a file only maps it into memory and validates the header. Factors
+ * and values are materialized when they are asked for, so a part of a large
+ * graph can be read without touching the rest of the file.
+ *
+ * Supported values: Point2, Point3, Pose2, Pose3, Rot3, Cal3_S2, Cal3Bundler
+ * and SfmCamera. Supported factors: PriorFactor and BetweenFactor on Point2,
+ * Point3, Pose2 and Pose3, PriorFactor on SfmCamera,
+ * GenericProjectionFactor<Pose3, Point3, Cal3_S2>,
+ * GeneralSFMFactor<SfmCamera, Point3> and GenericStereoFactor<Pose3, Point3>,
+ * with Unit, Isotropic, Diagonal, Constrained or Gaussian noise models,
+ * optionally wrapped in a Huber or Tukey robust kernel.
+ */
+class GTSAM_EXPORT BinaryGraphFile {
+ public:
+  /// Current version of the format, files with a newer version are rejected
+  static constexpr uint32_t kVersion = 1;
+
+  /**
+   * Map a binary graph file into memory.
+   * @throw std::runtime_error if the file cannot be opened, or if it is not a
+   * binary graph file of a supported version.
+   */
+  explicit BinaryGraphFile(const std::string& filename);
+
+  ~BinaryGraphFile();
+
+  BinaryGraphFile(const BinaryGraphFile&) = delete;
+  BinaryGraphFile& operator=(const BinaryGraphFile&) = delete;
+
+  /// Format version of the file
+  uint32_t version() const;
+
+  /// Number of factors in the file
+  size_t nrFactors() const { return nrFactors_; }
+
+  /// Number of values in the file
+  size_t nrValues() const { return nrValues_; }
+
+  /// Keys of factor i, without materializing it
+  KeyVector factorKeys(size_t i) const;
+
+  /// Materialize factor i
+  NonlinearFactor::shared_ptr factor(size_t i) const;
+
+  /// Materialize all factors
+  NonlinearFactorGraph factors() const;
+
+  /// Keys of all values, in increasing order
+  KeyVector keys() const;
+
+  /// Whether the file has a value for this key
+  bool exists(Key key) const;
+
+  /// Materialize the values of these keys, throws std::out_of_range if a key
+  /// has no value in the file
+  Values values(const KeyVector& keys) const;
+
+  /// Materialize all values
+  Values values() const;
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  std::vector<char> buffer_;  ///< File contents where mmap is not available
+  size_t nrValues_ = 0, nrFactors_ = 0;
+  uint64_t valueKeysOffset_ = 0, valueOffsetsOffset_ = 0,
+           factorOffsetsOffset_ = 0;
+
+  /// Offset of entry i of the table at the given offset
+  uint64_t tableEntry(uint64_t table, size_t i) const;
+
+  /// Index of the value with this key, or nrValues() if there is none
+  size_t findValue(Key key) const;
+
+  /// Decode value i into values
+  void insertValue(size_t i, Values* values) const;
+};
+
+/**
+ * Write a factor graph and Values in the binary graph format, see
+ * BinaryGraphFile.
+ * @throw std::invalid_argument if a factor, value or noise model has a type
+ * that the format does not support.
+ */
+GTSAM_EXPORT void writeBinaryGraph(const NonlinearFactorGraph& graph,
+                                   const Values& values,
+                                   const std::string& filename);
+
+/**
+ * Read all factors and values of a binary graph file, see BinaryGraphFile.
+ * @param filename The name of the binary graph file
+ * @return graph and initial values
+ */
+GTSAM_EXPORT GraphAndValues readBinaryGraph(const std::string& filename);
+
+}  // namespace gtsam
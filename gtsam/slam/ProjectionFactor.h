@@ -20,7 +20,7 @@
 
 #pragma once
 
-#include <gtsam/nonlinear/NonlinearFactor.h>
+#include <gtsam/nonlinear/FixedSizeNoiseModelFactor.h>
 #include <gtsam/geometry/PinholeCamera.h>
 #include <gtsam/geometry/Pose3.h>
 #include <gtsam/geometry/Point3.h>
@@ -37,7 +37,8 @@ namespace gtsam {
    */
   template <class POSE = Pose3, class LANDMARK = Point3,
             class CALIBRATION = Cal3_S2>
-  class GenericProjectionFactor: public NoiseModelFactorN<POSE, LANDMARK> {
+  class GenericProjectionFactor
+      : public FixedSizeNoiseModelFactorN<2, POSE, LANDMARK> {
   protected:
 
     // Keep a copy of measurement and calibration for I/O
@@ -52,7 +53,7 @@ namespace gtsam {
   public:
 
     /// shorthand for base class type
-    typedef NoiseModelFactorN<POSE, LANDMARK> Base;
+    typedef FixedSizeNoiseModelFactorN<2, POSE, LANDMARK> Base;
 
     // Provide access to the Matrix& version of evaluateError:
     using Base::evaluateError;
@@ -135,12 +136,13 @@ namespace gtsam {
     }
 
     /// Evaluate error h(x)-z and optionally derivatives
-    Vector evaluateError(const Pose3& pose, const Point3& point,
-        OptionalMatrixType H1, OptionalMatrixType H2) const override {
+    Vector2 evaluateErrorFixed(const Pose3& pose, const Point3& point,
+                               OptionalJacobian<2, 6> H1,
+                               OptionalJacobian<2, 3> H2) const override {
       try {
         if(body_P_sensor_) {
           if(H1) {
-            gtsam::Matrix H0;
+            Matrix66 H0;
             PinholeCamera<CALIBRATION> camera(pose.compose(*body_P_sensor_, H0), *K_);
             Point2 reprojectionError(camera.project(point, H1, H2, {}) - measured_);
             *H1 = *H1 * H0;
@@ -154,8 +156,8 @@ namespace gtsam {
           return camera.project(point, H1, H2, {}) - measured_;
         }
       } catch( CheiralityException& e) {
-        if (H1) *H1 = Matrix::Zero(2,6);
-        if (H2) *H2 = Matrix::Zero(2,3);
+        if (H1) H1->setZero();
+        if (H2) H2->setZero();
         if (verboseCheirality_)
           std::cout << e.what() << ": Landmark "<< DefaultKeyFormatter(this->key2()) <<
               " moved behind camera " << DefaultKeyFormatter(this->key1()) << std::endl;
@@ -193,7 +195,9 @@ namespace gtsam {
     friend class boost::serialization::access;
     template<class ARCHIVE>
     void serialize(ARCHIVE & ar, const unsigned int /*version*/) {
-      ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP(Base);
+      // NoiseModelFactorN as the base object, for backward compatibility
+      ar & boost::serialization::make_nvp("Base",
+          boost::serialization::base_object<NoiseModelFactorN<POSE, LANDMARK>>(*this));
       ar & BOOST_SERIALIZATION_NVP(measured_);
       ar & BOOST_SERIALIZATION_NVP(K_);
       ar & BOOST_SERIALIZATION_NVP(body_P_sensor_);
@@ -163,6 +163,11 @@ public:
     return K_;
   }
 
+  /** return the (optional) sensor pose with respect to the vehicle frame */
+  const std::optional<POSE>& body_P_sensor() const {
+    return body_P_sensor_;
+  }
+
   /** return verbosity */
   inline bool verboseCheirality() const { return verboseCheirality_; }
 
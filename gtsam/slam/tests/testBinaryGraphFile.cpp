@@ -0,0 +1,167 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testBinaryGraphFile.cpp
+ * @brief Unit tests for the binary graph file format
+ */
+
+#include <gtsam/slam/BinaryGraphFile.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/nonlinear/PriorFactor.h>
+#include <gtsam/slam/ProjectionFactor.h>
+#include <gtsam/slam/StereoFactor.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <fstream>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+TEST(BinaryGraphFile, g2o) {
+  const string g2oFile = findExampleDataFile("pose3example-offdiagonal");
+  const auto [expectedGraph, expectedValues] = readG2o(g2oFile, true);
+
+  const string filename = createRewrittenFileName(g2oFile);
+  writeBinaryGraph(*expectedGraph, *expectedValues, filename);
+  const auto [actualGraph, actualValues] = readBinaryGraph(filename);
+  EXPECT(assert_equal(*expectedValues, *actualValues, 1e-9));
+  EXPECT(assert_equal(*expectedGraph, *actualGraph, 1e-9));
+
+  // Writing the binary graph back to g2o gives the same graph
+  writeG2o(*actualGraph, *actualValues, filename);
+  const auto [g2oGraph, g2oValues] = readG2o(filename, true);
+  EXPECT(assert_equal(*expectedValues, *g2oValues, 1e-4));
+  EXPECT(assert_equal(*expectedGraph, *g2oGraph, 1e-4));
+}
+
+/* ************************************************************************* */
+TEST(BinaryGraphFile, robustG2o) {
+  const string g2oFile = findExampleDataFile("pose2example");
+  for (auto kernel : {KernelFunctionTypeHUBER, KernelFunctionTypeTUKEY}) {
+    const auto [expectedGraph, expectedValues] = readG2o(g2oFile, false, kernel);
+
+    const string filename = createRewrittenFileName(g2oFile);
+    writeBinaryGraph(*expectedGraph, *expectedValues, filename);
+    const auto [actualGraph, actualValues] = readBinaryGraph(filename);
+    EXPECT(assert_equal(*expectedValues, *actualValues, 1e-9));
+    EXPECT(assert_equal(*expectedGraph, *actualGraph, 1e-9));
+  }
+}
+
+/* ************************************************************************* */
+TEST(BinaryGraphFile, bal) {
+  const string balFile = findExampleDataFile("dubrovnik-3-7-pre");
+  const SfmData db = SfmData::FromBalFile(balFile);
+  const NonlinearFactorGraph expectedGraph =
+      db.sfmFactorGraph(noiseModel::Isotropic::Sigma(2, 1.0), 0);
+  const Values expectedValues = initialCamerasAndPointsEstimate(db);
+
+  const string filename = createRewrittenFileName(balFile);
+  writeBinaryGraph(expectedGraph, expectedValues, filename);
+  const auto [actualGraph, actualValues] = readBinaryGraph(filename);
+  EXPECT(assert_equal(expectedValues, *actualValues, 1e-9));
+  EXPECT(assert_equal(expectedGraph, *actualGraph, 1e-9));
+
+  // All projection factors share one noise model
+  const auto factor1 =
+      std::dynamic_pointer_cast<NoiseModelFactor>(actualGraph->at(1));
+  const auto factor2 =
+      std::dynamic_pointer_cast<NoiseModelFactor>(actualGraph->at(2));
+  EXPECT(factor1->noiseModel() == factor2->noiseModel());
+}
+
+/* ************************************************************************* */
+TEST(BinaryGraphFile, cameraFactors) {
+  const auto K = std::make_shared<Cal3_S2>(500, 500, 0.1, 320, 240);
+  const auto stereoK =
+      std::make_shared<Cal3_S2Stereo>(625, 625, 0, 320, 240, 0.5);
+  const Pose3 body_P_sensor(Rot3::Ypr(-M_PI / 2, 0, -M_PI / 2),
+                            Point3(0.25, -0.10, 1.0));
+  Matrix2 R;
+  R << 2.0, 0.5, 0.0, 1.0;
+
+  NonlinearFactorGraph graph;
+  graph.addPrior(X(0), Pose3(), noiseModel::Unit::Create(6));
+  graph.emplace_shared<GenericProjectionFactor<Pose3, Point3, Cal3_S2>>(
+      Point2(10, 20), noiseModel::Gaussian::SqrtInformation(R), X(0), L(0), K);
+  graph.emplace_shared<GenericProjectionFactor<Pose3, Point3, Cal3_S2>>(
+      Point2(30, 40), noiseModel::Isotropic::Sigma(2, 0.5), X(0), L(1), K,
+      true, false, body_P_sensor);
+  graph.push_back(NonlinearFactor::shared_ptr());
+  graph.emplace_shared<GenericStereoFactor<Pose3, Point3>>(
+      StereoPoint2(320, 300, 240), noiseModel::Diagonal::Sigmas(Vector3(1, 2, 3)),
+      X(0), L(0), stereoK, false, true, body_P_sensor);
+  graph.emplace_shared<BetweenFactor<Point3>>(
+      L(0), L(1), Point3(1, 2, 3),
+      noiseModel::Constrained::MixedSigmas(Vector3(0, 1, 0)));
+
+  Values values;
+  values.insert(X(0), Pose3(Rot3::RzRyRx(0.1, 0.2, 0.3), Point3(1, 2, 3)));
+  values.insert(L(0), Point3(1, 2, 10));
+  values.insert(L(1), Point3(-1, 2, 10));
+
+  const string filename =
+      createRewrittenFileName(findExampleDataFile("pose3example"));
+  writeBinaryGraph(graph, values, filename);
+  const BinaryGraphFile file(filename);
+  EXPECT_LONGS_EQUAL(BinaryGraphFile::kVersion, file.version());
+  EXPECT_LONGS_EQUAL(6, file.nrFactors());
+  EXPECT_LONGS_EQUAL(3, file.nrValues());
+  EXPECT(assert_equal(graph, file.factors(), 1e-9));
+  EXPECT(assert_equal(values, file.values(), 1e-9));
+
+  // Lazy access to single factors and values
+  EXPECT(file.factor(3) == nullptr);
+  EXPECT(assert_equal(*graph[4], *file.factor(4), 1e-9));
+  EXPECT(assert_container_equality(graph[2]->keys(), file.factorKeys(2)));
+  EXPECT(assert_container_equality(values.keys(), file.keys()));
+  EXPECT(file.exists(L(1)));
+  EXPECT(!file.exists(L(2)));
+  Values expected;
+  expected.insert(L(1), values.at<Point3>(L(1)));
+  EXPECT(assert_equal(expected, file.values({L(1)}), 1e-9));
+  CHECK_EXCEPTION(file.values({L(2)}), std::out_of_range);
+  CHECK_EXCEPTION(file.factor(6), std::out_of_range);
+}
+
+/* ************************************************************************* */
+TEST(BinaryGraphFile, errors) {
+  // Unsupported values are rejected when writing
+  Values values;
+  values.insert(0, Rot2(0.1));
+  const string filename =
+      createRewrittenFileName(findExampleDataFile("pose2example"));
+  CHECK_EXCEPTION(writeBinaryGraph(NonlinearFactorGraph(), values, filename),
+                  std::invalid_argument);
+
+  // Text files and truncated files are rejected when reading
+  CHECK_EXCEPTION(BinaryGraphFile(findExampleDataFile("pose2example")),
+                  std::runtime_error);
+  writeBinaryGraph(NonlinearFactorGraph(), Values(), filename);
+  {
+    std::ofstream os(filename, std::ios::binary | std::ios::app);
+    os << "trailing";
+  }
+  CHECK_EXCEPTION(BinaryGraphFile{filename}, std::runtime_error);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
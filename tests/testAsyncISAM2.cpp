@@ -0,0 +1,130 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testAsyncISAM2.cpp
+ * @brief   Unit tests for AsyncISAM2
+ */
+
+#include <gtsam/nonlinear/AsyncISAM2.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace gtsam;
+
+static const auto odoNoise = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.01));
+
+// Exact back-substitution and no relinearization, so the result does not
+// depend on how updates are grouped
+static const ISAM2Params params(ISAM2GaussNewtonParams(0.0), 0.1, 10, false);
+
+/* ************************************************************************* */
+// New factors and values for pose i of an odometry chain
+static std::pair<NonlinearFactorGraph, Values> odometry(size_t i) {
+  NonlinearFactorGraph graph;
+  Values values;
+  if (i == 0)
+    graph.addPrior(0, Pose2(), odoNoise);
+  else
+    graph.emplace_shared<BetweenFactor<Pose2>>(i - 1, i, Pose2(1, 0, 0.1),
+                                               odoNoise);
+  values.insert(i, Pose2(i + 0.1, 0.1 * i, 0.1 * i));
+  return {graph, values};
+}
+
+/* ************************************************************************* */
+TEST(AsyncISAM2, update) {
+  ISAM2 expected(params);
+  AsyncISAM2 actual(params);
+  actual.setMarginalKeys({0, 9});
+  EXPECT_LONGS_EQUAL(0, actual.updateCount());
+  EXPECT_LONGS_EQUAL(0, actual.calculateEstimate().size());
+
+  for (size_t i = 0; i < 10; i++) {
+    const auto [graph, values] = odometry(i);
+    expected.update(graph, values);
+    actual.update(graph, values);
+  }
+  actual.waitForUpdates();
+
+  EXPECT_LONGS_EQUAL(0, actual.pendingUpdates());
+  EXPECT_LONGS_EQUAL(10, actual.updateCount());
+  EXPECT(assert_equal(expected.calculateEstimate(), actual.calculateEstimate(), 1e-9));
+  EXPECT(assert_equal(expected.calculateEstimate<Pose2>(9),
+                      actual.calculateEstimate<Pose2>(9), 1e-9));
+  EXPECT(assert_equal(expected.marginalCovariance(9), actual.marginalCovariance(9), 1e-9));
+  EXPECT(assert_equal(expected.marginalCovariance(0), actual.marginalCovariance(0), 1e-9));
+  CHECK_EXCEPTION(actual.marginalCovariance(5), std::out_of_range);
+
+  // Updates with explicit parameters are applied on their own
+  ISAM2UpdateParams updateParams;
+  updateParams.force_relinearize = true;
+  actual.update(NonlinearFactorGraph(), Values(), updateParams);
+  actual.waitForUpdates();
+  EXPECT_LONGS_EQUAL(11, actual.updateCount());
+  EXPECT_LONGS_EQUAL(10, actual.snapshot().estimate.size());
+}
+
+/* ************************************************************************* */
+TEST(AsyncISAM2, consistentSnapshots) {
+  AsyncISAM2 isam(params);
+  std::atomic<bool> done{false}, consistent{true};
+
+  // Every pose adds one variable, so a consistent snapshot has as many
+  // variables as applied updates
+  std::thread reader([&] {
+    while (!done) {
+      const AsyncISAM2::Snapshot snapshot = isam.snapshot();
+      if (snapshot.estimate.size() != snapshot.updateCount) consistent = false;
+    }
+  });
+
+  for (size_t i = 0; i < 50; i++) {
+    const auto [graph, values] = odometry(i);
+    isam.update(graph, values);
+  }
+  isam.waitForUpdates();
+  done = true;
+  reader.join();
+
+  EXPECT(consistent);
+  EXPECT_LONGS_EQUAL(50, isam.updateCount());
+}
+
+/* ************************************************************************* */
+TEST(AsyncISAM2, error) {
+  AsyncISAM2 isam(params);
+  const auto [graph, values] = odometry(0);
+  isam.update(graph, values);
+  isam.waitForUpdates();
+
+  // A factor on a variable without a value throws on the worker thread
+  isam.update(odometry(2).first);
+  CHECK_EXCEPTION(isam.waitForUpdates(), std::exception);
+
+  // The error is only reported once, and the last snapshot is kept
+  isam.waitForUpdates();
+  EXPECT_LONGS_EQUAL(1, isam.updateCount());
+  EXPECT_LONGS_EQUAL(1, isam.calculateEstimate().size());
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
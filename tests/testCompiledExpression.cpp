@@ -0,0 +1,117 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testCompiledExpression.cpp
+ * @brief unit tests for CompiledExpression and CompiledExpressionBatch
+ */
+
+#include <gtsam/nonlinear/CompiledExpression.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/slam/expressions.h>
+#include <gtsam/base/Testable.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::K;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+namespace {
+// Projection of a point into a camera with unknown calibration
+Point2_ projection(Key x, Key p, Key k) {
+  return uncalibrate(Cal3_S2_(k), project(transformTo(Pose3_(x), Point3_(p))));
+}
+
+Values createValues() {
+  Values values;
+  values.insert(X(1), Pose3(Rot3::Ypr(0.1, -0.2, 0.3), Point3(0.5, -0.2, -3)));
+  values.insert(X(2), Pose3(Rot3::Ypr(-0.1, 0.2, 0.1), Point3(-0.5, 0.2, -3)));
+  values.insert(L(1), Point3(0.2, 0.3, 2));
+  values.insert(L(2), Point3(-0.4, 0.1, 1.5));
+  values.insert(K(1), Cal3_S2(500, 500, 0.1, 320, 240));
+  return values;
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(CompiledExpression, valueAndJacobians) {
+  const Values values = createValues();
+  const Point2_ expression = projection(X(1), L(1), K(1));
+  const CompiledExpression<Point2> compiled(expression);
+
+  // Keys are sorted
+  EXPECT(compiled.keys() == KeyVector({K(1), L(1), X(1)}));
+  EXPECT(compiled.dims() == FastVector<int>({5, 3, 6}));
+  EXPECT_LONGS_EQUAL(8, compiled.offset(2));
+  EXPECT_LONGS_EQUAL(14, compiled.cols());
+  EXPECT_LONGS_EQUAL(expression.traceSize(), compiled.traceSize());
+
+  std::vector<Matrix> expectedH(3);
+  const Point2 expected = expression.value(values, expectedH);
+  EXPECT(assert_equal(expected, compiled.value(values)));
+
+  // Evaluate twice, reusing the trace storage and the Jacobian matrices
+  std::vector<Matrix> H;
+  std::vector<const double*> storage;
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT(assert_equal(expected, compiled.valueAndJacobians(values, H)));
+    EXPECT_LONGS_EQUAL(3, H.size());
+    for (size_t j = 0; j < 3; ++j) EXPECT(assert_equal(expectedH[j], H[j]));
+    if (i == 0)
+      for (const Matrix& Hj : H) storage.push_back(Hj.data());
+  }
+  for (size_t j = 0; j < 3; ++j) EXPECT(storage[j] == H[j].data());
+}
+
+/* ************************************************************************* */
+TEST(CompiledExpression, batch) {
+  const Values values = createValues();
+  const std::vector<Point2_> expressions{projection(X(1), L(1), K(1)),
+                                         projection(X(2), L(1), K(1)),
+                                         projection(X(1), L(2), K(1))};
+  CompiledExpressionBatch<Point2> batch(expressions);
+  EXPECT_LONGS_EQUAL(3, batch.size());
+  EXPECT(batch.keys(1) == KeyVector({K(1), L(1), X(2)}));
+
+  // Twice, to check that the Jacobians are reset
+  for (size_t iteration = 0; iteration < 2; ++iteration) {
+    const std::vector<Point2>& result = batch.evaluate(values);
+    EXPECT_LONGS_EQUAL(3, result.size());
+    EXPECT_LONGS_EQUAL(6, batch.jacobians().rows());
+    EXPECT_LONGS_EQUAL(14, batch.jacobians().cols());
+    for (size_t i = 0; i < expressions.size(); ++i) {
+      std::vector<Matrix> H(3);
+      EXPECT(assert_equal(expressions[i].value(values, H), result[i]));
+      // Blocks follow the dims of the shape, keys are per expression
+      const KeyVector keys = batch.keys(i);
+      const std::set<Key> expectedKeys = expressions[i].keys();
+      EXPECT(keys == KeyVector(expectedKeys.begin(), expectedKeys.end()));
+      for (size_t j = 0; j < 3; ++j)
+        EXPECT(assert_equal(H[j], Matrix(batch.jacobian(i, j))));
+    }
+  }
+
+  // Different shape, or empty batch
+  CHECK_EXCEPTION(CompiledExpressionBatch<Point2>(
+                      {projection(X(1), L(1), K(1)), Point2_(Point2(1, 2))}),
+                  std::invalid_argument);
+  CHECK_EXCEPTION(CompiledExpressionBatch<Point2>({}), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -612,6 +612,113 @@ TEST(ISAM2, slamlike_solution_partial_relinearization_check)
   CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
 }
 
+/* ************************************************************************* */
+TEST(ISAM2, detailed_results_timings)
+{
+  // These variables will be reused and accumulate factors and values. Without
+  // cached linear factors all affected factors are relinearized, but the
+  // linearization point stays put because of the high threshold.
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 1e9, 1, true, false,
+                     ISAM2Params::CHOLESKY, false, DefaultKeyFormatter, true);
+  ISAM2 isam = createSlamlikeISAM2(&fullinit, &fullgraph, params);
+
+  // Close a loop, which re-eliminates most of the tree
+  NonlinearFactorGraph newfactors;
+  newfactors.emplace_shared<BetweenFactor<Pose2>>(0, 10, Pose2(5.0, 0.0, 0.0), odoNoise);
+  fullgraph.push_back(newfactors);
+  const ISAM2Result result = isam.update(newfactors);
+
+  CHECK(result.detail);
+  EXPECT(result.detail->updateDeltaTime > 0.0);
+  EXPECT(result.detail->relinearizeTime > 0.0);
+  EXPECT(result.detail->gatherOrphansTime >= 0.0);
+  EXPECT(result.detail->eliminateTime > 0.0);
+
+  // Compare solutions
+  CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, deferred_relinearization)
+{
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  ISAM2 isam = createSlamlikeISAM2(&fullinit, &fullgraph,
+                                   ISAM2Params(ISAM2GaussNewtonParams(0.0), 0.0, 0, false));
+
+  // All variables are above the zero threshold, only relinearize the two
+  // with the largest deltas
+  const VectorValues delta = isam.getDelta();
+  ISAM2UpdateParams updateParams;
+  updateParams.force_relinearize = true;
+  updateParams.maxRelinearizedVariables = 2;
+  ISAM2Result result = isam.update(NonlinearFactorGraph(), Values(), updateParams);
+  EXPECT_LONGS_EQUAL(delta.size() - 2, result.deferredRelinearizeKeys.size());
+  double smallestRelinearized = std::numeric_limits<double>::max(),
+         largestDeferred = 0.0;
+  for (const auto& [key, value] : delta) {
+    const double norm = value.lpNorm<Eigen::Infinity>();
+    if (result.deferredRelinearizeKeys.exists(key))
+      largestDeferred = std::max(largestDeferred, norm);
+    else
+      smallestRelinearized = std::min(smallestRelinearized, norm);
+  }
+  EXPECT(smallestRelinearized >= largestDeferred);
+
+  // The deferred variables are relinearized by the next unlimited update
+  updateParams.maxRelinearizedVariables = {};
+  result = isam.update(NonlinearFactorGraph(), Values(), updateParams);
+  EXPECT(result.deferredRelinearizeKeys.empty());
+  EXPECT_LONGS_EQUAL(delta.size(), result.variablesRelinearized);
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, deferred_backsubstitution)
+{
+  // A loop closure replaces most of the tree
+  NonlinearFactorGraph newfactors;
+  newfactors.emplace_shared<BetweenFactor<Pose2>>(0, 10, Pose2(5.0, 0.0, 0.0), odoNoise);
+
+  // Without relinearization, so both only differ in when delta is computed.
+  // A zero wildfire threshold is bounded as well.
+  for (double wildfireThreshold : {1e-12, 0.0}) {
+    const ISAM2Params params(ISAM2GaussNewtonParams(wildfireThreshold), 1e9, 1, true);
+    ISAM2 expected = createSlamlikeISAM2(nullptr, nullptr, params);
+    ISAM2 actual = createSlamlikeISAM2(nullptr, nullptr, params);
+    expected.update(newfactors);
+    actual.update(newfactors);
+
+    // Back-substitute at most one variable per update
+    ISAM2UpdateParams updateParams;
+    updateParams.maxBacksubstitutedVariables = 1;
+    ISAM2Result result = actual.update(NonlinearFactorGraph(), Values(), updateParams);
+    EXPECT(!result.deferredBacksubstituteKeys.empty());
+    result = actual.update(NonlinearFactorGraph(), Values(), updateParams);
+    EXPECT(!result.deferredBacksubstituteKeys.empty());
+
+    // Requesting the estimate finishes the deferred back-substitution
+    EXPECT(assert_equal(expected.calculateBestEstimate(), actual.calculateEstimate(), 1e-6));
+    EXPECT(assert_equal(expected.calculateBestEstimate(), actual.calculateBestEstimate(), 1e-9));
+  }
+
+  // A time budget is not enforced until the cost per variable is known
+  const ISAM2Params params(ISAM2GaussNewtonParams(1e-12), 1e9, 1, true);
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  createSlamlikeISAM2(&fullinit, &fullgraph, params);
+  ISAM2 timed(params);
+  ISAM2UpdateParams updateParams;
+  updateParams.timeBudget = 0.0;
+  ISAM2Result result = timed.update(fullgraph, fullinit, updateParams);
+  EXPECT(result.deferredRelinearizeKeys.empty());
+  EXPECT(result.deferredBacksubstituteKeys.empty());
+  timed.update(newfactors, Values(), updateParams);
+  result = timed.update(NonlinearFactorGraph(), Values(), updateParams);
+  EXPECT(!result.deferredBacksubstituteKeys.empty());
+}
+
 namespace {
   bool checkMarginalizeLeaves(ISAM2& isam, const FastList<Key>& leafKeys) {
     Matrix expectedAugmentedHessian, expected3AugmentedHessian;
@@ -984,6 +1091,75 @@ TEST(ISAM2, marginalCovariance)
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+TEST(ISAM2, marginalCovarianceCache)
+{
+  // Two independent chains, so that an update only touches one of the roots
+  ISAM2Params params;
+  params.marginalCacheCapacity = 20;
+  ISAM2 isam(params);
+  auto addPose = [&](Key key, bool first) {
+    NonlinearFactorGraph newFactors;
+    if (first)
+      newFactors.addPrior(key, Pose2(), odoNoise);
+    else
+      newFactors.emplace_shared<BetweenFactor<Pose2>>(
+          key - 1, key, Pose2(1.0, 0.0, 0.1), odoNoise);
+    Values init;
+    init.insert(key, Pose2(key % 100, 0.0, 0.1 * (key % 100)));
+    isam.update(newFactors, init);
+  };
+  for (Key key = 0; key < 5; ++key) {
+    addPose(key, key == 0);
+    addPose(100 + key, key == 0);
+  }
+  const KeyVector keys{0, 1, 2, 3, 4, 100, 101, 102, 103, 104};
+
+  auto checkAll = [&]() {
+    Marginals marginals(isam.getFactorsUnsafe(), isam.getLinearizationPoint());
+    for (Key key : keys)
+      EXPECT(assert_equal(marginals.marginalCovariance(key),
+                          isam.marginalCovariance(key), 1e-9));
+  };
+
+  // First queries miss, repeated queries hit
+  checkAll();
+  EXPECT_LONGS_EQUAL(10, isam.marginalCacheStatistics().misses);
+  EXPECT_LONGS_EQUAL(0, isam.marginalCacheStatistics().hits);
+  checkAll();
+  EXPECT_LONGS_EQUAL(10, isam.marginalCacheStatistics().hits);
+  EXPECT_LONGS_EQUAL(10, isam.marginalCacheStatistics().size);
+
+  // Extending the first chain leaves the cache of the second one valid
+  addPose(5, false);
+  checkAll();
+  const ISAM2::MarginalCacheStatistics statistics =
+      isam.marginalCacheStatistics();
+  EXPECT_LONGS_EQUAL(15, statistics.hits);
+  EXPECT_LONGS_EQUAL(15, statistics.misses);
+  EXPECT_LONGS_EQUAL(5, statistics.invalidated);
+
+  // A full cache evicts the least recently used entries
+  params.marginalCacheCapacity = 3;
+  ISAM2 small(params);
+  small.update(isam.getFactorsUnsafe(), isam.getLinearizationPoint());
+  for (Key key : keys) small.marginalCovariance(key);
+  EXPECT_LONGS_EQUAL(3, small.marginalCacheStatistics().size);
+  EXPECT_LONGS_EQUAL(7, small.marginalCacheStatistics().evicted);
+  small.marginalCovariance(104);
+  EXPECT_LONGS_EQUAL(1, small.marginalCacheStatistics().hits);
+
+  // Copies and assignments start with an empty cache and no statistics
+  const ISAM2 copy(isam);
+  EXPECT_LONGS_EQUAL(0, copy.marginalCacheStatistics().hits);
+  EXPECT_LONGS_EQUAL(0, copy.marginalCacheStatistics().size);
+  small = isam;
+  EXPECT_LONGS_EQUAL(0, small.marginalCacheStatistics().hits);
+  EXPECT_LONGS_EQUAL(0, small.marginalCacheStatistics().misses);
+  EXPECT_LONGS_EQUAL(0, small.marginalCacheStatistics().evicted);
+  EXPECT_LONGS_EQUAL(0, small.marginalCacheStatistics().size);
+}
+
 /* ************************************************************************* */
 TEST(ISAM2, calculate_nnz)
 {
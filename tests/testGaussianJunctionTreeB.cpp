@@ -95,18 +95,22 @@ TEST( GaussianJunctionTreeB, constructor2 ) {
   EXPECT(assert_equal(o324, x324->orderedFrontalKeys));
   EXPECT_LONGS_EQUAL(5, x324->factors.size());
   EXPECT_LONGS_EQUAL(9, x324->problemSize_);
+  EXPECT_LONGS_EQUAL(0, x324->separatorSize());
 
   EXPECT(assert_equal(o56, x56->orderedFrontalKeys));
   EXPECT_LONGS_EQUAL(4, x56->factors.size());
   EXPECT_LONGS_EQUAL(9, x56->problemSize_);
+  EXPECT_LONGS_EQUAL(1, x56->separatorSize());
 
   EXPECT(assert_equal(o7, x7->orderedFrontalKeys));
   EXPECT_LONGS_EQUAL(2, x7->factors.size());
   EXPECT_LONGS_EQUAL(4, x7->problemSize_);
+  EXPECT_LONGS_EQUAL(1, x7->separatorSize());
 
   EXPECT(assert_equal(o1, x1->orderedFrontalKeys));
   EXPECT_LONGS_EQUAL(2, x1->factors.size());
   EXPECT_LONGS_EQUAL(4, x1->problemSize_);
+  EXPECT_LONGS_EQUAL(1, x1->separatorSize());
 }
 
 ///* ************************************************************************* */
@@ -124,6 +128,28 @@ TEST(GaussianJunctionTreeB, OptimizeMultiFrontal) {
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+TEST(GaussianJunctionTreeB, ParallelScheduling) {
+  const auto fg = createSmoother(20);
+  const Ordering ordering = Ordering::Colamd(fg);
+  const auto expected = fg.eliminateMultifrontal(ordering, EliminateQR);
+
+  // Elimination results do not depend on the scheduling
+  for (double minTaskCost : {0.0, 10.0, 1e9}) {
+    treeTraversal::ParallelTraversalParams params;
+    params.minTaskCost = minTaskCost;
+    treeTraversal::ParallelTraversalStatistics statistics;
+    const auto actual =
+        fg.eliminateMultifrontal(ordering, EliminateQR, {}, params, &statistics);
+    EXPECT(assert_equal(*expected, *actual));
+
+    EXPECT_LONGS_EQUAL(expected->size(), statistics.nrNodes);
+    EXPECT(statistics.totalCost > 0.0);
+    EXPECT(statistics.criticalPathCost <= statistics.totalCost);
+    EXPECT(statistics.nrThreadsUsed() >= 1);
+  }
+}
+
 /* ************************************************************************* */
 TEST(GaussianJunctionTreeB, optimizeMultiFrontal2) {
   // create a graph
@@ -0,0 +1,175 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testImplicitSchurSolver.cpp
+ * @brief   Unit tests for ImplicitSchurSolver
+ */
+
+#include <examples/SFMdata.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/linear/HessianFactor.h>
+#include <gtsam/linear/ImplicitSchurSolver.h>
+#include <gtsam/linear/linearExceptions.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/slam/ProjectionFactor.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+namespace {
+
+// Small bundle adjustment problem, with a perturbed initial estimate
+NonlinearFactorGraph graph;
+Values initial;
+
+void createProblem() {
+  if (!graph.empty()) return;
+  const auto K = std::make_shared<Cal3_S2>(50.0, 50.0, 0.0, 50.0, 50.0);
+  const auto noise = noiseModel::Isotropic::Sigma(2, 1.0);
+  const vector<Point3> points = createPoints();
+  const vector<Pose3> poses = createPoses();
+  for (size_t i = 0; i < poses.size(); ++i) {
+    const PinholeCamera<Cal3_S2> camera(poses[i], *K);
+    for (size_t j = 0; j < points.size(); ++j)
+      graph.emplace_shared<GenericProjectionFactor<Pose3, Point3, Cal3_S2>>(
+          camera.project(points[j]), noise, X(i), L(j), K);
+  }
+  graph.addPrior(X(0), poses[0], noiseModel::Isotropic::Sigma(6, 0.1));
+  graph.addPrior(L(0), points[0], noiseModel::Isotropic::Sigma(3, 0.1));
+
+  for (size_t i = 0; i < poses.size(); ++i)
+    initial.insert(X(i), poses[i].compose(Pose3(Rot3::Rodrigues(-0.1, 0.2, 0.25),
+                                                Point3(0.05, -0.10, 0.20))));
+  for (size_t j = 0; j < points.size(); ++j)
+    initial.insert<Point3>(L(j), points[j] + Point3(-0.25, 0.20, 0.15));
+}
+
+ImplicitSchurSolverParameters accurateParameters() {
+  ImplicitSchurSolverParameters parameters;
+  parameters.setEpsilon_rel(1e-10);
+  parameters.setEpsilon_abs(1e-20);
+  return parameters;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ImplicitSchurSolver, linear) {
+  createProblem();
+  const GaussianFactorGraph gfg = *graph.linearize(initial);
+  const VectorValues expected = gfg.optimize();
+
+  ImplicitSchurSolverParameters parameters = accurateParameters();
+  for (auto preconditioner : {ImplicitSchurSolverParameters::BLOCK_JACOBI,
+                              ImplicitSchurSolverParameters::SCHUR_JACOBI}) {
+    parameters.preconditioner = preconditioner;
+    EXPECT(assert_equal(expected,
+                        ImplicitSchurSolver(parameters).optimize(gfg), 1e-6));
+  }
+
+  // The landmarks are picked automatically, giving them explicitly is the same
+  for (const auto& [key, value] : initial)
+    if (Symbol(key).chr() == 'l') parameters.eliminatedKeys.insert(key);
+  EXPECT(assert_equal(expected, ImplicitSchurSolver(parameters).optimize(gfg),
+                      1e-6));
+}
+
+/* ************************************************************************* */
+TEST(ImplicitSchurSolver, otherFactors) {
+  createProblem();
+  GaussianFactorGraph gfg = *graph.linearize(initial);
+  const VectorValues expected = gfg.optimize();
+
+  // The prior on the first pose as a HessianFactor, which is only multiplied
+  auto prior = std::dynamic_pointer_cast<JacobianFactor>(gfg.at(gfg.size() - 2));
+  CHECK(prior && prior->front() == X(0));
+  gfg.replace(gfg.size() - 2, std::make_shared<HessianFactor>(*prior));
+  EXPECT(assert_equal(expected,
+                      ImplicitSchurSolver(accurateParameters()).optimize(gfg),
+                      1e-6));
+
+  // An eliminated variable in a factor that is not a Jacobian factor
+  ImplicitSchurSolverParameters parameters;
+  parameters.eliminatedKeys = KeySet{X(0)};
+  CHECK_EXCEPTION(ImplicitSchurSolver(parameters).optimize(gfg),
+                  std::invalid_argument);
+
+  // Two eliminated variables in one factor
+  parameters.eliminatedKeys = KeySet{X(1), L(1)};
+  CHECK_EXCEPTION(ImplicitSchurSolver(parameters).optimize(gfg),
+                  std::invalid_argument);
+
+  // A landmark seen by a single camera is not constrained
+  GaussianFactorGraph single;
+  single.push_back(gfg.at(0));
+  single.push_back(gfg.back());
+  parameters.eliminatedKeys = KeySet{L(0)};
+  CHECK_EXCEPTION(ImplicitSchurSolver(parameters).optimize(single),
+                  IndeterminantLinearSystemException);
+}
+
+/* ************************************************************************* */
+TEST(ImplicitSchurSolver, severalOtherFactors) {
+  createProblem();
+  GaussianFactorGraph gfg = *graph.linearize(initial);
+
+  // The prior on the first pose and weak priors on the other poses, all as
+  // HessianFactors, so the solver keeps several of them side by side
+  auto prior = std::dynamic_pointer_cast<JacobianFactor>(gfg.at(gfg.size() - 2));
+  CHECK(prior && prior->front() == X(0));
+  gfg.replace(gfg.size() - 2, std::make_shared<HessianFactor>(*prior));
+  for (size_t i = 1; initial.exists(X(i)); ++i)
+    gfg.emplace_shared<HessianFactor>(JacobianFactor(
+        X(i), 0.1 * I_6x6, Vector6::Constant(0.01 * i),
+        noiseModel::Unit::Create(6)));
+  CHECK(gfg.size() > graph.size() + 1);
+
+  const VectorValues expected = gfg.optimize();
+  EXPECT(assert_equal(expected,
+                      ImplicitSchurSolver(accurateParameters()).optimize(gfg),
+                      1e-6));
+}
+
+/* ************************************************************************* */
+TEST(ImplicitSchurSolver, optimizer) {
+  createProblem();
+  const Values expected = LevenbergMarquardtOptimizer(graph, initial).optimize();
+
+  LevenbergMarquardtParams params;
+  params.setLinearSolverType("IMPLICIT_SCHUR");
+  EXPECT(params.isImplicitSchur());
+  EXPECT(params.getLinearSolverType() == "IMPLICIT_SCHUR");
+  params.iterativeParams =
+      std::make_shared<ImplicitSchurSolverParameters>(accurateParameters());
+  const Values actual =
+      LevenbergMarquardtOptimizer(graph, initial, params).optimize();
+  EXPECT(assert_equal(expected, actual, 1e-5));
+
+  // Default solver parameters converge as well
+  params.iterativeParams.reset();
+  EXPECT_DOUBLES_EQUAL(
+      0, graph.error(LevenbergMarquardtOptimizer(graph, initial, params).optimize()),
+      1e-3);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -258,6 +258,46 @@ TEST(Marginals, order) {
   testMarginals(marginals, set);
 }
 
+/* ************************************************************************* */
+TEST(Marginals, marginalCovariances) {
+  // A grid of poses, so that the Bayes tree branches
+  const size_t n = 6;
+  auto pose = [&](size_t i, size_t j) { return Symbol('x', i * n + j); };
+  auto noise = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.2, 0.05));
+  NonlinearFactorGraph graph;
+  Values values;
+  graph.addPrior(pose(0, 0), Pose2(), noise);
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      values.insert(pose(i, j), Pose2(i, j, 0.1 * i));
+      if (i > 0)
+        graph.emplace_shared<BetweenFactor<Pose2>>(
+            pose(i - 1, j), pose(i, j), Pose2(1, 0, 0.1), noise);
+      if (j > 0)
+        graph.emplace_shared<BetweenFactor<Pose2>>(
+            pose(i, j - 1), pose(i, j), Pose2(0, 1, 0), noise);
+    }
+  }
+
+  for (auto factorization : {Marginals::CHOLESKY, Marginals::QR}) {
+    Marginals marginals(graph, values, factorization);
+
+    // All variables
+    const FastMap<Key, Matrix> all = marginals.marginalCovariances();
+    EXPECT_LONGS_EQUAL(n * n, all.size());
+    for (const auto& [key, covariance] : all)
+      EXPECT(assert_equal(marginals.marginalCovariance(key), covariance, 1e-9));
+
+    // Some variables only
+    const KeyVector some{pose(n - 1, n - 1), pose(2, 3), pose(0, 0)};
+    const FastMap<Key, Matrix> actual = marginals.marginalCovariances(some);
+    EXPECT_LONGS_EQUAL(3, actual.size());
+    for (Key key : some)
+      EXPECT(assert_equal(marginals.marginalCovariance(key), actual.at(key),
+                          1e-9));
+  }
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -32,6 +32,8 @@
 #include <gtsam/linear/GaussianFactor.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/inference/Symbol.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/ProjectionFactor.h>
 
 using namespace std;
 using namespace gtsam;
@@ -725,6 +727,65 @@ TEST( NonlinearFactor, clone_rekey )
   EXPECT_LONGS_EQUAL((long)X(8), (long)actRekey->keys()[3]);
 }
 
+/* ************************************************************************* */
+TEST(NonlinearFactor, FixedSizeNoiseModelFactorN) {
+  const Pose3 pose1(Rot3::RzRyRx(0.1, -0.2, 0.3), Point3(1, 2, 3));
+  const Pose3 pose2(Rot3::RzRyRx(-0.2, 0.1, 0.4), Point3(1.5, 2, 2.5));
+  const Point3 point(1.2, 2.5, 8);
+  Values values;
+  values.insert(X(1), pose1);
+  values.insert(X(2), pose2);
+  values.insert(L(1), point);
+
+  const SharedNoiseModel models6[] = {
+      nullptr, noiseModel::Unit::Create(6), noiseModel::Isotropic::Sigma(6, 0.5),
+      noiseModel::Diagonal::Sigmas((Vector(6) << 1, 2, 3, 4, 5, 6).finished()),
+      noiseModel::Gaussian::Covariance(Matrix6::Identity() + Matrix6::Ones()),
+      noiseModel::Robust::Create(noiseModel::mEstimator::Huber::Create(0.1),
+                                 noiseModel::Isotropic::Sigma(6, 0.5)),
+      noiseModel::Constrained::MixedSigmas(
+          (Vector(6) << 0, 0, 0, 1, 2, 3).finished())};
+
+  // linearize on fixed-size Jacobians agrees with NoiseModelFactor::linearize
+  for (const SharedNoiseModel& model : models6) {
+    const BetweenFactor<Pose3> factor(X(1), X(2), Pose3(), model);
+    const auto expected = factor.NoiseModelFactor::linearize(values);
+    EXPECT(assert_equal(*expected, *factor.linearize(values), 1e-9));
+  }
+
+  const auto K = std::make_shared<Cal3_S2>(500, 500, 0.1, 320, 240);
+  const GenericProjectionFactor<Pose3, Point3> projection(
+      Point2(300, 200), noiseModel::Isotropic::Sigma(2, 2.0), X(1), L(1), K,
+      Pose3(Rot3::Ypr(0.1, 0, 0), Point3(0.1, 0, 0)));
+  EXPECT(assert_equal(*projection.NoiseModelFactor::linearize(values),
+                      *projection.linearize(values), 1e-9));
+
+  // evaluateError with dynamic Jacobians, from evaluateErrorFixed
+  Matrix H1, H2;
+  const Vector error = projection.evaluateError(pose1, point, H1, H2);
+  Matrix26 H1fixed;
+  Matrix23 H2fixed;
+  EXPECT(assert_equal(Vector(projection.evaluateErrorFixed(pose1, point,
+                                                           H1fixed, H2fixed)),
+                      error));
+  EXPECT(assert_equal(Matrix(H1fixed), H1));
+  EXPECT(assert_equal(Matrix(H2fixed), H2));
+
+  // Wrong noise model dimension
+  const BetweenFactor<Pose3> wrong(X(1), X(2), Pose3(),
+                                   noiseModel::Unit::Create(3));
+  CHECK_EXCEPTION(wrong.linearize(values), std::invalid_argument);
+
+  // Dynamic dimensions fall back to NoiseModelFactor::linearize
+  Values vectors;
+  vectors.insert(X(1), Vector(Vector3(1, 2, 3)));
+  vectors.insert(X(2), Vector(Vector3(2, 2, 1)));
+  const BetweenFactor<Vector> dynamic(X(1), X(2), Vector(Vector3(1, 1, 1)),
+                                      noiseModel::Isotropic::Sigma(3, 0.5));
+  EXPECT(assert_equal(*dynamic.NoiseModelFactor::linearize(vectors),
+                      *dynamic.linearize(vectors), 1e-9));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
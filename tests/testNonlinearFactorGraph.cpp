@@ -20,9 +20,12 @@
 
 #include <gtsam/base/Testable.h>
 #include <gtsam/base/Matrix.h>
+#include <gtsam/base/MonotonicArena.h>
 #include <tests/smallExample.h>
 #include <gtsam/inference/FactorGraph.h>
 #include <gtsam/inference/Symbol.h>
+#include <gtsam/linear/GaussianBayesNet.h>
+#include <gtsam/linear/GaussianBayesTree.h>
 #include <gtsam/symbolic/SymbolicFactorGraph.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/geometry/Pose2.h>
@@ -32,6 +35,10 @@
 
 #include <CppUnitLite/TestHarness.h>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/task_arena.h>
+#endif
+
 /*STL/C++*/
 #include <iostream>
 
@@ -215,6 +222,39 @@ TEST(NonlinearFactorGraph, UpdateCholesky) {
   EXPECT(assert_equal(initial, fg.updateCholesky(initial, dampen), 1e-6));
 }
 
+/* ************************************************************************* */
+TEST(NonlinearFactorGraph, LinearizeToHessianFactor) {
+  // Pose chain with loop closures, large enough to be split across threads
+  NonlinearFactorGraph fg;
+  Values initial;
+  const auto model = noiseModel::Isotropic::Sigma(3, 0.1);
+  fg.addPrior(0, Pose2(), model);
+  for (size_t i = 0; i < 100; i++) {
+    initial.insert(i, Pose2(i + 0.1, 0.01 * i, 0.02 * i));
+    if (i > 0) fg.emplace_shared<BetweenFactor<Pose2>>(i - 1, i, Pose2(1, 0, 0), model);
+    if (i > 10) fg.emplace_shared<BetweenFactor<Pose2>>(i - 10, i, Pose2(10, 0, 0), model);
+  }
+
+  Ordering ordering;
+  for (size_t i = 0; i < 100; i++) ordering.push_back(i);
+  const Matrix expected = fg.linearize(initial)->augmentedHessian(ordering);
+
+  EXPECT(assert_equal(expected, fg.linearizeToHessianFactor(initial)->augmentedInformation(), 1e-6));
+
+#ifdef GTSAM_USE_TBB
+  // Force the serial and the parallel assembly, and check they agree
+  Matrix serial, parallel;
+  tbb::task_arena(1).execute([&] {
+    serial = fg.linearizeToHessianFactor(initial, ordering)->augmentedInformation();
+  });
+  tbb::task_arena(4).execute([&] {
+    parallel = fg.linearizeToHessianFactor(initial, ordering)->augmentedInformation();
+  });
+  EXPECT(assert_equal(expected, serial, 1e-6));
+  EXPECT(assert_equal(serial, parallel, 1e-6));
+#endif
+}
+
 /* ************************************************************************* */
 // Example from issue #452 which threw an ILS error. The reason was a very 
 // weak prior on heading, which was tightened, and the ILS disappeared.
@@ -255,6 +295,37 @@ TEST(testNonlinearFactorGraph, eliminate) {
   EXPECT_LONGS_EQUAL(4, bn->size());
 }
 
+/* ************************************************************************* */
+TEST(NonlinearFactorGraph, linearizeInArena) {
+  const NonlinearFactorGraph graph = createNonlinearFactorGraph();
+  const Values values = createNoisyValues();
+  const GaussianFactorGraph expected = *graph.linearize(values);
+  const auto expectedBayesTree = expected.eliminateMultifrontal();
+
+  MonotonicArena arena;
+  for (size_t iteration = 0; iteration < 2; ++iteration) {
+    {
+      MonotonicArena::Scope scope(arena);
+      const auto linear = graph.linearize(values);
+      EXPECT(assert_equal(expected, *linear));
+      EXPECT_LONGS_EQUAL(graph.size(), arena.liveAllocations());
+
+      // Conditionals and remaining factors go in the arena, too
+      const auto bayesNet = linear->eliminateSequential(Ordering::COLAMD, EliminateQR);
+      const auto bayesTree = linear->eliminateMultifrontal();
+      EXPECT(assert_equal(*expectedBayesTree, *bayesTree));
+      EXPECT(assert_equal(expected.optimize(), bayesNet->optimize()));
+      EXPECT(arena.liveAllocations() > graph.size() + bayesNet->size());
+    }
+
+    // Everything was released, so the chunks can be reused
+    EXPECT_LONGS_EQUAL(0, arena.liveAllocations());
+    const size_t capacity = arena.capacity();
+    arena.reset();
+    EXPECT_LONGS_EQUAL(capacity, arena.capacity());
+  }
+}
+
 /* ************************************************************************* */
 TEST(testNonlinearFactorGraph, addPrior) {
   Key k(0);
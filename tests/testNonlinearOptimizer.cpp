@@ -244,6 +244,81 @@ TEST(NonlinearOptimizer, NullFactor) {
   DOUBLES_EQUAL(0,fg.error(actual3),tol);
 }
 
+/* ************************************************************************* */
+TEST(NonlinearOptimizer, ReuseEliminationStructure) {
+  // Pose graph with a loop closure and a null factor
+  NonlinearFactorGraph fg;
+  const auto model = noiseModel::Isotropic::Sigma(3, 0.1);
+  fg.addPrior(0, Pose2(), model);
+  for (size_t i = 1; i < 8; i++)
+    fg.emplace_shared<BetweenFactor<Pose2>>(i - 1, i, Pose2(1, 0, M_PI / 4), model);
+  fg.emplace_shared<BetweenFactor<Pose2>>(7, 0, Pose2(1, 0, M_PI / 4), model);
+  fg.push_back(NonlinearFactorGraph::sharedFactor());
+
+  Values init;
+  for (size_t i = 0; i < 8; i++)
+    init.insert(i, Pose2(0.1 * i + 0.2, -0.3 * i, 0.5 * i));
+
+  for (auto type : {NonlinearOptimizerParams::MULTIFRONTAL_CHOLESKY,
+                    NonlinearOptimizerParams::MULTIFRONTAL_QR}) {
+    GaussNewtonParams gnParams;
+    gnParams.linearSolverType = type;
+    const Values expectedGN = GaussNewtonOptimizer(fg, init, gnParams).optimize();
+    gnParams.setReuseEliminationStructure(true);
+    EXPECT(assert_equal(expectedGN, GaussNewtonOptimizer(fg, init, gnParams).optimize(), 1e-9));
+
+    LevenbergMarquardtParams lmParams;
+    lmParams.linearSolverType = type;
+    const Values expectedLM = LevenbergMarquardtOptimizer(fg, init, lmParams).optimize();
+    lmParams.setReuseEliminationStructure(true);
+    EXPECT(assert_equal(expectedLM, LevenbergMarquardtOptimizer(fg, init, lmParams).optimize(), 1e-9));
+    lmParams.setReuseEliminationStructure(false);
+    lmParams.setReuseEliminationAcrossLambdas(true);
+    EXPECT(assert_equal(expectedLM, LevenbergMarquardtOptimizer(fg, init, lmParams).optimize(), 1e-9));
+
+    DoglegParams dlParams;
+    dlParams.linearSolverType = type;
+    const Values expectedDL = DoglegOptimizer(fg, init, dlParams).optimize();
+    dlParams.setReuseEliminationStructure(true);
+    EXPECT(assert_equal(expectedDL, DoglegOptimizer(fg, init, dlParams).optimize(), 1e-9));
+  }
+}
+
+/* ************************************************************************* */
+TEST(NonlinearOptimizer, SparseCholesky) {
+  // Pose graph with a loop closure and a null factor
+  NonlinearFactorGraph fg;
+  const auto model = noiseModel::Isotropic::Sigma(3, 0.1);
+  fg.addPrior(0, Pose2(), model);
+  for (size_t i = 1; i < 8; i++)
+    fg.emplace_shared<BetweenFactor<Pose2>>(i - 1, i, Pose2(1, 0, M_PI / 4), model);
+  fg.emplace_shared<BetweenFactor<Pose2>>(7, 0, Pose2(1, 0, M_PI / 4), model);
+  fg.push_back(NonlinearFactorGraph::sharedFactor());
+
+  Values init;
+  for (size_t i = 0; i < 8; i++)
+    init.insert(i, Pose2(0.1 * i + 0.2, -0.3 * i, 0.5 * i));
+
+  GaussNewtonParams gnParams;
+  const Values expectedGN = GaussNewtonOptimizer(fg, init, gnParams).optimize();
+  gnParams.linearSolverType = NonlinearOptimizerParams::CHOLMOD;
+  EXPECT(assert_equal(expectedGN, GaussNewtonOptimizer(fg, init, gnParams).optimize(), 1e-9));
+
+  LevenbergMarquardtParams lmParams;
+  const Values expectedLM = LevenbergMarquardtOptimizer(fg, init, lmParams).optimize();
+  lmParams.linearSolverType = NonlinearOptimizerParams::CHOLMOD;
+  EXPECT(assert_equal(expectedLM, LevenbergMarquardtOptimizer(fg, init, lmParams).optimize(), 1e-9));
+
+  DoglegParams dlParams;
+  const Values expectedDL = DoglegOptimizer(fg, init, dlParams).optimize();
+  dlParams.linearSolverType = NonlinearOptimizerParams::CHOLMOD;
+  EXPECT(assert_equal(expectedDL, DoglegOptimizer(fg, init, dlParams).optimize(), 1e-9));
+
+  // With a given ordering
+  gnParams.ordering = Ordering{7, 6, 5, 4, 3, 2, 1, 0};
+  EXPECT(assert_equal(expectedGN, GaussNewtonOptimizer(fg, init, gnParams).optimize(), 1e-9));
+}
+
 /* ************************************************************************* */
 TEST_UNSAFE(NonlinearOptimizer, MoreOptimization) {
 
@@ -602,6 +677,47 @@ TEST( NonlinearOptimizer, iterationHook_LM )
   EXPECT(lastIterCalled>5);
 }
 /* ************************************************************************* */
+TEST( NonlinearOptimizer, rejectedSteps_LM )
+{
+  NonlinearFactorGraph fg;
+  fg.addPrior(0, Pose2(0, 0, 0), noiseModel::Isotropic::Sigma(3, 1));
+  fg.emplace_shared<BetweenFactor<Pose2>>(0, 1, Pose2(1, 0, M_PI / 2),
+      noiseModel::Isotropic::Sigma(3, 1));
+  fg.emplace_shared<BetweenFactor<Pose2>>(1, 2, Pose2(1, 0, M_PI / 2),
+      noiseModel::Isotropic::Sigma(3, 1));
+
+  Values init;
+  init.insert(0, Pose2(3, 4, -M_PI));
+  init.insert(1, Pose2(10, 2, -M_PI));
+  init.insert(2, Pose2(11, 7, -M_PI));
+
+  Values expected;
+  expected.insert(0, Pose2(0, 0, 0));
+  expected.insert(1, Pose2(1, 0, M_PI / 2));
+  expected.insert(2, Pose2(1, 1, M_PI));
+
+  // Start with a tiny lambda so that the first steps get rejected
+  for (bool diagonalDamping : {false, true}) {
+    LevenbergMarquardtParams lmParams;
+    lmParams.lambdaInitial = 1e-10;
+    lmParams.diagonalDamping = diagonalDamping;
+    const LevenbergMarquardtOptimizer* optimizer = nullptr;
+    size_t hookCalls = 0;
+    int totalRejected = 0;
+    lmParams.iterationHook = [&](size_t, double, double) {
+      hookCalls++;
+      totalRejected += optimizer->getRejectedSteps();
+    };
+    LevenbergMarquardtOptimizer lm(fg, init, lmParams);
+    optimizer = &lm;
+    EXPECT(assert_equal(expected, lm.optimize(), 1e-6));
+
+    // Every inner iteration is either a rejected or an accepted lambda
+    EXPECT(totalRejected > 0);
+    EXPECT_LONGS_EQUAL(lm.getInnerIterations(), totalRejected + hookCalls);
+  }
+}
+/* ************************************************************************* */
 TEST( NonlinearOptimizer, iterationHook_CG )
 {
   NonlinearFactorGraph fg(example::createReallyNonlinearFactorGraph());
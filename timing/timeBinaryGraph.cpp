@@ -0,0 +1,123 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeBinaryGraph.cpp
+ * @brief   Compare loading a pose graph from g2o, from a Boost binary archive
+ * and from the memory-mapped binary graph format
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/nonlinear/PriorFactor.h>
+#include <gtsam/slam/BinaryGraphFile.h>
+
+#ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
+#include <gtsam/base/serialization.h>
+#include <boost/serialization/export.hpp>
+#endif
+
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+#ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
+BOOST_CLASS_EXPORT_GUID(noiseModel::Constrained, "gtsam_noiseModel_Constrained")
+BOOST_CLASS_EXPORT_GUID(noiseModel::Diagonal, "gtsam_noiseModel_Diagonal")
+BOOST_CLASS_EXPORT_GUID(noiseModel::Gaussian, "gtsam_noiseModel_Gaussian")
+BOOST_CLASS_EXPORT_GUID(noiseModel::Unit, "gtsam_noiseModel_Unit")
+BOOST_CLASS_EXPORT_GUID(noiseModel::Isotropic, "gtsam_noiseModel_Isotropic")
+BOOST_CLASS_EXPORT_GUID(PriorFactor<Pose2>, "gtsam::PriorFactorPose2")
+BOOST_CLASS_EXPORT_GUID(PriorFactor<Pose3>, "gtsam::PriorFactorPose3")
+BOOST_CLASS_EXPORT_GUID(BetweenFactor<Pose2>, "gtsam::BetweenFactorPose2")
+BOOST_CLASS_EXPORT_GUID(BetweenFactor<Pose3>, "gtsam::BetweenFactorPose3")
+GTSAM_VALUE_EXPORT(gtsam::Pose2)
+GTSAM_VALUE_EXPORT(gtsam::Pose3)
+#endif
+
+int main(int argc, char* argv[]) {
+  // Usage: timeBinaryGraph [g2o file] [is3D]
+  const string g2oFile =
+      argc > 1 ? argv[1] : findExampleDataFile("sphere2500");
+  const bool is3D = argc > 2 ? atoi(argv[2]) != 0 : argc <= 1;
+  const size_t trials = 10;
+
+  const auto [graph, values] = readG2o(g2oFile, is3D);
+  // Some datasets, like sphere2500, have no initial estimate
+  if (values->empty()) {
+    for (Key key : graph->keys()) {
+      if (is3D)
+        values->insert(key, Pose3());
+      else
+        values->insert(key, Pose2());
+    }
+  }
+  cout << "NOTE: Times are reported for " << trials << " loads of "
+       << graph->size() << " factors and " << values->size() << " values"
+       << endl;
+
+  // Write the same graph and values in every format
+  const string rewritten = createRewrittenFileName(g2oFile);
+  const string textFile = rewritten + ".g2o", binaryFile = rewritten + ".bin";
+  writeG2o(*graph, *values, textFile);
+  writeBinaryGraph(*graph, *values, binaryFile);
+
+  size_t loaded = 0;
+  gttic_(readG2o);
+  for (size_t t = 0; t < trials; ++t)
+    loaded += readG2o(textFile, is3D).first->size();
+  gttoc_(readG2o);
+
+#ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
+  {
+    const string archiveFile = binaryFile + ".archive";
+    {
+      ofstream os(archiveFile.c_str(), ios::binary);
+      boost::archive::binary_oarchive archive(os);
+      archive << boost::serialization::make_nvp("graph", *graph);
+      archive << boost::serialization::make_nvp("values", *values);
+    }
+    gttic_(boost_binary_archive);
+    for (size_t t = 0; t < trials; ++t) {
+      ifstream is(archiveFile.c_str(), ios::binary);
+      boost::archive::binary_iarchive archive(is);
+      NonlinearFactorGraph archivedGraph;
+      Values archivedValues;
+      archive >> boost::serialization::make_nvp("graph", archivedGraph);
+      archive >> boost::serialization::make_nvp("values", archivedValues);
+      loaded += archivedGraph.size();
+    }
+    gttoc_(boost_binary_archive);
+    remove(archiveFile.c_str());
+  }
+#endif
+
+  gttic_(readBinaryGraph);
+  for (size_t t = 0; t < trials; ++t)
+    loaded += readBinaryGraph(binaryFile).first->size();
+  gttoc_(readBinaryGraph);
+
+  // Opening the file only maps it, decoding a few factors touches little else
+  gttic_(BinaryGraphFile_lazy);
+  for (size_t t = 0; t < trials; ++t) {
+    const BinaryGraphFile file(binaryFile);
+    for (size_t i = 0; i < file.nrFactors(); i += 100)
+      loaded += file.factor(i)->size();
+  }
+  gttoc_(BinaryGraphFile_lazy);
+
+  tictoc_print_();
+  cout << "(" << loaded << ")" << endl;
+  remove(textFile.c_str());
+  remove(binaryFile.c_str());
+  return 0;
+}
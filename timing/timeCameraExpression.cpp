@@ -17,6 +17,7 @@
  */
 
 #include <gtsam/slam/expressions.h>
+#include <gtsam/nonlinear/CompiledExpression.h>
 #include <gtsam/nonlinear/ExpressionFactor.h>
 #include <gtsam/slam/ProjectionFactor.h>
 #include <gtsam/slam/GeneralSFMFactor.h>
@@ -37,6 +38,35 @@ Point2 myProject(const Pose3& pose, const Point3& point,
   return camera.project(point, H1, H2, {});
 }
 
+// Time n evaluations of value and Jacobians of a compiled expression
+void timeCompiled(const string& str, const Expression<Point2>& expression,
+                  const Values& values) {
+  const CompiledExpression<Point2> compiled(expression);
+  VerticalBlockMatrix Ab(compiled.dims(), 2, true);
+  long timeLog = clock();
+  for (int i = 0; i < n; i++) {
+    Ab.matrix().setZero();
+    compiled.valueAndJacobians(values, Ab);
+  }
+  long timeLog2 = clock();
+  double seconds = (double)(timeLog2 - timeLog) / CLOCKS_PER_SEC;
+  cout << setprecision(3);
+  cout << str << ((double)seconds * 1000000 / n) << " musecs/call" << endl;
+}
+
+// Time evaluating a batch of m expressions n/m times
+void timeBatch(const string& str, const vector<Expression<Point2>>& expressions,
+               const Values& values) {
+  CompiledExpressionBatch<Point2> batch(expressions);
+  const int m = expressions.size();
+  long timeLog = clock();
+  for (int i = 0; i < n / m; i++) batch.evaluate(values);
+  long timeLog2 = clock();
+  double seconds = (double)(timeLog2 - timeLog) / CLOCKS_PER_SEC;
+  cout << setprecision(3);
+  cout << str << ((double)seconds * 1000000 / n) << " musecs/call" << endl;
+}
+
 int main() {
 
   // Create leaves
@@ -79,6 +109,10 @@ int main() {
           project3(x, p, K));
   time("Ternary(Leaf,Leaf,Leaf)     : ", f3, values);
 
+  // CompiledExpression, value and Jacobians only
+  timeCompiled("Compiled Bin(Leaf,Un(Bin))  : ",
+               uncalibrate(K, project(transformTo(x, p))), values);
+
   // CALIBRATED
 
   // Dedicated factor
@@ -103,5 +137,18 @@ int main() {
       std::make_shared<ExpressionFactor<Point2> >(model, z,
           Point2_(myProject, x, p));
   time("Binary(Leaf,Leaf)           : ", g3, values);
+
+  // CompiledExpression and a batch of 1000 expressions of the same shape
+  timeCompiled("Compiled Binary(Leaf,Leaf)  : ", Point2_(myProject, x, p),
+               values);
+  Values manyValues;
+  vector<Expression<Point2>> expressions;
+  for (size_t j = 0; j < 1000; j++) {
+    const Symbol xj('x', j), pj('p', j);
+    manyValues.insert(xj, Pose3());
+    manyValues.insert(pj, Point3(0, 0, 1));
+    expressions.emplace_back(myProject, Pose3_(xj), Point3_(pj));
+  }
+  timeBatch("Batch Binary(Leaf,Leaf)     : ", expressions, manyValues);
   return 0;
 }
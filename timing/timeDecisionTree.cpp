@@ -0,0 +1,73 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeDecisionTree.cpp
+ * @brief   Times decision tree products and discrete sum-product elimination
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/discrete/DecisionTreeFactor.h>
+#include <gtsam/discrete/DiscreteBayesNet.h>
+#include <gtsam/discrete/DiscreteFactorGraph.h>
+
+#include <iostream>
+
+using namespace gtsam;
+using namespace std;
+
+int main() {
+  // A binary grid MRF with attractive pairwise potentials, whose elimination
+  // creates factors on a whole row of the grid
+  const size_t rows = 10, cols = 10, nRepeats = 3;
+  auto key = [&](size_t i, size_t j) { return DiscreteKey(i * cols + j, 2); };
+  DiscreteFactorGraph graph;
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      graph.add(key(i, j), (i + j) % 3 ? "1 2" : "2 1");
+      if (i > 0) graph.add(key(i - 1, j) & key(i, j), "4 1 1 4");
+      if (j > 0) graph.add(key(i, j - 1) & key(i, j), "4 1 1 4");
+    }
+  }
+  Ordering ordering;
+  for (size_t j = 0; j < rows * cols; ++j) ordering.push_back(j);
+  cout << rows << "x" << cols << " grid, " << graph.size() << " factors\n";
+
+  gttic_(sumProduct);
+  for (size_t k = 0; k < nRepeats; ++k) graph.sumProduct(ordering);
+  gttoc_(sumProduct);
+
+  gttic_(maxProduct);
+  for (size_t k = 0; k < nRepeats; ++k) graph.maxProduct(ordering);
+  gttoc_(maxProduct);
+
+  // Products of many overlapping factors on a chain of ternary variables
+  vector<DecisionTreeFactor> factors;
+  for (size_t j = 0; j + 2 < 14; ++j)
+    factors.emplace_back(DiscreteKey(j, 3) & DiscreteKey(j + 1, 3) &
+                             DiscreteKey(j + 2, 3),
+                         "1 2 1 2 1 2 1 2 1 2 1 2 1 2 1 2 1 2 1 2 1 2 1 2 1 2 1");
+  gttic_(product);
+  for (size_t k = 0; k < nRepeats; ++k) {
+    DecisionTreeFactor product = factors.front();
+    for (size_t j = 1; j < factors.size(); ++j) product = product * factors[j];
+    product.sum(1);
+  }
+  gttoc_(product);
+
+  tictoc_getNode(sumProductNode, sumProduct);
+  tictoc_getNode(maxProductNode, maxProduct);
+  tictoc_getNode(productNode, product);
+  cout << "sumProduct: " << sumProductNode->secs() / nRepeats << " s\n";
+  cout << "maxProduct: " << maxProductNode->secs() / nRepeats << " s\n";
+  cout << "product:    " << productNode->secs() / nRepeats << " s\n";
+  return 0;
+}
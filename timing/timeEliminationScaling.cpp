@@ -0,0 +1,145 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeEliminationScaling.cpp
+ * @brief   Thread scaling of parallel multifrontal elimination, on a pose graph
+ *          and a bundle adjustment problem from examples/Data
+ *
+ * Usage: timeEliminationScaling [pose graph file] [BAL file]
+ * Defaults to w20000 and dubrovnik-3-7-pre.
+ */
+
+#include <gtsam/sfm/SfmData.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/GeneralSFMFactor.h>
+#include <gtsam/slam/dataset.h>
+#include <gtsam/geometry/Cal3Bundler.h>
+#include <gtsam/geometry/PinholeCamera.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/inference/Symbol.h>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/task_arena.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::C;
+using symbol_shorthand::P;
+
+static const size_t kRepetitions = 5;
+
+/* ************************************************************************* */
+// Pose graph with odometry-chained initial estimate
+static pair<GaussianFactorGraph, Ordering> poseGraphProblem(const string& file) {
+  const auto [graph, initialFromFile] = load2D(file);
+  Values initial;
+  initial.insert(0, Pose2());
+  for (const auto& factor : *graph) {
+    auto between = dynamic_pointer_cast<BetweenFactor<Pose2>>(factor);
+    if (!between) continue;
+    const Key i = between->key<1>(), j = between->key<2>();
+    if (initial.exists(i) && !initial.exists(j))
+      initial.insert(j, initial.at<Pose2>(i) * between->measured());
+  }
+  NonlinearFactorGraph withPrior = *graph;
+  withPrior.addPrior(0, Pose2(), noiseModel::Unit::Create(3));
+  const auto linear = withPrior.linearize(initial);
+  return {*linear, Ordering::Colamd(*linear)};
+}
+
+/* ************************************************************************* */
+// Bundle adjustment, eliminating points first
+static pair<GaussianFactorGraph, Ordering> balProblem(const string& file) {
+  typedef PinholeCamera<Cal3Bundler> Camera;
+  const SfmData db = SfmData::FromBalFile(file);
+  const auto model = noiseModel::Unit::Create(2);
+
+  NonlinearFactorGraph graph;
+  Values initial;
+  Ordering ordering;
+  for (size_t j = 0; j < db.numberTracks(); j++) {
+    for (const SfmMeasurement& m : db.tracks[j].measurements)
+      graph.emplace_shared<GeneralSFMFactor<Camera, Point3>>(m.second, model,
+                                                             C(m.first), P(j));
+    initial.insert(P(j), db.tracks[j].p);
+    ordering.push_back(P(j));
+  }
+  for (size_t i = 0; i < db.numberCameras(); i++) {
+    initial.insert(C(i), db.cameras[i]);
+    ordering.push_back(C(i));
+  }
+  // Fix the gauge
+  graph.addPrior(C(0), db.cameras[0], noiseModel::Isotropic::Sigma(9, 1e-3));
+  graph.addPrior(P(0), db.tracks[0].p, noiseModel::Isotropic::Sigma(3, 1e-3));
+  return {*graph.linearize(initial), ordering};
+}
+
+/* ************************************************************************* */
+// Average wall-clock time of eliminating the problem
+static double timeElimination(const GaussianFactorGraph& graph,
+                              const Ordering& ordering) {
+  graph.eliminateMultifrontal(ordering);  // warm up
+  const auto start = chrono::steady_clock::now();
+  for (size_t i = 0; i < kRepetitions; i++) graph.eliminateMultifrontal(ordering);
+  const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+  return elapsed.count() / kRepetitions;
+}
+
+/* ************************************************************************* */
+static void timeScaling(const string& name, const GaussianFactorGraph& graph,
+                        const Ordering& ordering) {
+  cout << name << ": " << graph.size() << " factors, " << ordering.size()
+       << " variables" << endl;
+  const int maxThreads = max(1u, thread::hardware_concurrency());
+  double serial = 0.0;
+  for (int nrThreads = 1; nrThreads <= maxThreads; nrThreads++) {
+    double seconds;
+#ifdef GTSAM_USE_TBB
+    tbb::task_arena arena(nrThreads);
+    arena.execute([&] { seconds = timeElimination(graph, ordering); });
+#else
+    if (nrThreads > 1) break;
+    seconds = timeElimination(graph, ordering);
+#endif
+    if (nrThreads == 1) serial = seconds;
+    cout << "  threads: " << setw(3) << nrThreads << "  time: " << setw(10)
+         << seconds << " s  speedup: " << serial / seconds << endl;
+  }
+}
+
+/* ************************************************************************* */
+int main(int argc, char* argv[]) {
+  const string poseGraphFile =
+      findExampleDataFile(argc > 1 ? argv[1] : "w20000");
+  const string balFile =
+      findExampleDataFile(argc > 2 ? argv[2] : "dubrovnik-3-7-pre");
+
+  const auto [poseGraph, poseOrdering] = poseGraphProblem(poseGraphFile);
+  timeScaling(poseGraphFile, poseGraph, poseOrdering);
+
+  const auto [bal, balOrdering] = balProblem(balFile);
+  timeScaling(balFile, bal, balOrdering);
+  return 0;
+}
@@ -17,10 +17,14 @@
  */
 
 #include <gtsam/base/timing.h>
+#include <gtsam/geometry/Cal3_S2.h>
+#include <gtsam/inference/Symbol.h>
 #include <gtsam/linear/GaussianBayesNet.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/NoiseModel.h>
 #include <gtsam/linear/VectorValues.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/ProjectionFactor.h>
 
 #include <random>
 #include <vector>
@@ -31,6 +35,31 @@ using namespace std;
 static std::mt19937 rng;
 static std::uniform_real_distribution<> uniform(0.0, 1.0);
 
+/// Time linearizing all factors nTrials times, with the dynamic-size path of
+/// NoiseModelFactor::linearize or with the fixed-size path of the factor.
+template <class FACTOR>
+static void timeLinearize(const string& name, const vector<FACTOR>& factors,
+                          const Values& values, size_t nTrials) {
+  tictoc_reset_();
+  gttic_(dynamicSize);
+  for (size_t trial = 0; trial < nTrials; ++trial)
+    for (const FACTOR& factor : factors)
+      factor.NoiseModelFactor::linearize(values);
+  gttoc_(dynamicSize);
+  tictoc_getNode(dynamicNode, dynamicSize);
+
+  gttic_(fixedSize);
+  for (size_t trial = 0; trial < nTrials; ++trial)
+    for (const FACTOR& factor : factors) factor.linearize(values);
+  gttoc_(fixedSize);
+  tictoc_getNode(fixedNode, fixedSize);
+
+  const double perFactor = 1e9 / double(nTrials * factors.size());
+  cout << name << ":  dynamic " << dynamicNode->secs() * perFactor
+       << "  fixed " << fixedNode->secs() * perFactor << " ns/factor  (speedup "
+       << dynamicNode->secs() / fixedNode->secs() << ")\n";
+}
+
 int main(int argc, char *argv[]) {
 
   Key key = 0;
@@ -154,6 +183,39 @@ int main(int argc, char *argv[]) {
       "  solve " << ((blocksolve-combsolve) / blocksolve) << "\n";
   cout << endl;
 
+  /////////////////////////////////////////////////////////////////////////////
+  // Overhead of linearizing nonlinear factors with dynamic-size Jacobians
+
+  {
+    using symbol_shorthand::L;
+    using symbol_shorthand::X;
+    const size_t nFactors = 1000, nLinearize = 200;
+    Values values;
+    for (size_t i = 0; i <= nFactors; ++i) {
+      values.insert(X(i), Pose3(Rot3::Ypr(0.01 * i, 0.1, -0.2),
+                                Point3(0.1 * i, uniform(rng), uniform(rng))));
+      values.insert(L(i), Point3(0.1 * i, uniform(rng), 10 + uniform(rng)));
+    }
+
+    vector<BetweenFactor<Pose3>> betweens;
+    const auto odometryNoise = noiseModel::Diagonal::Sigmas(
+        (Vector(6) << 0.1, 0.1, 0.1, 0.3, 0.3, 0.3).finished());
+    for (size_t i = 0; i < nFactors; ++i)
+      betweens.emplace_back(X(i), X(i + 1), Pose3(), odometryNoise);
+
+    vector<GenericProjectionFactor<Pose3, Point3>> projections;
+    const auto K = std::make_shared<Cal3_S2>(500, 500, 0.0, 320, 240);
+    const auto pixelNoise = noiseModel::Isotropic::Sigma(2, 1.0);
+    for (size_t i = 0; i < nFactors; ++i)
+      projections.emplace_back(Point2(320, 240), pixelNoise, X(i), L(i), K);
+
+    cout << "Linearizing " << nFactors << " factors " << nLinearize
+         << " times\n";
+    timeLinearize("BetweenFactor<Pose3>   ", betweens, values, nLinearize);
+    timeLinearize("GenericProjectionFactor", projections, values, nLinearize);
+    cout << endl;
+  }
+
   return 0;
 }
 
@@ -0,0 +1,118 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeFlatValues.cpp
+ * @brief   Compare the map-based Values with the contiguous FlatValues
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/nonlinear/FlatValues.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::L;
+using symbol_shorthand::X;
+
+int main(int argc, char* argv[]) {
+  const size_t nrPoses = argc > 1 ? atoi(argv[1]) : 100000;
+  const size_t nrPoints = nrPoses;
+  const size_t trials = 10;
+  cout << "NOTE: Times are reported for " << trials << " passes over "
+       << nrPoses << " poses and " << nrPoints << " points" << endl;
+
+  // Create a pose graph-like Values and a matching delta
+  Values values;
+  VectorValues delta;
+  for (size_t i = 0; i < nrPoses; ++i) {
+    values.insert(X(i), Pose3(Rot3::Rz(0.01 * i), Point3(i, 0, 0)));
+    delta.insert(X(i), (Vector6() << 1e-3, 2e-3, -1e-3, 0.1, 0.2, 0.3).finished());
+  }
+  for (size_t j = 0; j < nrPoints; ++j) {
+    values.insert(L(j), Point3(j, 1, 2));
+    delta.insert(L(j), Vector3(0.1, -0.1, 0.2));
+  }
+
+  gttic_(FlatValues_FromValues);
+  FlatValues flat = FlatValues::FromValues<Pose3, Point3>(values);
+  gttoc_(FlatValues_FromValues);
+
+  gttic_(Values_retract);
+  for (size_t t = 0; t < trials; ++t) values = values.retract(delta);
+  gttoc_(Values_retract);
+
+  gttic_(FlatValues_retract);
+  for (size_t t = 0; t < trials; ++t) flat = flat.retract(delta);
+  gttoc_(FlatValues_retract);
+
+  gttic_(FlatValues_retractInPlace);
+  for (size_t t = 0; t < trials; ++t) flat.retractInPlace(delta);
+  gttoc_(FlatValues_retractInPlace);
+
+  // Bring both to the same state for the remaining comparisons
+  flat = FlatValues::FromValues<Pose3, Point3>(values);
+  const Values retracted = values.retract(delta);
+  const FlatValues flatRetracted = flat.retract(delta);
+
+  gttic_(Values_localCoordinates);
+  for (size_t t = 0; t < trials; ++t) values.localCoordinates(retracted);
+  gttoc_(Values_localCoordinates);
+
+  gttic_(FlatValues_localCoordinates);
+  for (size_t t = 0; t < trials; ++t) flat.localCoordinates(flatRetracted);
+  gttoc_(FlatValues_localCoordinates);
+
+  double sum = 0;
+  gttic_(Values_at);
+  for (size_t t = 0; t < trials; ++t)
+    for (size_t i = 0; i < nrPoses; ++i)
+      sum += values.at<Pose3>(X(i)).x();
+  gttoc_(Values_at);
+
+  gttic_(FlatValues_at);
+  for (size_t t = 0; t < trials; ++t)
+    for (size_t i = 0; i < nrPoses; ++i) sum += flat.at<Pose3>(X(i)).x();
+  gttoc_(FlatValues_at);
+
+  // One iteration of an optimizer outside elimination: retract, then evaluate
+  // the error of an odometry chain at the new values
+  NonlinearFactorGraph graph;
+  const auto noise = noiseModel::Isotropic::Sigma(6, 0.1);
+  for (size_t i = 0; i + 1 < nrPoses; ++i)
+    graph.emplace_shared<BetweenFactor<Pose3>>(
+        X(i), X(i + 1), values.at<Pose3>(X(i)).between(values.at<Pose3>(X(i + 1))),
+        noise);
+
+  gttic_(Values_retract_error);
+  for (size_t t = 0; t < trials; ++t) {
+    values = values.retract(delta);
+    sum += graph.error(values);
+  }
+  gttoc_(Values_retract_error);
+
+  gttic_(FlatValues_retract_error);
+  for (size_t t = 0; t < trials; ++t) {
+    flat.retractInPlace(delta);
+    sum += graph.error(flat);
+  }
+  gttoc_(FlatValues_retract_error);
+
+  tictoc_print_();
+  cout << "checksum: " << sum << endl;
+
+  return 0;
+}
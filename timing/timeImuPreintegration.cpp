@@ -0,0 +1,105 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeImuPreintegration.cpp
+ * @brief   Compares per-sample IMU preintegration with integrating blocks
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/navigation/ImuFactor.h>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace gtsam;
+using namespace std;
+
+/// The per-sample update as it was before integrateMeasurementBlock
+class PerSamplePreintegration : public PreintegratedImuMeasurements {
+ public:
+  using PreintegratedImuMeasurements::PreintegratedImuMeasurements;
+
+  void integrate(const Vector3& measuredAcc, const Vector3& measuredOmega,
+                 double dt) {
+    Matrix9 A;
+    Matrix93 B, C;
+    PreintegrationType::update(measuredAcc, measuredOmega, dt, &A, &B, &C);
+    const Matrix3& aCov = p().accelerometerCovariance;
+    const Matrix3& wCov = p().gyroscopeCovariance;
+    const Matrix3& iCov = p().integrationCovariance;
+    preintMeasCov_ = A * preintMeasCov_ * A.transpose();
+    preintMeasCov_.noalias() += B * (aCov / dt) * B.transpose();
+    preintMeasCov_.noalias() += C * (wCov / dt) * C.transpose();
+    preintMeasCov_.block<3, 3>(3, 3).noalias() += iCov * dt;
+  }
+};
+
+int main() {
+  // 200 Hz IMU, integrated between 20 Hz camera frames
+  const size_t nSamples = 200000, blockSize = 10;
+  const double dt = 0.005;
+
+  auto p = PreintegrationParams::MakeSharedD(9.81);
+  p->accelerometerCovariance = 1e-4 * I_3x3;
+  p->gyroscopeCovariance = 1e-6 * I_3x3;
+  p->integrationCovariance = 1e-8 * I_3x3;
+
+  std::mt19937 rng(42);
+  std::normal_distribution<> normal(0.0, 0.1);
+  vector<double> accs(3 * nSamples), omegas(3 * nSamples), dts(nSamples, dt);
+  for (size_t i = 0; i < 3 * nSamples; ++i) {
+    accs[i] = normal(rng) + (i % 3 == 2 ? -9.81 : 0.0);
+    omegas[i] = normal(rng);
+  }
+
+  cout << nSamples << " samples, blocks of " << blockSize << "\n";
+
+  gttic_(perSample);
+  for (size_t start = 0; start < nSamples; start += blockSize) {
+    PerSamplePreintegration pim(p);
+    for (size_t k = start; k < start + blockSize; ++k)
+      pim.integrate(Vector3::Map(&accs[3 * k]), Vector3::Map(&omegas[3 * k]),
+                    dts[k]);
+  }
+  gttoc_(perSample);
+
+  gttic_(block);
+  for (size_t start = 0; start < nSamples; start += blockSize) {
+    PreintegratedImuMeasurements pim(p);
+    pim.integrateMeasurementBlock(&accs[3 * start], &omegas[3 * start],
+                                  &dts[start], blockSize);
+  }
+  gttoc_(block);
+
+  gttic_(deferredCovariance);
+  for (size_t start = 0; start < nSamples; start += blockSize) {
+    PreintegratedImuMeasurements pim(p);
+    pim.integrateMeasurementBlock(&accs[3 * start], &omegas[3 * start],
+                                  &dts[start], blockSize, true);
+  }
+  gttoc_(deferredCovariance);
+
+  tictoc_getNode(perSampleNode, perSample);
+  tictoc_getNode(blockNode, block);
+  tictoc_getNode(deferredNode, deferredCovariance);
+  const double perSample = 1e9 / double(nSamples);
+  cout << "per sample:          " << perSampleNode->secs() * perSample
+       << " ns/sample\n";
+  cout << "block:               " << blockNode->secs() * perSample
+       << " ns/sample  (speedup "
+       << perSampleNode->secs() / blockNode->secs() << ")\n";
+  cout << "deferred covariance: " << deferredNode->secs() * perSample
+       << " ns/sample  (speedup "
+       << perSampleNode->secs() / deferredNode->secs() << ")\n";
+  return 0;
+}
@@ -38,16 +38,20 @@ using symbol_shorthand::K;
 using symbol_shorthand::P;
 
 static bool gUseSchur = true;
+static bool gUseImplicitSchur = false;
 static SharedNoiseModel gNoiseModel = noiseModel::Unit::Create(2);
 
 // parse options and read BAL file
 SfmData preamble(int argc, char* argv[]) {
   // primitive argument parsing:
   if (argc > 2) {
-    if (strcmp(argv[1], "--colamd"))
+    if (!strcmp(argv[1], "--colamd"))
       gUseSchur = false;
+    else if (!strcmp(argv[1], "--implicit-schur"))
+      gUseImplicitSchur = true;
     else
-      throw runtime_error("Usage: timeSFMBALxxx [--colamd] [BALfile]");
+      throw runtime_error(
+          "Usage: timeSFMBALxxx [--colamd | --implicit-schur] [BALfile]");
   }
 
   // Load BAL file
@@ -71,7 +75,10 @@ int optimize(const SfmData& db, const NonlinearFactorGraph& graph,
 //  params.setLinearSolverType("SEQUENTIAL_CHOLESKY");
 //  params.setVerbosityLM("SUMMARY");
 
-  if (gUseSchur) {
+  if (gUseImplicitSchur) {
+    // Conjugate gradient on the camera system, landmarks eliminated implicitly
+    params.linearSolverType = LevenbergMarquardtParams::IMPLICIT_SCHUR;
+  } else if (gUseSchur) {
     // Create Schur-complement ordering
     Ordering ordering;
     for (size_t j = 0; j < db.numberTracks(); j++) ordering.push_back(P(j));
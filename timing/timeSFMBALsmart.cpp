@@ -19,6 +19,7 @@
 #include "timeSFMBAL.h"
 
 #include <gtsam/slam/SmartProjectionFactor.h>
+#include <gtsam/geometry/CameraSet.h>
 #include <gtsam/geometry/Cal3Bundler.h>
 #include <gtsam/geometry/PinholeCamera.h>
 #include <gtsam/geometry/Point3.h>
@@ -51,5 +52,38 @@ int main(int argc, char* argv[]) {
   for (const SfmCamera& camera : db.cameras)
     initial.insert(C(i++), camera);
 
+  // Time the projection with Jacobians that dominates linearizing the smart
+  // factors: camera by camera, as before, and with the batched CameraSet
+  {
+    vector<CameraSet<Camera>> sets(db.numberTracks());
+    for (size_t j = 0; j < db.numberTracks(); j++)
+      for (const SfmMeasurement& m : db.tracks[j].measurements)
+        sets[j].push_back(db.cameras[m.first]);
+
+    double sum = 0;
+    CameraSet<Camera>::FBlocks Fs;
+    Matrix E;
+    gttic_(project2_camera_by_camera);
+    for (size_t j = 0; j < db.numberTracks(); j++) {
+      const CameraSet<Camera>& set = sets[j];
+      const size_t m = set.size();
+      Fs.resize(m);
+      E.resize(2 * m, 3);
+      for (size_t k = 0; k < m; k++) {
+        Matrix23 Ek;
+        sum += set[k].project2(db.tracks[j].p, Fs[k], Ek).x();
+        E.block<2, 3>(2 * k, 0) = Ek;
+      }
+    }
+    gttoc_(project2_camera_by_camera);
+
+    gttic_(project2_batched);
+    for (size_t j = 0; j < db.numberTracks(); j++)
+      sum += sets[j].project2(db.tracks[j].p, Fs, E)[0].x();
+    gttoc_(project2_batched);
+    tictoc_print_();
+    cout << "(" << sum << ")" << endl;
+  }
+
   return optimize(db, graph, initial);
 }
@@ -0,0 +1,78 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeSparseCholesky.cpp
+ * @brief   Compares multifrontal elimination with the sparse Cholesky solver
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/linear/GaussianEliminationStructure.h>
+#include <gtsam/linear/SparseCholeskySolver.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+#include <iostream>
+
+using namespace gtsam;
+using namespace std;
+
+int main() {
+  // A Pose2 grid, linearized once and solved as a nonlinear optimizer would
+  const size_t side = 60, nSolves = 10;
+  NonlinearFactorGraph graph;
+  Values values;
+  const auto model = noiseModel::Isotropic::Sigma(3, 0.1);
+  auto key = [&](size_t i, size_t j) { return Key(i * side + j); };
+  graph.addPrior(key(0, 0), Pose2(), model);
+  for (size_t i = 0; i < side; ++i) {
+    for (size_t j = 0; j < side; ++j) {
+      values.insert(key(i, j), Pose2(i + 0.1 * j, j - 0.1 * i, 0.01 * i));
+      if (i > 0)
+        graph.emplace_shared<BetweenFactor<Pose2>>(key(i - 1, j), key(i, j),
+                                                   Pose2(1, 0, 0), model);
+      if (j > 0)
+        graph.emplace_shared<BetweenFactor<Pose2>>(key(i, j - 1), key(i, j),
+                                                   Pose2(0, 1, 0), model);
+    }
+  }
+  const GaussianFactorGraph linear = *graph.linearize(values);
+  const Ordering ordering = Ordering::Colamd(linear);
+  cout << side * side << " poses, " << nSolves << " solves\n";
+
+  gttic_(multifrontal);
+  for (size_t k = 0; k < nSolves; ++k)
+    linear.optimize(ordering, EliminateCholesky);
+  gttoc_(multifrontal);
+
+  gttic_(cachedMultifrontal);
+  const GaussianEliminationStructure structure(linear, ordering);
+  for (size_t k = 0; k < nSolves; ++k)
+    structure.eliminate(linear, EliminateCholesky)->optimize();
+  gttoc_(cachedMultifrontal);
+
+  gttic_(sparseCholesky);
+  const SparseCholeskySolver solver(linear, ordering);
+  for (size_t k = 0; k < nSolves; ++k) solver.solve(linear);
+  gttoc_(sparseCholesky);
+
+  tictoc_getNode(multifrontalNode, multifrontal);
+  tictoc_getNode(cachedNode, cachedMultifrontal);
+  tictoc_getNode(sparseNode, sparseCholesky);
+  cout << "multifrontal:        " << multifrontalNode->secs() << " s\n";
+  cout << "cached multifrontal: " << cachedNode->secs() << " s\n";
+  cout << "sparse Cholesky:     " << sparseNode->secs() << " s  (speedup "
+       << multifrontalNode->secs() / sparseNode->secs() << ")\n";
+  cout << "nnz(L): " << solver.nnz() << "\n";
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeTableFactor.cpp
+ * @brief   Times sparse TableFactor products and marginals against
+ *          DecisionTreeFactor
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/discrete/DecisionTreeFactor.h>
+#include <gtsam/discrete/TableFactor.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace gtsam;
+using namespace std;
+
+int main() {
+  // A chain of sparse CSP-like factors on variables with 6 values, where
+  // x[j] + x[j+1] + x[j+2] has to be even: the product has one nonzero per
+  // 2^(n-2) assignments.
+  const size_t n = 11, d = 6, nRepeats = 3;
+  mt19937 rng(42);
+  uniform_real_distribution<double> uniform(1.0, 2.0);
+  vector<TableFactor> tables;
+  vector<DecisionTreeFactor> trees;
+  for (size_t j = 0; j + 2 < n; ++j) {
+    const DiscreteKeys keys{{j, d}, {j + 1, d}, {j + 2, d}};
+    vector<double> values(d * d * d, 0.0);
+    for (size_t a = 0; a < d; ++a)
+      for (size_t b = 0; b < d; ++b)
+        for (size_t c = 0; c < d; ++c)
+          if ((a + b + c) % 2 == 0) values[(a * d + b) * d + c] = uniform(rng);
+    tables.emplace_back(keys, values);
+    trees.emplace_back(keys, values);
+  }
+  cout << tables.size() << " factors on " << n << " variables\n";
+
+  // Product of the chain, then sum and max out the first half of the keys.
+  Ordering half;
+  for (size_t j = 0; j < n / 2; ++j) half.push_back(j);
+
+  TableFactor tableProduct;
+  gttic_(TableFactor_product);
+  for (size_t k = 0; k < nRepeats; ++k) {
+    tableProduct = tables.front();
+    for (size_t j = 1; j < tables.size(); ++j)
+      tableProduct = tableProduct * tables[j];
+  }
+  gttoc_(TableFactor_product);
+  gttic_(TableFactor_marginals);
+  for (size_t k = 0; k < nRepeats; ++k) {
+    tableProduct.sum(half);
+    tableProduct.max(half);
+  }
+  gttoc_(TableFactor_marginals);
+
+  DecisionTreeFactor treeProduct;
+  gttic_(DecisionTreeFactor_product);
+  for (size_t k = 0; k < nRepeats; ++k) {
+    treeProduct = trees.front();
+    for (size_t j = 1; j < trees.size(); ++j)
+      treeProduct = treeProduct * trees[j];
+  }
+  gttoc_(DecisionTreeFactor_product);
+  gttic_(DecisionTreeFactor_marginals);
+  for (size_t k = 0; k < nRepeats; ++k) {
+    treeProduct.sum(half);
+    treeProduct.max(half);
+  }
+  gttoc_(DecisionTreeFactor_marginals);
+
+  // Check both agree on the marginal.
+  const auto tableMarginal = tableProduct.sum(half);
+  double error = 0.0;
+  for (const auto& [values, p] : treeProduct.sum(half)->enumerate())
+    error = std::max(error, std::abs((*tableMarginal)(values) - p));
+  cout << "nonzeros: " << tableProduct.nrNonZeros()
+       << ", max marginal difference: " << error << "\n";
+
+  tictoc_getNode(tableProductNode, TableFactor_product);
+  tictoc_getNode(tableMarginalsNode, TableFactor_marginals);
+  tictoc_getNode(treeProductNode, DecisionTreeFactor_product);
+  tictoc_getNode(treeMarginalsNode, DecisionTreeFactor_marginals);
+  cout << "TableFactor product:          "
+       << tableProductNode->secs() / nRepeats << " s\n";
+  cout << "TableFactor marginals:        "
+       << tableMarginalsNode->secs() / nRepeats << " s\n";
+  cout << "DecisionTreeFactor product:   "
+       << treeProductNode->secs() / nRepeats << " s\n";
+  cout << "DecisionTreeFactor marginals: "
+       << treeMarginalsNode->secs() / nRepeats << " s\n";
+  return 0;
+}